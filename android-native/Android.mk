@@ -447,12 +447,14 @@ LOCAL_SRC_FILES := \
   src/ndn-cpp/src/digest-sha256-signature.cpp \
   src/ndn-cpp/src/exclude.cpp \
   src/ndn-cpp/src/face.cpp \
+  src/ndn-cpp/src/face-metrics.cpp \
   src/ndn-cpp/src/generic-signature.cpp \
   src/ndn-cpp/src/hmac-with-sha256-signature.cpp \
   src/ndn-cpp/src/interest-filter.cpp \
   src/ndn-cpp/src/interest.cpp \
   src/ndn-cpp/src/key-locator.cpp \
   src/ndn-cpp/src/link.cpp \
+  src/ndn-cpp/src/merkle-signature.cpp \
   src/ndn-cpp/src/meta-info.cpp \
   src/ndn-cpp/src/name.cpp \
   src/ndn-cpp/src/network-nack.cpp \
@@ -485,6 +487,7 @@ LOCAL_SRC_FILES := \
   src/ndn-cpp/src/encrypt/sqlite3-group-manager-db.cpp \
   src/ndn-cpp/src/encrypt/sqlite3-producer-db.cpp \
   src/ndn-cpp/src/encrypt/algo/aes-algorithm.cpp \
+  src/ndn-cpp/src/encrypt/algo/aes-stream-cipher.cpp \
   src/ndn-cpp/src/encrypt/algo/encrypt-params.cpp \
   src/ndn-cpp/src/encrypt/algo/encryptor.cpp \
   src/ndn-cpp/src/encrypt/algo/rsa-algorithm.cpp \
@@ -526,6 +529,9 @@ LOCAL_SRC_FILES := \
   src/ndn-cpp/src/lp/congestion-mark.cpp \
   src/ndn-cpp/src/lp/incoming-face-id.cpp \
   src/ndn-cpp/src/lp/lp-packet.cpp \
+  src/ndn-cpp/src/security/async-signer.cpp \
+  src/ndn-cpp/src/security/batch-signer.cpp \
+  src/ndn-cpp/src/security/batch-verifier.cpp \
   src/ndn-cpp/src/security/command-interest-signer.cpp \
   src/ndn-cpp/src/security/key-chain.cpp \
   src/ndn-cpp/src/security/key-params.cpp \
@@ -535,6 +541,8 @@ LOCAL_SRC_FILES := \
   src/ndn-cpp/src/security/validator-null.cpp \
   src/ndn-cpp/src/security/validity-period.cpp \
   src/ndn-cpp/src/security/verification-helpers.cpp \
+  src/ndn-cpp/src/security/detail/decoded-public-key.cpp \
+  src/ndn-cpp/src/security/detail/merkle-tree.cpp \
   src/ndn-cpp/src/security/certificate/certificate-extension.cpp \
   src/ndn-cpp/src/security/certificate/certificate-subject-description.cpp \
   src/ndn-cpp/src/security/certificate/certificate.cpp \
@@ -591,8 +599,10 @@ LOCAL_SRC_FILES := \
   src/ndn-cpp/src/security/v2/validator-config/config-filter.cpp \
   src/ndn-cpp/src/security/v2/validator-config/config-name-relation.cpp \
   src/ndn-cpp/src/security/v2/validator-config/config-rule.cpp \
+  src/ndn-cpp/src/security/v2/verified-data-cache.cpp \
   src/ndn-cpp/src/transport/async-tcp-transport.cpp \
   src/ndn-cpp/src/transport/async-unix-transport.cpp \
+  src/ndn-cpp/src/transport/loopback-transport.cpp \
   src/ndn-cpp/src/transport/tcp-transport.cpp \
   src/ndn-cpp/src/transport/transport.cpp \
   src/ndn-cpp/src/transport/udp-transport.cpp \
@@ -602,8 +612,13 @@ LOCAL_SRC_FILES := \
   src/ndn-cpp/src/util/config-file.cpp \
   src/ndn-cpp/src/util/dynamic-uint8-vector.cpp \
   src/ndn-cpp/src/util/exponential-re-express.cpp \
+  src/ndn-cpp/src/util/file-status.cpp \
+  src/ndn-cpp/src/util/latency-histogram.cpp \
   src/ndn-cpp/src/util/logging.cpp \
+  src/ndn-cpp/src/util/loopback-forwarder.cpp \
   src/ndn-cpp/src/util/memory-content-cache.cpp \
+  src/ndn-cpp/src/util/packet-trace.cpp \
+  src/ndn-cpp/src/util/parallel-tasks.cpp \
   src/ndn-cpp/src/util/segment-fetcher.cpp \
   src/ndn-cpp/src/util/sqlite3-statement.cpp \
   src/ndn-cpp/src/util/regex/ndn-regex-backref-manager.cpp \
@@ -0,0 +1,195 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2018 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+/* This compares the time to verify many Data packets one at a time with
+ * VerificationHelpers::verifyDataSignature, as one batch with
+ * VerificationHelpers::verifyDataSignatures, and with BatchVerifier using
+ * different numbers of threads. To run it, you must install Boost with asio.
+ */
+
+// Only compile if ndn-cpp-config.h defines NDN_CPP_HAVE_BOOST_ASIO.
+#include <ndn-cpp/ndn-cpp-config.h>
+#if defined(NDN_CPP_HAVE_BOOST_ASIO) && NDN_CPP_HAVE_LIBPTHREAD
+
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <sys/time.h>
+#include <pthread.h>
+#include <ndn-cpp/security/key-chain.hpp>
+#include <ndn-cpp/security/verification-helpers.hpp>
+#include <ndn-cpp/security/batch-verifier.hpp>
+
+using namespace std;
+using namespace ndn;
+using namespace ndn::func_lib;
+
+static double
+getNowSeconds()
+{
+  struct timeval t;
+  gettimeofday(&t, 0);
+  return t.tv_sec + t.tv_usec / 1000000.0;
+}
+
+static void*
+runIoService(void* ioService)
+{
+  ((boost::asio::io_service*)ioService)->run();
+  return 0;
+}
+
+static void
+onVerified
+  (const vector<bool>& results, boost::asio::io_service* ioService,
+   size_t* nVerified)
+{
+  for (size_t i = 0; i < results.size(); ++i) {
+    if (results[i])
+      ++(*nVerified);
+  }
+
+  ioService->stop();
+}
+
+/**
+ * Use a BatchVerifier to verify the dataList, where the io_service is run by
+ * nThreads threads.
+ * @param dataList The Data packets to verify.
+ * @param publicKeyDerList The public key for each packet.
+ * @param nThreads The number of threads to run the io_service.
+ * @param nVerified Set this to the number of verified packets.
+ * @return The number of seconds.
+ */
+static double
+benchmarkBatchVerifierSeconds
+  (const vector<ptr_lib::shared_ptr<Data> >& dataList,
+   const vector<Blob>& publicKeyDerList, size_t nThreads, size_t& nVerified)
+{
+  boost::asio::io_service ioService;
+  // Keep the io_service running until onVerified calls stop().
+  boost::asio::io_service::work work(ioService);
+  BatchVerifier verifier(ioService);
+  nVerified = 0;
+
+  double start = getNowSeconds();
+  verifier.verifyDataSignatures
+    (dataList, publicKeyDerList,
+     bind(&onVerified, _1, &ioService, &nVerified));
+
+  vector<pthread_t> threads(nThreads);
+  for (size_t i = 0; i < nThreads; ++i)
+    pthread_create(&threads[i], 0, runIoService, &ioService);
+  for (size_t i = 0; i < nThreads; ++i)
+    pthread_join(threads[i], 0);
+  double finish = getNowSeconds();
+
+  return finish - start;
+}
+
+static void
+printResult(const string& label, size_t nPackets, size_t nVerified, double duration)
+{
+  cout << label << ": Verified " << nVerified << " of " << nPackets
+       << ", Duration sec, Hz: " << duration << ", " << (nPackets / duration)
+       << endl;
+}
+
+/**
+ * Sign nPackets Data packets with a new key of the given type, then verify them
+ * one at a time, as one batch, and with BatchVerifier for 1, 2 and 4 threads.
+ * @param keyParams The parameters for the signing key.
+ * @param nPackets The number of Data packets.
+ */
+static void
+benchmarkVerify(const KeyParams& keyParams, size_t nPackets)
+{
+  KeyChain keyChain("pib-memory:", "tpm-memory:");
+  ptr_lib::shared_ptr<PibIdentity> identity = keyChain.createIdentityV2
+    (Name("/test/identity"), keyParams);
+  ptr_lib::shared_ptr<PibKey> key = identity->getDefaultKey();
+
+  vector<ptr_lib::shared_ptr<Data> > dataList;
+  vector<Blob> publicKeyDerList;
+  for (size_t i = 0; i < nPackets; ++i) {
+    ptr_lib::shared_ptr<Data> data(new Data(Name("/test/data").appendSequenceNumber(i)));
+    data->setContent(Blob((const uint8_t*)"SUCCESS!", 8));
+    keyChain.sign(*data, SigningInfo(key));
+    dataList.push_back(data);
+    publicKeyDerList.push_back(key->getPublicKey());
+  }
+
+  string keyLabel = (keyParams.getKeyType() == KEY_TYPE_EC ? "EC " : "RSA");
+
+  size_t nVerified = 0;
+  double start = getNowSeconds();
+  for (size_t i = 0; i < nPackets; ++i) {
+    if (VerificationHelpers::verifyDataSignature(*dataList[i], publicKeyDerList[i]))
+      ++nVerified;
+  }
+  printResult(keyLabel + " one at a time  ", nPackets, nVerified,
+              getNowSeconds() - start);
+
+  vector<bool> results;
+  start = getNowSeconds();
+  VerificationHelpers::verifyDataSignatures(dataList, publicKeyDerList, results);
+  double duration = getNowSeconds() - start;
+  nVerified = 0;
+  for (size_t i = 0; i < results.size(); ++i) {
+    if (results[i])
+      ++nVerified;
+  }
+  printResult(keyLabel + " batch          ", nPackets, nVerified, duration);
+
+  for (size_t nThreads = 1; nThreads <= 4; nThreads *= 2) {
+    duration = benchmarkBatchVerifierSeconds
+      (dataList, publicKeyDerList, nThreads, nVerified);
+    ostringstream label;
+    label << keyLabel << " BatchVerifier " << nThreads;
+    printResult(label.str(), nPackets, nVerified, duration);
+  }
+}
+
+int
+main(int argc, char** argv)
+{
+  try {
+    benchmarkVerify(EcKeyParams(), 2000);
+    benchmarkVerify(RsaKeyParams(), 2000);
+  } catch (std::exception& e) {
+    cout << "exception: " << e.what() << endl;
+  }
+  return 0;
+}
+
+#else // NDN_CPP_HAVE_BOOST_ASIO
+
+#include <iostream>
+
+using namespace std;
+
+int main(int argc, char** argv)
+{
+  cout <<
+    "This program uses Boost asio but it is not installed. Install Boost and ./configure again." << endl;
+}
+
+#endif // NDN_CPP_HAVE_BOOST_ASIO
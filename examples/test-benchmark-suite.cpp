@@ -0,0 +1,1112 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2018 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+/* This runs benchmarks of the hot paths of the library, including Name,
+ * Interest and Data encoding, the pending interest table, interest filter
+ * dispatch, signing and verifying, and Face round trips over a
+ * LoopbackForwarder. Each benchmark is timed in several samples and the median
+ * time per operation is reported with the median absolute deviation. The
+ * results can be saved as JSON and compared to the JSON from a previous run to
+ * detect a regression. For usage, run with --help. To build and run with
+ * make, use for example:
+ *   make benchmark BENCHMARK_ARGS="--json new.json --baseline old.json"
+ */
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <map>
+#include <sys/time.h>
+#include <ndn-cpp/digest-sha256-signature.hpp>
+#include <ndn-cpp/interest-filter.hpp>
+#include <ndn-cpp/security/key-chain.hpp>
+#include <ndn-cpp/security/verification-helpers.hpp>
+#include <ndn-cpp/security/v2/validator.hpp>
+#include <ndn-cpp/security/v2/validation-policy-accept-all.hpp>
+#include <ndn-cpp/security/v2/validation-policy-command-interest.hpp>
+#include <ndn-cpp/sha256-with-ecdsa-signature.hpp>
+#include <ndn-cpp/encoding/tlv-wire-format.hpp>
+#include <ndn-cpp/util/memory-content-cache.hpp>
+#include <ndn-cpp/util/segment-fetcher.hpp>
+#include <ndn-cpp/util/loopback-forwarder.hpp>
+// The benchmarks of internal tables use the library's private headers.
+#include "../src/impl/pending-interest-table.hpp"
+#include "../src/impl/interest-filter-table.hpp"
+#include "../src/sync/digest-tree.hpp"
+
+using namespace std;
+using namespace ndn;
+using namespace ndn::func_lib;
+
+static double
+getNowSeconds()
+{
+  struct timeval t;
+  gettimeofday(&t, 0);
+  return t.tv_sec + t.tv_usec / 1000000.0;
+}
+
+/**
+ * A Benchmark does nOperations of something in each call to run(). The
+ * constructor or setUp() should do the work which is not timed.
+ */
+class Benchmark {
+public:
+  Benchmark(const string& name, size_t nOperations)
+  : name_(name), nOperations_(nOperations)
+  {
+  }
+
+  virtual void
+  setUp() {}
+
+  virtual void
+  run() = 0;
+
+  virtual
+  ~Benchmark() {}
+
+  const string&
+  getName() const { return name_; }
+
+  size_t
+  getNOperations() const { return nOperations_; }
+
+private:
+  string name_;
+  size_t nOperations_;
+};
+
+/**
+ * A Result has the statistics of the time per operation over all samples.
+ */
+class Result {
+public:
+  string name_;
+  double medianNs_;
+  double minNs_;
+  double madPercent_;
+  size_t nSamples_;
+};
+
+static double
+median(vector<double> values)
+{
+  sort(values.begin(), values.end());
+  size_t n = values.size();
+  if (n % 2 == 1)
+    return values[n / 2];
+  else
+    return (values[n / 2 - 1] + values[n / 2]) / 2.0;
+}
+
+/**
+ * Run the benchmark once to warm up, find the number of runs per sample so
+ * that a sample takes at least minSampleSeconds, then time nSamples samples.
+ */
+static Result
+measure(Benchmark& benchmark, size_t nSamples, double minSampleSeconds)
+{
+  benchmark.setUp();
+
+  double start = getNowSeconds();
+  benchmark.run();
+  double warmUpSeconds = getNowSeconds() - start;
+  size_t nRunsPerSample = 1;
+  if (warmUpSeconds < minSampleSeconds)
+    nRunsPerSample = (size_t)(minSampleSeconds / max(warmUpSeconds, 1e-7)) + 1;
+
+  vector<double> nsPerOperation;
+  for (size_t i = 0; i < nSamples; ++i) {
+    start = getNowSeconds();
+    for (size_t j = 0; j < nRunsPerSample; ++j)
+      benchmark.run();
+    double seconds = getNowSeconds() - start;
+    nsPerOperation.push_back
+      (seconds * 1e9 / (nRunsPerSample * benchmark.getNOperations()));
+  }
+
+  Result result;
+  result.name_ = benchmark.getName();
+  result.nSamples_ = nSamples;
+  result.medianNs_ = median(nsPerOperation);
+  result.minNs_ = *min_element(nsPerOperation.begin(), nsPerOperation.end());
+  vector<double> deviations;
+  for (size_t i = 0; i < nsPerOperation.size(); ++i)
+    deviations.push_back(fabs(nsPerOperation[i] - result.medianNs_));
+  result.madPercent_ = result.medianNs_ > 0 ?
+    100.0 * median(deviations) / result.medianNs_ : 0;
+
+  return result;
+}
+
+static void
+doNothingOnData
+  (const ptr_lib::shared_ptr<const Interest>& interest,
+   const ptr_lib::shared_ptr<Data>& data)
+{
+}
+
+static void
+doNothingOnTimeout(const ptr_lib::shared_ptr<const Interest>& interest)
+{
+}
+
+static void
+doNothingOnInterest
+  (const ptr_lib::shared_ptr<const Name>& prefix,
+   const ptr_lib::shared_ptr<const Interest>& interest, Face& face,
+   uint64_t interestFilterId,
+   const ptr_lib::shared_ptr<const InterestFilter>& filter)
+{
+}
+
+static void
+onRegisterFailed(const ptr_lib::shared_ptr<const Name>& prefix)
+{
+  throw runtime_error("Register failed for prefix " + prefix->toUri());
+}
+
+static void
+increment(size_t* count) { ++(*count); }
+
+static void
+incrementOnData
+  (size_t* count, const ptr_lib::shared_ptr<const Interest>& interest,
+   const ptr_lib::shared_ptr<Data>& data)
+{
+  ++(*count);
+}
+
+/**
+ * Make names typical of a producer's namespace.
+ */
+static void
+makeNames(size_t nNames, vector<Name>& names)
+{
+  names.clear();
+  for (size_t i = 0; i < nNames; ++i) {
+    ostringstream uri;
+    uri << "/ndn/edu/ucla/remap/benchmark/" << i;
+    names.push_back(Name(uri.str()).appendVersion(1).appendSegment(i % 10));
+  }
+}
+
+static Data
+makeData(const Name& name, size_t contentSize)
+{
+  Data data(name);
+  data.setContent(Blob(vector<uint8_t>(contentSize, 'x')));
+  data.getMetaInfo().setFreshnessPeriod(10000);
+  // Don't sign, since the signature value doesn't change the encoding speed.
+  data.setSignature(DigestSha256Signature());
+  return data;
+}
+
+class NameFromUri : public Benchmark {
+public:
+  NameFromUri()
+  : Benchmark("name/from-uri", 1000)
+  {
+  }
+
+  virtual void
+  run()
+  {
+    for (size_t i = 0; i < getNOperations(); ++i)
+      Name name("/ndn/edu/ucla/remap/benchmark/123/%FD%01/%00%07");
+  }
+};
+
+class NameCompare : public Benchmark {
+public:
+  NameCompare()
+  : Benchmark("name/compare", 1000)
+  {
+    makeNames(getNOperations() + 1, names_);
+  }
+
+  virtual void
+  run()
+  {
+    int total = 0;
+    for (size_t i = 0; i < getNOperations(); ++i)
+      total += names_[i].compare(names_[i + 1]);
+    sink_ = total;
+  }
+
+  vector<Name> names_;
+  int sink_;
+};
+
+class InterestEncode : public Benchmark {
+public:
+  InterestEncode()
+  : Benchmark("interest/encode", 1000),
+    interest_(Name("/ndn/edu/ucla/remap/benchmark/123/%FD%01/%00%07"))
+  {
+    interest_.setInterestLifetimeMilliseconds(4000);
+  }
+
+  virtual void
+  run()
+  {
+    for (size_t i = 0; i < getNOperations(); ++i) {
+      // Change a field so that wireEncode doesn't return the cached encoding.
+      interest_.setMustBeFresh(i % 2 == 0);
+      interest_.wireEncode();
+    }
+  }
+
+  Interest interest_;
+};
+
+class InterestDecode : public Benchmark {
+public:
+  InterestDecode(bool isLazy)
+  : Benchmark(isLazy ? "interest/decode-lazy" : "interest/decode", 1000),
+    isLazy_(isLazy)
+  {
+    Interest interest(Name("/ndn/edu/ucla/remap/benchmark/123/%FD%01/%00%07"));
+    interest.setInterestLifetimeMilliseconds(4000);
+    encoding_ = interest.wireEncode();
+  }
+
+  virtual void
+  run()
+  {
+    for (size_t i = 0; i < getNOperations(); ++i) {
+      if (isLazy_)
+        interest_.wireDecodeLazy(encoding_);
+      else
+        interest_.wireDecode(encoding_);
+    }
+  }
+
+  bool isLazy_;
+  Blob encoding_;
+  Interest interest_;
+};
+
+class DataEncode : public Benchmark {
+public:
+  DataEncode()
+  : Benchmark("data/encode", 1000),
+    data_(makeData(Name("/ndn/edu/ucla/remap/benchmark/123/%FD%01/%00%07"),
+                   1000))
+  {
+  }
+
+  virtual void
+  run()
+  {
+    for (size_t i = 0; i < getNOperations(); ++i) {
+      // Change a field so that wireEncode doesn't return the cached encoding.
+      data_.getMetaInfo().setFreshnessPeriod(10000 + i % 2);
+      data_.wireEncode();
+    }
+  }
+
+  Data data_;
+};
+
+class DataDecode : public Benchmark {
+public:
+  DataDecode(bool isLazy)
+  : Benchmark(isLazy ? "data/decode-lazy" : "data/decode", 1000),
+    isLazy_(isLazy)
+  {
+    encoding_ = makeData
+      (Name("/ndn/edu/ucla/remap/benchmark/123/%FD%01/%00%07"), 1000)
+      .wireEncode();
+  }
+
+  virtual void
+  run()
+  {
+    for (size_t i = 0; i < getNOperations(); ++i) {
+      if (isLazy_)
+        data_.wireDecodeLazy(encoding_);
+      else
+        data_.wireDecode(encoding_);
+    }
+  }
+
+  bool isLazy_;
+  Blob encoding_;
+  Data data_;
+};
+
+/**
+ * PitBenchmark is the base for the pending interest table benchmarks with a
+ * table of nEntries.
+ */
+class PitBenchmark : public Benchmark {
+public:
+  PitBenchmark(const string& operation, size_t nEntries, size_t nOperations)
+  : Benchmark(makeName(operation, nEntries), nOperations), nEntries_(nEntries)
+  {
+    vector<Name> names;
+    makeNames(nEntries, names);
+    for (size_t i = 0; i < nEntries; ++i) {
+      interests_.push_back(ptr_lib::make_shared<Interest>(names[i]));
+      data_.push_back(makeData(names[i], 10));
+    }
+  }
+
+  /**
+   * Fill the table with an entry for each Interest.
+   */
+  void
+  fill(PendingInterestTable& table)
+  {
+    entries_.clear();
+    for (size_t i = 0; i < nEntries_; ++i)
+      entries_.push_back(add(table, i));
+  }
+
+  ptr_lib::shared_ptr<PendingInterestTable::Entry>
+  add(PendingInterestTable& table, size_t i)
+  {
+    return table.add
+      (i + 1, interests_[i], &doNothingOnData, &doNothingOnTimeout,
+       OnNetworkNack());
+  }
+
+  static string
+  makeName(const string& operation, size_t nEntries)
+  {
+    ostringstream name;
+    name << "pit/" << operation << "/" << nEntries;
+    return name.str();
+  }
+
+  size_t nEntries_;
+  vector<ptr_lib::shared_ptr<Interest> > interests_;
+  vector<Data> data_;
+  vector<ptr_lib::shared_ptr<PendingInterestTable::Entry> > entries_;
+};
+
+class PitInsert : public PitBenchmark {
+public:
+  PitInsert(size_t nEntries)
+  : PitBenchmark("insert", nEntries, nEntries)
+  {
+  }
+
+  virtual void
+  run()
+  {
+    PendingInterestTable table;
+    fill(table);
+  }
+};
+
+class PitMatch : public PitBenchmark {
+public:
+  PitMatch(size_t nEntries)
+  : PitBenchmark("match", nEntries, 100)
+  {
+  }
+
+  virtual void
+  setUp() { fill(table_); }
+
+  virtual void
+  run()
+  {
+    vector<ptr_lib::shared_ptr<PendingInterestTable::Entry> > matched;
+    for (size_t i = 0; i < getNOperations(); ++i) {
+      // Spread the matched entries over the table.
+      size_t index = (i * 7919) % nEntries_;
+      matched.clear();
+      table_.extractEntriesForExpressedInterest(data_[index], matched);
+      // Put the entry back for the next run.
+      add(table_, index);
+    }
+  }
+
+  PendingInterestTable table_;
+};
+
+class PitTimeout : public PitBenchmark {
+public:
+  PitTimeout(size_t nEntries)
+  : PitBenchmark("timeout", nEntries, 100)
+  {
+  }
+
+  virtual void
+  setUp() { fill(table_); }
+
+  virtual void
+  run()
+  {
+    for (size_t i = 0; i < getNOperations(); ++i) {
+      size_t index = (i * 7919) % nEntries_;
+      // This is what Node does when the Interest times out.
+      if (table_.removeEntry(entries_[index]))
+        entries_[index]->callTimeout();
+      entries_[index] = add(table_, index);
+    }
+  }
+
+  PendingInterestTable table_;
+};
+
+class FilterDispatch : public Benchmark {
+public:
+  FilterDispatch(size_t nFilters)
+  : Benchmark(makeName(nFilters), 1000), face_(0)
+  {
+    vector<Name> names;
+    makeNames(nFilters, names);
+    for (size_t i = 0; i < nFilters; ++i) {
+      // Use the name without the segment as the filter prefix.
+      table_.setInterestFilter
+        (i + 1, ptr_lib::make_shared<InterestFilter>(names[i].getPrefix(-1)),
+         &doNothingOnInterest, face_);
+      interests_.push_back(Interest(names[i]));
+    }
+  }
+
+  virtual void
+  run()
+  {
+    vector<ptr_lib::shared_ptr<InterestFilterTable::Entry> > matched;
+    for (size_t i = 0; i < getNOperations(); ++i) {
+      matched.clear();
+      table_.getMatchedFilters(interests_[i % interests_.size()], matched);
+    }
+  }
+
+  static string
+  makeName(size_t nFilters)
+  {
+    ostringstream name;
+    name << "filter/dispatch/" << nFilters;
+    return name.str();
+  }
+
+  InterestFilterTable table_;
+  vector<Interest> interests_;
+  Face* face_;
+};
+
+class Sign : public Benchmark {
+public:
+  Sign
+    (const string& keyType, KeyChain& keyChain,
+     const SigningInfo& signingInfo)
+  : Benchmark("sign/" + keyType, 10), keyChain_(keyChain),
+    signingInfo_(signingInfo),
+    data_(makeData(Name("/ndn/edu/ucla/remap/benchmark/sign"), 1000))
+  {
+  }
+
+  virtual void
+  run()
+  {
+    for (size_t i = 0; i < getNOperations(); ++i)
+      keyChain_.sign(data_, signingInfo_);
+  }
+
+  KeyChain& keyChain_;
+  SigningInfo signingInfo_;
+  Data data_;
+};
+
+class Verify : public Benchmark {
+public:
+  Verify(const string& keyType, KeyChain& keyChain,
+         const ptr_lib::shared_ptr<PibIdentity>& identity)
+  : Benchmark("verify/" + keyType, 10),
+    certificate_(identity->getDefaultKey()->getDefaultCertificate()),
+    data_(makeData(Name("/ndn/edu/ucla/remap/benchmark/verify"), 1000))
+  {
+    keyChain.sign(data_, SigningInfo(identity));
+  }
+
+  virtual void
+  run()
+  {
+    for (size_t i = 0; i < getNOperations(); ++i) {
+      if (!VerificationHelpers::verifyDataSignature(data_, *certificate_))
+        throw runtime_error("Verify benchmark: Verification failed");
+    }
+  }
+
+  ptr_lib::shared_ptr<CertificateV2> certificate_;
+  Data data_;
+};
+
+class DigestTreeUpdate : public Benchmark {
+public:
+  DigestTreeUpdate(size_t nMembers)
+  : Benchmark(makeName(nMembers), 100), sequenceNo_(0)
+  {
+    for (size_t i = 0; i < nMembers; ++i) {
+      ostringstream prefix;
+      prefix << "/ndn/edu/ucla/remap/benchmark/member" << i;
+      prefixes_.push_back(prefix.str());
+      tree_.update(prefixes_[i], 1, 0);
+    }
+  }
+
+  virtual void
+  run()
+  {
+    for (size_t i = 0; i < getNOperations(); ++i) {
+      ++sequenceNo_;
+      tree_.update(prefixes_[i % prefixes_.size()], 1, sequenceNo_);
+    }
+  }
+
+  static string
+  makeName(size_t nMembers)
+  {
+    ostringstream name;
+    name << "sync/digest-tree-update/" << nMembers;
+    return name.str();
+  }
+
+  DigestTree tree_;
+  vector<string> prefixes_;
+  int sequenceNo_;
+};
+
+static void
+onCommandInterestValidated(const Interest& interest) {}
+
+static void
+onCommandInterestValidationFailed
+  (const Interest& interest, const ValidationError& error)
+{
+  cout << "CommandInterestValidate: " << error << endl;
+}
+
+/**
+ * CommandInterestValidate validates command Interests signed by nKeys
+ * different keys with a ValidationPolicyCommandInterest, which looks up and
+ * refreshes the last timestamp record of each key. The inner policy accepts
+ * all, so this times the timestamp check and not the signature verification.
+ */
+class CommandInterestValidate : public Benchmark {
+public:
+  CommandInterestValidate(size_t nKeys)
+  : Benchmark(makeName(nKeys), 1000),
+    validator_(ptr_lib::make_shared<ValidationPolicyCommandInterest>
+      (ptr_lib::make_shared<ValidationPolicyAcceptAll>(),
+       ValidationPolicyCommandInterest::Options(2 * 60 * 1000.0, nKeys))),
+    // Start at the clock so that the first timestamp is in the grace period.
+    timestamp_((uint64_t)(getNowSeconds() * 1000.0))
+  {
+    for (size_t i = 0; i < nKeys; ++i) {
+      ostringstream keyName;
+      keyName << "/benchmark/key" << i;
+      Sha256WithEcdsaSignature signature;
+      signature.getKeyLocator().setType(ndn_KeyLocatorType_KEYNAME);
+      signature.getKeyLocator().setKeyName(Name(keyName.str()));
+      signatureInfos_.push_back
+        (TlvWireFormat::get()->encodeSignatureInfo(signature));
+    }
+
+    // The inner policy doesn't verify, so use a dummy signature value.
+    Sha256WithEcdsaSignature signature;
+    uint8_t signatureBits[32] = { 0 };
+    signature.setSignature(Blob(signatureBits, sizeof(signatureBits)));
+    signatureValue_ = TlvWireFormat::get()->encodeSignatureValue(signature);
+  }
+
+  virtual void
+  setUp()
+  {
+    // Make sure that every key has a last timestamp record.
+    for (size_t i = 0; i < signatureInfos_.size(); ++i)
+      validate(i);
+  }
+
+  virtual void
+  run()
+  {
+    for (size_t i = 0; i < getNOperations(); ++i)
+      validate((i * 7919) % signatureInfos_.size());
+  }
+
+  static string
+  makeName(size_t nKeys)
+  {
+    ostringstream name;
+    name << "security/command-interest-validate/" << nKeys;
+    return name.str();
+  }
+
+private:
+  void
+  validate(size_t iKey)
+  {
+    ++timestamp_;
+    Interest interest(Name("/localhost/benchmark/command"));
+    interest.getName().append(Name::Component::fromNumber(timestamp_))
+      .append(Name::Component(Blob(nonce_, sizeof(nonce_))))
+      .append(Name::Component(signatureInfos_[iKey]))
+      .append(Name::Component(signatureValue_));
+    validator_.validate
+      (interest, &onCommandInterestValidated,
+       &onCommandInterestValidationFailed);
+  }
+
+  Validator validator_;
+  vector<Blob> signatureInfos_;
+  Blob signatureValue_;
+  uint64_t timestamp_;
+  static const uint8_t nonce_[8];
+};
+
+const uint8_t CommandInterestValidate::nonce_[8] = { 0 };
+
+/**
+ * LoopbackBenchmark is the base for benchmarks which send Interests from a
+ * consumer Face to a producer Face through a LoopbackForwarder. The forwarder
+ * content store is disabled so that the producer answers each Interest.
+ */
+class LoopbackBenchmark : public Benchmark {
+public:
+  LoopbackBenchmark
+    (const string& name, size_t nOperations, KeyChain& keyChain)
+  : Benchmark(name, nOperations), forwarder_(0),
+    consumer_(forwarder_.makeFace()), producer_(forwarder_.makeFace())
+  {
+    producer_->setCommandSigningInfo
+      (keyChain, keyChain.getDefaultCertificateName());
+  }
+
+  void
+  processEvents()
+  {
+    consumer_->processEvents();
+    forwarder_.processEvents();
+    producer_->processEvents();
+    forwarder_.processEvents();
+  }
+
+  /**
+   * Call processEvents until count reaches target.
+   */
+  void
+  processEventsUntil(const size_t& count, size_t target)
+  {
+    double timeout = getNowSeconds() + 10;
+    while (count < target) {
+      if (getNowSeconds() > timeout)
+        throw runtime_error(getName() + ": Timed out waiting for the faces");
+      processEvents();
+    }
+  }
+
+  LoopbackForwarder forwarder_;
+  ptr_lib::shared_ptr<Face> consumer_;
+  ptr_lib::shared_ptr<Face> producer_;
+};
+
+class FaceRoundTrip : public LoopbackBenchmark {
+public:
+  FaceRoundTrip(KeyChain& keyChain)
+  : LoopbackBenchmark("face/round-trip", 1000, keyChain), nReceived_(0),
+    nRegistered_(0)
+  {
+    makeNames(getNOperations(), names_);
+  }
+
+  virtual void
+  setUp()
+  {
+    producer_->registerPrefix
+      (Name("/ndn/edu/ucla/remap/benchmark"),
+       bind(&FaceRoundTrip::onInterest, this, _1, _2, _3, _4, _5),
+       &onRegisterFailed,
+       OnRegisterSuccess(bind(&increment, &nRegistered_)));
+    processEventsUntil(nRegistered_, 1);
+  }
+
+  void
+  onInterest
+    (const ptr_lib::shared_ptr<const Name>& prefix,
+     const ptr_lib::shared_ptr<const Interest>& interest, Face& face,
+     uint64_t interestFilterId,
+     const ptr_lib::shared_ptr<const InterestFilter>& filter)
+  {
+    face.putData(makeData(interest->getName(), 100));
+  }
+
+  virtual void
+  run()
+  {
+    // Keep a window of Interests in flight.
+    const size_t windowSize = 50;
+    nReceived_ = 0;
+    size_t nSent = 0;
+    while (nSent < getNOperations()) {
+      for (size_t i = 0; i < windowSize && nSent < getNOperations(); ++i) {
+        consumer_->expressInterest
+          (names_[nSent], bind(&incrementOnData, &nReceived_, _1, _2),
+           &doNothingOnTimeout);
+        ++nSent;
+      }
+      processEventsUntil(nReceived_, nSent);
+    }
+  }
+
+  vector<Name> names_;
+  size_t nReceived_;
+  size_t nRegistered_;
+};
+
+class MemoryContentCacheLookup : public LoopbackBenchmark {
+public:
+  MemoryContentCacheLookup(bool isHit, KeyChain& keyChain)
+  : LoopbackBenchmark
+      (isHit ? "memory-content-cache/hit" : "memory-content-cache/miss", 1000,
+       keyChain),
+    isHit_(isHit), contentCache_(producer_.get()), nReceived_(0),
+    nRegistered_(0)
+  {
+    makeNames(getNOperations(), names_);
+    if (!isHit_) {
+      // Make names which are not in the cache.
+      for (size_t i = 0; i < names_.size(); ++i)
+        names_[i].append("miss");
+    }
+  }
+
+  /**
+   * Add the content here instead of in the constructor since the cache removes
+   * stale content.
+   */
+  virtual void
+  setUp()
+  {
+    if (isHit_) {
+      for (size_t i = 0; i < names_.size(); ++i)
+        contentCache_.add(makeData(names_[i], 100));
+    }
+
+    // For a miss, the cache calls onDataNotFound which answers the Interest.
+    contentCache_.registerPrefix
+      (Name("/ndn/edu/ucla/remap/benchmark"), &onRegisterFailed,
+       OnRegisterSuccess(bind(&increment, &nRegistered_)),
+       isHit_ ? OnInterestCallback() :
+         OnInterestCallback(bind(&MemoryContentCacheLookup::onDataNotFound,
+                                 this, _1, _2, _3, _4, _5)));
+    processEventsUntil(nRegistered_, 1);
+  }
+
+  void
+  onDataNotFound
+    (const ptr_lib::shared_ptr<const Name>& prefix,
+     const ptr_lib::shared_ptr<const Interest>& interest, Face& face,
+     uint64_t interestFilterId,
+     const ptr_lib::shared_ptr<const InterestFilter>& filter)
+  {
+    face.putData(makeData(interest->getName(), 100));
+  }
+
+  virtual void
+  run()
+  {
+    const size_t windowSize = 50;
+    nReceived_ = 0;
+    size_t nSent = 0;
+    while (nSent < getNOperations()) {
+      for (size_t i = 0; i < windowSize && nSent < getNOperations(); ++i) {
+        consumer_->expressInterest
+          (names_[nSent], bind(&incrementOnData, &nReceived_, _1, _2),
+           &doNothingOnTimeout);
+        ++nSent;
+      }
+      processEventsUntil(nReceived_, nSent);
+    }
+  }
+
+  bool isHit_;
+  MemoryContentCache contentCache_;
+  vector<Name> names_;
+  size_t nReceived_;
+  size_t nRegistered_;
+};
+
+class SegmentFetcherThroughput : public LoopbackBenchmark {
+public:
+  SegmentFetcherThroughput(KeyChain& keyChain)
+  : LoopbackBenchmark("segment-fetcher/segment", 100, keyChain),
+    contentCache_(producer_.get()), prefix_("/ndn/edu/ucla/remap/benchmark"),
+    nCompleted_(0), nRegistered_(0)
+  {
+  }
+
+  /**
+   * Add the content here instead of in the constructor since the cache removes
+   * stale content.
+   */
+  virtual void
+  setUp()
+  {
+    for (size_t i = 0; i < getNOperations(); ++i) {
+      Data data = makeData
+        (Name(prefix_).appendVersion(1).appendSegment(i), 1000);
+      data.getMetaInfo().setFinalBlockId
+        (Name::Component::fromSegment(getNOperations() - 1));
+      contentCache_.add(data);
+    }
+
+    contentCache_.registerPrefix
+      (prefix_, &onRegisterFailed,
+       OnRegisterSuccess(bind(&increment, &nRegistered_)));
+    processEventsUntil(nRegistered_, 1);
+  }
+
+  void
+  onComplete(const Blob& content) { ++nCompleted_; }
+
+  static void
+  onError(SegmentFetcher::ErrorCode errorCode, const string& message)
+  {
+    throw runtime_error("SegmentFetcher error: " + message);
+  }
+
+  virtual void
+  run()
+  {
+    nCompleted_ = 0;
+    SegmentFetcher::fetch
+      (*consumer_, Interest(prefix_), SegmentFetcher::DontVerifySegment,
+       bind(&SegmentFetcherThroughput::onComplete, this, _1),
+       &SegmentFetcherThroughput::onError);
+    processEventsUntil(nCompleted_, 1);
+  }
+
+  MemoryContentCache contentCache_;
+  Name prefix_;
+  size_t nCompleted_;
+  size_t nRegistered_;
+};
+
+/**
+ * Read the results from a JSON file written by writeJson. This only reads the
+ * format of writeJson with one benchmark per line, not general JSON.
+ */
+static void
+readJson(const string& filePath, map<string, double>& medianNs)
+{
+  ifstream file(filePath.c_str());
+  if (!file.good())
+    throw runtime_error("Cannot open the baseline file " + filePath);
+
+  string line;
+  const string nameKey = "\"name\": \"";
+  const string medianKey = "\"medianNs\": ";
+  while (getline(file, line)) {
+    size_t nameStart = line.find(nameKey);
+    size_t medianStart = line.find(medianKey);
+    if (nameStart == string::npos || medianStart == string::npos)
+      continue;
+
+    nameStart += nameKey.size();
+    string name = line.substr(nameStart, line.find('"', nameStart) - nameStart);
+    medianNs[name] = atof(line.c_str() + medianStart + medianKey.size());
+  }
+}
+
+static void
+writeJson(const string& filePath, const vector<Result>& results)
+{
+  ofstream file(filePath.c_str());
+  file << fixed << setprecision(2);
+  file << "{\"benchmarks\": [" << endl;
+  for (size_t i = 0; i < results.size(); ++i) {
+    const Result& result = results[i];
+    file << "  {\"name\": \"" << result.name_ << "\", \"medianNs\": " <<
+      result.medianNs_ << ", \"minNs\": " << result.minNs_ <<
+      ", \"madPercent\": " << result.madPercent_ << ", \"samples\": " <<
+      result.nSamples_ << "}" << (i + 1 < results.size() ? "," : "") << endl;
+  }
+  file << "]}" << endl;
+}
+
+static void
+usage()
+{
+  cout << "Usage: test-benchmark-suite [options]" << endl <<
+    "  --filter TEXT       Only run the benchmarks whose name contains TEXT." << endl <<
+    "  --samples N         The number of timed samples. Default 7." << endl <<
+    "  --min-sample-ms MS  The minimum time of each sample. Default 20." << endl <<
+    "  --json FILE         Write the results to FILE as JSON." << endl <<
+    "  --baseline FILE     Compare to the JSON results of a previous run and" << endl <<
+    "                      exit with status 1 if any benchmark regressed." << endl <<
+    "  --threshold F       A regression is a median time more than the baseline" << endl <<
+    "                      times (1 + F), and more than the noise. Default 0.10." << endl;
+}
+
+int
+main(int argc, char** argv)
+{
+  string filter;
+  size_t nSamples = 7;
+  double minSampleSeconds = 0.020;
+  string jsonFilePath;
+  string baselineFilePath;
+  double threshold = 0.10;
+  for (int i = 1; i < argc; ++i) {
+    string option = argv[i];
+    if (option == "--help" || i + 1 >= argc) {
+      usage();
+      return option == "--help" ? 0 : 2;
+    }
+
+    string value = argv[++i];
+    if (option == "--filter")
+      filter = value;
+    else if (option == "--samples")
+      nSamples = max(1, atoi(value.c_str()));
+    else if (option == "--min-sample-ms")
+      minSampleSeconds = atof(value.c_str()) / 1000.0;
+    else if (option == "--json")
+      jsonFilePath = value;
+    else if (option == "--baseline")
+      baselineFilePath = value;
+    else if (option == "--threshold")
+      threshold = atof(value.c_str());
+    else {
+      usage();
+      return 2;
+    }
+  }
+
+  try {
+    map<string, double> baseline;
+    if (baselineFilePath != "")
+      readJson(baselineFilePath, baseline);
+
+    KeyChain keyChain("pib-memory:", "tpm-memory:");
+    ptr_lib::shared_ptr<PibIdentity> rsaIdentity = keyChain.createIdentityV2
+      (Name("/benchmark/rsa"), RsaKeyParams());
+    ptr_lib::shared_ptr<PibIdentity> ecIdentity = keyChain.createIdentityV2
+      (Name("/benchmark/ec"), EcKeyParams());
+    keyChain.setDefaultIdentity(*ecIdentity);
+    SigningInfo sha256SigningInfo;
+    sha256SigningInfo.setSha256Signing();
+
+    vector<ptr_lib::shared_ptr<Benchmark> > benchmarks;
+    benchmarks.push_back(ptr_lib::shared_ptr<Benchmark>(new NameFromUri()));
+    benchmarks.push_back(ptr_lib::shared_ptr<Benchmark>(new NameCompare()));
+    benchmarks.push_back(ptr_lib::shared_ptr<Benchmark>(new InterestEncode()));
+    benchmarks.push_back(ptr_lib::shared_ptr<Benchmark>
+      (new InterestDecode(false)));
+    benchmarks.push_back(ptr_lib::shared_ptr<Benchmark>
+      (new InterestDecode(true)));
+    benchmarks.push_back(ptr_lib::shared_ptr<Benchmark>(new DataEncode()));
+    benchmarks.push_back(ptr_lib::shared_ptr<Benchmark>(new DataDecode(false)));
+    benchmarks.push_back(ptr_lib::shared_ptr<Benchmark>(new DataDecode(true)));
+    size_t pitSizes[] = { 1000, 10000, 100000 };
+    for (size_t i = 0; i < sizeof(pitSizes) / sizeof(pitSizes[0]); ++i) {
+      benchmarks.push_back(ptr_lib::shared_ptr<Benchmark>
+        (new PitInsert(pitSizes[i])));
+      benchmarks.push_back(ptr_lib::shared_ptr<Benchmark>
+        (new PitMatch(pitSizes[i])));
+      benchmarks.push_back(ptr_lib::shared_ptr<Benchmark>
+        (new PitTimeout(pitSizes[i])));
+    }
+    benchmarks.push_back(ptr_lib::shared_ptr<Benchmark>
+      (new FilterDispatch(10)));
+    benchmarks.push_back(ptr_lib::shared_ptr<Benchmark>
+      (new FilterDispatch(1000)));
+    benchmarks.push_back(ptr_lib::shared_ptr<Benchmark>
+      (new Sign("sha256", keyChain, sha256SigningInfo)));
+    benchmarks.push_back(ptr_lib::shared_ptr<Benchmark>
+      (new Sign("rsa", keyChain, SigningInfo(rsaIdentity))));
+    benchmarks.push_back(ptr_lib::shared_ptr<Benchmark>
+      (new Sign("ecdsa", keyChain, SigningInfo(ecIdentity))));
+    benchmarks.push_back(ptr_lib::shared_ptr<Benchmark>
+      (new Verify("rsa", keyChain, rsaIdentity)));
+    benchmarks.push_back(ptr_lib::shared_ptr<Benchmark>
+      (new Verify("ecdsa", keyChain, ecIdentity)));
+    benchmarks.push_back(ptr_lib::shared_ptr<Benchmark>
+      (new DigestTreeUpdate(10)));
+    benchmarks.push_back(ptr_lib::shared_ptr<Benchmark>
+      (new DigestTreeUpdate(100)));
+    benchmarks.push_back(ptr_lib::shared_ptr<Benchmark>
+      (new CommandInterestValidate(1000)));
+    benchmarks.push_back(ptr_lib::shared_ptr<Benchmark>
+      (new CommandInterestValidate(50000)));
+    benchmarks.push_back(ptr_lib::shared_ptr<Benchmark>
+      (new FaceRoundTrip(keyChain)));
+    benchmarks.push_back(ptr_lib::shared_ptr<Benchmark>
+      (new MemoryContentCacheLookup(true, keyChain)));
+    benchmarks.push_back(ptr_lib::shared_ptr<Benchmark>
+      (new MemoryContentCacheLookup(false, keyChain)));
+    benchmarks.push_back(ptr_lib::shared_ptr<Benchmark>
+      (new SegmentFetcherThroughput(keyChain)));
+
+    vector<Result> results;
+    bool isRegression = false;
+    cout << left << setw(34) << "Benchmark" << right << setw(14) << "ns/op" <<
+      setw(10) << "+/- %" << setw(14) << "ops/sec" << setw(12) << "baseline" <<
+      endl;
+    for (size_t i = 0; i < benchmarks.size(); ++i) {
+      Benchmark& benchmark = *benchmarks[i];
+      if (benchmark.getName().find(filter) == string::npos)
+        continue;
+
+      Result result = measure(benchmark, nSamples, minSampleSeconds);
+      results.push_back(result);
+      cout << left << setw(34) << result.name_ << right << fixed <<
+        setprecision(1) << setw(14) << result.medianNs_ << setw(10) <<
+        result.madPercent_ << setprecision(0) << setw(14) <<
+        (result.medianNs_ > 0 ? 1e9 / result.medianNs_ : 0);
+
+      map<string, double>::iterator baselineNs = baseline.find(result.name_);
+      if (baselineNs != baseline.end() && baselineNs->second > 0) {
+        double change = result.medianNs_ / baselineNs->second - 1.0;
+        cout << setw(11) << showpos << setprecision(1) << change * 100 << "%" <<
+          noshowpos;
+        // Ignore a change which is within the noise of this run.
+        if (change > threshold && change * 100 > 3 * result.madPercent_) {
+          cout << "  REGRESSION";
+          isRegression = true;
+        }
+      }
+      cout << endl;
+    }
+
+    if (jsonFilePath != "")
+      writeJson(jsonFilePath, results);
+
+    return isRegression ? 1 : 0;
+  } catch (const std::exception& e) {
+    cout << "exception: " << e.what() << endl;
+    return 2;
+  }
+}
@@ -0,0 +1,125 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2018 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+/* This compares the time to look up Names in a std::map keyed by the Name, a
+ * std::map keyed by Name::toUri() and (if available) a std::unordered_map keyed
+ * by the Name using its cached hash.
+ */
+
+#include <iostream>
+#include <sstream>
+#include <map>
+#include <sys/time.h>
+#include <ndn-cpp/name.hpp>
+#if NDN_CPP_HAVE_STD_UNORDERED_MAP
+#include <unordered_map>
+#endif
+
+using namespace std;
+using namespace ndn;
+
+static double
+getNowSeconds()
+{
+  struct timeval t;
+  gettimeofday(&t, 0);
+  return t.tv_sec + t.tv_usec / 1000000.0;
+}
+
+static void
+printResult(const string& label, size_t nLookups, size_t nFound, double duration)
+{
+  cout << label << ": Found " << nFound << " of " << nLookups
+       << ", Duration sec, Hz: " << duration << ", " << (nLookups / duration)
+       << endl;
+}
+
+/**
+ * Look up each name in the map and return the number found.
+ */
+template<class Map> static size_t
+lookUpNames(const Map& map, const vector<Name>& names, size_t nIterations)
+{
+  size_t nFound = 0;
+  for (size_t iteration = 0; iteration < nIterations; ++iteration) {
+    for (size_t i = 0; i < names.size(); ++i) {
+      if (map.find(names[i]) != map.end())
+        ++nFound;
+    }
+  }
+
+  return nFound;
+}
+
+int
+main(int argc, char** argv)
+{
+  const size_t nNames = 10000;
+  const size_t nIterations = 100;
+
+  // Make names typical of a producer's namespace.
+  vector<Name> names;
+  for (size_t i = 0; i < nNames; ++i) {
+    ostringstream uri;
+    uri << "/ndn/edu/ucla/remap/data/" << i;
+    names.push_back(Name(uri.str()).appendSegment(i % 10));
+  }
+
+  // Make separate copies of the names to look up, so that the lookup compares
+  // values and not a shared components array.
+  vector<Name> queries;
+  for (size_t i = 0; i < nNames; ++i)
+    queries.push_back(Name(names[i].toUri()));
+  size_t nLookups = nNames * nIterations;
+
+  map<Name, size_t> nameMap;
+  for (size_t i = 0; i < nNames; ++i)
+    nameMap[names[i]] = i;
+  double start = getNowSeconds();
+  size_t nFound = lookUpNames(nameMap, queries, nIterations);
+  printResult("map<Name>          ", nLookups, nFound, getNowSeconds() - start);
+
+  map<string, size_t> uriMap;
+  for (size_t i = 0; i < nNames; ++i)
+    uriMap[names[i].toUri()] = i;
+  nFound = 0;
+  start = getNowSeconds();
+  for (size_t iteration = 0; iteration < nIterations; ++iteration) {
+    for (size_t i = 0; i < nNames; ++i) {
+      if (uriMap.find(queries[i].toUri()) != uriMap.end())
+        ++nFound;
+    }
+  }
+  printResult("map<toUri()>       ", nLookups, nFound, getNowSeconds() - start);
+
+#if NDN_CPP_HAVE_STD_UNORDERED_MAP
+  unordered_map<Name, size_t> nameHashMap;
+  for (size_t i = 0; i < nNames; ++i)
+    nameHashMap[names[i]] = i;
+  start = getNowSeconds();
+  nFound = lookUpNames(nameHashMap, queries, nIterations);
+  printResult("unordered_map<Name>", nLookups, nFound, getNowSeconds() - start);
+#else
+  cout << "std::unordered_map is not available. Use a C++11 compiler and ./configure again." << endl;
+#endif
+
+  return 0;
+}
@@ -53,6 +53,7 @@ typedef enum {
   ndn_SignatureType_Sha256WithRsaSignature = 1,
   ndn_SignatureType_Sha256WithEcdsaSignature = 3,
   ndn_SignatureType_HmacWithSha256Signature = 4,
+  ndn_SignatureType_MerkleSignature = 200,
   ndn_SignatureType_Generic = 0x7fff
 } ndn_SignatureType;
 
@@ -69,9 +70,10 @@ struct ndn_Signature {
   struct ndn_Blob signatureInfoEncoding; /**< used with Generic */
   int genericTypeCode;                   /**< used with Generic. -1 for not known. */
   struct ndn_KeyLocator keyLocator; /**< used with Sha256WithRsaSignature,
-                                     * Sha256WithEcdsaSignature, HmacWithSha256Signature */
+                                     * Sha256WithEcdsaSignature, HmacWithSha256Signature,
+                                     * MerkleSignature */
   struct ndn_ValidityPeriod validityPeriod; /**< used with Sha256WithRsaSignature,
-                                     * Sha256WithEcdsaSignature */
+                                     * Sha256WithEcdsaSignature, MerkleSignature */
 };
 
 /**
@@ -87,7 +87,8 @@ typedef enum {
   NDN_ERROR_An_Interest_may_not_have_a_selected_delegation_when_encoding_a_forwarding_hint,
   NDN_ERROR_An_Interest_may_not_have_a_link_object_when_encoding_a_forwarding_hint,
   NDN_ERROR_Unrecognized_critical_TLV_type_code,
-  NDN_ERROR_Name_component_otherTypeCode_must_be_non_negative
+  NDN_ERROR_Name_component_otherTypeCode_must_be_non_negative,
+  NDN_ERROR_SocketTransport_error_in_setsockopt
 } ndn_Error;
 
 /**
@@ -111,6 +111,56 @@ public:
     wireDecode(&input[0], input.size(), wireFormat);
   }
 
+  /**
+   * Check that the entire input can be decoded using a particular wire format,
+   * but only update the name of this Data. Keep a pointer to the input, and
+   * decode the signature, MetaInfo and content when one of them (or a method
+   * which uses them) is first accessed. This is useful when the application
+   * only needs the name, for example to match a pending Interest. Otherwise
+   * this is the same as wireDecode, including setting the defaultWireEncoding,
+   * so that wireEncode and getFullName don't need the other fields. Because
+   * the first access of the other fields changes this object, a const
+   * reference is not safe to read from multiple threads until you call
+   * decodeLazyFields().
+   * @param input The input byte array to be decoded as an immutable Blob.
+   * @param wireFormat A WireFormat object used to decode the input. If omitted, use WireFormat getDefaultWireFormat().
+   * @note A subclass which overrides wireDecode to check the other fields
+   * should not use this.
+   */
+  void
+  wireDecodeLazy
+    (const Blob& input,
+     WireFormat& wireFormat = *WireFormat::getDefaultWireFormat());
+
+  /**
+   * Check that the entire input can be decoded but only update the name, as
+   * in wireDecodeLazy(Blob). This copies the input to keep for decoding the
+   * other fields.
+   * @param input The input byte array to be decoded.
+   * @param inputLength The length of input.
+   * @param wireFormat A WireFormat object used to decode the input. If omitted, use WireFormat getDefaultWireFormat().
+   */
+  void
+  wireDecodeLazy
+    (const uint8_t* input, size_t inputLength,
+     WireFormat& wireFormat = *WireFormat::getDefaultWireFormat())
+  {
+    wireDecodeLazy(Blob(input, inputLength), wireFormat);
+  }
+
+  /**
+   * If wireDecodeLazy has not yet decoded the signature, MetaInfo and content, decode them now.
+   * Otherwise do nothing. Since the first access of a lazily decoded field
+   * changes this object, call this before a const reference to this Data
+   * may be read from multiple threads.
+   */
+  void
+  decodeLazyFields() const
+  {
+    if (lazyWireFormat_)
+      const_cast<Data*>(this)->finishLazyDecode();
+  }
+
   /**
    * Set dataLite to point to the values in this Data object, without copying
    * any memory.
@@ -130,10 +180,18 @@ public:
   set(const DataLite& dataLite);
 
   const Signature*
-  getSignature() const { return signature_.get(); }
+  getSignature() const
+  {
+    decodeLazyFields();
+    return signature_.get();
+  }
 
   Signature*
-  getSignature() { return signature_.get(); }
+  getSignature()
+  {
+    decodeLazyFields();
+    return signature_.get();
+  }
 
   const Name&
   getName() const { return name_.get(); }
@@ -142,12 +200,24 @@ public:
   getName() { return name_.get(); }
 
   const MetaInfo&
-  getMetaInfo() const { return metaInfo_.get(); }
+  getMetaInfo() const
+  {
+    decodeLazyFields();
+    return metaInfo_.get();
+  }
 
-  MetaInfo& getMetaInfo() { return metaInfo_.get(); }
+  MetaInfo& getMetaInfo()
+  {
+    decodeLazyFields();
+    return metaInfo_.get();
+  }
 
   const Blob&
-  getContent() const { return content_; }
+  getContent() const
+  {
+    decodeLazyFields();
+    return content_;
+  }
 
   /**
    * Get the incoming face ID according to the incoming packet header.
@@ -209,6 +279,7 @@ public:
   Data&
   setSignature(const Signature& signature)
   {
+    decodeLazyFields();
     signature_.set(signature.clone());
     ++changeCount_;
     return *this;
@@ -230,6 +301,7 @@ public:
   Data&
   setMetaInfo(const MetaInfo& metaInfo)
   {
+    decodeLazyFields();
     metaInfo_.set(metaInfo);
     ++changeCount_;
     return *this;
@@ -255,6 +327,7 @@ public:
   Data&
   setContent(const Blob& content)
   {
+    decodeLazyFields();
     content_ = content;
     ++changeCount_;
     return *this;
@@ -295,11 +368,34 @@ public:
   }
 
 private:
+  friend class WireFormat;
+  friend class Tlv0_2WireFormat;
+
+  /**
+   * Decode lazyEncoding_ and set the signature, MetaInfo and content, but not
+   * the name which the application may have changed. If the fields have not
+   * otherwise changed since wireDecodeLazy, keep the default wire encoding.
+   */
+  void
+  finishLazyDecode();
+
+  /**
+   * Set the signature, MetaInfo and content by copying from dataLite, but not
+   * the name.
+   * @param dataLite A DataLite object.
+   */
+  void
+  setFieldsExceptName(const DataLite& dataLite);
+
   void
   setDefaultWireEncoding
     (const SignedBlob& defaultWireEncoding,
      WireFormat *defaultWireEncodingFormat)
   {
+    if (defaultWireEncoding.buf() != defaultWireEncoding_.buf() &&
+        defaultFullName_->size() > 0)
+      // The full name was computed from a different encoding.
+      defaultFullName_.reset(new Name());
     defaultWireEncoding_ = defaultWireEncoding;
     defaultWireEncodingFormat_ = defaultWireEncodingFormat;
     // Set getDefaultWireEncodingChangeCount_ so that the next call to
@@ -317,6 +413,8 @@ private:
   uint64_t getDefaultWireEncodingChangeCount_;
   ptr_lib::shared_ptr<LpPacket> lpPacket_;
   uint64_t changeCount_;
+  Blob lazyEncoding_;
+  WireFormat* lazyWireFormat_; /**< 0 if the fields are already decoded */
 };
 
 }
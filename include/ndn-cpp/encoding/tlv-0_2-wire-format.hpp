@@ -122,6 +122,64 @@ public:
   decodeData
     (Data& data, const uint8_t *input, size_t inputLength, size_t *signedPortionBeginOffset, size_t *signedPortionEndOffset);
 
+  /**
+   * Decode input as an interest in NDN-TLV, checking that the entire encoding
+   * can be decoded, but only set the name. This decodes into stack arrays
+   * without making the other C++ objects of the Interest.
+   * @param name The Name object which is set to the interest name.
+   * @param input A pointer to the input buffer to decode.
+   * @param inputLength The number of bytes in input.
+   * @param signedPortionBeginOffset Return the offset in the encoding of the
+   * beginning of the signed portion, as in decodeInterest.
+   * @param signedPortionEndOffset Return the offset in the encoding of the end
+   * of the signed portion, as in decodeInterest.
+   */
+  virtual void
+  decodeInterestName
+    (Name& name, const uint8_t *input, size_t inputLength,
+     size_t *signedPortionBeginOffset, size_t *signedPortionEndOffset);
+
+  /**
+   * Decode input as a data packet in NDN-TLV, checking that the entire encoding
+   * can be decoded, but only set the name. This decodes into stack arrays
+   * without making the other C++ objects of the Data packet.
+   * @param name The Name object which is set to the data packet name.
+   * @param input A pointer to the input buffer to decode.
+   * @param inputLength The number of bytes in input.
+   * @param signedPortionBeginOffset Return the offset in the input buffer of
+   * the beginning of the signed portion, as in decodeData.
+   * @param signedPortionEndOffset Return the offset in the input buffer of the
+   * end of the signed portion, as in decodeData.
+   */
+  virtual void
+  decodeDataName
+    (Name& name, const uint8_t *input, size_t inputLength,
+     size_t *signedPortionBeginOffset, size_t *signedPortionEndOffset);
+
+  /**
+   * Decode input as an interest in NDN-TLV and set the fields of the interest
+   * other than the name. This decodes into stack arrays and copies the fields
+   * straight into interest without making a temporary Interest.
+   * @param interest The Interest object whose fields other than the name are
+   * updated.
+   * @param input A pointer to the input buffer to decode.
+   * @param inputLength The number of bytes in input.
+   */
+  virtual void
+  decodeInterestFields
+    (Interest& interest, const uint8_t *input, size_t inputLength);
+
+  /**
+   * Decode input as a data packet in NDN-TLV and set the signature, MetaInfo
+   * and content of data, but not the name. This decodes into stack arrays and
+   * copies the fields straight into data without making a temporary Data.
+   * @param data The Data object whose fields other than the name are updated.
+   * @param input A pointer to the input buffer to decode.
+   * @param inputLength The number of bytes in input.
+   */
+  virtual void
+  decodeDataFields(Data& data, const uint8_t *input, size_t inputLength);
+
   /**
    * Encode controlParameters as NDN-TLV and return the encoding.
    * @param controlParameters The ControlParameters object to encode.
@@ -178,6 +178,79 @@ public:
     decodeData(data, input, inputLength, &dummyBeginOffset, &dummyEndOffset);
   }
 
+  /**
+   * Decode input as an interest, checking that the entire encoding can be
+   * decoded, but only set the name. This is used by Interest::wireDecodeLazy.
+   * The default implementation calls decodeInterest with a temporary Interest
+   * object, so a derived class can override to avoid making the other fields.
+   * @param name The Name object which is set to the interest name.
+   * @param input A pointer to the input buffer to decode.
+   * @param inputLength The number of bytes in input.
+   * @param signedPortionBeginOffset Return the offset in the encoding of the
+   * beginning of the signed portion, as in decodeInterest.
+   * @param signedPortionEndOffset Return the offset in the encoding of the end
+   * of the signed portion, as in decodeInterest.
+   * @throws logic_error for unimplemented if the derived class does not
+   * override decodeInterest.
+   */
+  virtual void
+  decodeInterestName
+    (Name& name, const uint8_t *input, size_t inputLength,
+     size_t *signedPortionBeginOffset, size_t *signedPortionEndOffset);
+
+  /**
+   * Decode input as a data packet, checking that the entire encoding can be
+   * decoded, but only set the name. This is used by Data::wireDecodeLazy.
+   * The default implementation calls decodeData with a temporary Data object,
+   * so a derived class can override to avoid making the other fields.
+   * @param name The Name object which is set to the data packet name.
+   * @param input A pointer to the input buffer to decode.
+   * @param inputLength The number of bytes in input.
+   * @param signedPortionBeginOffset Return the offset in the input buffer of
+   * the beginning of the signed portion, as in decodeData.
+   * @param signedPortionEndOffset Return the offset in the input buffer of the
+   * end of the signed portion, as in decodeData.
+   * @throws logic_error for unimplemented if the derived class does not
+   * override decodeData.
+   */
+  virtual void
+  decodeDataName
+    (Name& name, const uint8_t *input, size_t inputLength,
+     size_t *signedPortionBeginOffset, size_t *signedPortionEndOffset);
+
+  /**
+   * Decode input as an interest and set the fields of the interest other than
+   * the name. This is used by Interest::decodeLazyFields after
+   * decodeInterestName has already checked the encoding. The default
+   * implementation calls decodeInterest with a temporary Interest object and
+   * copies the fields, so a derived class can override to decode straight into
+   * interest.
+   * @param interest The Interest object whose fields other than the name are
+   * updated.
+   * @param input A pointer to the input buffer to decode.
+   * @param inputLength The number of bytes in input.
+   * @throws logic_error for unimplemented if the derived class does not
+   * override decodeInterest.
+   */
+  virtual void
+  decodeInterestFields
+    (Interest& interest, const uint8_t *input, size_t inputLength);
+
+  /**
+   * Decode input as a data packet and set the signature, MetaInfo and content
+   * of data, but not the name. This is used by Data::decodeLazyFields after
+   * decodeDataName has already checked the encoding. The default
+   * implementation calls decodeData with a temporary Data object and copies
+   * the fields, so a derived class can override to decode straight into data.
+   * @param data The Data object whose fields other than the name are updated.
+   * @param input A pointer to the input buffer to decode.
+   * @param inputLength The number of bytes in input.
+   * @throws logic_error for unimplemented if the derived class does not
+   * override decodeData.
+   */
+  virtual void
+  decodeDataFields(Data& data, const uint8_t *input, size_t inputLength);
+
   /**
    * Encode controlParameters and return the encoding.
    * Your derived class should override.
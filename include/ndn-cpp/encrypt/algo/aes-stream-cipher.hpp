@@ -0,0 +1,172 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2018 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+#ifndef NDN_AES_STREAM_CIPHER_HPP
+#define NDN_AES_STREAM_CIPHER_HPP
+
+#include "../../util/blob.hpp"
+
+struct evp_cipher_ctx_st;
+
+namespace ndn {
+
+/**
+ * An AesStreamCipher encrypts or decrypts with AES incrementally, writing into
+ * caller buffers, so that a large content does not need to be in memory at
+ * once and the work can be spread over many calls. For example, an application
+ * can encrypt each segment of a large object with update() as it is published,
+ * and decrypt each fetched segment as it arrives. (Producer and Consumer still
+ * encrypt and decrypt the content of each Data packet in one call.) The key
+ * schedule is computed once in the constructor and kept by reset(), so one
+ * object can also process many small contents with the same key.
+ * The CBC mode uses PKCS#7 padding and is compatible with AesAlgorithm using
+ * ndn_EncryptAlgorithmType_AesCbc. The GCM mode produces an authentication tag
+ * which the decryptor must check with finish() before using the plain text.
+ * @note This class is an experimental feature. The API may change.
+ */
+class AesStreamCipher {
+public:
+  enum Mode {
+    MODE_CBC,
+    MODE_GCM
+  };
+
+  /**
+   * Create an AesStreamCipher with the key and initial vector.
+   * @param mode The cipher mode, MODE_CBC or MODE_GCM.
+   * @param isEncrypt True to encrypt, false to decrypt.
+   * @param keyBits The AES key, which must be 16 or 32 bytes for AES-128 or
+   * AES-256.
+   * @param initialVector The initial vector, which must be BLOCK_SIZE bytes for
+   * MODE_CBC. For MODE_GCM, this is usually GCM_IV_SIZE bytes.
+   * @throws std::invalid_argument for an invalid key or initial vector size.
+   * @throws std::runtime_error if the crypto library is not available.
+   */
+  AesStreamCipher
+    (Mode mode, bool isEncrypt, const Blob& keyBits, const Blob& initialVector);
+
+  ~AesStreamCipher();
+
+  /**
+   * Start a new content with the same key and a new initial vector, without
+   * computing the key schedule again. This clears any unfinished input.
+   * @param initialVector The new initial vector. For encryption, each content
+   * must have a different initial vector.
+   * @throws std::invalid_argument for an invalid initial vector size.
+   */
+  void
+  reset(const Blob& initialVector);
+
+  /**
+   * Process the next part of the input.
+   * @param input A pointer to the input bytes.
+   * @param inputLength The number of input bytes.
+   * @param output The output buffer, which must have room for at least
+   * getMaxUpdateOutputSize(inputLength) bytes. This may write fewer bytes than
+   * the input since CBC keeps a partial block until the next call.
+   * @return The number of bytes written to output.
+   * @warning For MODE_GCM decryption, the output is not authenticated until
+   * finish() checks the tag. If finish() throws, the content was modified or
+   * the key is wrong, so you must discard all the plain text that update()
+   * returned. Don't act on it or pass it to the application before finish().
+   * @throws std::runtime_error if finish() was already called or for a
+   * crypto library error.
+   */
+  size_t
+  update(const uint8_t* input, size_t inputLength, uint8_t* output);
+
+  /**
+   * Process the next part of the input and return the output as a new Blob.
+   * For MODE_GCM decryption, see the warning for the other update().
+   * @param input The input bytes.
+   * @return The output, which may be empty.
+   */
+  Blob
+  update(const Blob& input);
+
+  /**
+   * Finish the content. For CBC encryption, this writes the final padded block.
+   * For CBC decryption, this writes the last plain bytes and checks the
+   * padding. For GCM encryption, this computes the tag for getTag(). For GCM
+   * decryption, call setTag() first, and this checks the tag.
+   * @param output The output buffer, which must have room for at least
+   * BLOCK_SIZE bytes.
+   * @return The number of bytes written to output.
+   * @throws std::runtime_error if the CBC padding or GCM tag does not verify.
+   */
+  size_t
+  finish(uint8_t* output);
+
+  /**
+   * Finish the content and return the final output as a new Blob.
+   * @return The final output, which may be empty.
+   */
+  Blob
+  finish();
+
+  /**
+   * Get the GCM authentication tag after finish() for encryption.
+   * @return The GCM_TAG_SIZE byte tag.
+   * @throws std::runtime_error if this is not MODE_GCM encryption or finish()
+   * was not called.
+   */
+  Blob
+  getTag() const;
+
+  /**
+   * Set the expected GCM authentication tag for decryption. This must be
+   * called before finish().
+   * @param tag The tag from the encryptor.
+   * @throws std::runtime_error if this is not MODE_GCM decryption.
+   */
+  void
+  setTag(const Blob& tag);
+
+  /**
+   * Get the maximum number of bytes that update() writes for the input length.
+   * @param inputLength The input length.
+   * @return The maximum output size.
+   */
+  static size_t
+  getMaxUpdateOutputSize(size_t inputLength) { return inputLength + BLOCK_SIZE; }
+
+  static const size_t BLOCK_SIZE = 16;
+  static const size_t GCM_IV_SIZE = 12;
+  static const size_t GCM_TAG_SIZE = 16;
+
+private:
+  // Don't allow copying since the cipher context can't be shared.
+  AesStreamCipher(const AesStreamCipher& other);
+  AesStreamCipher& operator=(const AesStreamCipher& other);
+
+  void
+  checkInitialVector(const Blob& initialVector) const;
+
+  Mode mode_;
+  bool isEncrypt_;
+  bool isFinished_;
+  Blob tag_;
+  struct evp_cipher_ctx_st* context_;
+};
+
+}
+
+#endif
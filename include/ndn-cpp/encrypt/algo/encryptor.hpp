@@ -28,6 +28,8 @@
 
 namespace ndn {
 
+class AesStreamCipher;
+
 /**
  * Encryptor has static constants and utility methods for encryption, such as
  * encryptData.
@@ -55,6 +57,24 @@ public:
     (Data& data, const Blob& payload, const Name& keyName, const Blob& key,
      const EncryptParams& params);
 
+  /**
+   * Prepare an encrypted data packet the same as encryptData with
+   * ndn_EncryptAlgorithmType_AesCbc, but encrypt with the given AES-CBC
+   * AesStreamCipher. The cipher keeps the key schedule of the key, so it can be
+   * reused to encrypt many packets with the same key.
+   * @param data The data packet which is updated.
+   * @param payload The payload to encrypt.
+   * @param keyName The key name for the EncryptedContent.
+   * @param cipher An AesStreamCipher in MODE_CBC for encryption with the key.
+   * This resets the cipher with the initialVector.
+   * @param initialVector The initial vector, which should be new random bytes
+   * for each packet.
+   */
+  static void
+  encryptData
+    (Data& data, const Blob& payload, const Name& keyName,
+     AesStreamCipher& cipher, const Blob& initialVector);
+
   static const Name::Component&
   getNAME_COMPONENT_FOR() { return getValues().NAME_COMPONENT_FOR; }
 
@@ -24,6 +24,11 @@
 #define NDN_CONSUMER_HPP
 
 #include <map>
+#include <list>
+#include "../ndn-cpp-config.h"
+#if NDN_CPP_HAVE_STD_UNORDERED_MAP
+#include <unordered_map>
+#endif
 #include "../data.hpp"
 #include "../face.hpp"
 #include "../security/key-chain.hpp"
@@ -33,12 +38,17 @@
 
 // Give friend access to the tests.
 class TestConsumer_DecryptContent_Test;
+class TestConsumer_KeyCache_Test;
 
 namespace ndn {
 
 /**
  * A Consumer manages fetched group keys used to decrypt a data packet in the
  * group-based encryption protocol.
+ * The decrypted C-KEYs and D-KEYs are kept in caches with a maximum number of
+ * entries (evicting the least recently used) and a maximum lifetime. While a
+ * C-KEY or D-KEY is being fetched and decrypted, other calls to consume which
+ * need the same key wait for the same fetch instead of fetching it again.
  * @note This class is an experimental feature. The API may change.
  */
 class Consumer {
@@ -146,9 +156,151 @@ public:
     impl_-> decryptContent(data, onPlainText, onError);
   }
 
+  /**
+   * Set the maximum number of entries in each of the C-KEY and D-KEY caches.
+   * If a cache is full when adding a key, remove the least recently used key.
+   * @param capacity The maximum number of keys. If 0, don't cache keys.
+   */
+  void
+  setKeyCacheCapacity(size_t capacity)
+  {
+    impl_->cKeyCache_.setCapacity(capacity);
+    impl_->dKeyCache_.setCapacity(capacity);
+  }
+
+  /**
+   * Set the maximum time that a key can stay in the C-KEY and D-KEY caches
+   * after it is decrypted. This does not change keys which are already cached.
+   * @param lifetimeMilliseconds The maximum lifetime in milliseconds.
+   */
+  void
+  setKeyCacheLifetime(Milliseconds lifetimeMilliseconds)
+  {
+    impl_->cKeyCache_.setLifetime(lifetimeMilliseconds);
+    impl_->dKeyCache_.setLifetime(lifetimeMilliseconds);
+  }
+
+  /**
+   * Get the default maximum number of entries in each key cache.
+   * @return The default capacity.
+   */
+  static size_t
+  getDefaultKeyCacheCapacity() { return 100; }
+
+  /**
+   * Get the default maximum lifetime of a cached key (1 hour).
+   * @return The lifetime in milliseconds.
+   */
+  static Milliseconds
+  getDefaultKeyCacheLifetime() { return 3600.0 * 1000; }
+
+  /**
+   * Set the offset when the key caches get the current time, which should only
+   * be used for testing.
+   * @param nowOffsetMilliseconds The offset in milliseconds.
+   */
+  void
+  setKeyCacheNowOffsetMilliseconds_(Milliseconds nowOffsetMilliseconds)
+  {
+    impl_->cKeyCache_.setNowOffsetMilliseconds_(nowOffsetMilliseconds);
+    impl_->dKeyCache_.setNowOffsetMilliseconds_(nowOffsetMilliseconds);
+  }
+
 private:
   // Give friend access to the tests.
   friend TestConsumer_DecryptContent_Test;
+  friend TestConsumer_KeyCache_Test;
+
+  /**
+   * A KeyCache holds decrypted key bits by key name, up to a maximum number
+   * of entries. An entry is removed when its lifetime expires, and if the cache
+   * is full when inserting, the least recently used entry is removed.
+   */
+  class KeyCache {
+  public:
+    KeyCache(size_t capacity, Milliseconds lifetimeMilliseconds)
+    : capacity_(capacity), lifetimeMilliseconds_(lifetimeMilliseconds),
+      nowOffsetMilliseconds_(0)
+    {
+    }
+
+    /**
+     * Find the key with keyName and mark it as the most recently used. If the
+     * key has expired, remove it.
+     * @param keyName The key name.
+     * @param keyBits Set this to the key bits if found.
+     * @return True if found, false if not found or expired.
+     */
+    bool
+    find(const Name& keyName, Blob& keyBits);
+
+    /**
+     * Insert or replace the key with keyName, and set it to expire after the
+     * lifetime. If the capacity is zero, do nothing.
+     * @param keyName The key name, which is copied.
+     * @param keyBits The key bits.
+     */
+    void
+    insert(const Name& keyName, const Blob& keyBits);
+
+    /**
+     * Get the number of entries, including expired entries which have not yet
+     * been removed.
+     * @return The number of entries.
+     */
+    size_t
+    size() const { return entries_.size(); }
+
+    /**
+     * Set the maximum number of entries, removing the least recently used
+     * entries if the cache has more.
+     * @param capacity The maximum number of entries.
+     */
+    void
+    setCapacity(size_t capacity);
+
+    void
+    setLifetime(Milliseconds lifetimeMilliseconds)
+    {
+      lifetimeMilliseconds_ = lifetimeMilliseconds;
+    }
+
+    void
+    setNowOffsetMilliseconds_(Milliseconds nowOffsetMilliseconds)
+    {
+      nowOffsetMilliseconds_ = nowOffsetMilliseconds;
+    }
+
+  private:
+    // The front is the most recently used key name.
+    typedef std::list<Name> LruList;
+
+    class Entry {
+    public:
+      Blob keyBits_;
+      MillisecondsSince1970 expirationTime_;
+      LruList::iterator lruPosition_;
+    };
+
+#if NDN_CPP_HAVE_STD_UNORDERED_MAP
+    typedef std::unordered_map<Name, Entry> EntryMap;
+#else
+    typedef std::map<Name, Entry> EntryMap;
+#endif
+
+    /**
+     * Remove the entry from entries_ and lruList_.
+     * @param entry The iterator of the entry in entries_.
+     */
+    void
+    erase(EntryMap::iterator entry);
+
+    EntryMap entries_;
+    LruList lruList_;
+    size_t capacity_;
+    Milliseconds lifetimeMilliseconds_;
+    Milliseconds nowOffsetMilliseconds_;
+  };
 
   /**
    * Consumer::Impl does the work of Consumer. It is a separate class so that
@@ -183,7 +335,35 @@ private:
 
   private:
     // Give friend access to the tests.
+    friend class Consumer;
     friend TestConsumer_DecryptContent_Test;
+    friend TestConsumer_KeyCache_Test;
+
+    /**
+     * A PendingDecryption holds an EncryptedContent which is waiting for the
+     * key to be fetched and decrypted.
+     */
+    class PendingDecryption {
+    public:
+      PendingDecryption
+        (const ptr_lib::shared_ptr<EncryptedContent>& encryptedContent,
+         const OnPlainText& onPlainText, const EncryptError::OnError& onError)
+      : encryptedContent_(encryptedContent), onPlainText_(onPlainText),
+        onError_(onError)
+      {
+      }
+
+      ptr_lib::shared_ptr<EncryptedContent> encryptedContent_;
+      OnPlainText onPlainText_;
+      EncryptError::OnError onError_;
+    };
+
+    // The map key is the C-KEY or D-KEY name.
+#if NDN_CPP_HAVE_STD_UNORDERED_MAP
+    typedef std::unordered_map<Name, std::vector<PendingDecryption> > PendingMap;
+#else
+    typedef std::map<Name, std::vector<PendingDecryption> > PendingMap;
+#endif
 
     /**
      * Decode encryptedBlob as an EncryptedContent and decrypt using keyBits.
@@ -235,6 +415,51 @@ private:
       (const Data& dKeyData, const OnPlainText& onPlainText,
        const EncryptError::OnError& onError);
 
+    /**
+     * Decrypt encryptedContent with the cached key if it is in keyCache.
+     * Otherwise add it to the pending decryptions for keyName.
+     * @param keyCache The cache of C-KEYs or D-KEYs.
+     * @param pendingMap The pending decryptions for the C-KEYs or D-KEYs.
+     * @param keyName The name of the key to decrypt encryptedContent.
+     * @param encryptedContent The EncryptedContent to decrypt.
+     * @param onPlainText When encryptedContent is decrypted, this calls
+     * onPlainText(decryptedBlob) with the decrypted blob.
+     * @param onError This calls onError(errorCode, message) for an error.
+     * @return True if the caller must fetch the key, or false if the key is
+     * cached or another call is already fetching it.
+     */
+    bool
+    decryptWithCachedKey
+      (KeyCache& keyCache, PendingMap& pendingMap, const Name& keyName,
+       const ptr_lib::shared_ptr<EncryptedContent>& encryptedContent,
+       const OnPlainText& onPlainText, const EncryptError::OnError& onError);
+
+    /**
+     * Add the decrypted key to keyCache, and decrypt all the pending
+     * decryptions for keyName.
+     * @param keyCache The cache of C-KEYs or D-KEYs.
+     * @param pendingMap The pending decryptions for the C-KEYs or D-KEYs.
+     * @param keyName The key name.
+     * @param keyBits The decrypted key bits.
+     */
+    static void
+    onKeyPlainText
+      (KeyCache* keyCache, PendingMap* pendingMap, const Name& keyName,
+       const Blob& keyBits);
+
+    /**
+     * Call onError for all the pending decryptions for keyName, so that the
+     * next request for the key will fetch it again.
+     * @param pendingMap The pending decryptions for the C-KEYs or D-KEYs.
+     * @param keyName The key name.
+     * @param errorCode The error code.
+     * @param message The error message.
+     */
+    static void
+    onKeyError
+      (PendingMap* pendingMap, const Name& keyName,
+       EncryptError::ErrorCode errorCode, const std::string& message);
+
     /**
      * Get the encoded blob of the decryption key with decryptionKeyName from the
      * database.
@@ -287,11 +512,11 @@ private:
     Name consumerName_;
 
     const ptr_lib::shared_ptr<Link> cKeyLink_;
-    // The map key is the C-KEY name. The value is the encoded key Blob.
-    std::map<Name, Blob> cKeyMap_;
+    KeyCache cKeyCache_;
+    PendingMap pendingCKeys_;
     const ptr_lib::shared_ptr<Link> dKeyLink_;
-    // The map key is the D-KEY name. The value is the encoded key Blob.
-    std::map<Name, Blob> dKeyMap_;
+    KeyCache dKeyCache_;
+    PendingMap pendingDKeys_;
   };
 
   /**
@@ -23,6 +23,10 @@
 #ifndef NDN_GROUP_MANAGER_HPP
 #define NDN_GROUP_MANAGER_HPP
 
+#include "../ndn-cpp-config.h"
+#ifdef NDN_CPP_HAVE_BOOST_ASIO
+#include <boost/asio.hpp>
+#endif
 #include "../security/certificate/identity-certificate.hpp"
 #include "group-manager-db.hpp"
 
@@ -30,6 +34,8 @@
 class TestGroupManager_CreateDKeyData_Test;
 class TestGroupManager_CreateEKeyData_Test;
 class TestGroupManager_CalculateInterval_Test;
+class TestGroupManager_ScheduleIndex_Test;
+class TestGroupManager_GetGroupKeyParallel_Test;
 
 namespace ndn {
 
@@ -42,6 +48,23 @@ class KeyChain;
  */
 class GroupManager {
 public:
+  /**
+   * An OnGroupKeyData function object is called as onData(data) for each E-KEY
+   * or D-KEY Data packet produced by the parallel getGroupKey.
+   */
+  typedef func_lib::function<void
+    (const ptr_lib::shared_ptr<Data>& data)> OnGroupKeyData;
+
+  /**
+   * An OnGroupKeyComplete function object is called as
+   * onComplete(failedKeyNames) after the parallel getGroupKey has called onData
+   * for all the Data packets. failedKeyNames has the public key name of each
+   * member whose D-KEY Data packet could not be encrypted or signed, and is
+   * empty if all succeeded.
+   */
+  typedef func_lib::function<void
+    (const std::vector<Name>& failedKeyNames)> OnGroupKeyComplete;
+
   /**
    * Create a group manager with the given values. The group manager namespace
    * is /{prefix}/read/{dataType} .
@@ -83,6 +106,55 @@ public:
      std::vector<ptr_lib::shared_ptr<Data> >& result,
      bool needRegenerate = true);
 
+#ifdef NDN_CPP_HAVE_BOOST_ASIO
+  /**
+   * Create a group key for the interval into which timeSlot falls, the same as
+   * the other form of getGroupKey, but encrypt and sign the D-KEY Data packets
+   * for the members in tasks posted to workerService, and stream each finished
+   * packet to onData instead of returning a list. The interval, the group key
+   * pair and the E-KEY packet are made in the calling thread, and the E-KEY
+   * packet is the first given to onData. The number of threads which call
+   * workerService.run() sets the number of D-KEY packets made at the same time.
+   * The onData and onComplete callbacks are posted to resultService, so if it
+   * runs in one thread (for example the thread of a ThreadsafeFace), then the
+   * callbacks can add each packet to a MemoryContentCache, and onComplete is
+   * called after the last onData. It is the responsibility of the application
+   * to start and stop both services, and to keep this GroupManager valid until
+   * onComplete is called.
+   * If the KeyChain uses security v2, then the D-KEY packets are signed in the
+   * worker tasks with the TPM key handle, as with BatchSigner. The key handles
+   * of TpmBackEndMemory and TpmBackEndFile can sign from multiple threads. For
+   * a security v1 KeyChain, the D-KEY packets are signed in resultService
+   * before calling onData. If encrypting or signing the D-KEY for a member
+   * fails, this skips the member and gives its key name to onComplete.
+   * @param timeSlot The time slot to cover as milliseconds since Jan 1, 1970 UTC.
+   * @param workerService The asio io_service for the encryption and signing
+   * tasks.
+   * @param resultService The asio io_service for calling onData and onComplete.
+   * @param onData This calls onData(data) for the E-KEY and each D-KEY Data
+   * packet. If there is no member with an interval covering the time slot, this
+   * does not call onData.
+   * NOTE: The library will log any exceptions thrown by this callback, but for
+   * better error handling the callback should catch and properly handle any
+   * exceptions.
+   * @param onComplete This calls onComplete(failedKeyNames) when all the
+   * packets are done, where failedKeyNames has the key names of the members
+   * which were skipped.
+   * NOTE: The library will log any exceptions thrown by this callback, but for
+   * better error handling the callback should catch and properly handle any
+   * exceptions.
+   * @param needRegenerate (optional) See the other form of getGroupKey. If
+   * omitted, use true.
+   * @throws GroupManagerDb::Error for a database error.
+   * @throws SecurityException for an error using the security KeyChain.
+   */
+  void
+  getGroupKey
+    (MillisecondsSince1970 timeSlot, boost::asio::io_service& workerService,
+     boost::asio::io_service& resultService, const OnGroupKeyData& onData,
+     const OnGroupKeyComplete& onComplete, bool needRegenerate = true);
+#endif
+
   /**
    * Add a schedule with the given scheduleName.
    * @param scheduleName The name of the schedule. The name cannot be empty.
@@ -91,10 +163,7 @@ public:
    * exists, if the name is empty, or other database error.
    */
   void
-  addSchedule(const std::string& scheduleName, const Schedule& schedule)
-  {
-    database_->addSchedule(scheduleName, schedule);
-  }
+  addSchedule(const std::string& scheduleName, const Schedule& schedule);
 
   /**
    * Delete the schedule with the given scheduleName. Also delete members which
@@ -103,10 +172,7 @@ public:
    * @throws GroupManagerDb::Error for a database error.
    */
   void
-  deleteSchedule(const std::string& scheduleName)
-  {
-    database_->deleteSchedule(scheduleName);
-  }
+  deleteSchedule(const std::string& scheduleName);
 
   /**
    * Update the schedule with scheduleName and replace the old object with the
@@ -117,10 +183,7 @@ public:
    * @throws GroupManagerDb::Error if the name is empty, or other database error.
    */
   void
-  updateSchedule(const std::string& scheduleName, const Schedule& schedule)
-  {
-    database_->updateSchedule(scheduleName, schedule);
-  }
+  updateSchedule(const std::string& scheduleName, const Schedule& schedule);
 
   /**
    * Add a new member with the given memberCertificate into a schedule named
@@ -134,12 +197,7 @@ public:
    * certificate.
    */
   void
-  addMember(const std::string& scheduleName, const Data& memberCertificate)
-  {
-    IdentityCertificate cert(memberCertificate);
-    database_->addMember
-      (scheduleName, cert.getPublicKeyName(), cert.getPublicKeyInfo().getKeyDer());
-  }
+  addMember(const std::string& scheduleName, const Data& memberCertificate);
 
   /**
    * Remove a member with the given identity name. If there is no member with
@@ -148,10 +206,7 @@ public:
    * @throws GroupManagerDb::Error for a database error.
    */
   void
-  removeMember(const Name& identity)
-  {
-    database_->deleteMember(identity);
-  }
+  removeMember(const Name& identity);
 
   /**
    * Change the name of the schedule for the given member's identity name.
@@ -161,10 +216,7 @@ public:
    * name in the database, or there's no schedule named scheduleName.
    */
   void
-  updateMemberSchedule(const Name& identity, const std::string& scheduleName)
-  {
-    database_->updateMemberSchedule(identity, scheduleName);
-  }
+  updateMemberSchedule(const Name& identity, const std::string& scheduleName);
 
   /**
    * Delete all the EKeys in the database.
@@ -175,11 +227,64 @@ public:
   void
   cleanEKeys() { database_->cleanEKeys(); }
 
+  /**
+   * Clear the in-memory index of schedules and members so that the next call
+   * to getGroupKey reloads it from the database. The index is kept up to date
+   * by the methods of this GroupManager, so you only need to call this if you
+   * change the schedules or members directly through the GroupManagerDb.
+   */
+  void
+  clearScheduleIndex()
+  {
+    scheduleIndex_.clear();
+    memberIndex_.clear();
+    isScheduleIndexLoaded_ = false;
+  }
+
 private:
+  /**
+   * An IndexedSchedule holds a decoded Schedule from the database and the keys
+   * of the members which use it.
+   */
+  class IndexedSchedule {
+  public:
+    ptr_lib::shared_ptr<Schedule> schedule_;
+    // The key is the Name of the public key and the value is the key DER.
+    std::map<Name, Blob> memberKeys_;
+  };
+
+  // The key is the schedule name.
+  typedef std::map<std::string, IndexedSchedule> ScheduleIndex;
+  // The key is the member identity name and the value is the schedule name and
+  // the public key name.
+  typedef std::map<Name, std::pair<std::string, Name> > MemberIndex;
+
   // Give friend access to the tests.
   friend TestGroupManager_CreateDKeyData_Test;
   friend TestGroupManager_CreateEKeyData_Test;
   friend TestGroupManager_CalculateInterval_Test;
+  friend TestGroupManager_ScheduleIndex_Test;
+  friend TestGroupManager_GetGroupKeyParallel_Test;
+
+  /**
+   * If the schedule index is not loaded, load it from the database. This reads
+   * each schedule and its members once, so that calculateInterval does not
+   * need to query the database or decode schedules.
+   * @throws GroupManagerDb::Error for a database error.
+   */
+  void
+  loadScheduleIndex();
+
+  /**
+   * Remove the member with the identity name from memberIndex_ and from the
+   * member keys of its schedule in scheduleIndex_. If there is no such member,
+   * do nothing.
+   * @param identity The member's identity name.
+   * @return The public key name and DER of the removed member, or an empty
+   * Blob if not found.
+   */
+  std::pair<Name, Blob>
+  removeIndexedMember(const Name& identity);
 
   /**
    * Calculate an Interval that covers the timeSlot.
@@ -194,6 +299,79 @@ private:
   calculateInterval
     (MillisecondsSince1970 timeSlot, std::map<Name, Blob>& memberKeys);
 
+  /**
+   * Get the E-KEY Data packet and the group private key for the interval, and
+   * create the group key pair if needed, as done by getGroupKey.
+   * @param finalInterval The interval from calculateInterval.
+   * @param needRegenerate True to create a new group key pair.
+   * @param privateKeyBlob Set privateKeyBlob to the encoding Blob of the group
+   * private key.
+   * @return The signed E-KEY Data packet.
+   */
+  ptr_lib::shared_ptr<Data>
+  prepareGroupKey
+    (const Interval& finalInterval, bool needRegenerate, Blob& privateKeyBlob);
+
+#ifdef NDN_CPP_HAVE_BOOST_ASIO
+  class DKeyBatch;
+
+  /**
+   * Make and sign the D-KEY Data packets for the members of the batch in the
+   * range [begin, end) and post each to the batch's resultService. This is a
+   * ParallelTasks task.
+   * @param batch The batch with the members and group private key.
+   * @param begin The index of the first member.
+   * @param end The index after the last member.
+   */
+  static void
+  dKeyTask(const ptr_lib::shared_ptr<DKeyBatch>& batch, size_t begin, size_t end);
+
+  /**
+   * Call onData for the E-KEY or D-KEY Data packet. This is called in the
+   * batch's resultService.
+   * @param batch The batch with the onData callback.
+   * @param data The Data packet.
+   */
+  static void
+  deliverGroupKeyData
+    (const ptr_lib::shared_ptr<DKeyBatch>& batch,
+     const ptr_lib::shared_ptr<Data>& data);
+
+  /**
+   * Sign the D-KEY Data packet with the KeyChain for a security v1 KeyChain,
+   * then call onData. If signing fails, mark the member as failed. This is
+   * called in the batch's resultService.
+   * @param batch The batch with the onData callback.
+   * @param memberIndex The index of the member in the batch.
+   * @param data The D-KEY Data packet.
+   */
+  static void
+  deliverDKeyData
+    (const ptr_lib::shared_ptr<DKeyBatch>& batch, size_t memberIndex,
+     const ptr_lib::shared_ptr<Data>& data);
+
+  /**
+   * Post the call to finishGroupKey to the batch's resultService. This is
+   * called after the last task of the batch.
+   * @param batch The batch whose tasks are finished.
+   */
+  static void
+  postFinishGroupKey(const ptr_lib::shared_ptr<DKeyBatch>& batch);
+
+  /**
+   * Call onComplete for the finished batch with the key names of the failed
+   * members. This is called in the batch's resultService.
+   * @param batch The finished batch.
+   */
+  static void
+  finishGroupKey(const ptr_lib::shared_ptr<DKeyBatch>& batch);
+
+  /**
+   * The number of members for which one posted task makes D-KEY packets.
+   */
+  static const size_t D_KEY_TASK_SIZE = 16;
+#endif
+
   /**
    * Generate an RSA key pair according to keySize_.
    * @param privateKeyBlob Set privateKeyBlob to the encoding Blob of the
@@ -217,6 +395,26 @@ private:
     (const std::string& startTimeStamp, const std::string& endTimeStamp,
      const Blob& publicKeyBlob);
 
+  /**
+   * Make an unsigned D-KEY Data packet with an EncryptedContent for the given
+   * private key, encrypted with the certificate key. This does not use the
+   * KeyChain or database so that it can be called from multiple threads.
+   * @param startTimeStamp The start time stamp string to put in the name.
+   * @param endTimeStamp The end time stamp string to put in the name.
+   * @param keyName The key name to put in the data packet name and the
+   * EncryptedContent key locator.
+   * @param privateKeyBlob A Blob of the encoded private key.
+   * @param certificateKey The certificate key encoding, used to encrypt the
+   * private key.
+   * @return The unsigned Data packet.
+   * @throws SecurityException for an error encrypting.
+   */
+  ptr_lib::shared_ptr<Data>
+  makeDKeyData
+    (const std::string& startTimeStamp, const std::string& endTimeStamp,
+     const Name& keyName, const Blob& privateKeyBlob,
+     const Blob& certificateKey) const;
+
   /**
    * Create a D-KEY Data packet with an EncryptedContent for the given private
    * key, encrypted with the certificate key.
@@ -280,6 +478,9 @@ private:
   uint32_t keySize_;
   int freshnessHours_;
   KeyChain* keyChain_;
+  ScheduleIndex scheduleIndex_;
+  MemberIndex memberIndex_;
+  bool isScheduleIndexLoaded_;
   static const uint64_t MILLISECONDS_IN_HOUR = 3600 * 1000;
 };
 
@@ -32,6 +32,8 @@
 
 namespace ndn {
 
+class AesStreamCipher;
+
 /**
  * A Producer manages content keys used to encrypt a data packet in the
  * group-based encryption protocol.
@@ -130,6 +132,36 @@ public:
     impl_->produce(data, timeSlot, content, onError);
   }
 
+  /**
+   * Encrypt each content with the content key that covers its time slot and
+   * create a Data packet for each, the same as calling produce for each one.
+   * This gets each content key once for the batch instead of once per packet,
+   * and if the KeyChain uses security v2 then this signs the whole batch with
+   * one signing key lookup.
+   * @param timeSlots The list of time slots as milliseconds since Jan 1, 1970
+   * UTC, one for each content. Each time slot is also used in the Data name,
+   * so the time slots should be different.
+   * @param contents The list of contents to encrypt.
+   * @param result This clears result and sets it to the list of new Data
+   * packets, one for each content, in the same order.
+   * @param onError (optional) This calls onError(errorCode, message) for an
+   * error. If omitted, use a default callback which does nothing.
+   * NOTE: The library will log any exceptions thrown by this callback, but for
+   * better error handling the callback should catch and properly handle any
+   * exceptions.
+   * @throws std::invalid_argument if timeSlots and contents have different
+   * sizes.
+   */
+  void
+  produce
+    (const std::vector<MillisecondsSince1970>& timeSlots,
+     const std::vector<Blob>& contents,
+     std::vector<ptr_lib::shared_ptr<Data> >& result,
+     const EncryptError::OnError& onError = defaultOnError)
+  {
+    impl_->produce(timeSlots, contents, result, onError);
+  }
+
   /**
    * The default OnError callback which does nothing.
    */
@@ -162,6 +194,13 @@ private:
       (Data& data, MillisecondsSince1970 timeSlot, const Blob& content,
        const EncryptError::OnError& onError);
 
+    void
+    produce
+      (const std::vector<MillisecondsSince1970>& timeSlots,
+       const std::vector<Blob>& contents,
+       std::vector<ptr_lib::shared_ptr<Data> >& result,
+       const EncryptError::OnError& onError);
+
   private:
     class KeyInfo {
     public:
@@ -184,6 +223,49 @@ private:
       std::vector<ptr_lib::shared_ptr<Data> > encryptedKeys;
     };
 
+    /**
+     * Get the name and bits of the content key covering timeSlot, creating it
+     * if needed as in createContentKey. This keeps the content key of the
+     * last hour slot in memory so that producing many Data packets in the same
+     * hour does not read the database for each one.
+     * @param timeSlot The time slot as milliseconds since Jan 1, 1970 UTC.
+     * @param onError The OnError callback for createContentKey.
+     * @param contentKeyName Set this to the content key name.
+     * @param contentKey Set this to the content key bits.
+     */
+    void
+    getContentKey
+      (MillisecondsSince1970 timeSlot, const EncryptError::OnError& onError,
+       Name& contentKeyName, Blob& contentKey);
+
+    /**
+     * Encrypt the content with the content key and set the name and content of
+     * data. This does not sign.
+     * @param data The Data object to update.
+     * @param timeSlot The time slot as milliseconds since Jan 1, 1970 UTC.
+     * @param content The content to encrypt.
+     * @param contentKeyName The content key name for the key locator.
+     * @param contentKey The content key bits.
+     */
+    void
+    encryptContent
+      (Data& data, MillisecondsSince1970 timeSlot, const Blob& content,
+       const Name& contentKeyName, const Blob& contentKey);
+
+    /**
+     * Encrypt the content with the AES-CBC cipher for the content key and set
+     * the name and content of data. This does not sign.
+     * @param data The Data object to update.
+     * @param timeSlot The time slot as milliseconds since Jan 1, 1970 UTC.
+     * @param content The content to encrypt.
+     * @param contentKeyName The content key name for the key locator.
+     * @param cipher The AesStreamCipher for the content key.
+     */
+    void
+    encryptContent
+      (Data& data, MillisecondsSince1970 timeSlot, const Blob& content,
+       const Name& contentKeyName, AesStreamCipher& cipher);
+
     /**
      * Round timeSlot to the nearest whole hour, so that we can store content
      * keys uniformly (by start of the hour).
@@ -374,6 +456,11 @@ private:
     std::map<MillisecondsSince1970, ptr_lib::shared_ptr<KeyRequest> > keyRequests_;
     ptr_lib::shared_ptr<ProducerDb> database_;
     int maxRepeatAttempts_;
+    // The content key of the last hour slot used by produce. If
+    // cachedContentKey_ is null, there is no cached content key.
+    MillisecondsSince1970 cachedContentKeyHourSlot_;
+    Name cachedContentKeyName_;
+    Blob cachedContentKey_;
 
     Link keyRetrievalLink_;
 
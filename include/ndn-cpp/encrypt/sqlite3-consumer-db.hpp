@@ -34,6 +34,8 @@ struct sqlite3;
 
 namespace ndn {
 
+class Sqlite3StatementCache;
+
 /**
  * Sqlite3ConsumerDb extends ConsumerDb to implement the storage of decryption
  * keys for the consumer using SQLite3.
@@ -47,6 +49,12 @@ public:
    */
   Sqlite3ConsumerDb(const std::string& databaseFilePath);
 
+  /**
+   * Close the SQLite3 database.
+   */
+  virtual
+  ~Sqlite3ConsumerDb();
+
   /**
    * Get the key with keyName from the database.
    * @param keyName The key name.
@@ -76,8 +84,40 @@ public:
   virtual void
   deleteKey(const Name& keyName);
 
+  /**
+   * Begin a transaction so that the following changes are written to the
+   * database together by commitTransaction(). Adding many decryption keys in
+   * one transaction is much faster than writing each separately.
+   * @throws ConsumerDb::Error if a transaction is already in progress or other
+   * database error.
+   */
+  void
+  beginTransaction();
+
+  /**
+   * Commit the transaction started by beginTransaction().
+   * @throws ConsumerDb::Error if there is no transaction in progress or other
+   * database error.
+   */
+  void
+  commitTransaction();
+
+  /**
+   * Roll back the transaction started by beginTransaction() to discard the
+   * changes since then.
+   * @throws ConsumerDb::Error if there is no transaction in progress or other
+   * database error.
+   */
+  void
+  rollbackTransaction();
+
 private:
+  // Disable the copy constructor and assignment operator.
+  Sqlite3ConsumerDb(const Sqlite3ConsumerDb& other);
+  Sqlite3ConsumerDb& operator=(const Sqlite3ConsumerDb& other);
+
   struct sqlite3 *database_;
+  ptr_lib::shared_ptr<Sqlite3StatementCache> statementCache_;
 };
 
 }
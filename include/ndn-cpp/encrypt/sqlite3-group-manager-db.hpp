@@ -35,6 +35,8 @@ struct sqlite3;
 
 namespace ndn {
 
+class Sqlite3StatementCache;
+
 /**
  * Sqlite3GroupManagerDb extends GroupManagerDb to implement the storage of
  * data used by the GroupManager using SQLite3.
@@ -48,6 +50,12 @@ public:
    */
   Sqlite3GroupManagerDb(const std::string& databaseFilePath);
 
+  /**
+   * Close the SQLite3 database.
+   */
+  virtual
+  ~Sqlite3GroupManagerDb();
+
   ////////////////////////////////////////////////////// Schedule management.
 
   /**
@@ -243,6 +251,35 @@ public:
   virtual void
   deleteEKey(const Name& eKeyName);
 
+  ////////////////////////////////////////////////////// Transactions.
+
+  /**
+   * Begin a transaction so that the following changes are written to the
+   * database together by commitTransaction(). Adding many members in one
+   * transaction is much faster than writing each change separately.
+   * @throws GroupManagerDb::Error if a transaction is already in progress or
+   * other database error.
+   */
+  void
+  beginTransaction();
+
+  /**
+   * Commit the transaction started by beginTransaction().
+   * @throws GroupManagerDb::Error if there is no transaction in progress or
+   * other database error.
+   */
+  void
+  commitTransaction();
+
+  /**
+   * Roll back the transaction started by beginTransaction() to discard the
+   * changes since then.
+   * @throws GroupManagerDb::Error if there is no transaction in progress or
+   * other database error.
+   */
+  void
+  rollbackTransaction();
+
 private:
   /**
    * Get the ID for the schedule.
@@ -253,7 +290,12 @@ private:
   int
   getScheduleId(const std::string& name);
 
+  // Disable the copy constructor and assignment operator.
+  Sqlite3GroupManagerDb(const Sqlite3GroupManagerDb& other);
+  Sqlite3GroupManagerDb& operator=(const Sqlite3GroupManagerDb& other);
+
   struct sqlite3 *database_;
+  ptr_lib::shared_ptr<Sqlite3StatementCache> statementCache_;
   std::map<Name, Blob> privateKeyBase_;
 };
 
@@ -0,0 +1,203 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2018 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+#ifndef NDN_FACE_METRICS_HPP
+#define NDN_FACE_METRICS_HPP
+
+#include <string>
+#include "common.hpp"
+#include "util/latency-histogram.hpp"
+
+namespace ndn {
+
+class Node;
+
+/**
+ * A FaceMetrics is a snapshot of the counters and latency histograms which a
+ * Face keeps about the packets it sends and receives and the callbacks it calls.
+ * Get it with Face::getMetrics(), which must be called in the thread which
+ * processes events for the Face. The counters start at zero when the Face is
+ * created. Byte counts are the sizes of the encoded Interest and Data packets,
+ * not including any link-layer header.
+ */
+class FaceMetrics {
+public:
+  FaceMetrics()
+  : nInterestsExpressed_(0), nInterestsSatisfied_(0), nInterestsTimedOut_(0),
+    nInterestsNacked_(0), nInterestsReceived_(0), nDataSent_(0),
+    nDataReceived_(0), nInterestBytesOut_(0), nInterestBytesIn_(0),
+    nDataBytesOut_(0), nDataBytesIn_(0), pendingInterestTableSize_(0),
+    interestFilterTableSize_(0), delayedCallTableSize_(0)
+  {
+  }
+
+  /**
+   * Get the number of Interests sent by expressInterest.
+   * @return The number of Interests.
+   */
+  uint64_t
+  getNInterestsExpressed() const { return nInterestsExpressed_; }
+
+  /**
+   * Get the number of pending Interests which were satisfied by an incoming
+   * Data packet. If one Data packet satisfies multiple pending Interests, this
+   * counts each one.
+   * @return The number of satisfied Interests.
+   */
+  uint64_t
+  getNInterestsSatisfied() const { return nInterestsSatisfied_; }
+
+  /**
+   * Get the number of pending Interests which timed out.
+   * @return The number of timed out Interests.
+   */
+  uint64_t
+  getNInterestsTimedOut() const { return nInterestsTimedOut_; }
+
+  /**
+   * Get the number of pending Interests which received a network Nack.
+   * @return The number of Nacked Interests.
+   */
+  uint64_t
+  getNInterestsNacked() const { return nInterestsNacked_; }
+
+  /**
+   * Get the number of incoming Interest packets.
+   * @return The number of incoming Interests.
+   */
+  uint64_t
+  getNInterestsReceived() const { return nInterestsReceived_; }
+
+  /**
+   * Get the number of Data packets sent by putData.
+   * @return The number of Data packets.
+   */
+  uint64_t
+  getNDataSent() const { return nDataSent_; }
+
+  /**
+   * Get the number of incoming Data packets.
+   * @return The number of incoming Data packets.
+   */
+  uint64_t
+  getNDataReceived() const { return nDataReceived_; }
+
+  /**
+   * Get the total size of the Interest packets sent by expressInterest.
+   * @return The number of bytes.
+   */
+  uint64_t
+  getNInterestBytesOut() const { return nInterestBytesOut_; }
+
+  /**
+   * Get the total size of the incoming Interest packets.
+   * @return The number of bytes.
+   */
+  uint64_t
+  getNInterestBytesIn() const { return nInterestBytesIn_; }
+
+  /**
+   * Get the total size of the Data packets sent by putData.
+   * @return The number of bytes.
+   */
+  uint64_t
+  getNDataBytesOut() const { return nDataBytesOut_; }
+
+  /**
+   * Get the total size of the incoming Data packets.
+   * @return The number of bytes.
+   */
+  uint64_t
+  getNDataBytesIn() const { return nDataBytesIn_; }
+
+  /**
+   * Get the number of entries in the pending interest table when this snapshot
+   * was made.
+   * @return The number of entries.
+   */
+  size_t
+  getPendingInterestTableSize() const { return pendingInterestTableSize_; }
+
+  /**
+   * Get the number of entries in the interest filter table when this snapshot
+   * was made.
+   * @return The number of entries.
+   */
+  size_t
+  getInterestFilterTableSize() const { return interestFilterTableSize_; }
+
+  /**
+   * Get the number of calls waiting in the delayed call table when this
+   * snapshot was made. This is zero if a subclass of Face such as
+   * ThreadsafeFace overrides callLater.
+   * @return The number of delayed calls.
+   */
+  size_t
+  getDelayedCallTableSize() const { return delayedCallTableSize_; }
+
+  /**
+   * Get the histogram of the round trip time in microseconds from sending an
+   * Interest to receiving the Data which satisfies it.
+   * @return The histogram.
+   */
+  const LatencyHistogram&
+  getRoundTripTimeMicroseconds() const { return roundTripTimeMicroseconds_; }
+
+  /**
+   * Get the histogram of the time in microseconds to execute each application
+   * callback for onData, onInterest, onTimeout and onNetworkNack.
+   * @return The histogram.
+   */
+  const LatencyHistogram&
+  getCallbackTimeMicroseconds() const { return callbackTimeMicroseconds_; }
+
+  /**
+   * Encode this snapshot as a JSON object. Each histogram is summarized by
+   * its count, min, mean, max and the 50th, 90th and 99th percentiles.
+   * @return The JSON string.
+   */
+  std::string
+  toJson() const;
+
+private:
+  friend class Node;
+
+  uint64_t nInterestsExpressed_;
+  uint64_t nInterestsSatisfied_;
+  uint64_t nInterestsTimedOut_;
+  uint64_t nInterestsNacked_;
+  uint64_t nInterestsReceived_;
+  uint64_t nDataSent_;
+  uint64_t nDataReceived_;
+  uint64_t nInterestBytesOut_;
+  uint64_t nInterestBytesIn_;
+  uint64_t nDataBytesOut_;
+  uint64_t nDataBytesIn_;
+  size_t pendingInterestTableSize_;
+  size_t interestFilterTableSize_;
+  size_t delayedCallTableSize_;
+  LatencyHistogram roundTripTimeMicroseconds_;
+  LatencyHistogram callbackTimeMicroseconds_;
+};
+
+}
+
+#endif
@@ -29,6 +29,7 @@
 #include "encoding/wire-format.hpp"
 #include "interest-filter.hpp"
 #include "transport/transport.hpp"
+#include "face-metrics.hpp"
 
 namespace ndn {
 
@@ -646,6 +647,35 @@ public:
   virtual void
   shutdown();
 
+  /**
+   * Get a snapshot of the counters and latency histograms for the packets sent
+   * and received by this Face, and the current sizes of its tables. The
+   * metrics are updated without synchronization in the thread which processes
+   * events, so you must call this in that thread. For Face, this is the thread
+   * which calls processEvents. For ThreadsafeFace, this is the thread which
+   * runs the io_service, so call this from a callback such as onData or from a
+   * function posted with io_service dispatch. It is not safe to call this from
+   * another thread.
+   * @return A copy of the FaceMetrics.
+   * @note This is an experimental feature. This API may change in the future.
+   */
+  FaceMetrics
+  getMetrics() const;
+
+  /**
+   * Set an interest filter for the prefix which answers each matching Interest
+   * with a Data packet whose content is getMetrics().toJson(). The Data name is
+   * the prefix plus a version component with the current time, it has a
+   * freshness period of one second and it has a DigestSha256Signature. You
+   * must separately register the prefix with the forwarder if needed, usually
+   * under /localhost so that the metrics are not served to the network.
+   * @param prefix The Name prefix such as /localhost/metrics.
+   * @return The interest filter ID which can be used with unsetInterestFilter.
+   * @note This is an experimental feature. This API may change in the future.
+   */
+  uint64_t
+  serveMetrics(const Name& prefix);
+
   /**
    * Get the practical limit of the size of a network-layer packet. If a packet
    * is larger than this, the library or application MAY drop it. This is a
@@ -76,7 +76,10 @@ public:
     linkWireEncoding_(interest.linkWireEncoding_),
     linkWireEncodingFormat_(interest.linkWireEncodingFormat_),
     selectedDelegationIndex_(interest.selectedDelegationIndex_),
-    changeCount_(0)
+    changeCount_(0),
+    // Copy the encoding of the fields which are not decoded yet, if any.
+    lazyEncoding_(interest.lazyEncoding_),
+    lazyWireFormat_(interest.lazyWireFormat_)
   {
     if (interest.link_.get())
       link_.set(ptr_lib::make_shared<Link>(*interest.link_.get()));
@@ -149,6 +152,54 @@ public:
     wireDecode(&input[0], input.size(), wireFormat);
   }
 
+  /**
+   * Check that the entire input can be decoded using a particular wire format,
+   * but only update the name of this Interest. Keep a pointer to the input, and
+   * decode the other fields when one of them (or a method which uses them) is
+   * first accessed. This is useful when the application only needs the name,
+   * for example to find a matching interest filter. Otherwise this is the same
+   * as wireDecode, including setting the defaultWireEncoding. Because the first
+   * access of the other fields changes this object, a const reference is not
+   * safe to read from multiple threads until you call decodeLazyFields().
+   * @param input The input byte array to be decoded as an immutable Blob.
+   * @param wireFormat (optional) A WireFormat object used to decode the input.
+   * If omitted, use WireFormat::getDefaultWireFormat().
+   */
+  void
+  wireDecodeLazy
+    (const Blob& input,
+     WireFormat& wireFormat = *WireFormat::getDefaultWireFormat());
+
+  /**
+   * Check that the entire input can be decoded but only update the name, as
+   * in wireDecodeLazy(Blob). This copies the input to keep for decoding the
+   * other fields.
+   * @param input The input byte array to be decoded.
+   * @param inputLength The length of input.
+   * @param wireFormat (optional) A WireFormat object used to decode the input.
+   * If omitted, use WireFormat::getDefaultWireFormat().
+   */
+  void
+  wireDecodeLazy
+    (const uint8_t *input, size_t inputLength,
+     WireFormat& wireFormat = *WireFormat::getDefaultWireFormat())
+  {
+    wireDecodeLazy(Blob(input, inputLength), wireFormat);
+  }
+
+  /**
+   * If wireDecodeLazy has not yet decoded the other fields, decode them now.
+   * Otherwise do nothing. Since the first access of a lazily decoded field
+   * changes this object, call this before a const reference to this Interest
+   * may be read from multiple threads.
+   */
+  void
+  decodeLazyFields() const
+  {
+    if (lazyWireFormat_)
+      const_cast<Interest*>(this)->finishLazyDecode();
+  }
+
   /**
    * Encode the name according to the "NDN URI Scheme".  If there are interest
    * selectors, append "?" and add the selectors as a query string.  For example
@@ -189,10 +240,18 @@ public:
   getName() const { return name_.get(); }
 
   int
-  getMinSuffixComponents() const { return minSuffixComponents_; }
+  getMinSuffixComponents() const
+  {
+    decodeLazyFields();
+    return minSuffixComponents_;
+  }
 
   int
-  getMaxSuffixComponents() const { return maxSuffixComponents_; }
+  getMaxSuffixComponents() const
+  {
+    decodeLazyFields();
+    return maxSuffixComponents_;
+  }
 
   /**
    * Get the CanBePrefix flag. If not specified, the default is true.
@@ -201,35 +260,64 @@ public:
   bool
   getCanBePrefix()
   {
+    decodeLazyFields();
     // Use the closest v0.2 semantics. CanBePrefix is the opposite of exact
     // match where MaxSuffixComponents is 1 (for the implicit digest).
     return maxSuffixComponents_ != 1;
   }
 
   const KeyLocator&
-  getKeyLocator() const { return keyLocator_.get(); }
+  getKeyLocator() const
+  {
+    decodeLazyFields();
+    return keyLocator_.get();
+  }
 
   KeyLocator&
-  getKeyLocator() { return keyLocator_.get(); }
+  getKeyLocator()
+  {
+    decodeLazyFields();
+    return keyLocator_.get();
+  }
 
   Exclude&
-  getExclude() { return exclude_.get(); }
+  getExclude()
+  {
+    decodeLazyFields();
+    return exclude_.get();
+  }
 
   const Exclude&
-  getExclude() const { return exclude_.get(); }
+  getExclude() const
+  {
+    decodeLazyFields();
+    return exclude_.get();
+  }
 
   int
-  getChildSelector() const { return childSelector_; }
+  getChildSelector() const
+  {
+    decodeLazyFields();
+    return childSelector_;
+  }
 
   /**
    * Return true if the content must be fresh. The default is true.
    * @return true if must be fresh, otherwise false.
    */
   bool
-  getMustBeFresh() const { return mustBeFresh_; }
+  getMustBeFresh() const
+  {
+    decodeLazyFields();
+    return mustBeFresh_;
+  }
 
   Milliseconds
-  getInterestLifetimeMilliseconds() const { return interestLifetimeMilliseconds_; }
+  getInterestLifetimeMilliseconds() const
+  {
+    decodeLazyFields();
+    return interestLifetimeMilliseconds_;
+  }
 
   /**
    * Return the nonce value from the incoming interest.  If you change any of the fields in this Interest object,
@@ -239,6 +327,7 @@ public:
   const Blob&
   getNonce() const
   {
+    decodeLazyFields();
     if (getNonceChangeCount_ != getChangeCount()) {
       // The values have changed, so the existing nonce is invalidated.
       // This method can be called on a const object, but we want to be able to update the default cached value.
@@ -255,10 +344,18 @@ public:
    * @return The forwarding hint as a DelegationSet.
    */
   DelegationSet&
-  getForwardingHint() { return forwardingHint_.get(); }
+  getForwardingHint()
+  {
+    decodeLazyFields();
+    return forwardingHint_.get();
+  }
 
   const DelegationSet&
-  getForwardingHint() const { return forwardingHint_.get(); }
+  getForwardingHint() const
+  {
+    decodeLazyFields();
+    return forwardingHint_.get();
+  }
 
   /**
    * Check if this interest has a link object (or a link wire encoding which
@@ -269,6 +366,7 @@ public:
   bool
   DEPRECATED_IN_NDN_CPP hasLink() const
   {
+    decodeLazyFields();
     return link_.get() || !linkWireEncoding_.isNull();
   }
 
@@ -306,7 +404,11 @@ public:
    * @deprecated Use getForwardingHint.
    */
   int
-  DEPRECATED_IN_NDN_CPP getSelectedDelegationIndex() const { return selectedDelegationIndex_; }
+  DEPRECATED_IN_NDN_CPP getSelectedDelegationIndex() const
+  {
+    decodeLazyFields();
+    return selectedDelegationIndex_;
+  }
 
   /**
    * Get the incoming face ID according to the incoming packet header.
@@ -338,6 +440,7 @@ public:
   Interest&
   setMinSuffixComponents(int minSuffixComponents)
   {
+    decodeLazyFields();
     minSuffixComponents_ = minSuffixComponents;
     ++changeCount_;
     return *this;
@@ -352,6 +455,7 @@ public:
   Interest&
   setMaxSuffixComponents(int maxSuffixComponents)
   {
+    decodeLazyFields();
     maxSuffixComponents_ = maxSuffixComponents;
     ++changeCount_;
     return *this;
@@ -366,6 +470,7 @@ public:
   Interest&
   setCanBePrefix(int canBePrefix)
   {
+    decodeLazyFields();
     // Use the closest v0.2 semantics. CanBePrefix is the opposite of exact
     // match where MaxSuffixComponents is 1 (for the implicit digest).
     maxSuffixComponents_ = (canBePrefix ? -1 : 1);
@@ -381,6 +486,7 @@ public:
   Interest&
   setChildSelector(int childSelector)
   {
+    decodeLazyFields();
     childSelector_ = childSelector;
     ++changeCount_;
     return *this;
@@ -395,6 +501,7 @@ public:
   Interest&
   setMustBeFresh(bool mustBeFresh)
   {
+    decodeLazyFields();
     mustBeFresh_ = mustBeFresh;
     ++changeCount_;
     return *this;
@@ -409,6 +516,7 @@ public:
   Interest&
   setInterestLifetimeMilliseconds(Milliseconds interestLifetimeMilliseconds)
   {
+    decodeLazyFields();
     interestLifetimeMilliseconds_ = interestLifetimeMilliseconds;
     ++changeCount_;
     return *this;
@@ -420,6 +528,7 @@ public:
   Interest&
   DEPRECATED_IN_NDN_CPP setNonce(const Blob& nonce)
   {
+    decodeLazyFields();
     nonce_ = nonce;
     // Set getNonceChangeCount_ so that the next call to getNonce() won't clear nonce_.
     ++changeCount_;
@@ -438,6 +547,7 @@ public:
   Interest&
   setKeyLocator(const KeyLocator& keyLocator)
   {
+    decodeLazyFields();
     keyLocator_ = keyLocator;
     ++changeCount_;
     return *this;
@@ -454,6 +564,7 @@ public:
   Interest&
   setExclude(const Exclude& exclude)
   {
+    decodeLazyFields();
     exclude_ = exclude;
     ++changeCount_;
     return *this;
@@ -472,6 +583,7 @@ public:
   Interest&
   setForwardingHint(const DelegationSet& forwardingHint)
   {
+    decodeLazyFields();
     forwardingHint_ = forwardingHint;
     ++changeCount_;
     return *this;
@@ -494,6 +606,7 @@ public:
     (Blob encoding,
      WireFormat& wireFormat = *WireFormat::getDefaultWireFormat())
   {
+    decodeLazyFields();
     linkWireEncoding_ = encoding;
     linkWireEncodingFormat_ = &wireFormat;
 
@@ -526,6 +639,7 @@ public:
   Interest&
   DEPRECATED_IN_NDN_CPP setSelectedDelegationIndex(int selectedDelegationIndex)
   {
+    decodeLazyFields();
     selectedDelegationIndex_ = selectedDelegationIndex;
     ++changeCount_;
     return *this;
@@ -627,6 +741,27 @@ public:
   }
 
 private:
+  friend class WireFormat;
+  friend class Tlv0_2WireFormat;
+
+  /**
+   * Decode lazyEncoding_ and set the fields other than the name, which the
+   * application may have changed. If the fields have not otherwise changed
+   * since wireDecodeLazy, keep the nonce and the default wire encoding.
+   */
+  void
+  finishLazyDecode();
+
+  /**
+   * Set the fields other than the name by copying from interestLite. This does
+   * not update getNonceChangeCount_.
+   * @param interestLite An InterestLite object.
+   * @param wireFormat The wire format of the link object, if any.
+   */
+  void
+  setFieldsExceptName
+    (const InterestLite& interestLite, WireFormat& wireFormat);
+
   void
   construct()
   {
@@ -637,6 +772,7 @@ private:
     interestLifetimeMilliseconds_ = -1.0;
     linkWireEncodingFormat_ = 0;
     selectedDelegationIndex_ = -1;
+    lazyWireFormat_ = 0;
   }
 
   void
@@ -671,6 +807,8 @@ private:
   uint64_t getDefaultWireEncodingChangeCount_;
   ptr_lib::shared_ptr<LpPacket> lpPacket_;
   uint64_t changeCount_;
+  Blob lazyEncoding_;
+  WireFormat* lazyWireFormat_; /**< 0 if the fields are already decoded */
 };
 
 }
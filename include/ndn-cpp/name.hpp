@@ -36,6 +36,9 @@ namespace ndn {
 
 /**
  * A Name holds an array of Name::Component and represents an NDN name.
+ * Copying a Name shares the array of components with the original, and the
+ * array is copied only when one of the names is changed (copy-on-write). An
+ * empty Name does not allocate the array.
  */
 class Name {
 public:
@@ -701,6 +704,14 @@ public:
     bool
     operator != (const Component& other) const { return !equals(other); }
 
+    /**
+     * Get a 64-bit hash of the type and value of this component, so that
+     * components which are equal by equals() have the same hash.
+     * @return The hash value.
+     */
+    uint64_t
+    getHash() const;
+
     /**
      * Compare this to the other Component using NDN canonical ordering.
      * @param other The other Component to compare with.
@@ -773,7 +784,7 @@ public:
    * Create a new Name with no components.
    */
   Name()
-  : changeCount_(0)
+  : changeCount_(0), hash_(EMPTY_HASH)
   {
   }
 
@@ -782,7 +793,8 @@ public:
    * @param components A vector of Component
    */
   Name(const std::vector<Component>& components)
-  : components_(components), changeCount_(0)
+  : components_(new std::vector<Component>(components)), changeCount_(0),
+    hash_(computeHash())
   {
   }
 
@@ -791,7 +803,7 @@ public:
    * @param uri The URI string.
    */
   Name(const char* uri)
-  : changeCount_(0)
+  : changeCount_(0), hash_(EMPTY_HASH)
   {
     set(uri);
   }
@@ -801,7 +813,7 @@ public:
    * @param uri The URI string.
    */
   Name(const std::string& uri)
-  : changeCount_(0)
+  : changeCount_(0), hash_(EMPTY_HASH)
   {
     set(uri.c_str());
   }
@@ -837,6 +849,17 @@ public:
   void
   set(const std::string& uri) { set(uri.c_str()); }
 
+  /**
+   * Parse many URIs according to the NDN URI Scheme. This is faster than
+   * creating each Name separately when the URIs have common components such as
+   * a shared prefix, because a component with the same text at the same index
+   * as in a previous URI is only parsed once and shares its value.
+   * @param uris The URIs to parse.
+   * @param names Set this to a Name for each URI, in the same order.
+   */
+  static void
+  fromUris(const std::vector<std::string>& uris, std::vector<Name>& names);
+
   /**
    * Append a new component, copying from value of length valueLength.
    * (To append an ImplicitSha256Digest component, use appendImplicitSha256Digest.)
@@ -923,8 +946,9 @@ public:
   Name&
   append(const Component &value)
   {
-    components_.push_back(value);
+    getMutableComponents().push_back(value);
     ++changeCount_;
+    hash_ = updateHash(hash_, value);
     return *this;
   }
 
@@ -1051,8 +1075,10 @@ public:
    */
   void
   clear() {
-    components_.clear();
+    // Release the components, which may be shared with another Name.
+    components_.reset();
     ++changeCount_;
+    hash_ = EMPTY_HASH;
   }
 
   /**
@@ -1089,7 +1115,7 @@ public:
   Name
   getSubName(int iStartComponent) const
   {
-    return getSubName(iStartComponent, components_.size());
+    return getSubName(iStartComponent, size());
   }
 
   /**
@@ -1102,7 +1128,7 @@ public:
   getPrefix(int nComponents) const
   {
     if (nComponents < 0)
-      return getSubName(0, components_.size() + nComponents);
+      return getSubName(0, size() + nComponents);
     else
       return getSubName(0, nComponents);
   }
@@ -1118,6 +1144,23 @@ public:
   std::string
   toUri(bool includeScheme = false) const;
 
+  /**
+   * Encode this name as a URI into the caller's buffer, without allocating
+   * memory. This is like snprintf: if the URI and its null terminator fit in
+   * the buffer, write them. Otherwise, don't write anything. In either case,
+   * return the length of the URI so that the caller can check if it fit and
+   * allocate a larger buffer if needed.
+   * @param buffer The buffer to write the null-terminated URI.
+   * @param bufferLength The length of the buffer.
+   * @param includeScheme (optional) If true, include the "ndn:" scheme in the
+   * URI. If omitted, just write the path.
+   * @return The length of the URI, not counting the null terminator. If this is
+   * not less than bufferLength, then the buffer was too small and nothing was
+   * written.
+   */
+  size_t
+  toUri(char* buffer, size_t bufferLength, bool includeScheme = false) const;
+
   /**
    * @deprecated Use toUri().
    */
@@ -1402,7 +1445,7 @@ public:
    * @return The number of components.
    */
   size_t
-  size() const { return components_.size(); }
+  size() const { return components_ ? components_->size() : 0; }
 
   /**
    * Encode this Name for a particular wire format.
@@ -1474,6 +1517,16 @@ public:
   uint64_t
   getChangeCount() const { return changeCount_; }
 
+  /**
+   * Get a 64-bit hash of the component values of this name, so that names
+   * which are equal by equals() have the same hash. The hash is updated each
+   * time the name is changed, so this only reads it and threads can call this
+   * on a shared const Name.
+   * @return The hash value.
+   */
+  uint64_t
+  getHash() const { return hash_; }
+
   /**
    * Compare this to the other Name using NDN canonical ordering. If the first
    * components of each name are not equal, this returns -1 if the first comes
@@ -1496,7 +1549,7 @@ public:
   int
   compare(const Name& other) const
   {
-    return compare(0, components_.size(), other);
+    return compare(0, size(), other);
   }
 
   /**
@@ -1548,7 +1601,7 @@ public:
   {
     return compare
       (iStartComponent, nComponents, other, iOtherStartComponent,
-       other.components_.size());
+       other.size());
   }
 
   const Component&
@@ -1644,25 +1697,25 @@ public:
    * Begin iterator (const).
    */
   const_iterator
-  begin() const { return components_.begin(); }
+  begin() const { return getComponents().begin(); }
 
   /**
    * End iterator (const).
    */
   const_iterator
-  end() const { return components_.end(); }
+  end() const { return getComponents().end(); }
 
   /**
    * Reverse begin iterator (const).
    */
   const_reverse_iterator
-  rbegin() const { return components_.rbegin(); }
+  rbegin() const { return getComponents().rbegin(); }
 
   /**
    * Reverse end iterator (const).
    */
   const_reverse_iterator
-  rend() const { return components_.rend(); }
+  rend() const { return getComponents().rend(); }
 
 private:
   /**
@@ -1673,8 +1726,50 @@ private:
   void
   checkAppendOtherTypeCode(int otherTypeCode);
 
-  std::vector<Component> components_;
+  /**
+   * Get the components array, or an empty array if components_ is null.
+   * @return The components array.
+   */
+  const std::vector<Component>&
+  getComponents() const
+  {
+    return components_ ? *components_ : getEmptyComponents();
+  }
+
+  /**
+   * Get the components array to modify. If it is shared with another Name,
+   * first replace components_ with a copy.
+   * @return The components array.
+   */
+  std::vector<Component>&
+  getMutableComponents();
+
+  /**
+   * Compute the hash for getHash() from all the components.
+   * @return The hash value.
+   */
+  uint64_t
+  computeHash() const;
+
+  /**
+   * Update the hash for getHash() with the component which is appended.
+   * @param hash The hash of the name before appending.
+   * @param component The appended component.
+   * @return The updated hash.
+   */
+  static uint64_t
+  updateHash(uint64_t hash, const Component& component);
+
+  // The hash of a Name with no components, which is the FNV-1a offset basis.
+  static const uint64_t EMPTY_HASH = 14695981039346656037ULL;
+
+  static const std::vector<Component>&
+  getEmptyComponents();
+
+  // If null, this Name has no components.
+  ptr_lib::shared_ptr<std::vector<Component> > components_;
   uint64_t changeCount_;
+  uint64_t hash_;
 };
 
 inline std::ostream&
@@ -1686,5 +1781,28 @@ operator << (std::ostream& os, const Name& name)
 
 }
 
+#if NDN_CPP_HAVE_STD_UNORDERED_MAP
+#include <functional>
+
+// Define std::hash so that Name and Name::Component can be the key of
+// std::unordered_map, etc.
+namespace std {
+
+template<> struct hash<ndn::Name> {
+  size_t
+  operator() (const ndn::Name& name) const { return (size_t)name.getHash(); }
+};
+
+template<> struct hash<ndn::Name::Component> {
+  size_t
+  operator() (const ndn::Name::Component& component) const
+  {
+    return (size_t)component.getHash();
+  }
+};
+
+}
+#endif
+
 #endif
 
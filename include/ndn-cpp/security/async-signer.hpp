@@ -0,0 +1,224 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2018 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+#ifndef NDN_ASYNC_SIGNER_HPP
+#define NDN_ASYNC_SIGNER_HPP
+
+// Only compile if ndn-cpp-config.h defines NDN_CPP_HAVE_BOOST_ASIO.
+#include "../ndn-cpp-config.h"
+#ifdef NDN_CPP_HAVE_BOOST_ASIO
+
+#include <boost/asio.hpp>
+#include "key-chain.hpp"
+
+namespace ndn {
+
+class TpmKeyHandle;
+
+/**
+ * An AsyncSigner uses a KeyChain and Boost asio io_services to sign without
+ * waiting for the TPM. The key is found in the calling thread, then the TPM
+ * operation is posted to a worker io_service and the result is delivered in a
+ * result io_service. For example, a producer can pass the io_service of its
+ * ThreadsafeFace as resultService so that it keeps answering Interests from
+ * its cache while a slow TPM signs a new packet. It is the responsibility of
+ * the application to start and stop the services.
+ * The key handles of TpmBackEndMemory and TpmBackEndFile can sign from multiple
+ * threads. The key handles of other TPM back ends may not be thread safe, so
+ * for other TPMs run workerService in one thread.
+ */
+class AsyncSigner {
+public:
+  /**
+   * An OnSignResult function object is called as onSignResult(signature) when
+   * the TPM has signed, where signature is the signature Blob.
+   */
+  typedef func_lib::function<void(const Blob& signature)> OnSignResult;
+
+  /**
+   * An OnSignError function object is called as onSignError(errorMessage) if
+   * the key does not exist or the TPM fails to sign.
+   */
+  typedef func_lib::function<void
+    (const std::string& errorMessage)> OnSignError;
+
+  /**
+   * An OnDataSigned function object is called as onSigned(data) when the Data
+   * packet is signed.
+   */
+  typedef func_lib::function<void
+    (const ptr_lib::shared_ptr<Data>& data)> OnDataSigned;
+
+  /**
+   * An OnDataSignError function object is called as
+   * onSignError(data, errorMessage) if the TPM fails to sign the Data packet.
+   */
+  typedef func_lib::function<void
+    (const ptr_lib::shared_ptr<Data>& data,
+     const std::string& errorMessage)> OnDataSignError;
+
+  /**
+   * Create an AsyncSigner to use the keyChain and post tasks to the services.
+   * @param keyChain The security v2 KeyChain for finding the signing key. This
+   * only uses the KeyChain from the thread which calls sign().
+   * @param workerService The asio io_service for the signing tasks.
+   * @param resultService The asio io_service for calling the callbacks. This
+   * may be the same as workerService.
+   * @throws KeyChain::Error if keyChain is a security v1 KeyChain.
+   */
+  AsyncSigner
+    (KeyChain& keyChain, boost::asio::io_service& workerService,
+     boost::asio::io_service& resultService);
+
+  /**
+   * Sign the Data packet according to the supplied signing parameters. This
+   * finds the key, sets the SignatureInfo and encodes the packet in the calling
+   * thread, then posts the signing to workerService and returns immediately.
+   * When the signature is ready, this sets it, encodes the packet again and
+   * calls onSigned in resultService. If the TPM fails to sign, this calls
+   * onSignError instead and the packet is not changed further. The application
+   * must not access the Data object or delete the signing key until onSigned
+   * or onSignError is called.
+   * @param data The Data object to be signed. This replaces its Signature
+   * object based on the type of key and other info in the SigningInfo params,
+   * and updates the wireEncoding.
+   * @param params The signing parameters.
+   * @param onSigned When the packet is signed, this calls onSigned(data).
+   * NOTE: The library will log any exceptions thrown by this callback, but for
+   * better error handling the callback should catch and properly handle any
+   * exceptions.
+   * @param onSignError If the TPM fails to sign, this calls
+   * onSignError(data, errorMessage).
+   * NOTE: The library will log any exceptions thrown by this callback, but for
+   * better error handling the callback should catch and properly handle any
+   * exceptions.
+   * @param wireFormat (optional) A WireFormat object used to encode the input.
+   * If omitted, use WireFormat getDefaultWireFormat().
+   * @throws KeyChain::Error if the signing key does not exist in the TPM.
+   * @throws KeyChain::InvalidSigningInfoError if params is invalid, or if the
+   * identity, key or certificate specified in params does not exist.
+   */
+  void
+  sign
+    (const ptr_lib::shared_ptr<Data>& data, const SigningInfo& params,
+     const OnDataSigned& onSigned, const OnDataSignError& onSignError,
+     WireFormat& wireFormat = *WireFormat::getDefaultWireFormat());
+
+  /**
+   * Find the key with name keyName in the TPM of the KeyChain in the calling
+   * thread, then post a task to workerService to compute a digital signature of
+   * data and return immediately. When finished, post a call to onSignResult or
+   * onSignError to resultService.
+   * @param data The input byte array.
+   * @param keyName The name of the key.
+   * @param digestAlgorithm The digest algorithm for the signature.
+   * @param onSignResult This calls onSignResult(signature) with the signature
+   * Blob.
+   * NOTE: The library will log any exceptions thrown by this callback, but for
+   * better error handling the callback should catch and properly handle any
+   * exceptions.
+   * @param onSignError This calls onSignError(errorMessage) if the key does not
+   * exist, for an unrecognized digestAlgorithm or if the key fails to sign.
+   * NOTE: The library will log any exceptions thrown by this callback, but for
+   * better error handling the callback should catch and properly handle any
+   * exceptions.
+   */
+  void
+  sign
+    (const Blob& data, const Name& keyName, DigestAlgorithm digestAlgorithm,
+     const OnSignResult& onSignResult, const OnSignError& onSignError);
+
+  /**
+   * Post a task to workerService to compute a digital signature of data using
+   * keyHandle, and return immediately. When finished, post a call to
+   * onSignResult or onSignError to resultService. The application must not
+   * delete the key until one of the callbacks is called.
+   * @param keyHandle The TPM key handle.
+   * @param digestAlgorithm The digest algorithm.
+   * @param data The input byte array.
+   * @param onSignResult This calls onSignResult(signature) with the signature
+   * Blob.
+   * NOTE: The library will log any exceptions thrown by this callback, but for
+   * better error handling the callback should catch and properly handle any
+   * exceptions.
+   * @param onSignError This calls onSignError(errorMessage) for an unrecognized
+   * digestAlgorithm or if the key fails to sign.
+   * NOTE: The library will log any exceptions thrown by this callback, but for
+   * better error handling the callback should catch and properly handle any
+   * exceptions.
+   */
+  void
+  sign
+    (const TpmKeyHandle& keyHandle, DigestAlgorithm digestAlgorithm,
+     const Blob& data, const OnSignResult& onSignResult,
+     const OnSignError& onSignError);
+
+private:
+  /**
+   * Sign the data with the key handle and post the result to resultService.
+   * This runs in a thread of the workerService.
+   */
+  static void
+  signTask
+    (const TpmKeyHandle* keyHandle, DigestAlgorithm digestAlgorithm,
+     const Blob& data, boost::asio::io_service* resultService,
+     const OnSignResult& onSignResult, const OnSignError& onSignError);
+
+  /**
+   * Set the signature of the Data packet, encode it again and call onSigned.
+   * This is called in the resultService.
+   */
+  static void
+  finishDataSign
+    (const ptr_lib::shared_ptr<Data>& data, WireFormat* wireFormat,
+     const OnDataSigned& onSigned, const Blob& signature);
+
+  /**
+   * Call onSignError(data, errorMessage). This is called in the resultService.
+   */
+  static void
+  failDataSign
+    (const ptr_lib::shared_ptr<Data>& data, const OnDataSignError& onSignError,
+     const std::string& errorMessage);
+
+  /**
+   * Call onSignResult(signature) and log any exception that it throws.
+   */
+  static void
+  deliverSignResult(const OnSignResult& onSignResult, const Blob& signature);
+
+  /**
+   * Call onSignError(errorMessage) and log any exception that it throws.
+   */
+  static void
+  deliverSignError
+    (const OnSignError& onSignError, const std::string& errorMessage);
+
+  KeyChain& keyChain_;
+  boost::asio::io_service& workerService_;
+  boost::asio::io_service& resultService_;
+};
+
+}
+
+#endif // NDN_CPP_HAVE_BOOST_ASIO
+
+#endif
@@ -0,0 +1,152 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2018 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+#ifndef NDN_BATCH_SIGNER_HPP
+#define NDN_BATCH_SIGNER_HPP
+
+// Only compile if ndn-cpp-config.h defines NDN_CPP_HAVE_BOOST_ASIO.
+#include "../ndn-cpp-config.h"
+#ifdef NDN_CPP_HAVE_BOOST_ASIO
+
+#include <boost/asio.hpp>
+#include "key-chain.hpp"
+
+namespace ndn {
+
+/**
+ * A BatchSigner uses a KeyChain and a Boost asio io_service to sign many Data
+ * packets in parallel. The signing key and SignatureInfo are found once in the
+ * calling thread, then the packets are split into tasks which are posted to the
+ * io_service, where all tasks share the same immutable TPM key handle. The
+ * number of threads which call ioService.run() sets the number of packets
+ * signed at the same time. It is the responsibility of the application to start
+ * and stop the service.
+ * The key handles of TpmBackEndMemory and TpmBackEndFile can sign from multiple
+ * threads. The key handles of other TPM back ends may not be thread safe, so
+ * for other TPMs run the io_service in one thread.
+ */
+class BatchSigner {
+public:
+  /**
+   * An OnSigned function object is called when all the packets in a batch are
+   * signed, as onSigned(dataList) where dataList is the list given to sign(),
+   * in the same order. This is called from one of the threads running the
+   * io_service.
+   */
+  typedef func_lib::function<void
+    (const std::vector<ptr_lib::shared_ptr<Data> >& dataList)> OnSigned;
+
+  /**
+   * An OnSignError function object is called instead of OnSigned if the TPM
+   * fails to sign any packet in a batch, as
+   * onSignError(failedDataList, errorMessage) where failedDataList has the
+   * packets which are not signed, in the order of the list given to sign(), and
+   * errorMessage is the error of the first one. This is called from one of the
+   * threads running the io_service.
+   */
+  typedef func_lib::function<void
+    (const std::vector<ptr_lib::shared_ptr<Data> >& failedDataList,
+     const std::string& errorMessage)> OnSignError;
+
+  /**
+   * Create a BatchSigner to use the keyChain and post tasks to the ioService.
+   * @param keyChain The KeyChain for finding the signing key. This only uses
+   * the KeyChain from the thread which calls sign().
+   * @param ioService The asio io_service. It is the responsibility of the
+   * application to start and stop the service.
+   * @param maxTaskSize (optional) The maximum number of packets which one
+   * posted task signs. If omitted, use getDefaultMaxTaskSize().
+   */
+  BatchSigner
+    (KeyChain& keyChain, boost::asio::io_service& ioService,
+     size_t maxTaskSize = getDefaultMaxTaskSize());
+
+  /**
+   * Sign each Data packet in dataList according to the supplied signing
+   * parameters, spreading the work across the threads running the io_service.
+   * This finds the key and sets the SignatureInfo of each packet in the calling
+   * thread, then each task signs and encodes its own packets. The application
+   * must not access the Data objects or delete the signing key until onSigned
+   * or onSignError is called.
+   * @param dataList The Data packets to sign. This replaces the Signature
+   * object of each packet and updates its wireEncoding.
+   * @param params The signing parameters.
+   * @param onSigned When all packets are signed, this calls onSigned(dataList).
+   * NOTE: The library will log any exceptions thrown by this callback, but for
+   * better error handling the callback should catch and properly handle any
+   * exceptions.
+   * @param onSignError If the TPM fails to sign any packet, this calls
+   * onSignError(failedDataList, errorMessage) instead of onSigned. The failed
+   * packets have an empty signature value and must not be published.
+   * NOTE: The library will log any exceptions thrown by this callback, but for
+   * better error handling the callback should catch and properly handle any
+   * exceptions.
+   * @param wireFormat (optional) A WireFormat object used to encode the Data
+   * packets. If omitted, use WireFormat getDefaultWireFormat().
+   * @throws KeyChain::Error if the signing key does not exist in the TPM.
+   * @throws KeyChain::InvalidSigningInfoError if params is invalid, or if the
+   * identity, key or certificate specified in params does not exist.
+   */
+  void
+  sign
+    (const std::vector<ptr_lib::shared_ptr<Data> >& dataList,
+     const SigningInfo& params, const OnSigned& onSigned,
+     const OnSignError& onSignError,
+     WireFormat& wireFormat = *WireFormat::getDefaultWireFormat());
+
+  /**
+   * Get the default maximum number of packets in one posted task.
+   * @return The default maximum task size.
+   */
+  static size_t
+  getDefaultMaxTaskSize() { return 16; }
+
+private:
+  class Batch;
+
+  /**
+   * Sign and encode the packets of the batch in the range [begin, end). This
+   * is a ParallelTasks task.
+   * @param batch The batch with the packets and key handle.
+   * @param begin The index of the first packet to sign.
+   * @param end The index after the last packet to sign.
+   */
+  static void
+  signTask(const ptr_lib::shared_ptr<Batch>& batch, size_t begin, size_t end);
+
+  /**
+   * Call onSigned for the finished batch, or onSignError if any packet failed.
+   * This is called after the last task of the batch.
+   * @param batch The finished batch.
+   */
+  static void
+  finish(const ptr_lib::shared_ptr<Batch>& batch);
+
+  KeyChain& keyChain_;
+  boost::asio::io_service& ioService_;
+  size_t maxTaskSize_;
+};
+
+}
+
+#endif // NDN_CPP_HAVE_BOOST_ASIO
+
+#endif
@@ -0,0 +1,129 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2018 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+#ifndef NDN_BATCH_VERIFIER_HPP
+#define NDN_BATCH_VERIFIER_HPP
+
+// Only compile if ndn-cpp-config.h defines NDN_CPP_HAVE_BOOST_ASIO.
+#include "../ndn-cpp-config.h"
+#ifdef NDN_CPP_HAVE_BOOST_ASIO
+
+#include <boost/asio.hpp>
+#include "../data.hpp"
+
+namespace ndn {
+
+/**
+ * A BatchVerifier uses a Boost asio io_service to verify the signatures of
+ * many Data packets in parallel. The packets are grouped by public key so that
+ * each key is decoded only once, and each group is split into tasks which are
+ * posted to the io_service. The number of threads which call ioService.run()
+ * sets the number of packets verified at the same time. It is the
+ * responsibility of the application to start and stop the service.
+ */
+class BatchVerifier {
+public:
+  /**
+   * An OnVerified function object is called when all the packets in a batch
+   * are verified, as onVerified(results) where results[i] is true if the i-th
+   * packet is verified. This is called from one of the threads running the
+   * io_service.
+   */
+  typedef func_lib::function<void(const std::vector<bool>& results)>
+    OnVerified;
+
+  /**
+   * Create a BatchVerifier to post tasks to the ioService.
+   * @param ioService The asio io_service. It is the responsibility of the
+   * application to start and stop the service.
+   * @param maxTaskSize (optional) The maximum number of packets which one
+   * posted task verifies. A smaller value spreads the work more evenly across
+   * threads. If omitted, use getDefaultMaxTaskSize().
+   */
+  BatchVerifier
+    (boost::asio::io_service& ioService,
+     size_t maxTaskSize = getDefaultMaxTaskSize());
+
+  /**
+   * Verify each Data packet in dataList using the DER-encoded public key at the
+   * same index in publicKeyDerList, spreading the work across the threads
+   * running the io_service. This encodes the packets and decodes the keys in
+   * the calling thread before posting the tasks, so the Data objects are not
+   * accessed by the other threads. This does not check the type of public key
+   * against the type of SignatureInfo in each Data packet.
+   * @param dataList The Data packets to verify.
+   * @param publicKeyDerList The DER-encoded public keys, where
+   * publicKeyDerList[i] is used to verify dataList[i].
+   * @param onVerified When all packets are verified, this calls
+   * onVerified(results) where results[i] is true if dataList[i] is verified,
+   * or false if verification fails or for an error encoding the packet or
+   * decoding its public key.
+   * NOTE: The library will log any exceptions thrown by this callback, but for
+   * better error handling the callback should catch and properly handle any
+   * exceptions.
+   * @param wireFormat (optional) A WireFormat object used to encode the Data
+   * packets. If omitted, use WireFormat getDefaultWireFormat().
+   * @throws invalid_argument if publicKeyDerList does not have the same size
+   * as dataList.
+   */
+  void
+  verifyDataSignatures
+    (const std::vector<ptr_lib::shared_ptr<Data> >& dataList,
+     const std::vector<Blob>& publicKeyDerList, const OnVerified& onVerified,
+     WireFormat& wireFormat = *WireFormat::getDefaultWireFormat());
+
+  /**
+   * Get the default maximum number of packets in one posted task.
+   * @return The default maximum task size.
+   */
+  static size_t
+  getDefaultMaxTaskSize() { return 32; }
+
+private:
+  class Batch;
+
+  /**
+   * Verify the packets of the batch at the given indexes. This is a
+   * ParallelTasks task.
+   * @param batch The batch with the encodings, keys and results.
+   * @param begin The index in batch->indexes_ of the first packet to verify.
+   * @param end The index in batch->indexes_ after the last packet to verify.
+   */
+  static void
+  verifyTask(const ptr_lib::shared_ptr<Batch>& batch, size_t begin, size_t end);
+
+  /**
+   * Convert the results of the batch and call onVerified. This is called after
+   * the last task of the batch.
+   * @param batch The finished batch.
+   */
+  static void
+  finish(const ptr_lib::shared_ptr<Batch>& batch);
+
+  boost::asio::io_service& ioService_;
+  size_t maxTaskSize_;
+};
+
+}
+
+#endif // NDN_CPP_HAVE_BOOST_ASIO
+
+#endif
@@ -24,15 +24,20 @@
 #define NDN_FILE_PRIVATE_KEY_STORAGE_HPP
 
 #include <string>
+#include <map>
 #include "private-key-storage.hpp"
 
 namespace ndn {
 
 class DerNode;
+class TpmPrivateKey;
+class FileStatus;
 
 /**
  * FilePrivateKeyStorage extends PrivateKeyStorage to implement private key
- * storage using files.
+ * storage using files. The keys which are decoded from the files are cached in
+ * memory so that signing again with the same key only needs to check that the
+ * key file has not changed, by its modification time, size and inode number.
  */
 class FilePrivateKeyStorage : public PrivateKeyStorage {
 public:
@@ -125,6 +130,35 @@ public:
   doesKeyExist(const Name& keyName, KeyClass keyClass);
 
 private:
+  /**
+   * A CachedKeyFile has the path of a key file, its status when it was read and
+   * the key which was decoded from it. Only one of privateKey_ or publicKey_ is
+   * used, depending on the type of file.
+   */
+  class CachedKeyFile {
+  public:
+    std::string filePath_;
+    ptr_lib::shared_ptr<FileStatus> status_;
+    ptr_lib::shared_ptr<TpmPrivateKey> privateKey_;
+    ptr_lib::shared_ptr<PublicKey> publicKey_;
+  };
+
+  typedef std::map<Name, CachedKeyFile> KeyFileCache;
+
+  /**
+   * Find the entry in the cache for keyName and check that the key file has
+   * not changed. If the entry is new or the file has changed, reset the key in
+   * the entry so that the caller decodes the file again.
+   * @param cache The cache, either privateKeyCache_ or publicKeyCache_.
+   * @param keyName The name of the key.
+   * @param extension The extension of the key file, ".pri" or ".pub".
+   * @return A pointer to the cache entry, or null if the key file doesn't
+   * exist. The pointer is invalidated by the next change to the cache.
+   */
+  CachedKeyFile*
+  getCachedKeyFile
+    (KeyFileCache& cache, const Name& keyName, const std::string& extension);
+
   std::string
   nameTransform(const std::string& keyName, const std::string& extension);
 
@@ -138,6 +172,8 @@ private:
   maintainMapping(const std::string& keyName);
 
   std::string keyStorePath_;
+  KeyFileCache privateKeyCache_;
+  KeyFileCache publicKeyCache_;
 };
 
 }
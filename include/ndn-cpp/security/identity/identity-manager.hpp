@@ -23,6 +23,7 @@
 #ifndef NDN_IDENTITY_MANAGER_HPP
 #define NDN_IDENTITY_MANAGER_HPP
 
+#include <map>
 #include "../certificate/identity-certificate.hpp"
 #include "../../interest.hpp"
 #include "identity-storage.hpp"
@@ -164,19 +165,18 @@ public:
   void
   setDefaultIdentity(const Name& identityName)
   {
+    clearDefaultCertificateNameCache();
     identityStorage_->setDefaultIdentity(identityName);
   }
 
   /**
-   * Get the default identity.
+   * Get the default identity. This caches the result. See
+   * clearDefaultCertificateNameCache().
    * @return The name of default identity.
    * @throws SecurityException if the default identity is not set.
    */
   Name
-  getDefaultIdentity()
-  {
-    return identityStorage_->getDefaultIdentity();
-  }
+  getDefaultIdentity();
 
   /**
    * Get the certificate of the default identity.
@@ -223,6 +223,7 @@ public:
   void
   setDefaultKeyForIdentity(const Name& keyName, const Name& identityNameCheck = Name())
   {
+    clearDefaultCertificateNameCache();
     identityStorage_->setDefaultKeyNameForIdentity(keyName, identityNameCheck);
   }
 
@@ -308,6 +309,7 @@ public:
   void
   addCertificate(const IdentityCertificate& certificate)
   {
+    clearDefaultCertificateNameCache();
     identityStorage_->addCertificate(certificate);
   }
 
@@ -345,16 +347,14 @@ public:
 
   /**
    * Get the default certificate name for the specified identity, which will be used when signing is performed based on identity.
+   * This caches the result. See clearDefaultCertificateNameCache().
    * @param identityName The name of the specified identity.
    * @return The requested certificate name.
    * @throws SecurityException if the default key name for the identity is not
    * set or the default certificate name for the key name is not set.
    */
   Name
-  getDefaultCertificateNameForIdentity(const Name& identityName)
-  {
-    return identityStorage_->getDefaultCertificateNameForIdentity(identityName);
-  }
+  getDefaultCertificateNameForIdentity(const Name& identityName);
 
   /**
    * Get the default certificate name of the default identity, which will be used when signing is based on identity and
@@ -367,7 +367,23 @@ public:
   Name
   getDefaultCertificateName()
   {
-    return identityStorage_->getDefaultCertificateNameForIdentity(getDefaultIdentity());
+    return getDefaultCertificateNameForIdentity(getDefaultIdentity());
+  }
+
+  /**
+   * Clear the cache of the default identity and the default certificate names
+   * which is used by getDefaultIdentity() and
+   * getDefaultCertificateNameForIdentity() so that signing doesn't query the
+   * identity storage each time. The methods of this IdentityManager which
+   * change the identity storage clear the cache, but if the application or
+   * another process changes a default directly in the identity storage, the
+   * application must call this.
+   */
+  void
+  clearDefaultCertificateNameCache()
+  {
+    haveDefaultIdentity_ = false;
+    defaultCertificateNames_.clear();
   }
 
   /**
@@ -547,6 +563,11 @@ private:
 
   ptr_lib::shared_ptr<IdentityStorage> identityStorage_;
   ptr_lib::shared_ptr<PrivateKeyStorage> privateKeyStorage_;
+  // defaultIdentity_ is only valid if haveDefaultIdentity_ is true.
+  Name defaultIdentity_;
+  bool haveDefaultIdentity_;
+  // The key is the identity name and the value is its default certificate name.
+  std::map<Name, Name> defaultCertificateNames_;
 };
 
 }
@@ -295,7 +295,8 @@ public:
 
   /**
    * Wire encode the Data object, sign it according to the supplied signing
-   * parameters, and set its signature.
+   * parameters, and set its signature. To sign without waiting for a slow TPM,
+   * see AsyncSigner.
    * @param data The Data object to be signed. This replaces its Signature
    * object based on the type of key and other info in the SigningInfo params,
    * and updates the wireEncoding.
@@ -333,6 +334,53 @@ public:
     sign(data, getDefaultSigningInfo(), wireFormat);
   }
 
+  /**
+   * Wire encode each Data object in dataList, sign it according to the supplied
+   * signing parameters, and set its signature. This is the same as calling
+   * sign(data, params, wireFormat) for each Data object, except that the
+   * signing key and SignatureInfo are found only once. To sign in parallel
+   * using multiple threads, see BatchSigner.
+   * @param dataList The Data objects to be signed. This replaces the Signature
+   * object of each one based on the type of key and other info in the
+   * SigningInfo params, and updates the wireEncoding.
+   * @param params The signing parameters.
+   * @param wireFormat (optional) A WireFormat object used to encode the input.
+   * If omitted, use WireFormat getDefaultWireFormat().
+   * @throws KeyChain::Error if signing fails.
+   * @throws KeyChain::InvalidSigningInfoError if params is invalid, or if the
+   * identity, key or certificate specified in params does not exist.
+   */
+  void
+  sign(const std::vector<ptr_lib::shared_ptr<Data> >& dataList,
+       const SigningInfo& params,
+       WireFormat& wireFormat = *WireFormat::getDefaultWireFormat());
+
+  /**
+   * Sign all the Data objects in dataList with one aggregate signature. Set the
+   * signature of each Data object to a MerkleSignature with the KeyLocator and
+   * ValidityPeriod from the SigningInfo params, compute a Merkle tree over the
+   * signed portions, and sign only the root with the key. The signature bytes
+   * of each Data object have the root signature and the authentication path of
+   * its leaf, so that it can be verified by itself with
+   * VerificationHelpers::verifyDataSignature. This needs one signing operation
+   * for the whole list plus a few SHA-256 operations per packet.
+   * @param dataList The Data objects to be signed. This replaces the Signature
+   * object of each one and updates the wireEncoding.
+   * @param params The signing parameters. This must specify a signing key
+   * (not SIGNER_TYPE_SHA256).
+   * @param wireFormat (optional) A WireFormat object used to encode the input.
+   * If omitted, use WireFormat getDefaultWireFormat().
+   * @throws KeyChain::Error if signing fails.
+   * @throws KeyChain::InvalidSigningInfoError if params is invalid, or if the
+   * identity, key or certificate specified in params does not exist.
+   * @note This is an experimental feature. See MerkleSignature.
+   */
+  void
+  signWithMerkleTree
+    (const std::vector<ptr_lib::shared_ptr<Data> >& dataList,
+     const SigningInfo& params,
+     WireFormat& wireFormat = *WireFormat::getDefaultWireFormat());
+
   /**
    * Sign Interest according to the supplied signing parameters. Append a
    * SignatureInfo to the Interest name, sign the encoded name components and
@@ -1098,6 +1146,9 @@ public:
 
 private:
   friend class CommandInterestSigner;
+  friend class AsyncSigner;
+  friend class BatchSigner;
+  friend class GroupManager;
 
   /**
    * Do the work of the constructor to create a KeyChain from the given locators.
@@ -1207,6 +1258,18 @@ private:
   sign(const uint8_t* buffer, size_t bufferLength, const Name& keyName,
        DigestAlgorithm digestAlgorithm) const;
 
+  /**
+   * Get the TPM key handle of the key with name keyName, so that AsyncSigner,
+   * BatchSigner and GroupManager can sign with the same key handle from
+   * multiple threads.
+   * @param keyName The name of the key from prepareSignatureInfo.
+   * @return A pointer to the key handle which is owned by the TPM, or null if
+   * keyName is SigningInfo::getDigestSha256Identity().
+   * @throws KeyChain::Error if the key does not exist in the TPM.
+   */
+  const TpmKeyHandle*
+  findSigningKeyHandle(const Name& keyName) const;
+
   static const SigningInfo&
   getDefaultSigningInfo();
 
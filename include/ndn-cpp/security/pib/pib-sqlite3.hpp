@@ -36,6 +36,8 @@ struct sqlite3;
 
 namespace ndn {
 
+class Sqlite3StatementCache;
+
 /**
  * PibSqlite3 extends PibImpl and is used by the Pib class as an implementation
  * of a PIB based on an SQLite3 database. All the contents in the PIB are stored
@@ -288,6 +290,34 @@ public:
   virtual ptr_lib::shared_ptr<CertificateV2>
   getDefaultCertificateOfKey(const Name& keyName) const;
 
+  /**
+   * Begin a transaction so that the following changes to the PIB are written
+   * to the database together by commitTransaction(). Adding many identities,
+   * keys or certificates in one transaction is much faster than writing each
+   * change separately.
+   * @throws PibImpl::Error if a transaction is already in progress or other
+   * database error.
+   */
+  void
+  beginTransaction();
+
+  /**
+   * Commit the transaction started by beginTransaction().
+   * @throws PibImpl::Error if there is no transaction in progress or other
+   * database error.
+   */
+  void
+  commitTransaction();
+
+  /**
+   * Roll back the transaction started by beginTransaction() to discard the
+   * changes since then.
+   * @throws PibImpl::Error if there is no transaction in progress or other
+   * database error.
+   */
+  void
+  rollbackTransaction();
+
   /**
    * Get the default that the constructor uses if databaseDirectoryPath is
    * omitted. This does not try to create the directory.
@@ -322,6 +352,7 @@ private:
   PibSqlite3& operator=(const PibSqlite3& other);
 
   struct sqlite3 *database_;
+  ptr_lib::shared_ptr<Sqlite3StatementCache> statementCache_;
 };
 
 }
@@ -25,6 +25,7 @@
 
 #include <float.h>
 #include <map>
+#include <list>
 #include "../../interest.hpp"
 #include "certificate-v2.hpp"
 
@@ -33,7 +34,8 @@ namespace ndn {
 /**
  * A CertificateCacheV2 holds other user's verified certificates in security v2
  * format CertificateV2. A certificate is removed no later than its NotAfter
- * time, or maxLifetime after it has been added to the cache.
+ * time, or maxLifetime after it has been added to the cache. If the cache is
+ * full when inserting, the least recently used certificate is removed.
  */
 class CertificateCacheV2 {
 public:
@@ -42,8 +44,12 @@ public:
    * @param maxLifetimeMilliseconds (optional) The maximum time that
    * certificates can live inside the cache, in milliseconds. If omitted, use
    * getDefaultLifetime().
+   * @param capacity (optional) The maximum number of certificates in the
+   * cache. If omitted, use getDefaultCapacity().
    */
-  CertificateCacheV2(Milliseconds maxLifetimeMilliseconds = getDefaultLifetime());
+  CertificateCacheV2
+    (Milliseconds maxLifetimeMilliseconds = getDefaultLifetime(),
+     size_t capacity = getDefaultCapacity());
 
   /**
    * Insert the certificate into the cache. The inserted certificate will be
@@ -55,9 +61,11 @@ public:
   insert(const CertificateV2& certificate);
 
   /**
-   * Find the certificate by the given key name.
+   * Find the certificate by the given key name, and mark it as the most
+   * recently used.
    * @param certificatePrefix The certificate prefix for searching for the
-   * certificate.
+   * certificate. If the last component is an implicit SHA-256 digest, then
+   * this is the full name of the certificate.
    * @return The found certificate, or null if not found. You must not modify
    * the returned object. If you need to modify it, then make a copy.
    */
@@ -65,7 +73,8 @@ public:
   find(const Name& certificatePrefix) const;
 
   /**
-   * Find the certificate by the given interest.
+   * Find the certificate by the given interest, and mark it as the most
+   * recently used.
    * @param interest The input interest object.
    * @return The found certificate which matches the interest, or null if not
    * found. You must not modify the returned object. If you need to modify it,
@@ -90,9 +99,34 @@ public:
   clear()
   {
     certificatesByName_.clear();
-    nextRefreshTime_ = DBL_MAX;
+    certificatesByRemovalTime_.clear();
+    lruList_.clear();
   }
 
+  /**
+   * Get the number of certificates in the cache, including expired
+   * certificates which have not yet been removed.
+   * @return The number of certificates.
+   */
+  size_t
+  size() const { return certificatesByName_.size(); }
+
+  /**
+   * Set the maximum number of certificates, removing the least recently used
+   * certificates if the cache has more.
+   * @param capacity The maximum number of certificates. If 0, don't cache
+   * certificates.
+   */
+  void
+  setCapacity(size_t capacity);
+
+  /**
+   * Get the maximum number of certificates.
+   * @return The capacity.
+   */
+  size_t
+  getCapacity() const { return capacity_; }
+
   /**
    * Get the default maximum lifetime (1 hour).
    * @return The lifetime in milliseconds.
@@ -100,6 +134,13 @@ public:
   static Milliseconds
   getDefaultLifetime() { return 3600.0 * 1000; }
 
+  /**
+   * Get the default maximum number of certificates (10000).
+   * @return The default capacity.
+   */
+  static size_t
+  getDefaultCapacity() { return 10000; }
+
   /**
    * Set the offset when insert() and refresh() get the current time, which
    * should only be used for testing.
@@ -112,45 +153,58 @@ public:
   }
 
 private:
+  // The front is the most recently used certificate name.
+  typedef std::list<Name> LruList;
+  // The certificate names ordered by removal time, so that refresh() only
+  // visits the entries to remove.
+  typedef std::multimap<MillisecondsSince1970, Name> RemovalTimeIndex;
+
   /**
    * CertificateCacheV2::Entry is the value of the certificatesByName_ map.
    */
   class Entry {
   public:
-    /**
-     * Create a new CertificateCacheV2::Entry with the given values.
-     * @param certificate The certificate.
-     * @param removalTime The removal time for this entry  as milliseconds since
-     * Jan 1, 1970 UTC.
-     */
-    Entry
-      (const ptr_lib::shared_ptr<CertificateV2>& certificate,
-       MillisecondsSince1970 removalTime)
-    : certificate_(certificate), removalTime_(removalTime)
-    {}
-
-    Entry()
-    {
-      removalTime_ = 0;
-    }
-
     ptr_lib::shared_ptr<CertificateV2> certificate_;
-    MillisecondsSince1970 removalTime_;
+    // The implicit SHA-256 digest component of the certificate's full name.
+    Name::Component implicitDigest_;
+    RemovalTimeIndex::iterator removalPosition_;
+    LruList::iterator lruPosition_;
   };
 
+  typedef std::map<Name, Entry> EntryMap;
+
   /**
    * Remove all outdated certificate entries.
    */
   void
   refresh();
 
+  /**
+   * Remove the entry from certificatesByName_ and the indexes.
+   * @param entry The iterator of the entry in certificatesByName_.
+   */
+  void
+  erase(EntryMap::iterator entry);
+
+  /**
+   * Mark the entry as the most recently used.
+   * @param entry The entry in certificatesByName_.
+   */
+  void
+  touch(const Entry& entry) const
+  {
+    lruList_.splice(lruList_.begin(), lruList_, entry.lruPosition_);
+  }
+
   // Disable the copy constructor and assignment operator.
   CertificateCacheV2(const CertificateCacheV2& other);
   CertificateCacheV2& operator=(const CertificateCacheV2& other);
 
-  std::map<Name, Entry> certificatesByName_;
-  MillisecondsSince1970 nextRefreshTime_;
+  EntryMap certificatesByName_;
+  RemovalTimeIndex certificatesByRemovalTime_;
+  mutable LruList lruList_;
   Milliseconds maxLifetimeMilliseconds_;
+  size_t capacity_;
   Milliseconds nowOffsetMilliseconds_;
 };
 
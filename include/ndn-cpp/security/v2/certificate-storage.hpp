@@ -40,6 +40,9 @@ public:
   {
   }
 
+  virtual
+  ~CertificateStorage() {}
+
   /**
    * Find a trusted certificate in the trust anchor container or in the
    * verified cache.
@@ -125,10 +128,15 @@ public:
   }
 
   /**
-   * Remove any previously loaded static or dynamic trust anchors.
+   * Remove any previously loaded static or dynamic trust anchors, then call
+   * onCertificatesReset().
    */
   void
-  resetAnchors() { trustAnchors_.clear(); }
+  resetAnchors()
+  {
+    trustAnchors_.clear();
+    onCertificatesReset();
+  }
 
   /**
    * Cache the verified certificate a period of time (1 hour).
@@ -141,10 +149,14 @@ public:
   }
 
   /**
-   * Remove any cached verified certificates.
+   * Remove any cached verified certificates, then call onCertificatesReset().
    */
   void
-  resetVerifiedCertificates() { verifiedCertificateCache_.clear(); }
+  resetVerifiedCertificates()
+  {
+    verifiedCertificateCache_.clear();
+    onCertificatesReset();
+  }
 
   /**
    * Set the offset when the cache insert() and refresh() get the current time,
@@ -164,6 +176,14 @@ private:
   CertificateStorage& operator=(const CertificateStorage& other);
 
 protected:
+  /**
+   * This is called by resetAnchors() and resetVerifiedCertificates() so that a
+   * subclass can clear what it derived from the anchors or certificates. The
+   * default does nothing.
+   */
+  virtual void
+  onCertificatesReset() {}
+
   TrustAnchorContainer trustAnchors_;
   CertificateCacheV2 verifiedCertificateCache_;
   CertificateCacheV2 unverifiedCertificateCache_;
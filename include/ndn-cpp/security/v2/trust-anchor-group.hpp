@@ -24,10 +24,13 @@
 #define NDN_TRUST_ANCHOR_GROUP_HPP
 
 #include <set>
+#include <map>
 #include "certificate-v2.hpp"
 
 namespace ndn {
 
+class FileStatus;
+
 class CertificateContainerInterface
 {
 public:
@@ -168,6 +171,12 @@ public:
    *
    * Upon refresh, the existing certificates are not changed.
    *
+   * Only files which changed since the last refresh are read again. Where
+   * inotify is available, this watches the directory (or the directory of the
+   * file) so that a refresh with no changes does not read the directory or
+   * stat the files. Otherwise, or if the watch can't be made, this compares the
+   * modification time, size and inode of each file.
+   *
    * @param certificateContainer A certificate container into which trust
    * anchors from the group will be added.
    * @param id The group id.
@@ -185,6 +194,9 @@ public:
      const std::string& path, Milliseconds refreshPeriod,
      bool isDirectory = false);
 
+  virtual
+  ~DynamicTrustAnchorGroup();
+
   /**
    * Request a certificate refresh.
    */
@@ -192,13 +204,86 @@ public:
   refresh();
 
 private:
+  /**
+   * An AnchorFile holds the status of a file when it was last read and the
+   * name of the certificate it had.
+   */
+  class AnchorFile {
+  public:
+    ptr_lib::shared_ptr<FileStatus> status_;
+    // If the file does not have a valid certificate, this is empty.
+    Name certificateName_;
+  };
+
+  // The key is the file path.
+  typedef std::map<std::string, AnchorFile> AnchorFileMap;
+
+  /**
+   * Check every file under path_, read the files which changed and remove the
+   * anchors of the files which are gone.
+   */
+  void
+  scanAllFiles();
+
+  /**
+   * Stat the file and read it again if it changed, or remove its anchor if it
+   * is gone.
+   * @param filePath The file path.
+   */
+  void
+  updateFile(const std::string& filePath);
+
+  /**
+   * Add the anchor for a file, or count another file with the same
+   * certificate name.
+   * @param certificate The certificate.
+   */
+  void
+  addFileAnchor(const CertificateV2& certificate);
+
+  /**
+   * Uncount a file with the certificate name, and remove the anchor if no
+   * other file has it.
+   * @param certificateName The certificate name. If empty, do nothing.
+   */
+  void
+  removeFileAnchor(const Name& certificateName);
+
+  /**
+   * Try to start watching the directory with inotify.
+   * @return True if the watch is started.
+   */
+  bool
+  startWatch();
+
+  /**
+   * Stop watching and close the inotify file descriptor, if open.
+   */
   void
-  loadCertificate(const std::string& file, std::set<Name>& oldAnchorNames);
+  stopWatch();
+
+  /**
+   * Read the pending inotify events without blocking.
+   * @param changedFilePaths Add the path of each changed file.
+   * @return True if changedFilePaths has all the changes, or false if all the
+   * files need to be checked because the event queue overflowed or the watch
+   * was removed.
+   */
+  bool
+  readWatchEvents(std::set<std::string>& changedFilePaths);
 
   bool isDirectory_;
   std::string path_;
   Milliseconds refreshPeriod_;
   Milliseconds expireTime_;
+  AnchorFileMap files_;
+  // The number of files with each certificate name in anchorNames_.
+  std::map<Name, int> anchorFileCount_;
+  // The directory to watch, which is path_ or the directory of the file.
+  std::string watchDirectory_;
+  // If not isDirectory_, the name of the file in watchDirectory_.
+  std::string watchFileName_;
+  int watchFd_;
 };
 
 }
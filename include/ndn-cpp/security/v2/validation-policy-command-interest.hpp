@@ -24,6 +24,11 @@
 #define NDN_VALIDATION_POLICY_COMMAND_INTEREST_HPP
 
 #include <map>
+#include <list>
+#include "../../ndn-cpp-config.h"
+#if NDN_CPP_HAVE_STD_UNORDERED_MAP
+#include <unordered_map>
+#endif
 #include "validation-policy.hpp"
 
 namespace ndn {
@@ -189,16 +194,20 @@ private:
     (const Interest& interest, const Name& keyName,
      MillisecondsSince1970 timestamp);
 
-  /**
-   * Find the record in container_ which has the keyName.
-   * @param keyName The key name to search for.
-   * @return The index in container_ of the record, or -1 if not found.
-   */
-  int
-  findByKeyName(const Name& keyName);
+  // The front is the least recently refreshed record.
+  typedef std::list<LastTimestampRecord> RecordList;
+  // The lookup by key name doesn't need ordering, so use a hash table if
+  // available.
+#if NDN_CPP_HAVE_STD_UNORDERED_MAP
+  typedef std::unordered_map<Name, RecordList::iterator> RecordMap;
+#else
+  typedef std::map<Name, RecordList::iterator> RecordMap;
+#endif
 
   Options options_;
-  std::vector<ptr_lib::shared_ptr<LastTimestampRecord> > container_;
+  RecordList container_;
+  // The same records as container_, indexed by key name.
+  RecordMap recordsByKeyName_;
   Milliseconds nowOffsetMilliseconds_;
 };
 
@@ -25,6 +25,7 @@
 
 #include "certificate-fetcher-offline.hpp"
 #include "validation-policy.hpp"
+#include "verified-data-cache.hpp"
 
 namespace ndn {
 
@@ -51,6 +52,17 @@ namespace ndn {
  * anchors, a verified certificate cache for saving certificates that are
  * already verified, and an unverified certificate cache for saving pre-fetched
  * but not yet verified certificates.
+ *
+ * A Validator also has an optional verified Data cache (disabled by default)
+ * which records the full names of successfully validated Data packets so that
+ * validating the exact same packet again immediately calls the success
+ * callback. To enable it, call getVerifiedDataCache().setCapacity(capacity).
+ *
+ * A Validator also has an optional verified Merkle root cache (disabled by
+ * default) for Data packets with a MerkleSignature. It records the roots whose
+ * signature has been verified, so that validating another packet of the same
+ * batch only needs to recompute the root from the packet's authentication
+ * path. To enable it, call getVerifiedMerkleRootCache().setCapacity(capacity).
  */
 class Validator : public CertificateStorage {
 public:
@@ -95,7 +107,45 @@ public:
   getMaxDepth() const { return maxDepth_; }
 
   /**
-   * Asynchronously validate the Data packet.
+   * Get the cache of the full names of successfully validated Data packets.
+   * The cache is disabled until you call setCapacity() with a positive value.
+   * An entry expires no later than the earliest NotAfter time of the
+   * certificates in the chain which validated the Data packet.
+   * @return The VerifiedDataCache.
+   */
+  VerifiedDataCache&
+  getVerifiedDataCache() { return verifiedDataCache_; }
+
+  /**
+   * Get the cache of the Merkle roots of MerkleSignature Data packets whose
+   * root signature has been verified. Each entry is the name of the signing
+   * key with an ImplicitSha256Digest component of the root hash. The cache is
+   * disabled until you call setCapacity() with a positive value. An entry
+   * expires no later than the earliest NotAfter time of the certificates in the
+   * chain which validated the root.
+   * @return The VerifiedDataCache of Merkle roots.
+   */
+  VerifiedDataCache&
+  getVerifiedMerkleRootCache() { return verifiedMerkleRootCache_; }
+
+  /**
+   * Set the offset when the certificate caches and the verified Data and
+   * Merkle root caches get the current time, which should only be used for
+   * testing.
+   * @param nowOffsetMilliseconds The offset in milliseconds.
+   */
+  void
+  setCacheNowOffsetMilliseconds_(Milliseconds nowOffsetMilliseconds)
+  {
+    CertificateStorage::setCacheNowOffsetMilliseconds_(nowOffsetMilliseconds);
+    verifiedDataCache_.setNowOffsetMilliseconds_(nowOffsetMilliseconds);
+    verifiedMerkleRootCache_.setNowOffsetMilliseconds_(nowOffsetMilliseconds);
+  }
+
+  /**
+   * Asynchronously validate the Data packet. If the verified Data cache is
+   * enabled and already has the full name of the Data packet, then immediately
+   * call successCallback(data) without checking the policy or the signature.
    * @param data The Data packet to validate, which is copied.
    * @param successCallback On validation success, this calls
    * successCallback(data).
@@ -122,6 +172,17 @@ public:
      const InterestValidationFailureCallback& failureCallback);
 
 private:
+  /**
+   * Clear the verified Data and Merkle root caches since their entries may
+   * depend on the anchors or certificates which were reset.
+   */
+  virtual void
+  onCertificatesReset()
+  {
+    verifiedDataCache_.clear();
+    verifiedMerkleRootCache_.clear();
+  }
+
   /**
    * Recursively validate the certificates in the certification chain.
    * @param certificate The certificate to check.
@@ -132,6 +193,34 @@ private:
     (const ptr_lib::shared_ptr<CertificateV2>& certificate,
      const ptr_lib::shared_ptr<ValidationState>& state);
 
+  /**
+   * If the state is a DataValidationState with a successful outcome, add the
+   * full name of its Data packet to the verified Data cache, and add
+   * merkleRootName (if not empty) to the verified Merkle root cache.
+   * @param state The validation state after verifying the original packet.
+   * @param trustedCertificate The trusted certificate at the top of the
+   * certificate chain.
+   * @param merkleRootName The name from getMerkleRootName, or an empty Name.
+   */
+  void
+  cacheVerifiedData
+    (const ptr_lib::shared_ptr<ValidationState>& state,
+     const CertificateV2& trustedCertificate, const Name& merkleRootName);
+
+  /**
+   * If the verified Merkle root cache is enabled and the state is a
+   * DataValidationState whose Data packet has a MerkleSignature, get the name
+   * for the verified Merkle root cache.
+   * @param state The validation state.
+   * @param signingCertificate The certificate which signed the Data packet.
+   * @return The key name of signingCertificate with an ImplicitSha256Digest
+   * component of the root hash, or an empty Name if not applicable.
+   */
+  Name
+  getMerkleRootName
+    (const ptr_lib::shared_ptr<ValidationState>& state,
+     const CertificateV2& signingCertificate);
+
   /**
    * Request a certificate for further validation.
    * @param certificateRequest The certificate request.
@@ -181,6 +270,8 @@ private:
   ptr_lib::shared_ptr<ValidationPolicy> policy_;
   ptr_lib::shared_ptr<CertificateFetcher> certificateFetcher_;
   size_t maxDepth_;
+  VerifiedDataCache verifiedDataCache_;
+  VerifiedDataCache verifiedMerkleRootCache_;
 };
 
 }
@@ -0,0 +1,190 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2018 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+#ifndef NDN_VERIFIED_DATA_CACHE_HPP
+#define NDN_VERIFIED_DATA_CACHE_HPP
+
+#include <float.h>
+#include <map>
+#include <set>
+#include "../../name.hpp"
+#if NDN_CPP_HAVE_STD_UNORDERED_MAP
+#include <unordered_map>
+#endif
+
+namespace ndn {
+
+/**
+ * A VerifiedDataCache records the full names (including the implicit SHA-256
+ * digest) of Data packets which a Validator has successfully validated, so that
+ * validating the exact same packet again does not need to repeat the policy
+ * checks and signature verification. An entry is removed no later than the
+ * earliest NotAfter time of the certificates which were used to validate it, or
+ * maxLifetime after it has been added to the cache. If the cache is full when
+ * inserting, the entry which is closest to its removal time is evicted.
+ * A capacity of zero (the default) disables the cache.
+ */
+class VerifiedDataCache {
+public:
+  /**
+   * Create a VerifiedDataCache.
+   * @param capacity (optional) The maximum number of entries in the cache. If
+   * omitted, use 0 which disables the cache.
+   * @param maxLifetimeMilliseconds (optional) The maximum time that an entry
+   * can live inside the cache, in milliseconds. If omitted, use
+   * getDefaultLifetime().
+   */
+  VerifiedDataCache
+    (size_t capacity = 0,
+     Milliseconds maxLifetimeMilliseconds = getDefaultLifetime());
+
+  /**
+   * Record that the Data packet with the given full name has been successfully
+   * validated. If the capacity is zero, do nothing.
+   * @param fullName The full name of the Data packet, including the implicit
+   * SHA-256 digest, which is copied.
+   * @param notAfterTime The earliest NotAfter time of the certificates used to
+   * validate the Data packet, as milliseconds since Jan 1, 1970 UTC. The entry
+   * is removed no later than this time.
+   */
+  void
+  insert(const Name& fullName, MillisecondsSince1970 notAfterTime);
+
+  /**
+   * Check if the Data packet with the given full name has been successfully
+   * validated and the entry has not yet expired.
+   * @param fullName The full name of the Data packet, including the implicit
+   * SHA-256 digest.
+   * @return True if the Data packet is in the cache.
+   */
+  bool
+  contains(const Name& fullName) const;
+
+  /**
+   * Clear all entries from the cache.
+   */
+  void
+  clear()
+  {
+    removalTimeByFullName_.clear();
+    fullNamesByRemovalTime_.clear();
+  }
+
+  /**
+   * Get the number of entries in the cache, including expired entries which
+   * have not yet been removed.
+   * @return The number of entries.
+   */
+  size_t
+  size() const { return removalTimeByFullName_.size(); }
+
+  /**
+   * Get the maximum number of entries in the cache.
+   * @return The capacity. If 0, the cache is disabled.
+   */
+  size_t
+  getCapacity() const { return capacity_; }
+
+  /**
+   * Set the maximum number of entries in the cache. If the cache has more
+   * entries than the new capacity, evict the ones closest to their removal
+   * time.
+   * @param capacity The maximum number of entries. If 0, this clears and
+   * disables the cache.
+   */
+  void
+  setCapacity(size_t capacity);
+
+  /**
+   * Get the maximum time that an entry can live inside the cache.
+   * @return The maximum lifetime in milliseconds.
+   */
+  Milliseconds
+  getMaxLifetime() const { return maxLifetimeMilliseconds_; }
+
+  /**
+   * Set the maximum time that an entry can live inside the cache. This does
+   * not change the removal time of existing entries.
+   * @param maxLifetimeMilliseconds The maximum lifetime in milliseconds.
+   */
+  void
+  setMaxLifetime(Milliseconds maxLifetimeMilliseconds)
+  {
+    maxLifetimeMilliseconds_ = maxLifetimeMilliseconds;
+  }
+
+  /**
+   * Get the default maximum lifetime (1 hour).
+   * @return The lifetime in milliseconds.
+   */
+  static Milliseconds
+  getDefaultLifetime() { return 3600.0 * 1000; }
+
+  /**
+   * Set the offset when insert() and contains() get the current time, which
+   * should only be used for testing.
+   * @param nowOffsetMilliseconds The offset in milliseconds.
+   */
+  void
+  setNowOffsetMilliseconds_(Milliseconds nowOffsetMilliseconds)
+  {
+    nowOffsetMilliseconds_ = nowOffsetMilliseconds;
+  }
+
+private:
+  /**
+   * Remove all entries whose removal time is not later than now.
+   * @param now The current time in milliseconds since Jan 1, 1970 UTC.
+   */
+  void
+  refresh(MillisecondsSince1970 now);
+
+  /**
+   * Remove the entry which is closest to its removal time.
+   */
+  void
+  evictOne();
+
+  // Disable the copy constructor and assignment operator.
+  VerifiedDataCache(const VerifiedDataCache& other);
+  VerifiedDataCache& operator=(const VerifiedDataCache& other);
+
+  typedef std::set<std::pair<MillisecondsSince1970, Name> > RemovalIndex;
+  // The lookup by full name doesn't need ordering, so use a hash table if
+  // available.
+#if NDN_CPP_HAVE_STD_UNORDERED_MAP
+  typedef std::unordered_map<Name, MillisecondsSince1970> RemovalTimeMap;
+#else
+  typedef std::map<Name, MillisecondsSince1970> RemovalTimeMap;
+#endif
+
+  RemovalTimeMap removalTimeByFullName_;
+  // The same entries as removalTimeByFullName_, ordered by removal time so that
+  // refresh() and evictOne() only touch the entries at the front.
+  RemovalIndex fullNamesByRemovalTime_;
+  size_t capacity_;
+  Milliseconds maxLifetimeMilliseconds_;
+  Milliseconds nowOffsetMilliseconds_;
+};
+
+}
+
+#endif
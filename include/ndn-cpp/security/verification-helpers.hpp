@@ -120,7 +120,9 @@ public:
   /**
    * Verify the Data packet using the public key. This does not check the
    * type of public key or digest algorithm against the type of SignatureInfo in
-   * the Data packet such as Sha256WithRsaSignature.
+   * the Data packet such as Sha256WithRsaSignature. If the Data packet has a
+   * MerkleSignature, this computes the root of the Merkle tree from the packet
+   * and its authentication path and verifies the signature of the root.
    * @param data The Data packet to verify.
    * @param publicKey The object containing the public key.
    * @param digestAlgorithm (optional) The digest algorithm. If omitted, use SHA256.
@@ -181,6 +183,30 @@ public:
       (data, certificate.getPublicKey(), digestAlgorithm, wireFormat);
   }
 
+  /**
+   * Verify each Data packet in dataList using the DER-encoded public key at the
+   * same index in publicKeyDerList. This decodes each distinct public key only
+   * once, so it is faster than calling verifyDataSignature for each packet when
+   * many packets are signed by the same key. This does not check the type of
+   * public key against the type of SignatureInfo in each Data packet. To spread
+   * the work across multiple threads, see BatchVerifier.
+   * @param dataList The Data packets to verify.
+   * @param publicKeyDerList The DER-encoded public keys, where
+   * publicKeyDerList[i] is used to verify dataList[i].
+   * @param results This resizes results to the size of dataList and sets
+   * results[i] true if dataList[i] is verified, or false if verification fails
+   * or for an error encoding the packet or decoding its public key.
+   * @param wireFormat (optional) A WireFormat object used to encode the Data
+   * packets. If omitted, use WireFormat getDefaultWireFormat().
+   * @throws invalid_argument if publicKeyDerList does not have the same size
+   * as dataList.
+   */
+  static void
+  verifyDataSignatures
+    (const std::vector<ptr_lib::shared_ptr<Data> >& dataList,
+     const std::vector<Blob>& publicKeyDerList, std::vector<bool>& results,
+     WireFormat& wireFormat = *WireFormat::getDefaultWireFormat());
+
   /**
    * Verify the Interest packet using the public key, where the last two name
    * components are the SignatureInfo and signature bytes. This does not check
@@ -0,0 +1,167 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2018 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+#ifndef NDN_LOOPBACK_TRANSPORT_HPP
+#define NDN_LOOPBACK_TRANSPORT_HPP
+
+#include <vector>
+#include "../common.hpp"
+#include "transport.hpp"
+
+namespace ndn {
+
+/**
+ * A LoopbackTransport sends packets to another LoopbackTransport in the same
+ * process without using a socket, so that a Face can communicate with another
+ * Face or with a LoopbackForwarder at full speed and without a running NFD.
+ * A packet given to send() is copied to the queue of the peer transport and is
+ * passed to the peer's element listener when the peer's processEvents() is
+ * called. This is not thread safe, so all the connected transports must be
+ * used in the same thread.
+ */
+class LoopbackTransport : public Transport {
+public:
+  /**
+   * A LoopbackTransport::ConnectionInfo has the peer LoopbackTransport to
+   * connect to.
+   */
+  class ConnectionInfo : public Transport::ConnectionInfo {
+  public:
+    /**
+     * Create a ConnectionInfo with the given peer.
+     * @param peer (optional) The LoopbackTransport to connect to. If omitted or
+     * null, connect() only sets the element listener and this transport waits
+     * for another LoopbackTransport to connect to it.
+     */
+    ConnectionInfo
+      (const ptr_lib::shared_ptr<LoopbackTransport>& peer =
+         ptr_lib::shared_ptr<LoopbackTransport>())
+    : peer_(peer)
+    {
+    }
+
+    /**
+     * Get the peer given to the constructor.
+     * @return The peer LoopbackTransport, or null if not specified.
+     */
+    const ptr_lib::shared_ptr<LoopbackTransport>&
+    getPeer() const { return peer_; }
+
+    virtual
+    ~ConnectionInfo();
+
+  private:
+    ptr_lib::shared_ptr<LoopbackTransport> peer_;
+  };
+
+  LoopbackTransport();
+
+  /**
+   * The peer is always in the same process, so return true.
+   * @param connectionInfo This is ignored.
+   * @return True.
+   */
+  virtual bool
+  isLocal(const Transport::ConnectionInfo& connectionInfo);
+
+  /**
+   * Override to return false since connect does not need to use the onConnected
+   * callback.
+   * @return False.
+   */
+  virtual bool
+  isAsync();
+
+  /**
+   * Set the element listener and connect to the peer in connectionInfo. If
+   * this was connected to another peer, first disconnect from it.
+   * @param connectionInfo A reference to a LoopbackTransport::ConnectionInfo.
+   * @param elementListener Not a shared_ptr because we assume that it will
+   * remain valid during the life of this object.
+   * @param onConnected This calls onConnected() when the connection is
+   * established.
+   */
+  virtual void
+  connect(const Transport::ConnectionInfo& connectionInfo,
+          ElementListener& elementListener, const OnConnected& onConnected);
+
+  /**
+   * Copy the data to the receive queue of the peer transport.
+   * @param data A pointer to the buffer of data to send. This must be one
+   * entire element, such as one Interest or Data packet.
+   * @param dataLength The number of bytes in data.
+   * @throws runtime_error If this is not connected to a peer.
+   */
+  virtual void
+  send(const uint8_t *data, size_t dataLength);
+
+  /**
+   * For each element which the peer sent before this call, call
+   * elementListener.onReceivedElement. An element which is sent during a
+   * callback is received in the next call to processEvents. This returns
+   * immediately if there are no elements or connect has not been called. You
+   * should normally not call this directly since it is called by
+   * Face.processEvents.
+   * @throws This may throw an exception in the callback for processing the
+   * data.
+   */
+  virtual void
+  processEvents();
+
+  /**
+   * Check if this has an element listener and a peer.
+   * @return True if connected.
+   */
+  virtual bool
+  getIsConnected();
+
+  /**
+   * Disconnect from the peer and clear the receive queue.
+   */
+  virtual void
+  close();
+
+  virtual
+  ~LoopbackTransport();
+
+private:
+  // Don't allow copying since the peer has a pointer to this object.
+  LoopbackTransport(const LoopbackTransport& other);
+  LoopbackTransport& operator=(const LoopbackTransport& other);
+
+  void
+  disconnect();
+
+  ElementListener* elementListener_;
+  // The peer has a pointer back to this object, and each clears the other's
+  // pointer when it is disconnected.
+  LoopbackTransport* peer_;
+  // The received elements, one after another.
+  std::vector<uint8_t> receiveQueue_;
+  std::vector<size_t> receiveQueueLengths_;
+  // processEvents swaps the queue with these to reuse the allocated buffers.
+  std::vector<uint8_t> processBuffer_;
+  std::vector<size_t> processLengths_;
+};
+
+}
+
+#endif
@@ -23,6 +23,7 @@
 #define NDN_UDPTRANSPORT_HPP
 
 #include <string>
+#include <vector>
 #include "../common.hpp"
 #include "transport.hpp"
 
@@ -76,7 +77,24 @@ public:
     unsigned short port_;
   };
 
-  UdpTransport();
+  /**
+   * Create a UdpTransport.
+   * @param batchSize (optional) The maximum number of datagrams to receive or
+   * send with one system call (using recvmmsg and sendmmsg if available). If
+   * this is greater than 1, then send() queues the packet and the queue is sent
+   * when it has batchSize packets, when processEvents() is called, or when you
+   * call flush(). If omitted, use 1 to receive and send one packet at a time.
+   * This is limited to 64, which is the most datagrams that one system call
+   * will receive, so a larger value is reduced to 64.
+   * @param receiveBufferSize (optional) The size in bytes of the socket receive
+   * buffer in the kernel, which should be large enough to hold the packets
+   * which arrive between calls to processEvents(). If omitted or 0, use the
+   * system default.
+   * @param sendBufferSize (optional) The size in bytes of the socket send
+   * buffer in the kernel. If omitted or 0, use the system default.
+   */
+  UdpTransport
+    (size_t batchSize = 1, int receiveBufferSize = 0, int sendBufferSize = 0);
 
   /**
    * Determine whether this transport connecting according to connectionInfo is
@@ -109,18 +127,30 @@ public:
           ElementListener& elementListener, const OnConnected& onConnected);
 
   /**
-   * Send data to the host
+   * Send data to the host. If the batchSize given to the constructor is greater
+   * than 1, this copies the data to the send queue. See flush().
    * @param data A pointer to the buffer of data to send.
    * @param dataLength The number of bytes in data.
+   * @throws runtime_error If the transport is not connected, or for an error
+   * sending.
    */
   virtual void
   send(const uint8_t *data, size_t dataLength);
 
+  /**
+   * Send the packets which send() has queued, if any. This is called by
+   * processEvents() so you only need to call it to send without waiting for
+   * the next call to processEvents().
+   */
+  void
+  flush();
+
   /**
    * Process any data to receive.  For each element received, call
    * elementListener.onReceivedElement. This is non-blocking and will return
    * immediately if there is no data to receive. You should normally not call
-   * this directly since it is called by Face.processEvents.
+   * this directly since it is called by Face.processEvents. This also sends
+   * packets queued by send() before and after receiving.
    * @throws This may throw an exception for reading data or in the callback for
    * processing the data.  If you call this from an main event loop, you may
    * want to catch and log/disregard all exceptions.
@@ -132,7 +162,8 @@ public:
   getIsConnected();
 
   /**
-   * Close the connection to the host.
+   * Send the packets which send() has queued, if any, and close the connection
+   * to the host. The socket is closed even if sending the queue fails.
    */
   virtual void
   close();
@@ -141,6 +172,15 @@ private:
   ptr_lib::shared_ptr<struct ndn_UdpTransport> transport_;
   ptr_lib::shared_ptr<DynamicUInt8Vector> elementBuffer_;
   bool isConnected_;
+  size_t batchSize_;
+  int receiveBufferSize_;
+  int sendBufferSize_;
+  // batchSize_ buffers of MAX_NDN_PACKET_SIZE which processEvents swaps in
+  // and out to reuse the allocation.
+  std::vector<uint8_t> receiveBuffers_;
+  // The packets queued by send(), one after another.
+  std::vector<uint8_t> sendQueue_;
+  std::vector<size_t> sendQueueLengths_;
 };
 
 }
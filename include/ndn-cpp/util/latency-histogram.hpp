@@ -0,0 +1,131 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2018 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+#ifndef NDN_LATENCY_HISTOGRAM_HPP
+#define NDN_LATENCY_HISTOGRAM_HPP
+
+#include <vector>
+#include "../common.hpp"
+
+namespace ndn {
+
+/**
+ * A LatencyHistogram records non-negative integer values (such as latencies in
+ * microseconds) in log-linear buckets in the style of an HDR histogram. Values
+ * below 32 are recorded exactly. Larger values are recorded in buckets whose
+ * width is 1/16 of the power of two below the value, so that a value returned
+ * by getValueAtPercentile is within about 6% of the recorded value. Recording
+ * a value is constant time and does not allocate memory.
+ */
+class LatencyHistogram {
+public:
+  /**
+   * Create an empty LatencyHistogram.
+   */
+  LatencyHistogram();
+
+  /**
+   * Record one occurrence of the value.
+   * @param value The value to record. If this is larger than
+   * getMaxTrackableValue(), record getMaxTrackableValue().
+   */
+  void
+  recordValue(uint64_t value);
+
+  /**
+   * Add all the recorded values of the other histogram to this histogram.
+   * @param other The other LatencyHistogram.
+   */
+  void
+  add(const LatencyHistogram& other);
+
+  /**
+   * Clear all the recorded values.
+   */
+  void
+  reset();
+
+  /**
+   * Get the number of recorded values.
+   * @return The number of recorded values.
+   */
+  uint64_t
+  getCount() const { return count_; }
+
+  /**
+   * Get the smallest recorded value.
+   * @return The smallest value, or 0 if no values have been recorded.
+   */
+  uint64_t
+  getMin() const { return count_ == 0 ? 0 : min_; }
+
+  /**
+   * Get the largest recorded value.
+   * @return The largest value, or 0 if no values have been recorded.
+   */
+  uint64_t
+  getMax() const { return max_; }
+
+  /**
+   * Get the mean of the recorded values. This uses the exact recorded values,
+   * not the bucket values.
+   * @return The mean, or 0 if no values have been recorded.
+   */
+  double
+  getMean() const { return count_ == 0 ? 0.0 : (double)sum_ / count_; }
+
+  /**
+   * Get the value at the given percentile of the recorded values, which is the
+   * largest value equivalent to the bucket which holds the percentile.
+   * @param percentile The percentile from 0.0 to 100.0, for example 99.0.
+   * @return The value at the percentile, which is not more than getMax(), or 0
+   * if no values have been recorded.
+   */
+  uint64_t
+  getValueAtPercentile(double percentile) const;
+
+  /**
+   * Get the largest value which can be recorded without being clamped.
+   * @return The largest trackable value, about 12.7 days in microseconds.
+   */
+  static uint64_t
+  getMaxTrackableValue() { return MAX_TRACKABLE_VALUE; }
+
+private:
+  static size_t
+  getBucketIndex(uint64_t value);
+
+  static uint64_t
+  getHighestEquivalentValue(size_t bucketIndex);
+
+  static const uint64_t MAX_TRACKABLE_VALUE = (((uint64_t)1) << 40) - 1;
+  static const size_t N_BUCKETS = 16 * (40 - 4) + 16;
+
+  std::vector<uint64_t> counts_;
+  uint64_t count_;
+  uint64_t min_;
+  uint64_t max_;
+  uint64_t sum_;
+};
+
+}
+
+#endif
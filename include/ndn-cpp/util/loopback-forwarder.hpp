@@ -0,0 +1,171 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2018 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+#ifndef NDN_LOOPBACK_FORWARDER_HPP
+#define NDN_LOOPBACK_FORWARDER_HPP
+
+#include <map>
+#include <deque>
+#include <vector>
+#include "../face.hpp"
+#include "../transport/loopback-transport.hpp"
+
+namespace ndn {
+
+/**
+ * A LoopbackForwarder is a minimal in-memory stand-in for NFD so that
+ * applications, tests and benchmarks can run Faces in one process without a
+ * running forwarder. Each Face from makeFace() is connected to the forwarder
+ * with a LoopbackTransport. The forwarder has a FIB with longest prefix match,
+ * a PIT which aggregates Interests with the same Name and selectors and drops
+ * a looping Interest with a duplicate nonce, and a content store. It answers
+ * the /localhost/nfd/rib/register and unregister commands from
+ * Face.registerPrefix and Face.removeRegisteredPrefix but does not check the
+ * command signature. Interest forwarding hints, Nacks and the content store
+ * child selector are not supported. This is not thread safe, so the forwarder
+ * and all its Faces must be used in the same thread.
+ */
+class LoopbackForwarder {
+public:
+  /**
+   * Create a LoopbackForwarder with no faces.
+   * @param contentStoreCapacity (optional) The maximum number of Data packets
+   * in the content store. When it is full, the oldest Data packet is removed.
+   * If 0, don't cache Data packets. If omitted, use 1000.
+   */
+  LoopbackForwarder(size_t contentStoreCapacity = 1000);
+
+  /**
+   * Make a new Face which uses a new LoopbackTransport to connect to a new face
+   * of this forwarder. The forwarder must remain valid during the life of the
+   * returned Face.
+   * @return The new Face.
+   */
+  ptr_lib::shared_ptr<Face>
+  makeFace();
+
+  /**
+   * Process the packets which each Face sent to this forwarder and remove timed
+   * out PIT entries. This is non-blocking. You should call this in the same
+   * event loop which calls processEvents for each Face. A packet which this
+   * forwarder sends is received by the Face in its next call to processEvents.
+   */
+  void
+  processEvents();
+
+  /**
+   * Get the number of prefixes in the FIB.
+   * @return The number of FIB entries.
+   */
+  size_t
+  getFibSize() const { return fib_.size(); }
+
+  /**
+   * Get the number of entries in the PIT.
+   * @return The number of PIT entries.
+   */
+  size_t
+  getPitSize() const { return pitSize_; }
+
+  /**
+   * Get the number of Data packets in the content store.
+   * @return The number of content store entries.
+   */
+  size_t
+  getContentStoreSize() const { return contentStore_.size(); }
+
+  ~LoopbackForwarder();
+
+private:
+  class FaceEntry;
+
+  class PitEntry {
+  public:
+    PitEntry(const ptr_lib::shared_ptr<Interest>& interest)
+    : interest_(interest)
+    {
+    }
+
+    ptr_lib::shared_ptr<Interest> interest_;
+    std::vector<size_t> inFaceIds_;
+    std::vector<Blob> nonces_;
+    MillisecondsSince1970 expirationTime_;
+  };
+
+  class ContentStoreEntry {
+  public:
+    Data data_;
+    Blob encoding_;
+    MillisecondsSince1970 staleTime_;
+  };
+
+  // Don't allow copying since each FaceEntry has a pointer to this object.
+  LoopbackForwarder(const LoopbackForwarder& other);
+  LoopbackForwarder& operator=(const LoopbackForwarder& other);
+
+  /**
+   * This is called by the FaceEntry for faceId when the Face sends a packet.
+   */
+  void
+  onReceivedElement(size_t faceId, const uint8_t *element, size_t elementLength);
+
+  void
+  onReceivedInterest
+    (size_t faceId, const uint8_t *element, size_t elementLength);
+
+  void
+  onReceivedData(size_t faceId, const uint8_t *element, size_t elementLength);
+
+  /**
+   * Answer a /localhost/nfd/rib command Interest and update the FIB.
+   */
+  void
+  onRibCommand(size_t faceId, const Interest& interest);
+
+  /**
+   * Send the element to the face. If the Face has been destroyed, do nothing.
+   */
+  void
+  sendToFace(size_t faceId, const uint8_t *element, size_t elementLength);
+
+  void
+  removeTimedOutPitEntries(MillisecondsSince1970 nowMilliseconds);
+
+  static bool
+  selectorsEqual(const Interest& interest1, const Interest& interest2);
+
+  size_t contentStoreCapacity_;
+  std::vector<ptr_lib::shared_ptr<FaceEntry> > faces_;
+  // The key is the prefix. The value is the list of next hop face IDs.
+  std::map<Name, std::vector<size_t> > fib_;
+  // The key is the Interest name.
+  std::map<Name, std::vector<ptr_lib::shared_ptr<PitEntry> > > pit_;
+  size_t pitSize_;
+  MillisecondsSince1970 nextPitExpirationTime_;
+  // The key is the Data name.
+  std::map<Name, ptr_lib::shared_ptr<ContentStoreEntry> > contentStore_;
+  // The Data names in the order they were added, for removing the oldest.
+  std::deque<Name> contentStoreOrder_;
+};
+
+}
+
+#endif
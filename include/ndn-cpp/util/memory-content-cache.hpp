@@ -25,6 +25,9 @@
 #include <map>
 #include <deque>
 #include "../face.hpp"
+#if NDN_CPP_HAVE_STD_UNORDERED_MAP
+#include <unordered_map>
+#endif
 
 namespace ndn {
 
@@ -627,7 +630,13 @@ private:
     Face* face_;
     Milliseconds cleanupIntervalMilliseconds_;
     MillisecondsSince1970 nextCleanupTime_;
-    std::map<std::string, OnInterestCallback> onDataNotFoundForPrefix_; /**< The map key is the prefix.toUri() */
+#if NDN_CPP_HAVE_STD_UNORDERED_MAP
+    typedef std::unordered_map<Name, OnInterestCallback> OnDataNotFoundMap;
+#else
+    typedef std::map<Name, OnInterestCallback> OnDataNotFoundMap;
+#endif
+
+    OnDataNotFoundMap onDataNotFoundForPrefix_; /**< The map key is the prefix */
     std::vector<uint64_t> interestFilterIdList_;
     std::vector<uint64_t> registeredPrefixIdList_;
     std::vector<ptr_lib::shared_ptr<const Content> > noStaleTimeCache_;
@@ -0,0 +1,163 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2018 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+#ifndef NDN_PACKET_TRACE_HPP
+#define NDN_PACKET_TRACE_HPP
+
+#include <string>
+#include <vector>
+#include "../common.hpp"
+
+namespace ndn {
+
+/**
+ * PacketTrace has static methods to record packet events with a timestamp in a
+ * ring buffer for each thread, and to dump the records to a file for offline
+ * latency analysis. Recording an event does not format strings, allocate
+ * memory or take a lock, and the oldest records of a thread are overwritten
+ * when its ring buffer is full. The library records events in Node only if it
+ * is configured with ./configure --with-packet-trace . Otherwise the
+ * _TRACE_PACKET macro compiles to nothing, but an application can still call
+ * record() for its own events. Lock-free recording needs the GCC or Clang
+ * atomic builtins. With another compiler, record() does nothing.
+ */
+class PacketTrace {
+public:
+  /**
+   * An EventType is the type of event in a Record.
+   */
+  enum EventType {
+    /** An element was received. The value is the element length. */
+    RECEIVE = 1,
+    /** An Interest or Data was decoded. The value is the TLV type. */
+    DECODE = 2,
+    /** The value is the number of PIT entries matched by a Data or Nack. */
+    PIT_MATCH = 3,
+    /** The value is the number of interest filters matched by an Interest. */
+    INTEREST_FILTER_MATCH = 4,
+    /** An application callback was called. The value is the entry ID. */
+    CALLBACK_ENTER = 5,
+    /** An application callback returned. The value is the entry ID. */
+    CALLBACK_EXIT = 6,
+    /** An Interest or Data was sent. The value is the encoding length. */
+    SEND = 7,
+    /** A pending Interest timed out. The value is the pending interest ID. */
+    TIMEOUT = 8
+  };
+
+  /**
+   * A Record is one event. The dump file has the records in this binary layout
+   * in the byte order of the host.
+   */
+  struct Record {
+    /** Nanoseconds from a monotonic clock, only comparable in one process. */
+    uint64_t timestampNanoseconds;
+    /** The Name::getHash() of the packet name, or 0 if not known. */
+    uint64_t nameHash;
+    /** The value, depending on the eventType. */
+    uint64_t value;
+    /** The index of the recording thread, starting from 0. */
+    uint32_t threadIndex;
+    /** The EventType. */
+    uint16_t eventType;
+    uint16_t reserved;
+  };
+
+  /**
+   * Record the event in the ring buffer of the calling thread. The first call
+   * in a thread allocates its ring buffer with getBufferCapacity() records.
+   * @param eventType The EventType.
+   * @param value The value, depending on the eventType.
+   * @param nameHash The Name::getHash() of the packet name, or 0 if not known.
+   */
+  static void
+  record(EventType eventType, uint64_t value, uint64_t nameHash);
+
+  /**
+   * Get a copy of the records of all threads, sorted by timestamp. This can be
+   * called from any thread while other threads are recording. Since the
+   * oldest record of a full ring buffer may be overwritten while copying, this
+   * returns at most the capacity minus one of the most recent records of each
+   * thread.
+   * @param records Set this to the records.
+   */
+  static void
+  getRecords(std::vector<Record>& records);
+
+  /**
+   * Skip the records which have been recorded so far so that getRecords and
+   * dump don't return them.
+   */
+  static void
+  clear();
+
+  /**
+   * Write the records from getRecords to a file. The file has the 8 bytes
+   * "NDNTRACE", the version 1 and the record size 32 as 32-bit integers, then
+   * the records.
+   * @param filePath The path of the file to write.
+   * @throws runtime_error If the file can't be written.
+   */
+  static void
+  dump(const std::string& filePath);
+
+  /**
+   * Read the records from a file written by dump.
+   * @param filePath The path of the file to read.
+   * @param records Set this to the records.
+   * @throws runtime_error If the file can't be read or is not a dump file.
+   */
+  static void
+  readFile(const std::string& filePath, std::vector<Record>& records);
+
+  /**
+   * Set the number of records in the ring buffer of each thread which records
+   * after this call. This does not change existing ring buffers.
+   * @param capacity The number of records, which is rounded up to a power of 2.
+   */
+  static void
+  setBufferCapacity(size_t capacity);
+
+  /**
+   * Get the number of records in the ring buffer of each new thread.
+   * @return The number of records, initially 16384.
+   */
+  static size_t
+  getBufferCapacity();
+
+  /**
+   * Check if the library was configured to record packet events.
+   * @return True if configured with --with-packet-trace.
+   */
+  static bool
+  isEnabled();
+};
+
+}
+
+#if NDN_CPP_WITH_PACKET_TRACE
+#define _TRACE_PACKET(eventType, value, nameHash) \
+  ndn::PacketTrace::record((eventType), (value), (nameHash))
+#else
+#define _TRACE_PACKET(eventType, value, nameHash)
+#endif
+
+#endif
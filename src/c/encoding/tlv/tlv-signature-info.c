@@ -189,7 +189,8 @@ ndn_encodeTlvSignatureInfo
 
   if (signatureInfo->type == ndn_SignatureType_Sha256WithRsaSignature ||
       signatureInfo->type == ndn_SignatureType_Sha256WithEcdsaSignature ||
-      signatureInfo->type == ndn_SignatureType_HmacWithSha256Signature)
+      signatureInfo->type == ndn_SignatureType_HmacWithSha256Signature ||
+      signatureInfo->type == ndn_SignatureType_MerkleSignature)
     return ndn_TlvEncoder_writeNestedTlv
       (encoder, ndn_Tlv_SignatureInfo,
        encodeSignatureWithKeyLocatorAndValidityPeriodValue, signatureInfo, 0);
@@ -224,7 +225,8 @@ ndn_decodeTlvSignatureInfo
 
   if (signatureType == ndn_Tlv_SignatureType_SignatureSha256WithRsa ||
       signatureType == ndn_Tlv_SignatureType_SignatureSha256WithEcdsa ||
-      signatureType == ndn_Tlv_SignatureType_SignatureHmacWithSha256) {
+      signatureType == ndn_Tlv_SignatureType_SignatureHmacWithSha256 ||
+      signatureType == ndn_Tlv_SignatureType_SignatureMerkle) {
     // Assume that the ndn_SignatureType enum has the same values as the TLV
     // signature types.
     signatureInfo->type = signatureType;
@@ -65,7 +65,16 @@ enum {
   ndn_Tlv_SignatureType_DigestSha256 = 0,
   ndn_Tlv_SignatureType_SignatureSha256WithRsa = 1,
   ndn_Tlv_SignatureType_SignatureSha256WithEcdsa = 3,
-  ndn_Tlv_SignatureType_SignatureHmacWithSha256 = 4
+  ndn_Tlv_SignatureType_SignatureHmacWithSha256 = 4,
+  // Experimental. See MerkleSignature.
+  ndn_Tlv_SignatureType_SignatureMerkle = 200
+};
+
+enum {
+  ndn_Tlv_MerkleSignature_LeafIndex =     201,
+  ndn_Tlv_MerkleSignature_LeafCount =     202,
+  ndn_Tlv_MerkleSignature_RootSignature = 203,
+  ndn_Tlv_MerkleSignature_PathHash =      204
 };
 
 enum {
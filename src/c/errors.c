@@ -146,6 +146,8 @@ ndn_getErrorString(int error)
     return      "Unrecognized critical TLV type code";
   case NDN_ERROR_Name_component_otherTypeCode_must_be_non_negative:
     return      "Name component otherTypeCode must be non-negative";
+  case NDN_ERROR_SocketTransport_error_in_setsockopt:
+    return      "SocketTransport error in setsockopt";
   default:
     return "unrecognized ndn_Error code";
   }
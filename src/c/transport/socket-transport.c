@@ -18,6 +18,11 @@
  * A copy of the GNU Lesser General Public License is in the file COPYING.
  */
 
+// recvmmsg and sendmmsg are GNU extensions.
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
 // Only compile if we have Unix socket support.
 #include <ndn-cpp/ndn-cpp-config.h>
 #if NDN_CPP_HAVE_UNISTD_H
@@ -203,6 +208,168 @@ ndn_SocketTransport_processEvents
   }
 }
 
+ndn_Error
+ndn_SocketTransport_setBufferSizes
+  (struct ndn_SocketTransport *self, int receiveBufferSize, int sendBufferSize)
+{
+  if (self->socketDescriptor < 0)
+    return NDN_ERROR_SocketTransport_socket_is_not_open;
+
+  if (receiveBufferSize > 0) {
+    if (setsockopt(self->socketDescriptor, SOL_SOCKET, SO_RCVBUF,
+                   &receiveBufferSize, sizeof(receiveBufferSize)) != 0)
+      return NDN_ERROR_SocketTransport_error_in_setsockopt;
+  }
+  if (sendBufferSize > 0) {
+    if (setsockopt(self->socketDescriptor, SOL_SOCKET, SO_SNDBUF,
+                   &sendBufferSize, sizeof(sendBufferSize)) != 0)
+      return NDN_ERROR_SocketTransport_error_in_setsockopt;
+  }
+
+  return NDN_ERROR_success;
+}
+
+ndn_Error
+ndn_SocketTransport_processDatagrams
+  (struct ndn_SocketTransport *self, uint8_t *buffers,
+   size_t datagramBufferLength, size_t nBuffers)
+{
+  if (self->socketDescriptor < 0)
+    // The socket is not open.  Just silently return.
+    return NDN_ERROR_success;
+
+  if (nBuffers > MAX_DATAGRAMS_PER_CALL)
+    nBuffers = MAX_DATAGRAMS_PER_CALL;
+
+  // Loop until there are no more datagrams in the receive buffer.
+  while (1) {
+    ndn_Error error;
+    size_t i;
+#if NDN_CPP_HAVE_RECVMMSG
+    struct mmsghdr messages[MAX_DATAGRAMS_PER_CALL];
+    struct iovec iovecs[MAX_DATAGRAMS_PER_CALL];
+    int nReceived;
+
+    ndn_memset((uint8_t *)messages, 0, nBuffers * sizeof(messages[0]));
+    for (i = 0; i < nBuffers; ++i) {
+      iovecs[i].iov_base = buffers + i * datagramBufferLength;
+      iovecs[i].iov_len = datagramBufferLength;
+      messages[i].msg_hdr.msg_iov = &iovecs[i];
+      messages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    nReceived = recvmmsg
+      (self->socketDescriptor, messages, nBuffers, MSG_DONTWAIT, 0);
+    if (nReceived < 0) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK)
+        // No more data.
+        return NDN_ERROR_success;
+      return NDN_ERROR_SocketTransport_error_in_recv;
+    }
+
+    for (i = 0; i < (size_t)nReceived; ++i) {
+      if (messages[i].msg_len == 0)
+        continue;
+      if ((error = ndn_ElementReader_onReceivedData
+           (&self->elementReader, buffers + i * datagramBufferLength,
+            messages[i].msg_len)))
+        return error;
+    }
+
+    if ((size_t)nReceived < nBuffers)
+      // We got all the datagrams which were waiting.
+      return NDN_ERROR_success;
+#else
+    // Receive into each buffer until none are left, then process them.
+    size_t nReceived = 0;
+    size_t datagramLengths[MAX_DATAGRAMS_PER_CALL];
+    int gotAll = 0;
+
+    while (nReceived < nBuffers) {
+      int nBytes = recv
+        (self->socketDescriptor, buffers + nReceived * datagramBufferLength,
+         datagramBufferLength, MSG_DONTWAIT);
+      if (nBytes < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+          gotAll = 1;
+          break;
+        }
+        return NDN_ERROR_SocketTransport_error_in_recv;
+      }
+
+      datagramLengths[nReceived] = (size_t)nBytes;
+      ++nReceived;
+    }
+
+    for (i = 0; i < nReceived; ++i) {
+      if (datagramLengths[i] == 0)
+        continue;
+      if ((error = ndn_ElementReader_onReceivedData
+           (&self->elementReader, buffers + i * datagramBufferLength,
+            datagramLengths[i])))
+        return error;
+    }
+
+    if (gotAll)
+      return NDN_ERROR_success;
+#endif
+  }
+}
+
+ndn_Error
+ndn_SocketTransport_sendDatagrams
+  (struct ndn_SocketTransport *self, const uint8_t *data,
+   const size_t *datagramLengths, size_t nDatagrams)
+{
+  if (self->socketDescriptor < 0)
+    return NDN_ERROR_SocketTransport_socket_is_not_open;
+
+#if NDN_CPP_HAVE_RECVMMSG
+  {
+    struct mmsghdr messages[MAX_DATAGRAMS_PER_CALL];
+    struct iovec iovecs[MAX_DATAGRAMS_PER_CALL];
+
+    while (nDatagrams > 0) {
+      size_t nToSend = nDatagrams < MAX_DATAGRAMS_PER_CALL ?
+        nDatagrams : MAX_DATAGRAMS_PER_CALL;
+      const uint8_t *datagram = data;
+      size_t i;
+      int nSent;
+
+      ndn_memset((uint8_t *)messages, 0, nToSend * sizeof(messages[0]));
+      for (i = 0; i < nToSend; ++i) {
+        iovecs[i].iov_base = (void *)datagram;
+        iovecs[i].iov_len = datagramLengths[i];
+        messages[i].msg_hdr.msg_iov = &iovecs[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+        datagram += datagramLengths[i];
+      }
+
+      if ((nSent = sendmmsg(self->socketDescriptor, messages, nToSend, 0)) <= 0)
+        return NDN_ERROR_SocketTransport_error_in_send;
+
+      // sendmmsg may send fewer than requested, so continue after the last sent.
+      for (i = 0; i < (size_t)nSent; ++i)
+        data += datagramLengths[i];
+      datagramLengths += nSent;
+      nDatagrams -= nSent;
+    }
+  }
+#else
+  while (nDatagrams > 0) {
+    ndn_Error error;
+    if ((error = ndn_SocketTransport_send(self, data, *datagramLengths)))
+      return error;
+
+    data += *datagramLengths;
+    ++datagramLengths;
+    --nDatagrams;
+  }
+#endif
+
+  return NDN_ERROR_success;
+}
+
 ndn_Error ndn_SocketTransport_close(struct ndn_SocketTransport *self)
 {
   if (self->socketDescriptor < 0)
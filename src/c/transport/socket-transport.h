@@ -30,6 +30,12 @@
 extern "C" {
 #endif
 
+/**
+ * The maximum number of datagrams for one call to recvmmsg or sendmmsg. A larger
+ * nBuffers for ndn_SocketTransport_processDatagrams is reduced to this.
+ */
+#define MAX_DATAGRAMS_PER_CALL 64
+
 typedef enum {
   SOCKET_TCP,
   SOCKET_UDP,
@@ -120,6 +126,55 @@ ndn_Error
 ndn_SocketTransport_processEvents
   (struct ndn_SocketTransport *self, uint8_t *buffer, size_t bufferLength);
 
+/**
+ * Set the size of the socket receive and send buffers in the kernel. A larger
+ * receive buffer lets a datagram socket hold more packets between calls to
+ * process events. You must call this after connect.
+ * @param self A pointer to the ndn_SocketTransport struct.
+ * @param receiveBufferSize The SO_RCVBUF size in bytes, or 0 to not change it.
+ * @param sendBufferSize The SO_SNDBUF size in bytes, or 0 to not change it.
+ * @return 0 for success, else an error code.
+ */
+ndn_Error
+ndn_SocketTransport_setBufferSizes
+  (struct ndn_SocketTransport *self, int receiveBufferSize, int sendBufferSize);
+
+/**
+ * Process any datagrams to receive, the same as
+ * ndn_SocketTransport_processEvents but receive up to nBuffers datagrams with
+ * each system call (using recvmmsg if available). This is non-blocking and
+ * will return when there are no more datagrams to receive.
+ * @param self A pointer to the ndn_SocketTransport struct.
+ * @param buffers A pointer to nBuffers consecutive buffers, each of
+ * datagramBufferLength bytes, for receiving datagrams. These are only for
+ * temporary use and are reused for each batch.
+ * @param datagramBufferLength The size of each buffer, which should be
+ * MAX_NDN_PACKET_SIZE.
+ * @param nBuffers The number of buffers, which is the maximum number of
+ * datagrams received with one system call. If this is greater than
+ * MAX_DATAGRAMS_PER_CALL, then only use the first MAX_DATAGRAMS_PER_CALL
+ * buffers.
+ * @return 0 for success, else an error code.
+ */
+ndn_Error
+ndn_SocketTransport_processDatagrams
+  (struct ndn_SocketTransport *self, uint8_t *buffers,
+   size_t datagramBufferLength, size_t nBuffers);
+
+/**
+ * Send each datagram to the socket, sending many datagrams with each system
+ * call (using sendmmsg if available).
+ * @param self A pointer to the ndn_SocketTransport struct.
+ * @param data A pointer to the buffer of the datagrams, one after another.
+ * @param datagramLengths An array of the number of bytes in each datagram.
+ * @param nDatagrams The number of datagrams.
+ * @return 0 for success, else an error code.
+ */
+ndn_Error
+ndn_SocketTransport_sendDatagrams
+  (struct ndn_SocketTransport *self, const uint8_t *data,
+   const size_t *datagramLengths, size_t nDatagrams);
+
 /**
  * Close the socket.
  * @param self A pointer to the ndn_SocketTransport struct.
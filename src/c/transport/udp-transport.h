@@ -105,6 +105,60 @@ ndn_UdpTransport_processEvents
   return ndn_SocketTransport_processEvents(&self->base, buffer, bufferLength);
 }
 
+/**
+ * Set the size of the socket receive and send buffers in the kernel. You must
+ * call this after connect.
+ * @param self A pointer to the ndn_UdpTransport struct.
+ * @param receiveBufferSize The SO_RCVBUF size in bytes, or 0 to not change it.
+ * @param sendBufferSize The SO_SNDBUF size in bytes, or 0 to not change it.
+ * @return 0 for success, else an error code.
+ */
+static __inline ndn_Error
+ndn_UdpTransport_setBufferSizes
+  (struct ndn_UdpTransport *self, int receiveBufferSize, int sendBufferSize)
+{
+  return ndn_SocketTransport_setBufferSizes
+    (&self->base, receiveBufferSize, sendBufferSize);
+}
+
+/**
+ * Process any datagrams to receive, receiving up to nBuffers datagrams with
+ * each system call. See ndn_SocketTransport_processDatagrams.
+ * @param self A pointer to the ndn_UdpTransport struct.
+ * @param buffers A pointer to nBuffers consecutive buffers, each of
+ * datagramBufferLength bytes, for receiving datagrams.
+ * @param datagramBufferLength The size of each buffer, which should be
+ * MAX_NDN_PACKET_SIZE.
+ * @param nBuffers The number of buffers.
+ * @return 0 for success, else an error code.
+ */
+static __inline ndn_Error
+ndn_UdpTransport_processDatagrams
+  (struct ndn_UdpTransport *self, uint8_t *buffers,
+   size_t datagramBufferLength, size_t nBuffers)
+{
+  return ndn_SocketTransport_processDatagrams
+    (&self->base, buffers, datagramBufferLength, nBuffers);
+}
+
+/**
+ * Send each datagram to the socket, sending many datagrams with each system
+ * call. See ndn_SocketTransport_sendDatagrams.
+ * @param self A pointer to the ndn_UdpTransport struct.
+ * @param data A pointer to the buffer of the datagrams, one after another.
+ * @param datagramLengths An array of the number of bytes in each datagram.
+ * @param nDatagrams The number of datagrams.
+ * @return 0 for success, else an error code.
+ */
+static __inline ndn_Error
+ndn_UdpTransport_sendDatagrams
+  (struct ndn_UdpTransport *self, const uint8_t *data,
+   const size_t *datagramLengths, size_t nDatagrams)
+{
+  return ndn_SocketTransport_sendDatagrams
+    (&self->base, data, datagramLengths, nDatagrams);
+}
+
 /**
  * Close the socket.
  * @param self A pointer to the ndn_UdpTransport struct.
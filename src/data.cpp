@@ -23,6 +23,7 @@
 #include <ndn-cpp/common.hpp>
 #include <ndn-cpp/digest-sha256-signature.hpp>
 #include <ndn-cpp/sha256-with-ecdsa-signature.hpp>
+#include <ndn-cpp/merkle-signature.hpp>
 #include <ndn-cpp/sha256-with-rsa-signature.hpp>
 #include <ndn-cpp/hmac-with-sha256-signature.hpp>
 #include <ndn-cpp/generic-signature.hpp>
@@ -40,7 +41,8 @@ Data::Data()
 : signature_(new Sha256WithRsaSignature()),
   changeCount_(0),
   defaultFullName_(new Name()),
-  getDefaultWireEncodingChangeCount_(0)
+  getDefaultWireEncodingChangeCount_(0),
+  lazyWireFormat_(0)
 {
 }
 
@@ -49,7 +51,8 @@ Data::Data(const Name& name)
   signature_(new Sha256WithRsaSignature()),
   changeCount_(0),
   defaultFullName_(new Name()),
-  getDefaultWireEncodingChangeCount_(0)
+  getDefaultWireEncodingChangeCount_(0),
+  lazyWireFormat_(0)
 {
 }
 
@@ -57,8 +60,11 @@ Data::Data(const Data& data)
 : name_(data.name_),
   metaInfo_(data.metaInfo_),
   content_(data.content_),
-  defaultFullName_(new Name(*data.defaultFullName_)),
-  changeCount_(0)
+  defaultFullName_(new Name()),
+  changeCount_(0),
+  // Copy the encoding of the fields which are not decoded yet, if any.
+  lazyEncoding_(data.lazyEncoding_),
+  lazyWireFormat_(data.lazyWireFormat_)
 {
   if (data.signature_.get()) {
     signature_.set(data.signature_.get()->clone());
@@ -66,6 +72,8 @@ Data::Data(const Data& data)
   }
   setDefaultWireEncoding
     (data.getDefaultWireEncoding(), data.defaultWireEncodingFormat_);
+  // Copy the full name after setting the encoding which it was computed from.
+  defaultFullName_.reset(new Name(*data.defaultFullName_));
 }
 
 Data::~Data()
@@ -74,6 +82,14 @@ Data::~Data()
 
 Data& Data::operator=(const Data& data)
 {
+  // The fields below replace any fields which are not decoded yet, so clear
+  // the lazy encoding before calling the setters. Save the values in case
+  // data is this object.
+  Blob lazyEncoding = data.lazyEncoding_;
+  WireFormat* lazyWireFormat = data.lazyWireFormat_;
+  lazyEncoding_ = Blob();
+  lazyWireFormat_ = 0;
+
   if (data.signature_.get())
     signature_.set(data.signature_.get()->clone());
   else
@@ -84,6 +100,8 @@ Data& Data::operator=(const Data& data)
   setContent(data.content_);
   setDefaultWireEncoding
     (data.defaultWireEncoding_, data.defaultWireEncodingFormat_);
+  lazyEncoding_ = lazyEncoding;
+  lazyWireFormat_ = lazyWireFormat;
 
   return *this;
 }
@@ -136,6 +154,7 @@ Data::getFullName(WireFormat& wireFormat) const
 void
 Data::get(DataLite& dataLite) const
 {
+  decodeLazyFields();
   signature_.get()->get(dataLite.getSignature());
   name_.get().get(dataLite.getName());
   metaInfo_.get().get(dataLite.getMetaInfo());
@@ -144,6 +163,17 @@ Data::get(DataLite& dataLite) const
 
 void
 Data::set(const DataLite& dataLite)
+{
+  // This replaces all the fields.
+  lazyEncoding_ = Blob();
+  lazyWireFormat_ = 0;
+
+  name_.get().set(dataLite.getName());
+  setFieldsExceptName(dataLite);
+}
+
+void
+Data::setFieldsExceptName(const DataLite& dataLite)
 {
   if (dataLite.getSignature().getType() == ndn_SignatureType_Sha256WithRsaSignature)
     signature_.set(ptr_lib::shared_ptr<Signature>(new Sha256WithRsaSignature()));
@@ -151,6 +181,8 @@ Data::set(const DataLite& dataLite)
     signature_.set(ptr_lib::shared_ptr<Signature>(new Sha256WithEcdsaSignature()));
   else if (dataLite.getSignature().getType() == ndn_SignatureType_HmacWithSha256Signature)
     signature_.set(ptr_lib::shared_ptr<Signature>(new HmacWithSha256Signature()));
+  else if (dataLite.getSignature().getType() == ndn_SignatureType_MerkleSignature)
+    signature_.set(ptr_lib::shared_ptr<Signature>(new MerkleSignature()));
   else if (dataLite.getSignature().getType() == ndn_SignatureType_DigestSha256Signature)
     signature_.set(ptr_lib::shared_ptr<Signature>(new DigestSha256Signature()));
   else if (dataLite.getSignature().getType() == ndn_SignatureType_Generic)
@@ -161,7 +193,6 @@ Data::set(const DataLite& dataLite)
 
   signature_.get()->set(dataLite.getSignature());
 
-  name_.get().set(dataLite.getName());
   metaInfo_.get().set(dataLite.getMetaInfo());
   setContent(Blob(dataLite.getContent()));
 }
@@ -196,6 +227,9 @@ Data::wireEncode(WireFormat& wireFormat) const
 void
 Data::wireDecode(const Blob& input, WireFormat& wireFormat)
 {
+  lazyEncoding_ = Blob();
+  lazyWireFormat_ = 0;
+
   size_t signedPortionBeginOffset, signedPortionEndOffset;
   wireFormat.decodeData(*this, input.buf(), input.size(), &signedPortionBeginOffset, &signedPortionEndOffset);
 
@@ -209,4 +243,46 @@ Data::wireDecode(const Blob& input, WireFormat& wireFormat)
     setDefaultWireEncoding(SignedBlob(), 0);
 }
 
+void
+Data::wireDecodeLazy(const Blob& input, WireFormat& wireFormat)
+{
+  size_t signedPortionBeginOffset, signedPortionEndOffset;
+  wireFormat.decodeDataName
+    (name_.get(), input.buf(), input.size(), &signedPortionBeginOffset,
+     &signedPortionEndOffset);
+  ++changeCount_;
+  lazyEncoding_ = input;
+  lazyWireFormat_ = &wireFormat;
+
+  if (&wireFormat == WireFormat::getDefaultWireFormat())
+    // This is the default wire encoding.
+    // Take a pointer to the input Blob without copying.
+    setDefaultWireEncoding
+      (SignedBlob(input, signedPortionBeginOffset, signedPortionEndOffset),
+       WireFormat::getDefaultWireFormat());
+  else
+    setDefaultWireEncoding(SignedBlob(), 0);
+}
+
+void
+Data::finishLazyDecode()
+{
+  Blob encoding = lazyEncoding_;
+  WireFormat* wireFormat = lazyWireFormat_;
+  // Clear first so that the methods below don't try to decode again.
+  lazyEncoding_ = Blob();
+  lazyWireFormat_ = 0;
+
+  // getDefaultWireEncoding() is null if the name has changed.
+  SignedBlob defaultWireEncoding = getDefaultWireEncoding();
+  WireFormat* defaultWireEncodingFormat = defaultWireEncodingFormat_;
+
+  wireFormat->decodeDataFields(*this, encoding.buf(), encoding.size());
+  ++changeCount_;
+
+  if (!defaultWireEncoding.isNull())
+    // The decoded fields are the same as the encoding, so restore it.
+    setDefaultWireEncoding(defaultWireEncoding, defaultWireEncodingFormat);
+}
+
 }
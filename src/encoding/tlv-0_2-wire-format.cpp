@@ -27,6 +27,7 @@
 #include <ndn-cpp/digest-sha256-signature.hpp>
 #include <ndn-cpp/sha256-with-rsa-signature.hpp>
 #include <ndn-cpp/sha256-with-ecdsa-signature.hpp>
+#include <ndn-cpp/merkle-signature.hpp>
 #include <ndn-cpp/hmac-with-sha256-signature.hpp>
 #include <ndn-cpp/generic-signature.hpp>
 #include <ndn-cpp/delegation-set.hpp>
@@ -170,6 +171,96 @@ Tlv0_2WireFormat::decodeData
   data.set(dataLite);
 }
 
+void
+Tlv0_2WireFormat::decodeInterestName
+  (Name& name, const uint8_t *input, size_t inputLength,
+   size_t *signedPortionBeginOffset, size_t *signedPortionEndOffset)
+{
+  struct ndn_NameComponent nameComponents[100];
+  struct ndn_ExcludeEntry excludeEntries[100];
+  struct ndn_NameComponent keyNameComponents[100];
+  InterestLite interestLite
+    (nameComponents, sizeof(nameComponents) / sizeof(nameComponents[0]),
+     excludeEntries, sizeof(excludeEntries) / sizeof(excludeEntries[0]),
+     keyNameComponents, sizeof(keyNameComponents) / sizeof(keyNameComponents[0]));
+
+  ndn_Error error;
+  if ((error = Tlv0_2WireFormatLite::decodeInterest
+       (interestLite, input, inputLength, signedPortionBeginOffset,
+        signedPortionEndOffset)))
+    throw runtime_error(ndn_getErrorString(error));
+
+  if (interestLite.getForwardingHintWireEncoding().buf()) {
+    // Throw any decoding exceptions now, the same as decodeInterest.
+    DelegationSet delegationSet;
+    decodeDelegationSet
+      (delegationSet, interestLite.getForwardingHintWireEncoding().buf(),
+       interestLite.getForwardingHintWireEncoding().size());
+  }
+
+  name.set(interestLite.getName());
+}
+
+void
+Tlv0_2WireFormat::decodeDataName
+  (Name& name, const uint8_t *input, size_t inputLength,
+   size_t *signedPortionBeginOffset, size_t *signedPortionEndOffset)
+{
+  struct ndn_NameComponent nameComponents[100];
+  struct ndn_NameComponent keyNameComponents[100];
+  DataLite dataLite
+    (nameComponents, sizeof(nameComponents) / sizeof(nameComponents[0]),
+     keyNameComponents, sizeof(keyNameComponents) / sizeof(keyNameComponents[0]));
+
+  ndn_Error error;
+  if ((error = Tlv0_2WireFormatLite::decodeData
+       (dataLite, input, inputLength, signedPortionBeginOffset,
+        signedPortionEndOffset)))
+    throw runtime_error(ndn_getErrorString(error));
+
+  name.set(dataLite.getName());
+}
+
+void
+Tlv0_2WireFormat::decodeInterestFields
+  (Interest& interest, const uint8_t *input, size_t inputLength)
+{
+  struct ndn_NameComponent nameComponents[100];
+  struct ndn_ExcludeEntry excludeEntries[100];
+  struct ndn_NameComponent keyNameComponents[100];
+  InterestLite interestLite
+    (nameComponents, sizeof(nameComponents) / sizeof(nameComponents[0]),
+     excludeEntries, sizeof(excludeEntries) / sizeof(excludeEntries[0]),
+     keyNameComponents, sizeof(keyNameComponents) / sizeof(keyNameComponents[0]));
+
+  size_t dummyBeginOffset, dummyEndOffset;
+  ndn_Error error;
+  if ((error = Tlv0_2WireFormatLite::decodeInterest
+       (interestLite, input, inputLength, &dummyBeginOffset, &dummyEndOffset)))
+    throw runtime_error(ndn_getErrorString(error));
+
+  interest.setFieldsExceptName(interestLite, *this);
+}
+
+void
+Tlv0_2WireFormat::decodeDataFields
+  (Data& data, const uint8_t *input, size_t inputLength)
+{
+  struct ndn_NameComponent nameComponents[100];
+  struct ndn_NameComponent keyNameComponents[100];
+  DataLite dataLite
+    (nameComponents, sizeof(nameComponents) / sizeof(nameComponents[0]),
+     keyNameComponents, sizeof(keyNameComponents) / sizeof(keyNameComponents[0]));
+
+  size_t dummyBeginOffset, dummyEndOffset;
+  ndn_Error error;
+  if ((error = Tlv0_2WireFormatLite::decodeData
+       (dataLite, input, inputLength, &dummyBeginOffset, &dummyEndOffset)))
+    throw runtime_error(ndn_getErrorString(error));
+
+  data.setFieldsExceptName(dataLite);
+}
+
 Blob
 Tlv0_2WireFormat::encodeControlParameters
   (const ControlParameters& controlParameters)
@@ -313,6 +404,8 @@ Tlv0_2WireFormat::decodeSignatureInfoAndValue
     result.reset(new Sha256WithEcdsaSignature());
   else if (signatureLite.getType() == ndn_SignatureType_HmacWithSha256Signature)
     result.reset(new HmacWithSha256Signature());
+  else if (signatureLite.getType() == ndn_SignatureType_MerkleSignature)
+    result.reset(new MerkleSignature());
   else if (signatureLite.getType() == ndn_SignatureType_DigestSha256Signature)
     result.reset(new DigestSha256Signature());
   else if (signatureLite.getType() == ndn_SignatureType_Generic)
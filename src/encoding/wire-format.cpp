@@ -20,6 +20,8 @@
  */
 
 #include <stdexcept>
+#include <ndn-cpp/interest.hpp>
+#include <ndn-cpp/data.hpp>
 #include <ndn-cpp/encoding/wire-format.hpp>
 
 using namespace std;
@@ -85,6 +87,63 @@ WireFormat::decodeData
   throw logic_error("unimplemented");
 }
 
+void
+WireFormat::decodeInterestName
+  (Name& name, const uint8_t *input, size_t inputLength,
+   size_t *signedPortionBeginOffset, size_t *signedPortionEndOffset)
+{
+  Interest interest;
+  decodeInterest
+    (interest, input, inputLength, signedPortionBeginOffset,
+     signedPortionEndOffset);
+  name = interest.getName();
+}
+
+void
+WireFormat::decodeDataName
+  (Name& name, const uint8_t *input, size_t inputLength,
+   size_t *signedPortionBeginOffset, size_t *signedPortionEndOffset)
+{
+  Data data;
+  decodeData
+    (data, input, inputLength, signedPortionBeginOffset,
+     signedPortionEndOffset);
+  name = data.getName();
+}
+
+void
+WireFormat::decodeInterestFields
+  (Interest& interest, const uint8_t *input, size_t inputLength)
+{
+  Interest decoded;
+  decodeInterest(decoded, input, inputLength);
+  interest.minSuffixComponents_ = decoded.minSuffixComponents_;
+  interest.maxSuffixComponents_ = decoded.maxSuffixComponents_;
+  interest.keyLocator_.set(decoded.keyLocator_.get());
+  interest.exclude_.set(decoded.exclude_.get());
+  interest.childSelector_ = decoded.childSelector_;
+  interest.mustBeFresh_ = decoded.mustBeFresh_;
+  interest.interestLifetimeMilliseconds_ =
+    decoded.interestLifetimeMilliseconds_;
+  interest.forwardingHint_.set(decoded.forwardingHint_.get());
+  interest.linkWireEncoding_ = decoded.linkWireEncoding_;
+  interest.linkWireEncodingFormat_ = decoded.linkWireEncodingFormat_;
+  interest.link_.set(ptr_lib::shared_ptr<Link>());
+  interest.selectedDelegationIndex_ = decoded.selectedDelegationIndex_;
+  interest.nonce_ = decoded.nonce_;
+}
+
+void
+WireFormat::decodeDataFields
+  (Data& data, const uint8_t *input, size_t inputLength)
+{
+  Data decoded;
+  decodeData(decoded, input, inputLength);
+  data.signature_.set(decoded.signature_.get()->clone());
+  data.metaInfo_.set(decoded.metaInfo_.get());
+  data.content_ = decoded.content_;
+}
+
 Blob
 WireFormat::encodeControlParameters(const ControlParameters& controlParameters)
 {
@@ -0,0 +1,233 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2018 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+#include <stdexcept>
+#include <ndn-cpp/ndn-cpp-config.h>
+#if NDN_CPP_HAVE_LIBCRYPTO
+#include <openssl/evp.h>
+#endif
+#include <ndn-cpp/encrypt/algo/aes-stream-cipher.hpp>
+
+using namespace std;
+
+namespace ndn {
+
+#if NDN_CPP_HAVE_LIBCRYPTO
+
+/**
+ * Get the OpenSSL cipher for the mode and key size.
+ * @param mode The cipher mode.
+ * @param keySize The key size in bytes.
+ * @return The cipher.
+ * @throws std::invalid_argument for an invalid key size.
+ */
+static const EVP_CIPHER*
+getCipher(AesStreamCipher::Mode mode, size_t keySize)
+{
+  if (keySize == 16)
+    return mode == AesStreamCipher::MODE_GCM ? EVP_aes_128_gcm() : EVP_aes_128_cbc();
+  else if (keySize == 32)
+    return mode == AesStreamCipher::MODE_GCM ? EVP_aes_256_gcm() : EVP_aes_256_cbc();
+  else
+    throw invalid_argument("AesStreamCipher: The key must be 16 or 32 bytes");
+}
+
+AesStreamCipher::AesStreamCipher
+  (Mode mode, bool isEncrypt, const Blob& keyBits, const Blob& initialVector)
+: mode_(mode), isEncrypt_(isEncrypt), isFinished_(false), context_(0)
+{
+  const EVP_CIPHER* cipher = getCipher(mode, keyBits.size());
+  checkInitialVector(initialVector);
+
+  context_ = EVP_CIPHER_CTX_new();
+  if (!context_)
+    throw runtime_error("AesStreamCipher: Error creating the cipher context");
+
+  // Set the cipher and IV length first, then the key and IV.
+  int success = EVP_CipherInit_ex(context_, cipher, 0, 0, 0, isEncrypt ? 1 : 0);
+  if (success && mode == MODE_GCM)
+    success = EVP_CIPHER_CTX_ctrl
+      (context_, EVP_CTRL_GCM_SET_IVLEN, initialVector.size(), 0);
+  if (success)
+    success = EVP_CipherInit_ex
+      (context_, 0, 0, keyBits.buf(), initialVector.buf(), isEncrypt ? 1 : 0);
+  if (!success) {
+    EVP_CIPHER_CTX_free(context_);
+    throw runtime_error("AesStreamCipher: Error initializing the cipher");
+  }
+}
+
+AesStreamCipher::~AesStreamCipher()
+{
+  EVP_CIPHER_CTX_free(context_);
+}
+
+void
+AesStreamCipher::reset(const Blob& initialVector)
+{
+  checkInitialVector(initialVector);
+
+  if (mode_ == MODE_GCM &&
+      !EVP_CIPHER_CTX_ctrl
+       (context_, EVP_CTRL_GCM_SET_IVLEN, initialVector.size(), 0))
+    throw runtime_error("AesStreamCipher: Error setting the IV length");
+  // A null cipher and key keep the existing key schedule.
+  if (!EVP_CipherInit_ex
+      (context_, 0, 0, 0, initialVector.buf(), isEncrypt_ ? 1 : 0))
+    throw runtime_error("AesStreamCipher: Error resetting the cipher");
+
+  isFinished_ = false;
+  tag_ = Blob();
+}
+
+size_t
+AesStreamCipher::update(const uint8_t* input, size_t inputLength, uint8_t* output)
+{
+  if (isFinished_)
+    throw runtime_error("AesStreamCipher: update called after finish");
+
+  int outputLength;
+  if (!EVP_CipherUpdate(context_, output, &outputLength, input, inputLength))
+    throw runtime_error("AesStreamCipher: Error in update");
+  return outputLength;
+}
+
+size_t
+AesStreamCipher::finish(uint8_t* output)
+{
+  if (isFinished_)
+    throw runtime_error("AesStreamCipher: finish was already called");
+
+  if (mode_ == MODE_GCM && !isEncrypt_) {
+    if (tag_.size() != GCM_TAG_SIZE)
+      throw runtime_error("AesStreamCipher: Call setTag before finish");
+    if (!EVP_CIPHER_CTX_ctrl
+        (context_, EVP_CTRL_GCM_SET_TAG, tag_.size(), (void*)tag_.buf()))
+      throw runtime_error("AesStreamCipher: Error setting the tag");
+  }
+
+  int outputLength;
+  if (!EVP_CipherFinal_ex(context_, output, &outputLength)) {
+    isFinished_ = true;
+    if (mode_ == MODE_GCM)
+      throw runtime_error("AesStreamCipher: The GCM tag does not verify");
+    else
+      throw runtime_error("AesStreamCipher: Bad padding or incomplete block");
+  }
+  isFinished_ = true;
+
+  if (mode_ == MODE_GCM && isEncrypt_) {
+    uint8_t tag[GCM_TAG_SIZE];
+    if (!EVP_CIPHER_CTX_ctrl
+        (context_, EVP_CTRL_GCM_GET_TAG, sizeof(tag), tag))
+      throw runtime_error("AesStreamCipher: Error getting the tag");
+    tag_ = Blob(tag, sizeof(tag));
+  }
+
+  return outputLength;
+}
+
+void
+AesStreamCipher::setTag(const Blob& tag)
+{
+  if (mode_ != MODE_GCM || isEncrypt_)
+    throw runtime_error("AesStreamCipher: setTag is only for GCM decryption");
+  if (tag.size() != GCM_TAG_SIZE)
+    throw runtime_error("AesStreamCipher: The tag has the wrong size");
+
+  tag_ = tag;
+}
+
+#else // NDN_CPP_HAVE_LIBCRYPTO
+
+AesStreamCipher::AesStreamCipher
+  (Mode mode, bool isEncrypt, const Blob& keyBits, const Blob& initialVector)
+: mode_(mode), isEncrypt_(isEncrypt), isFinished_(false), context_(0)
+{
+  throw runtime_error
+    ("AesStreamCipher: Not supported without the OpenSSL crypto library");
+}
+
+AesStreamCipher::~AesStreamCipher()
+{
+}
+
+void
+AesStreamCipher::reset(const Blob& initialVector) {}
+
+size_t
+AesStreamCipher::update(const uint8_t* input, size_t inputLength, uint8_t* output)
+{
+  return 0;
+}
+
+size_t
+AesStreamCipher::finish(uint8_t* output) { return 0; }
+
+void
+AesStreamCipher::setTag(const Blob& tag) {}
+
+#endif // NDN_CPP_HAVE_LIBCRYPTO
+
+Blob
+AesStreamCipher::update(const Blob& input)
+{
+  ptr_lib::shared_ptr<vector<uint8_t> > output
+    (new vector<uint8_t>(getMaxUpdateOutputSize(input.size())));
+  output->resize(update(input.buf(), input.size(), &output->front()));
+  return Blob(output, false);
+}
+
+Blob
+AesStreamCipher::finish()
+{
+  uint8_t output[BLOCK_SIZE];
+  size_t outputLength = finish(output);
+  return Blob(output, outputLength);
+}
+
+Blob
+AesStreamCipher::getTag() const
+{
+  if (mode_ != MODE_GCM || !isEncrypt_ || !isFinished_)
+    throw runtime_error
+      ("AesStreamCipher: getTag is only for GCM encryption after finish");
+
+  return tag_;
+}
+
+void
+AesStreamCipher::checkInitialVector(const Blob& initialVector) const
+{
+  if (mode_ == MODE_CBC) {
+    if (initialVector.size() != BLOCK_SIZE)
+      throw invalid_argument
+        ("AesStreamCipher: The CBC initial vector must be 16 bytes");
+  }
+  else if (initialVector.size() == 0)
+    throw invalid_argument("AesStreamCipher: The GCM initial vector is empty");
+}
+
+const size_t AesStreamCipher::BLOCK_SIZE;
+const size_t AesStreamCipher::GCM_IV_SIZE;
+const size_t AesStreamCipher::GCM_TAG_SIZE;
+
+}
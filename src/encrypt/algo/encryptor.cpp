@@ -25,6 +25,7 @@
 #include <ndn-cpp/encrypt/encrypted-content.hpp>
 #include <ndn-cpp/encoding/tlv-wire-format.hpp>
 #include <ndn-cpp/encrypt/algo/aes-algorithm.hpp>
+#include <ndn-cpp/encrypt/algo/aes-stream-cipher.hpp>
 #include <ndn-cpp/encrypt/algo/rsa-algorithm.hpp>
 #include <ndn-cpp/lite/util/crypto-lite.hpp>
 #include "../../c/util/ndn_memory.h"
@@ -165,6 +166,31 @@ Encryptor::encryptData
     throw runtime_error("Unsupported encryption method");
 }
 
+void
+Encryptor::encryptData
+  (Data& data, const Blob& payload, const Name& keyName,
+   AesStreamCipher& cipher, const Blob& initialVector)
+{
+  data.getName().append(getNAME_COMPONENT_FOR()).append(keyName);
+
+  cipher.reset(initialVector);
+  ptr_lib::shared_ptr<vector<uint8_t> > encryptedPayload(new vector<uint8_t>
+    (AesStreamCipher::getMaxUpdateOutputSize(payload.size()) +
+     AesStreamCipher::BLOCK_SIZE));
+  size_t length = cipher.update
+    (payload.buf(), payload.size(), &encryptedPayload->front());
+  length += cipher.finish(&encryptedPayload->front() + length);
+  encryptedPayload->resize(length);
+
+  EncryptedContent content;
+  content.getKeyLocator().setType(ndn_KeyLocatorType_KEYNAME);
+  content.getKeyLocator().setKeyName(keyName);
+  content.setAlgorithmType(ndn_EncryptAlgorithmType_AesCbc);
+  content.setPayload(Blob(encryptedPayload, false));
+  content.setInitialVector(initialVector);
+  data.setContent(content.wireEncode(*TlvWireFormat::get()));
+}
+
 Encryptor::Values* Encryptor::values_ = 0;
 
 }
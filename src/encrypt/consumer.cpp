@@ -26,6 +26,7 @@
 #include <ndn-cpp/encrypt/algo/rsa-algorithm.hpp>
 #include <ndn-cpp/encrypt/algo/encryptor.hpp>
 #include <ndn-cpp/encrypt/consumer.hpp>
+#include "../c/util/time.h"
 
 using namespace std;
 using namespace ndn::func_lib;
@@ -44,7 +45,9 @@ Consumer::Impl::Impl
   consumerName_(consumerName),
   database_(database),
   cKeyLink_(new Link(cKeyLink)),
-  dKeyLink_(new Link(dKeyLink))
+  cKeyCache_(getDefaultKeyCacheCapacity(), getDefaultKeyCacheLifetime()),
+  dKeyLink_(new Link(dKeyLink)),
+  dKeyCache_(getDefaultKeyCacheCapacity(), getDefaultKeyCacheLifetime())
 {
 }
 
@@ -231,59 +234,43 @@ Consumer::Impl::decryptContent
   }
   const Name& cKeyName = dataEncryptedContent->getKeyLocator().getKeyName();
 
-  // Check if the content key is already in the store.
-  if (cKeyMap_.find(cKeyName) != cKeyMap_.end())
-    decryptEncryptedContent
-      (*dataEncryptedContent, cKeyMap_[cKeyName], onPlainText, onError);
-  else {
-    // Retrieve the C-KEY Data from the network.
-    Name interestName(cKeyName);
-    interestName.append(Encryptor::getNAME_COMPONENT_FOR()).append(groupName_);
-    ptr_lib::shared_ptr<const Interest> interest(new Interest(interestName));
-
-    // Prepare the callbacks. We make a shared_ptr object since it needs to
-    // exist after we call expressInterest and return.
-    class Callbacks : public ptr_lib::enable_shared_from_this<Callbacks> {
-    public:
-      Callbacks
-        (Consumer::Impl* parent,
-         const ptr_lib::shared_ptr<EncryptedContent>& dataEncryptedContent,
-         const Name& cKeyName, const OnPlainText& onPlainText,
-         const EncryptError::OnError& onError)
-      : parent_(parent), dataEncryptedContent_(dataEncryptedContent),
-        cKeyName_(cKeyName), onPlainText_(onPlainText), onError_(onError)
-      {}
-
-      void
-      onCKeyVerified(const ptr_lib::shared_ptr<Data>& validCKeyData)
-      {
-        parent_->decryptCKey
-          (*validCKeyData,
-           bind(&Callbacks::onCKeyPlainText, shared_from_this(), _1),
-           onError_);
-      }
+  if (!decryptWithCachedKey
+      (cKeyCache_, pendingCKeys_, cKeyName, dataEncryptedContent, onPlainText,
+       onError))
+    return;
 
-      void
-      onCKeyPlainText(const Blob& cKeyBits)
-      {
-        parent_->cKeyMap_[cKeyName_] = cKeyBits;
-        parent_->decryptEncryptedContent
-          (*dataEncryptedContent_, cKeyBits, onPlainText_, onError_);
-      }
+  // Retrieve the C-KEY Data from the network. When the C-KEY is decrypted,
+  // decrypt all the content which is waiting for it.
+  Name interestName(cKeyName);
+  interestName.append(Encryptor::getNAME_COMPONENT_FOR()).append(groupName_);
+  ptr_lib::shared_ptr<const Interest> interest(new Interest(interestName));
 
-      Consumer::Impl* parent_;
-      ptr_lib::shared_ptr<EncryptedContent> dataEncryptedContent_;
-      Name cKeyName_;
-      OnPlainText onPlainText_;
-      EncryptError::OnError onError_;
-    };
-
-    ptr_lib::shared_ptr<Callbacks> callbacks(new Callbacks
-      (this, dataEncryptedContent, cKeyName, onPlainText, onError));
-    sendInterest
-      (interest, 1, cKeyLink_, bind(&Callbacks::onCKeyVerified, callbacks, _1),
-       onError);
-  }
+  // Prepare the callbacks. We make a shared_ptr object since it needs to
+  // exist after we call expressInterest and return.
+  class Callbacks {
+  public:
+    Callbacks(Consumer::Impl* parent, const Name& cKeyName)
+    : parent_(parent), cKeyName_(cKeyName)
+    {}
+
+    void
+    onCKeyVerified(const ptr_lib::shared_ptr<Data>& validCKeyData)
+    {
+      parent_->decryptCKey
+        (*validCKeyData,
+         bind(&Impl::onKeyPlainText, &parent_->cKeyCache_,
+              &parent_->pendingCKeys_, cKeyName_, _1),
+         bind(&Impl::onKeyError, &parent_->pendingCKeys_, cKeyName_, _1, _2));
+    }
+
+    Consumer::Impl* parent_;
+    Name cKeyName_;
+  };
+
+  ptr_lib::shared_ptr<Callbacks> callbacks(new Callbacks(this, cKeyName));
+  sendInterest
+    (interest, 1, cKeyLink_, bind(&Callbacks::onCKeyVerified, callbacks, _1),
+     bind(&Impl::onKeyError, &pendingCKeys_, cKeyName, _1, _2));
 }
 
 void
@@ -313,59 +300,43 @@ Consumer::Impl::decryptCKey
   dKeyName.append(Encryptor::getNAME_COMPONENT_D_KEY())
     .append(eKeyName.getSubName(-2));
 
-  // Check if the decryption key is already in the store.
-  if (dKeyMap_.find(dKeyName) != dKeyMap_.end())
-    decryptEncryptedContent
-      (*cKeyEncryptedContent, dKeyMap_[dKeyName], onPlainText, onError);
-  else {
-    // Get the D-Key Data.
-    Name interestName(dKeyName);
-    interestName.append(Encryptor::getNAME_COMPONENT_FOR()).append(consumerName_);
-    ptr_lib::shared_ptr<const Interest> interest(new Interest(interestName));
-
-    // Prepare the callbacks. We make a shared_ptr object since it needs to
-    // exist after we call expressInterest and return.
-    class Callbacks : public ptr_lib::enable_shared_from_this<Callbacks> {
-    public:
-      Callbacks
-        (Consumer::Impl* parent,
-         const ptr_lib::shared_ptr<EncryptedContent>& cKeyEncryptedContent,
-         const Name& dKeyName, const OnPlainText& onPlainText,
-         const EncryptError::OnError& onError)
-      : parent_(parent), cKeyEncryptedContent_(cKeyEncryptedContent),
-        dKeyName_(dKeyName), onPlainText_(onPlainText), onError_(onError)
-      {}
-
-      void
-      onDKeyVerified(const ptr_lib::shared_ptr<Data>& validDKeyData)
-      {
-        parent_->decryptDKey
-          (*validDKeyData,
-           bind(&Callbacks::onDKeyPlainText, shared_from_this(), _1),
-           onError_);
-      }
+  if (!decryptWithCachedKey
+      (dKeyCache_, pendingDKeys_, dKeyName, cKeyEncryptedContent, onPlainText,
+       onError))
+    return;
 
-      void
-      onDKeyPlainText(const Blob& dKeyBits)
-      {
-        parent_->dKeyMap_[dKeyName_] = dKeyBits;
-        parent_->decryptEncryptedContent
-          (*cKeyEncryptedContent_, dKeyBits, onPlainText_, onError_);
-      }
+  // Get the D-Key Data. When the D-KEY is decrypted, decrypt all the C-KEYs
+  // which are waiting for it.
+  Name interestName(dKeyName);
+  interestName.append(Encryptor::getNAME_COMPONENT_FOR()).append(consumerName_);
+  ptr_lib::shared_ptr<const Interest> interest(new Interest(interestName));
 
-      Consumer::Impl* parent_;
-      ptr_lib::shared_ptr<EncryptedContent> cKeyEncryptedContent_;
-      Name dKeyName_;
-      OnPlainText onPlainText_;
-      EncryptError::OnError onError_;
-    };
-
-    ptr_lib::shared_ptr<Callbacks> callbacks(new Callbacks
-      (this, cKeyEncryptedContent, dKeyName, onPlainText, onError));
-    sendInterest
-      (interest, 1, dKeyLink_, bind(&Callbacks::onDKeyVerified, callbacks, _1),
-       onError);
-  }
+  // Prepare the callbacks. We make a shared_ptr object since it needs to
+  // exist after we call expressInterest and return.
+  class Callbacks {
+  public:
+    Callbacks(Consumer::Impl* parent, const Name& dKeyName)
+    : parent_(parent), dKeyName_(dKeyName)
+    {}
+
+    void
+    onDKeyVerified(const ptr_lib::shared_ptr<Data>& validDKeyData)
+    {
+      parent_->decryptDKey
+        (*validDKeyData,
+         bind(&Impl::onKeyPlainText, &parent_->dKeyCache_,
+              &parent_->pendingDKeys_, dKeyName_, _1),
+         bind(&Impl::onKeyError, &parent_->pendingDKeys_, dKeyName_, _1, _2));
+    }
+
+    Consumer::Impl* parent_;
+    Name dKeyName_;
+  };
+
+  ptr_lib::shared_ptr<Callbacks> callbacks(new Callbacks(this, dKeyName));
+  sendInterest
+    (interest, 1, dKeyLink_, bind(&Callbacks::onDKeyVerified, callbacks, _1),
+     bind(&Impl::onKeyError, &pendingDKeys_, dKeyName, _1, _2));
 }
 
 void
@@ -445,6 +416,79 @@ Consumer::Impl::decryptDKey
      onError);
 }
 
+bool
+Consumer::Impl::decryptWithCachedKey
+  (KeyCache& keyCache, PendingMap& pendingMap, const Name& keyName,
+   const ptr_lib::shared_ptr<EncryptedContent>& encryptedContent,
+   const OnPlainText& onPlainText, const EncryptError::OnError& onError)
+{
+  Blob keyBits;
+  if (keyCache.find(keyName, keyBits)) {
+    decryptEncryptedContent(*encryptedContent, keyBits, onPlainText, onError);
+    return false;
+  }
+
+  PendingMap::iterator pending = pendingMap.find(keyName);
+  if (pending != pendingMap.end()) {
+    // Another call is already fetching the key, so wait for it.
+    _LOG_TRACE("Waiting for the pending fetch of " << keyName);
+    pending->second.push_back
+      (PendingDecryption(encryptedContent, onPlainText, onError));
+    return false;
+  }
+
+  pendingMap[keyName].push_back
+    (PendingDecryption(encryptedContent, onPlainText, onError));
+  return true;
+}
+
+void
+Consumer::Impl::onKeyPlainText
+  (KeyCache* keyCache, PendingMap* pendingMap, const Name& keyName,
+   const Blob& keyBits)
+{
+  keyCache->insert(keyName, keyBits);
+
+  PendingMap::iterator pending = pendingMap->find(keyName);
+  if (pending == pendingMap->end())
+    // We don't expect this to happen.
+    return;
+  // Remove the entry before decrypting in case a callback fetches the key again.
+  vector<PendingDecryption> decryptions;
+  decryptions.swap(pending->second);
+  pendingMap->erase(pending);
+
+  for (size_t i = 0; i < decryptions.size(); ++i)
+    decryptEncryptedContent
+      (*decryptions[i].encryptedContent_, keyBits, decryptions[i].onPlainText_,
+       decryptions[i].onError_);
+}
+
+void
+Consumer::Impl::onKeyError
+  (PendingMap* pendingMap, const Name& keyName,
+   EncryptError::ErrorCode errorCode, const string& message)
+{
+  PendingMap::iterator pending = pendingMap->find(keyName);
+  if (pending == pendingMap->end())
+    // We don't expect this to happen.
+    return;
+  // Remove the entry so that the next request for the key fetches it again.
+  vector<PendingDecryption> decryptions;
+  decryptions.swap(pending->second);
+  pendingMap->erase(pending);
+
+  for (size_t i = 0; i < decryptions.size(); ++i) {
+    try {
+      decryptions[i].onError_(errorCode, message);
+    } catch (const std::exception& ex) {
+      _LOG_ERROR("Error in onError: " << ex.what());
+    } catch (...) {
+      _LOG_ERROR("Error in onError.");
+    }
+  }
+}
+
 void
 Consumer::Impl::sendInterest
   (const ptr_lib::shared_ptr<const Interest>& interest, int nRetrials,
@@ -572,6 +616,62 @@ Consumer::Impl::onValidationFailed
   }
 }
 
+bool
+Consumer::KeyCache::find(const Name& keyName, Blob& keyBits)
+{
+  EntryMap::iterator entry = entries_.find(keyName);
+  if (entry == entries_.end())
+    return false;
+
+  if (entry->second.expirationTime_ <=
+      ndn_getNowMilliseconds() + nowOffsetMilliseconds_) {
+    erase(entry);
+    return false;
+  }
+
+  // Move to the front as the most recently used.
+  lruList_.splice(lruList_.begin(), lruList_, entry->second.lruPosition_);
+  keyBits = entry->second.keyBits_;
+  return true;
+}
+
+void
+Consumer::KeyCache::insert(const Name& keyName, const Blob& keyBits)
+{
+  if (capacity_ == 0)
+    return;
+
+  EntryMap::iterator entry = entries_.find(keyName);
+  if (entry != entries_.end())
+    erase(entry);
+
+  while (entries_.size() >= capacity_)
+    // Remove the least recently used.
+    erase(entries_.find(lruList_.back()));
+
+  lruList_.push_front(keyName);
+  Entry& newEntry = entries_[keyName];
+  newEntry.keyBits_ = keyBits;
+  newEntry.expirationTime_ = ndn_getNowMilliseconds() + nowOffsetMilliseconds_ +
+    lifetimeMilliseconds_;
+  newEntry.lruPosition_ = lruList_.begin();
+}
+
+void
+Consumer::KeyCache::setCapacity(size_t capacity)
+{
+  capacity_ = capacity;
+  while (entries_.size() > capacity_)
+    erase(entries_.find(lruList_.back()));
+}
+
+void
+Consumer::KeyCache::erase(EntryMap::iterator entry)
+{
+  lruList_.erase(entry->second.lruPosition_);
+  entries_.erase(entry);
+}
+
 Link* Consumer::noLink_ = 0;
 
 }
@@ -20,16 +20,66 @@
  * A copy of the GNU Lesser General Public License is in the file COPYING.
  */
 
+#include <ndn-cpp/util/logging.hpp>
 #include <ndn-cpp/security/key-chain.hpp>
 #include <ndn-cpp/security/security-exception.hpp>
 #include <ndn-cpp/encrypt/algo/encryptor.hpp>
 #include <ndn-cpp/encrypt/algo/rsa-algorithm.hpp>
 #include <ndn-cpp/encrypt/group-manager.hpp>
+#ifdef NDN_CPP_HAVE_BOOST_ASIO
+#include <boost/bind.hpp>
+#include <ndn-cpp/lite/util/crypto-lite.hpp>
+#include <ndn-cpp/security/tpm/tpm-key-handle.hpp>
+#include "../util/parallel-tasks.hpp"
+#endif
 
 using namespace std;
 
+INIT_LOGGER("ndn.GroupManager");
+
 namespace ndn {
 
+#ifdef NDN_CPP_HAVE_BOOST_ASIO
+/**
+ * A GroupManager::DKeyBatch holds the members and group private key of one call
+ * to the parallel getGroupKey. Each task makes the D-KEY packets for a
+ * different range of the members and marks its own failed members, so no lock
+ * is needed.
+ */
+class GroupManager::DKeyBatch {
+public:
+  DKeyBatch
+    (GroupManager& manager, const string& startTimeStamp,
+     const string& endTimeStamp, const Blob& privateKeyBlob,
+     boost::asio::io_service& resultService, const OnGroupKeyData& onData,
+     const OnGroupKeyComplete& onComplete)
+  : manager_(manager), startTimeStamp_(startTimeStamp),
+    endTimeStamp_(endTimeStamp), privateKeyBlob_(privateKeyBlob), keyHandle_(0),
+    digestAlgorithm_(DIGEST_ALGORITHM_SHA256), resultService_(resultService),
+    onData_(onData), onComplete_(onComplete)
+  {
+  }
+
+  GroupManager& manager_;
+  string startTimeStamp_;
+  string endTimeStamp_;
+  Blob privateKeyBlob_;
+  // The key is the Name of the member's public key and the value is the DER.
+  vector<pair<Name, Blob> > memberKeys_;
+  // 1 if the D-KEY for the member at the same index in memberKeys_ failed. Use
+  // uint8_t instead of bool since different threads write the values.
+  vector<uint8_t> isFailed_;
+  // If null, the D-KEY packets are signed by the KeyChain in resultService_.
+  ptr_lib::shared_ptr<Signature> signatureInfo_;
+  // If null and signatureInfo_ is not null, the signature is a DigestSha256.
+  const TpmKeyHandle* keyHandle_;
+  DigestAlgorithm digestAlgorithm_;
+  boost::asio::io_service& resultService_;
+  OnGroupKeyData onData_;
+  OnGroupKeyComplete onComplete_;
+};
+#endif
+
 GroupManager::GroupManager
   (const Name& prefix, const Name& dataType,
    const ptr_lib::shared_ptr<GroupManagerDb>& database, uint32_t keySize,
@@ -37,7 +87,8 @@ GroupManager::GroupManager
 : database_(database),
   keySize_(keySize),
   freshnessHours_(freshnessHours),
-  keyChain_(keyChain)
+  keyChain_(keyChain),
+  isScheduleIndexLoaded_(false)
 {
   namespace_ = Name(prefix).append(Encryptor::getNAME_COMPONENT_READ())
     .append(dataType);
@@ -59,8 +110,314 @@ GroupManager::getGroupKey
   string startTimeStamp = Schedule::toIsoString(finalInterval.getStartTime());
   string endTimeStamp = Schedule::toIsoString(finalInterval.getEndTime());
 
-  // Generate the private and public keys.
+  // Add the E-KEY as the first element to the result.
+  Blob privateKeyBlob;
+  ptr_lib::shared_ptr<Data> data = prepareGroupKey
+    (finalInterval, needRegenerate, privateKeyBlob);
+  result.push_back(data);
+
+  // Encrypt the private key with the public key from each member's certificate.
+  for (map<Name, Blob>::iterator i = memberKeys.begin(); i != memberKeys.end(); ++i) {
+    const Name& keyName = i->first;
+    Blob& certificateKey = i->second;
+
+    // Generate the name of the packet.
+    // The D-KEY (private key) data packet name convention is:
+    // /<data_type>/D-KEY/[start-ts]/[end-ts]/[member-name]
+    data = createDKeyData
+      (startTimeStamp, endTimeStamp, keyName, privateKeyBlob, certificateKey);
+    result.push_back(data);
+  }
+}
+
+void
+GroupManager::addSchedule(const string& scheduleName, const Schedule& schedule)
+{
+  database_->addSchedule(scheduleName, schedule);
+
+  if (isScheduleIndexLoaded_)
+    scheduleIndex_[scheduleName].schedule_.reset(new Schedule(schedule));
+}
+
+void
+GroupManager::deleteSchedule(const string& scheduleName)
+{
+  database_->deleteSchedule(scheduleName);
+
+  if (isScheduleIndexLoaded_) {
+    ScheduleIndex::iterator entry = scheduleIndex_.find(scheduleName);
+    if (entry != scheduleIndex_.end()) {
+      // The database also deleted the members which use this schedule.
+      map<Name, Blob>& memberKeys = entry->second.memberKeys_;
+      for (map<Name, Blob>::iterator i = memberKeys.begin();
+           i != memberKeys.end(); ++i)
+        memberIndex_.erase(i->first.getPrefix(-1));
+      scheduleIndex_.erase(entry);
+    }
+  }
+}
+
+void
+GroupManager::updateSchedule(const string& scheduleName, const Schedule& schedule)
+{
+  database_->updateSchedule(scheduleName, schedule);
+
+  if (isScheduleIndexLoaded_)
+    // This keeps the members if the schedule already exists.
+    scheduleIndex_[scheduleName].schedule_.reset(new Schedule(schedule));
+}
+
+void
+GroupManager::addMember(const string& scheduleName, const Data& memberCertificate)
+{
+  IdentityCertificate cert(memberCertificate);
+  const Name& keyName = cert.getPublicKeyName();
+  const Blob& keyDer = cert.getPublicKeyInfo().getKeyDer();
+  database_->addMember(scheduleName, keyName, keyDer);
+
+  if (isScheduleIndexLoaded_) {
+    scheduleIndex_[scheduleName].memberKeys_[keyName] = keyDer;
+    memberIndex_[keyName.getPrefix(-1)] = make_pair(scheduleName, keyName);
+  }
+}
+
+void
+GroupManager::removeMember(const Name& identity)
+{
+  database_->deleteMember(identity);
+
+  if (isScheduleIndexLoaded_)
+    removeIndexedMember(identity);
+}
+
+void
+GroupManager::updateMemberSchedule(const Name& identity, const string& scheduleName)
+{
+  database_->updateMemberSchedule(identity, scheduleName);
+
+  if (isScheduleIndexLoaded_) {
+    pair<Name, Blob> key = removeIndexedMember(identity);
+    if (!key.second.isNull()) {
+      scheduleIndex_[scheduleName].memberKeys_[key.first] = key.second;
+      memberIndex_[identity] = make_pair(scheduleName, key.first);
+    }
+    else
+      // We don't expect this since the database updated the member.
+      clearScheduleIndex();
+  }
+}
+
+void
+GroupManager::loadScheduleIndex()
+{
+  if (isScheduleIndexLoaded_)
+    return;
+
+  scheduleIndex_.clear();
+  memberIndex_.clear();
+
+  vector<string> scheduleNames;
+  database_->listAllScheduleNames(scheduleNames);
+  for (size_t i = 0; i < scheduleNames.size(); ++i) {
+    const string& scheduleName = scheduleNames[i];
+    IndexedSchedule& entry = scheduleIndex_[scheduleName];
+
+    entry.schedule_ = database_->getSchedule(scheduleName);
+    database_->getScheduleMembers(scheduleName, entry.memberKeys_);
+    for (map<Name, Blob>::iterator j = entry.memberKeys_.begin();
+         j != entry.memberKeys_.end(); ++j)
+      memberIndex_[j->first.getPrefix(-1)] = make_pair(scheduleName, j->first);
+  }
+
+  isScheduleIndexLoaded_ = true;
+}
+
+pair<Name, Blob>
+GroupManager::removeIndexedMember(const Name& identity)
+{
+  MemberIndex::iterator member = memberIndex_.find(identity);
+  if (member == memberIndex_.end())
+    return pair<Name, Blob>();
+
+  pair<Name, Blob> result;
+  ScheduleIndex::iterator entry = scheduleIndex_.find(member->second.first);
+  if (entry != scheduleIndex_.end()) {
+    map<Name, Blob>::iterator key =
+      entry->second.memberKeys_.find(member->second.second);
+    if (key != entry->second.memberKeys_.end()) {
+      result = *key;
+      entry->second.memberKeys_.erase(key);
+    }
+  }
+
+  memberIndex_.erase(member);
+  return result;
+}
+
+#ifdef NDN_CPP_HAVE_BOOST_ASIO
+void
+GroupManager::getGroupKey
+  (MillisecondsSince1970 timeSlot, boost::asio::io_service& workerService,
+   boost::asio::io_service& resultService, const OnGroupKeyData& onData,
+   const OnGroupKeyComplete& onComplete, bool needRegenerate)
+{
+  map<Name, Blob> memberKeys;
+
+  // Get the time interval.
+  Interval finalInterval = calculateInterval(timeSlot, memberKeys);
+  if (finalInterval.isValid() == false) {
+    ptr_lib::shared_ptr<DKeyBatch> batch(new DKeyBatch
+      (*this, "", "", Blob(), resultService, onData, onComplete));
+    resultService.post(boost::bind(&GroupManager::finishGroupKey, batch));
+    return;
+  }
+
   Blob privateKeyBlob;
+  ptr_lib::shared_ptr<Data> eKeyData = prepareGroupKey
+    (finalInterval, needRegenerate, privateKeyBlob);
+
+  ptr_lib::shared_ptr<DKeyBatch> batch(new DKeyBatch
+    (*this, Schedule::toIsoString(finalInterval.getStartTime()),
+     Schedule::toIsoString(finalInterval.getEndTime()), privateKeyBlob,
+     resultService, onData, onComplete));
+  batch->memberKeys_.assign(memberKeys.begin(), memberKeys.end());
+  batch->isFailed_.resize(batch->memberKeys_.size(), 0);
+
+  if (!keyChain_->getIsSecurityV1()) {
+    // Find the signing key in this thread so that the tasks can sign with the
+    // key handle, as with BatchSigner.
+    SigningInfo params;
+    Name keyName;
+    batch->signatureInfo_ = keyChain_->prepareSignatureInfo(params, keyName);
+    batch->keyHandle_ = keyChain_->findSigningKeyHandle(keyName);
+    batch->digestAlgorithm_ = params.getDigestAlgorithm();
+  }
+
+  // The E-KEY is already signed.
+  resultService.post(boost::bind
+    (&GroupManager::deliverGroupKeyData, batch, eKeyData));
+
+  ParallelTasks::post
+    (workerService, batch->memberKeys_.size(), D_KEY_TASK_SIZE,
+     boost::bind(&GroupManager::dKeyTask, batch, _1, _2),
+     boost::bind(&GroupManager::postFinishGroupKey, batch));
+}
+
+void
+GroupManager::dKeyTask
+  (const ptr_lib::shared_ptr<DKeyBatch>& batch, size_t begin, size_t end)
+{
+  for (size_t i = begin; i < end; ++i) {
+    const Name& keyName = batch->memberKeys_[i].first;
+
+    // Catch the error for this member so that the other members get their
+    // D-KEY. finishGroupKey reports the failed members.
+    ptr_lib::shared_ptr<Data> data;
+    try {
+      data = batch->manager_.makeDKeyData
+        (batch->startTimeStamp_, batch->endTimeStamp_, keyName,
+         batch->privateKeyBlob_, batch->memberKeys_[i].second);
+
+      if (batch->signatureInfo_) {
+        data->setSignature(*batch->signatureInfo_);
+        // Encode once to get the signed portion.
+        SignedBlob encoding = data->wireEncode();
+
+        Blob signatureBytes;
+        if (batch->keyHandle_)
+          signatureBytes = batch->keyHandle_->sign
+            (batch->digestAlgorithm_, encoding.signedBuf(),
+             encoding.signedSize());
+        else {
+          uint8_t digest[ndn_SHA256_DIGEST_SIZE];
+          CryptoLite::digestSha256
+            (encoding.signedBuf(), encoding.signedSize(), digest);
+          signatureBytes = Blob(digest, sizeof(digest));
+        }
+        data->getSignature()->setSignature(signatureBytes);
+        // Encode again to include the signature.
+        data->wireEncode();
+      }
+    } catch (const std::exception& ex) {
+      _LOG_DEBUG("GroupManager: Error making the D-KEY for " <<
+                 keyName.toUri() << ": " << ex.what());
+      batch->isFailed_[i] = 1;
+      continue;
+    }
+
+    batch->resultService_.post(boost::bind
+      (&GroupManager::deliverDKeyData, batch, i, data));
+  }
+}
+
+void
+GroupManager::deliverDKeyData
+  (const ptr_lib::shared_ptr<DKeyBatch>& batch, size_t memberIndex,
+   const ptr_lib::shared_ptr<Data>& data)
+{
+  if (!batch->signatureInfo_) {
+    try {
+      batch->manager_.keyChain_->sign(*data);
+    } catch (const std::exception& ex) {
+      _LOG_DEBUG("GroupManager: Error signing " << data->getName().toUri() <<
+                 ": " << ex.what());
+      batch->isFailed_[memberIndex] = 1;
+      return;
+    }
+  }
+
+  deliverGroupKeyData(batch, data);
+}
+
+void
+GroupManager::deliverGroupKeyData
+  (const ptr_lib::shared_ptr<DKeyBatch>& batch,
+   const ptr_lib::shared_ptr<Data>& data)
+{
+  try {
+    batch->onData_(data);
+  } catch (const std::exception& ex) {
+    _LOG_ERROR("GroupManager: Error in onData: " << ex.what());
+  } catch (...) {
+    _LOG_ERROR("GroupManager: Error in onData.");
+  }
+}
+
+void
+GroupManager::postFinishGroupKey(const ptr_lib::shared_ptr<DKeyBatch>& batch)
+{
+  // The tasks posted their packets before this, so onComplete is called after
+  // the last onData.
+  batch->resultService_.post(boost::bind(&GroupManager::finishGroupKey, batch));
+}
+
+void
+GroupManager::finishGroupKey(const ptr_lib::shared_ptr<DKeyBatch>& batch)
+{
+  vector<Name> failedKeyNames;
+  for (size_t i = 0; i < batch->isFailed_.size(); ++i) {
+    if (batch->isFailed_[i])
+      failedKeyNames.push_back(batch->memberKeys_[i].first);
+  }
+
+  try {
+    batch->onComplete_(failedKeyNames);
+  } catch (const std::exception& ex) {
+    _LOG_ERROR("GroupManager: Error in onComplete: " << ex.what());
+  } catch (...) {
+    _LOG_ERROR("GroupManager: Error in onComplete.");
+  }
+}
+#endif
+
+ptr_lib::shared_ptr<Data>
+GroupManager::prepareGroupKey
+  (const Interval& finalInterval, bool needRegenerate, Blob& privateKeyBlob)
+{
+  string startTimeStamp = Schedule::toIsoString(finalInterval.getStartTime());
+  string endTimeStamp = Schedule::toIsoString(finalInterval.getEndTime());
+
+  // Generate the private and public keys.
   Blob publicKeyBlob;
   Name eKeyName(namespace_);
   eKeyName.append(Encryptor::getNAME_COMPONENT_E_KEY()).append(startTimeStamp)
@@ -75,25 +432,9 @@ GroupManager::getGroupKey
     addEKey(eKeyName, publicKeyBlob, privateKeyBlob);
   }
 
-  // Add the first element to the result.
   // The E-KEY (public key) data packet name convention is:
   // /<data_type>/E-KEY/[start-ts]/[end-ts]
-  ptr_lib::shared_ptr<Data> data = createEKeyData
-    (startTimeStamp, endTimeStamp, publicKeyBlob);
-  result.push_back(data);
-
-  // Encrypt the private key with the public key from each member's certificate.
-  for (map<Name, Blob>::iterator i = memberKeys.begin(); i != memberKeys.end(); ++i) {
-    const Name& keyName = i->first;
-    Blob& certificateKey = i->second;
-
-    // Generate the name of the packet.
-    // The D-KEY (private key) data packet name convention is:
-    // /<data_type>/D-KEY/[start-ts]/[end-ts]/[member-name]
-    data = createDKeyData
-      (startTimeStamp, endTimeStamp, keyName, privateKeyBlob, certificateKey);
-    result.push_back(data);
-  }
+  return createEKeyData(startTimeStamp, endTimeStamp, publicKeyBlob);
 }
 
 Interval
@@ -105,14 +446,13 @@ GroupManager::calculateInterval
   Interval negativeResult;
   memberKeys.clear();
 
-  // Get the all intervals from the schedules.
-  vector<string> scheduleNames;
-  database_->listAllScheduleNames(scheduleNames);
-  for (size_t i = 0; i < scheduleNames.size(); ++i) {
-    string& scheduleName = scheduleNames[i];
+  loadScheduleIndex();
 
-    ptr_lib::shared_ptr<Schedule> schedule = database_->getSchedule(scheduleName);
-    Schedule::Result result = schedule->getCoveringInterval(timeSlot);
+  // Get the all intervals from the schedules.
+  for (ScheduleIndex::iterator entry = scheduleIndex_.begin();
+       entry != scheduleIndex_.end(); ++entry) {
+    Schedule::Result result =
+      entry->second.schedule_->getCoveringInterval(timeSlot);
     Interval tempInterval = result.interval;
 
     if (result.isPositive) {
@@ -120,9 +460,11 @@ GroupManager::calculateInterval
         positiveResult = tempInterval;
       positiveResult.intersectWith(tempInterval);
 
-      map<Name, Blob> map;
-      database_->getScheduleMembers(scheduleName, map);
-      memberKeys.insert(map.begin(), map.end());
+      const map<Name, Blob>& scheduleMemberKeys = entry->second.memberKeys_;
+      if (memberKeys.empty())
+        memberKeys = scheduleMemberKeys;
+      else
+        memberKeys.insert(scheduleMemberKeys.begin(), scheduleMemberKeys.end());
     }
     else {
       if (!negativeResult.isValid())
@@ -177,6 +519,18 @@ ptr_lib::shared_ptr<Data>
 GroupManager::createDKeyData
   (const string& startTimeStamp, const string& endTimeStamp,
    const Name& keyName, const Blob& privateKeyBlob, const Blob& certificateKey)
+{
+  ptr_lib::shared_ptr<Data> data = makeDKeyData
+    (startTimeStamp, endTimeStamp, keyName, privateKeyBlob, certificateKey);
+  keyChain_->sign(*data);
+  return data;
+}
+
+ptr_lib::shared_ptr<Data>
+GroupManager::makeDKeyData
+  (const string& startTimeStamp, const string& endTimeStamp,
+   const Name& keyName, const Blob& privateKeyBlob,
+   const Blob& certificateKey) const
 {
   Name name(namespace_);
   name.append(Encryptor::getNAME_COMPONENT_D_KEY());
@@ -193,7 +547,6 @@ GroupManager::createDKeyData
       (string("createDKeyData: Error in encryptData: ") + ex.what());
   }
 
-  keyChain_->sign(*data);
   return data;
 }
 
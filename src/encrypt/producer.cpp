@@ -20,9 +20,11 @@
  */
 
 #include <math.h>
+#include <stdexcept>
 #include <ndn-cpp/util/logging.hpp>
 #include <ndn-cpp/encrypt/algo/encryptor.hpp>
 #include <ndn-cpp/encrypt/algo/aes-algorithm.hpp>
+#include <ndn-cpp/encrypt/algo/aes-stream-cipher.hpp>
 #include <ndn-cpp/encrypt/schedule.hpp>
 #include <ndn-cpp/encrypt/producer.hpp>
 
@@ -47,6 +49,7 @@ Producer::Impl::Impl
     keyChain_(keyChain),
     database_(database),
     maxRepeatAttempts_(repeatAttempts),
+    cachedContentKeyHourSlot_(0),
     keyRetrievalLink_(keyRetrievalLink)
 {
   Name fixedPrefix(prefix);
@@ -86,7 +89,8 @@ Producer::Impl::createContentKey
   Blob contentKeyBits;
 
   // Check if we have created the content key before.
-  if (database_->hasContentKey(timeSlot))
+  if ((!cachedContentKey_.isNull() && cachedContentKeyHourSlot_ == hourSlot) ||
+      database_->hasContentKey(timeSlot))
     // We have created the content key. Return its name directly.
     return contentKeyName;
 
@@ -94,6 +98,9 @@ Producer::Impl::createContentKey
   AesKeyParams aesParams(128);
   contentKeyBits = AesAlgorithm::generateKey(aesParams).getKeyBits();
   database_->addContentKey(timeSlot, contentKeyBits);
+  cachedContentKeyHourSlot_ = hourSlot;
+  cachedContentKeyName_ = contentKeyName;
+  cachedContentKey_ = contentKeyBits;
 
   // Now we need to retrieve the E-KEYs for content key encryption.
   MillisecondsSince1970 timeCount = ::round(timeSlot);
@@ -134,17 +141,110 @@ Producer::Impl::produce
    const EncryptError::OnError& onError)
 {
   // Get a content key.
-  Name contentKeyName = createContentKey(timeSlot, OnEncryptedKeys(), onError);
-  Blob contentKey = database_->getContentKey(timeSlot);
+  Name contentKeyName;
+  Blob contentKey;
+  getContentKey(timeSlot, onError, contentKeyName, contentKey);
 
   // Produce data.
+  encryptContent(data, timeSlot, content, contentKeyName, contentKey);
+  keyChain_->sign(data);
+}
+
+void
+Producer::Impl::produce
+  (const vector<MillisecondsSince1970>& timeSlots, const vector<Blob>& contents,
+   vector<ptr_lib::shared_ptr<Data> >& result,
+   const EncryptError::OnError& onError)
+{
+  if (timeSlots.size() != contents.size())
+    throw invalid_argument
+      ("Producer::produce: timeSlots and contents must have the same size");
+
+  result.clear();
+  result.reserve(contents.size());
+  // Reuse the cipher, and its key schedule, while the content key is the same.
+  ptr_lib::shared_ptr<AesStreamCipher> cipher;
+  Blob cipherKey;
+  for (size_t i = 0; i < contents.size(); ++i) {
+    // getContentKey uses the cached content key unless the hour changes.
+    Name contentKeyName;
+    Blob contentKey;
+    getContentKey(timeSlots[i], onError, contentKeyName, contentKey);
+
+    ptr_lib::shared_ptr<Data> data(new Data());
+    if (contentKey.size() != AesStreamCipher::BLOCK_SIZE)
+      // Let AesAlgorithm report an unexpected key.
+      encryptContent
+        (*data, timeSlots[i], contents[i], contentKeyName, contentKey);
+    else {
+      EncryptParams params(ndn_EncryptAlgorithmType_AesCbc, 16);
+      if (!cipher || !cipherKey.equals(contentKey)) {
+        cipher.reset(new AesStreamCipher
+          (AesStreamCipher::MODE_CBC, true, contentKey,
+           params.getInitialVector()));
+        cipherKey = contentKey;
+      }
+
+      encryptContent
+        (*data, timeSlots[i], contents[i], contentKeyName, *cipher);
+    }
+    result.push_back(data);
+  }
+
+  if (keyChain_->getIsSecurityV1()) {
+    for (size_t i = 0; i < result.size(); ++i)
+      keyChain_->sign(*result[i]);
+  }
+  else
+    keyChain_->sign(result, SigningInfo());
+}
+
+void
+Producer::Impl::getContentKey
+  (MillisecondsSince1970 timeSlot, const EncryptError::OnError& onError,
+   Name& contentKeyName, Blob& contentKey)
+{
+  MillisecondsSince1970 hourSlot = getRoundedTimeSlot(timeSlot);
+  if (cachedContentKey_.isNull() || cachedContentKeyHourSlot_ != hourSlot) {
+    Name name = createContentKey(timeSlot, OnEncryptedKeys(), onError);
+    // createContentKey may have already cached a new key.
+    if (cachedContentKey_.isNull() || cachedContentKeyHourSlot_ != hourSlot) {
+      cachedContentKey_ = database_->getContentKey(timeSlot);
+      cachedContentKeyHourSlot_ = hourSlot;
+      cachedContentKeyName_ = name;
+    }
+  }
+
+  contentKeyName = cachedContentKeyName_;
+  contentKey = cachedContentKey_;
+}
+
+void
+Producer::Impl::encryptContent
+  (Data& data, MillisecondsSince1970 timeSlot, const Blob& content,
+   const Name& contentKeyName, const Blob& contentKey)
+{
   Name dataName(namespace_);
   dataName.append(Schedule::toIsoString(timeSlot));
 
   data.setName(dataName);
   EncryptParams params(ndn_EncryptAlgorithmType_AesCbc, 16);
   Encryptor::encryptData(data, content, contentKeyName, contentKey, params);
-  keyChain_->sign(data);
+}
+
+void
+Producer::Impl::encryptContent
+  (Data& data, MillisecondsSince1970 timeSlot, const Blob& content,
+   const Name& contentKeyName, AesStreamCipher& cipher)
+{
+  Name dataName(namespace_);
+  dataName.append(Schedule::toIsoString(timeSlot));
+
+  data.setName(dataName);
+  // EncryptParams makes a new random initial vector.
+  EncryptParams params(ndn_EncryptAlgorithmType_AesCbc, 16);
+  Encryptor::encryptData
+    (data, content, contentKeyName, cipher, params.getInitialVector());
 }
 
 MillisecondsSince1970
@@ -29,6 +29,7 @@
 #include <stdlib.h>
 #include <sstream>
 #include <fstream>
+#include "../util/sqlite3-statement.hpp"
 #include <ndn-cpp/encrypt/sqlite3-consumer-db.hpp>
 
 using namespace std;
@@ -45,16 +46,6 @@ static const string INITIALIZATION =
   "CREATE UNIQUE INDEX IF NOT EXISTS                  \n"
   "   KeyNameIndex ON decryptionkeys(key_name);       \n";
 
-/**
- * A utility function to call the normal sqlite3_bind_blob where the value and
- * length are blob.buf() and blob.size().
- */
-static int sqlite3_bind_blob
-  (sqlite3_stmt* statement, int index, const Blob& value, void(*destructor)(void*))
-{
-  return sqlite3_bind_blob(statement, index, value.buf(), value.size(), destructor);
-}
-
 Sqlite3ConsumerDb::Sqlite3ConsumerDb(const string& databaseFilePath)
 {
   int status = sqlite3_open(databaseFilePath.c_str(), &database_);
@@ -64,6 +55,9 @@ Sqlite3ConsumerDb::Sqlite3ConsumerDb(const string& databaseFilePath)
 
   // Enable foreign keys.
   sqlite3_exec(database_, "PRAGMA foreign_keys = ON", NULL, NULL, NULL);
+  // Use write-ahead logging so that a commit doesn't sync a rollback journal.
+  sqlite3_exec(database_, "PRAGMA journal_mode = WAL", NULL, NULL, NULL);
+  sqlite3_exec(database_, "PRAGMA synchronous = NORMAL", NULL, NULL, NULL);
 
   // initialize database specific tables
   char* errorMessage = 0;
@@ -72,42 +66,40 @@ Sqlite3ConsumerDb::Sqlite3ConsumerDb(const string& databaseFilePath)
     sqlite3_free(errorMessage);
     throw ConsumerDb::Error("Consumer DB cannot be initialized");
   }
+
+  statementCache_.reset(new Sqlite3StatementCache(database_));
+}
+
+Sqlite3ConsumerDb::~Sqlite3ConsumerDb()
+{
+  // Finalize the cached statements before closing.
+  statementCache_.reset();
+  sqlite3_close(database_);
 }
 
 Blob
 Sqlite3ConsumerDb::getKey(const Name& keyName)
 {
-  sqlite3_stmt *statement;
-  sqlite3_prepare_v2
-    (database_, "SELECT key_buf FROM decryptionkeys WHERE key_name=?",
-     -1, &statement, 0);
-  sqlite3_bind_blob(statement, 1, keyName.wireEncode(), SQLITE_TRANSIENT);
-
-  int res = sqlite3_step(statement);
-
-  Blob key;
-  if (res == SQLITE_ROW)
-    key = Blob
-      (static_cast<const uint8_t*>(sqlite3_column_blob(statement, 0)),
-       sqlite3_column_bytes(statement, 0));
-
-  sqlite3_finalize(statement);
-  return key;
+  Sqlite3Statement statement
+    (*statementCache_, "SELECT key_buf FROM decryptionkeys WHERE key_name=?");
+  statement.bind(1, keyName.wireEncode());
+
+  if (statement.step() == SQLITE_ROW)
+    return statement.getBlob(0);
+  else
+    return Blob();
 }
 
 void
 Sqlite3ConsumerDb::addKey(const Name& keyName, const Blob& keyBlob)
 {
-  sqlite3_stmt *statement;
-  sqlite3_prepare_v2
-    (database_, "INSERT INTO decryptionkeys(key_name, key_buf) values (?, ?)",
-     -1, &statement, 0);
-  sqlite3_bind_blob(statement, 1, keyName.wireEncode(), SQLITE_TRANSIENT);
-  sqlite3_bind_blob(statement, 2, keyBlob, SQLITE_TRANSIENT);
-
-  int status = sqlite3_step(statement);
-  sqlite3_finalize(statement);
-  if (status != SQLITE_DONE)
+  Sqlite3Statement statement
+    (*statementCache_,
+     "INSERT INTO decryptionkeys(key_name, key_buf) values (?, ?)");
+  statement.bind(1, keyName.wireEncode());
+  statement.bind(2, keyBlob);
+
+  if (statement.step() != SQLITE_DONE)
     throw ConsumerDb::Error
       ("Sqlite3ConsumerDb::addKey: Cannot add the key to the database");
 }
@@ -115,12 +107,37 @@ Sqlite3ConsumerDb::addKey(const Name& keyName, const Blob& keyBlob)
 void
 Sqlite3ConsumerDb::deleteKey(const Name& keyName)
 {
-  sqlite3_stmt *statement;
-  sqlite3_prepare_v2
-    (database_, "DELETE FROM decryptionkeys WHERE key_name=?", -1, &statement, 0);
-  sqlite3_bind_blob(statement, 1, keyName.wireEncode(), SQLITE_TRANSIENT);
-  sqlite3_step(statement);
-  sqlite3_finalize(statement);
+  Sqlite3Statement statement
+    (*statementCache_, "DELETE FROM decryptionkeys WHERE key_name=?");
+  statement.bind(1, keyName.wireEncode());
+  statement.step();
+}
+
+void
+Sqlite3ConsumerDb::beginTransaction()
+{
+  if (statementCache_->beginTransaction() != SQLITE_OK)
+    throw ConsumerDb::Error
+      (string("Sqlite3ConsumerDb::beginTransaction: ") +
+       sqlite3_errmsg(database_));
+}
+
+void
+Sqlite3ConsumerDb::commitTransaction()
+{
+  if (statementCache_->commitTransaction() != SQLITE_OK)
+    throw ConsumerDb::Error
+      (string("Sqlite3ConsumerDb::commitTransaction: ") +
+       sqlite3_errmsg(database_));
+}
+
+void
+Sqlite3ConsumerDb::rollbackTransaction()
+{
+  if (statementCache_->rollbackTransaction() != SQLITE_OK)
+    throw ConsumerDb::Error
+      (string("Sqlite3ConsumerDb::rollbackTransaction: ") +
+       sqlite3_errmsg(database_));
 }
 
 }
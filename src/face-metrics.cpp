@@ -0,0 +1,73 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2018 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+#include <sstream>
+#include <ndn-cpp/face-metrics.hpp>
+
+using namespace std;
+
+namespace ndn {
+
+/**
+ * Write the summary of the histogram as a JSON object.
+ * @param os The output stream.
+ * @param histogram The LatencyHistogram.
+ */
+static void
+writeHistogramJson(ostream& os, const LatencyHistogram& histogram)
+{
+  os << "{\"count\":" << histogram.getCount() <<
+    ",\"min\":" << histogram.getMin() <<
+    ",\"mean\":" << histogram.getMean() <<
+    ",\"p50\":" << histogram.getValueAtPercentile(50.0) <<
+    ",\"p90\":" << histogram.getValueAtPercentile(90.0) <<
+    ",\"p99\":" << histogram.getValueAtPercentile(99.0) <<
+    ",\"max\":" << histogram.getMax() << "}";
+}
+
+string
+FaceMetrics::toJson() const
+{
+  ostringstream os;
+  os << "{\"interestsExpressed\":" << nInterestsExpressed_ <<
+    ",\"interestsSatisfied\":" << nInterestsSatisfied_ <<
+    ",\"interestsTimedOut\":" << nInterestsTimedOut_ <<
+    ",\"interestsNacked\":" << nInterestsNacked_ <<
+    ",\"interestsReceived\":" << nInterestsReceived_ <<
+    ",\"dataSent\":" << nDataSent_ <<
+    ",\"dataReceived\":" << nDataReceived_ <<
+    ",\"interestBytesOut\":" << nInterestBytesOut_ <<
+    ",\"interestBytesIn\":" << nInterestBytesIn_ <<
+    ",\"dataBytesOut\":" << nDataBytesOut_ <<
+    ",\"dataBytesIn\":" << nDataBytesIn_ <<
+    ",\"pendingInterestTableSize\":" << pendingInterestTableSize_ <<
+    ",\"interestFilterTableSize\":" << interestFilterTableSize_ <<
+    ",\"delayedCallTableSize\":" << delayedCallTableSize_ <<
+    ",\"roundTripTimeMicroseconds\":";
+  writeHistogramJson(os, roundTripTimeMicroseconds_);
+  os << ",\"callbackTimeMicroseconds\":";
+  writeHistogramJson(os, callbackTimeMicroseconds_);
+  os << "}";
+
+  return os.str();
+}
+
+}
@@ -22,6 +22,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdexcept>
+#include <ndn-cpp/digest-sha256-signature.hpp>
+#include <ndn-cpp/lite/util/crypto-lite.hpp>
+#include "c/util/time.h"
 #include "node.hpp"
 #include <ndn-cpp/transport/tcp-transport.hpp>
 #include <ndn-cpp/transport/unix-transport.hpp>
@@ -230,6 +233,45 @@ Face::shutdown()
   node_->shutdown();
 }
 
+FaceMetrics
+Face::getMetrics() const
+{
+  return node_->getMetrics();
+}
+
+/**
+ * This is the OnInterestCallback for serveMetrics which answers with a Data
+ * packet of the metrics JSON.
+ */
+static void
+onMetricsInterest
+  (const ptr_lib::shared_ptr<const Name>& prefix,
+   const ptr_lib::shared_ptr<const Interest>& interest, Face& face,
+   uint64_t interestFilterId,
+   const ptr_lib::shared_ptr<const InterestFilter>& filter)
+{
+  Data data(Name(*prefix).appendVersion((uint64_t)ndn_getNowMilliseconds()));
+  data.getMetaInfo().setFreshnessPeriod(1000.0);
+  string json = face.getMetrics().toJson();
+  data.setContent(Blob((const uint8_t*)json.c_str(), json.size()));
+
+  // Encode once to get the signed portion.
+  data.setSignature(DigestSha256Signature());
+  SignedBlob encoding = data.wireEncode();
+  uint8_t digest[ndn_SHA256_DIGEST_SIZE];
+  CryptoLite::digestSha256
+    (encoding.signedBuf(), encoding.signedSize(), digest);
+  data.getSignature()->setSignature(Blob(digest, sizeof(digest)));
+
+  face.putData(data);
+}
+
+uint64_t
+Face::serveMetrics(const Name& prefix)
+{
+  return setInterestFilter(prefix, &onMetricsInterest);
+}
+
 void
 Face::callLater(Milliseconds delayMilliseconds, const Callback& callback)
 {
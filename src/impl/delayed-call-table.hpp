@@ -46,6 +46,13 @@ public:
   void
   callTimedOut();
 
+  /**
+   * Get the number of callbacks waiting in the delayed call table.
+   * @return The number of entries.
+   */
+  size_t
+  size() const { return table_.size(); }
+
 private:
   class Entry {
   public:
@@ -0,0 +1,95 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2018 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+#ifndef NDN_OBJECT_POOL_HPP
+#define NDN_OBJECT_POOL_HPP
+
+#include <vector>
+#include <ndn-cpp/common.hpp>
+
+namespace ndn {
+
+/**
+ * An ObjectPool keeps objects which were allocated with make_shared so that
+ * they can be reused, along with their shared_ptr control block, instead of
+ * allocating a new object for each use. An object is only put back in the pool
+ * if no one else has a reference to it, so an application can keep an object
+ * which it was given. The user of the pool must set all the values of an object
+ * from acquire() since it may have values from a previous use. This is not
+ * thread safe.
+ */
+template<class T> class ObjectPool {
+public:
+  /**
+   * Create an ObjectPool which is initially empty.
+   * @param maxSize (optional) The maximum number of unused objects to keep. If
+   * omitted, use 16.
+   */
+  ObjectPool(size_t maxSize = 16)
+  : maxSize_(maxSize)
+  {
+  }
+
+  /**
+   * Get an object from the pool, or make a new object if the pool is empty.
+   * @return The object, which may have values from a previous use.
+   */
+  ptr_lib::shared_ptr<T>
+  acquire()
+  {
+    if (pool_.empty())
+      return ptr_lib::make_shared<T>();
+
+    ptr_lib::shared_ptr<T> object = pool_.back();
+    pool_.pop_back();
+    return object;
+  }
+
+  /**
+   * Reset the object pointer. If this had the only reference to the object and
+   * the pool is not full, put the object in the pool to be reused.
+   * @param object The pointer to the object, which is reset. If this is null,
+   * do nothing.
+   */
+  void
+  release(ptr_lib::shared_ptr<T>& object)
+  {
+    if (object && object.use_count() == 1 && pool_.size() < maxSize_)
+      pool_.push_back(object);
+
+    object.reset();
+  }
+
+  /**
+   * Get the number of unused objects in the pool.
+   * @return The number of objects.
+   */
+  size_t
+  size() const { return pool_.size(); }
+
+private:
+  std::vector<ptr_lib::shared_ptr<T> > pool_;
+  size_t maxSize_;
+};
+
+}
+
+#endif
@@ -21,6 +21,7 @@
 
 #include <algorithm>
 #include <ndn-cpp/util/logging.hpp>
+#include "../c/util/time.h"
 #include "pending-interest-table.hpp"
 
 INIT_LOGGER("ndn.PendingInterestTable");
@@ -60,7 +61,8 @@ PendingInterestTable::add
   }
 
   ptr_lib::shared_ptr<Entry> entry(new Entry
-    (pendingInterestId, interestCopy, onData, onTimeout, onNetworkNack));
+    (pendingInterestId, interestCopy, onData, onTimeout, onNetworkNack,
+     ndn_getNowMilliseconds()));
   table_.push_back(entry);
   return entry;
 }
@@ -45,9 +45,11 @@ public:
     Entry
       (uint64_t pendingInterestId,
        const ptr_lib::shared_ptr<const Interest>& interest, const OnData& onData,
-       const OnTimeout& onTimeout, const OnNetworkNack& onNetworkNack)
+       const OnTimeout& onTimeout, const OnNetworkNack& onNetworkNack,
+       MillisecondsSince1970 expressTime)
     : pendingInterestId_(pendingInterestId), interest_(interest), onData_(onData),
-      onTimeout_(onTimeout), onNetworkNack_(onNetworkNack), isRemoved_(false)
+      onTimeout_(onTimeout), onNetworkNack_(onNetworkNack), isRemoved_(false),
+      expressTime_(expressTime)
     {
     }
 
@@ -93,6 +95,14 @@ public:
     bool
     getIsRemoved() { return isRemoved_; }
 
+    /**
+     * Get the time when this entry was added to the pending interest table,
+     * which is used to compute the round trip time.
+     * @return The time in milliseconds since 1/1/1970.
+     */
+    MillisecondsSince1970
+    getExpressTime() { return expressTime_; }
+
     /**
      * Call onTimeout_ (if defined).  This ignores exceptions from the call to
      * onTimeout_.
@@ -107,6 +117,7 @@ public:
     const OnTimeout onTimeout_;
     const OnNetworkNack onNetworkNack_;
     bool isRemoved_;
+    MillisecondsSince1970 expressTime_;
   };
 
   /**
@@ -180,6 +191,13 @@ public:
   bool
   removeEntry(const ptr_lib::shared_ptr<Entry>& pendingInterest);
 
+  /**
+   * Get the number of entries in the pending interest table.
+   * @return The number of entries.
+   */
+  size_t
+  size() const { return table_.size(); }
+
 private:
   std::vector<ptr_lib::shared_ptr<Entry> > table_;
   std::vector<uint64_t> removeRequests_;
@@ -36,6 +36,14 @@ namespace ndn {
 
 Interest& Interest::operator=(const Interest& interest)
 {
+  // The fields below replace any fields which are not decoded yet, so clear
+  // the lazy encoding before calling the setters. Save the values in case
+  // interest is this object.
+  Blob lazyEncoding = interest.lazyEncoding_;
+  WireFormat* lazyWireFormat = interest.lazyWireFormat_;
+  lazyEncoding_ = Blob();
+  lazyWireFormat_ = 0;
+
   setName(interest.name_.get());
   setMinSuffixComponents(interest.minSuffixComponents_);
   setMaxSuffixComponents(interest.maxSuffixComponents_);
@@ -54,6 +62,8 @@ Interest& Interest::operator=(const Interest& interest)
 
   setDefaultWireEncoding
     (interest.getDefaultWireEncoding(), interest.defaultWireEncodingFormat_);
+  lazyEncoding_ = lazyEncoding;
+  lazyWireFormat_ = lazyWireFormat;
 
   return *this;
 }
@@ -71,6 +81,7 @@ Interest::getIncomingFaceId() const
 void
 Interest::get(InterestLite& interestLite, WireFormat& wireFormat) const
 {
+  decodeLazyFields();
   name_.get().get(interestLite.getName());
   interestLite.setMinSuffixComponents(minSuffixComponents_);
   interestLite.setMaxSuffixComponents(maxSuffixComponents_);
@@ -99,7 +110,20 @@ Interest::get(InterestLite& interestLite, WireFormat& wireFormat) const
 void
 Interest::set(const InterestLite& interestLite, WireFormat& wireFormat)
 {
+  // This replaces all the fields.
+  lazyEncoding_ = Blob();
+  lazyWireFormat_ = 0;
+
   name_.get().set(interestLite.getName());
+  setFieldsExceptName(interestLite, wireFormat);
+  // Set getNonceChangeCount_ so that the next call to getNonce() won't clear nonce_.
+  getNonceChangeCount_ = getChangeCount();
+}
+
+void
+Interest::setFieldsExceptName
+  (const InterestLite& interestLite, WireFormat& wireFormat)
+{
   setMinSuffixComponents(interestLite.getMinSuffixComponents());
   setMaxSuffixComponents(interestLite.getMaxSuffixComponents());
 
@@ -126,10 +150,8 @@ Interest::set(const InterestLite& interestLite, WireFormat& wireFormat)
     unsetLink();
   setSelectedDelegationIndex(interestLite.getSelectedDelegationIndex());
 
-  // Set the nonce last so that getNonceChangeCount_ is set correctly.
+  // Set the nonce last so that the caller can set getNonceChangeCount_.
   nonce_ = Blob(interestLite.getNonce());
-  // Set getNonceChangeCount_ so that the next call to getNonce() won't clear nonce_.
-  getNonceChangeCount_ = getChangeCount();
 }
 
 SignedBlob
@@ -156,6 +178,9 @@ Interest::wireEncode(WireFormat& wireFormat) const
 void
 Interest::wireDecode(const Blob& input, WireFormat& wireFormat)
 {
+  lazyEncoding_ = Blob();
+  lazyWireFormat_ = 0;
+
   size_t signedPortionBeginOffset, signedPortionEndOffset;
   wireFormat.decodeInterest
     (*this, input.buf(), input.size(), &signedPortionBeginOffset,
@@ -175,6 +200,9 @@ void
 Interest::wireDecode
   (const uint8_t *input, size_t inputLength, WireFormat& wireFormat)
 {
+  lazyEncoding_ = Blob();
+  lazyWireFormat_ = 0;
+
   size_t signedPortionBeginOffset, signedPortionEndOffset;
   wireFormat.decodeInterest(*this, input, inputLength, &signedPortionBeginOffset, &signedPortionEndOffset);
 
@@ -188,9 +216,60 @@ Interest::wireDecode
     setDefaultWireEncoding(SignedBlob(), 0);
 }
 
+void
+Interest::wireDecodeLazy(const Blob& input, WireFormat& wireFormat)
+{
+  size_t signedPortionBeginOffset, signedPortionEndOffset;
+  wireFormat.decodeInterestName
+    (name_.get(), input.buf(), input.size(), &signedPortionBeginOffset,
+     &signedPortionEndOffset);
+  ++changeCount_;
+  lazyEncoding_ = input;
+  lazyWireFormat_ = &wireFormat;
+  // Set getNonceChangeCount_ so that getNonce() keeps the decoded nonce.
+  getNonceChangeCount_ = getChangeCount();
+
+  if (&wireFormat == WireFormat::getDefaultWireFormat())
+    // This is the default wire encoding.
+    // Take a pointer to the input Blob without copying.
+    setDefaultWireEncoding
+      (SignedBlob(input, signedPortionBeginOffset, signedPortionEndOffset),
+       WireFormat::getDefaultWireFormat());
+  else
+    setDefaultWireEncoding(SignedBlob(), 0);
+}
+
+void
+Interest::finishLazyDecode()
+{
+  Blob encoding = lazyEncoding_;
+  WireFormat* wireFormat = lazyWireFormat_;
+  // Clear first so that the methods below don't try to decode again.
+  lazyEncoding_ = Blob();
+  lazyWireFormat_ = 0;
+
+  // If the name has changed, then the nonce and default wire encoding are
+  // invalidated as usual.
+  bool unchanged = (getNonceChangeCount_ == getChangeCount());
+  SignedBlob defaultWireEncoding = getDefaultWireEncoding();
+  WireFormat* defaultWireEncodingFormat = defaultWireEncodingFormat_;
+
+  wireFormat->decodeInterestFields(*this, encoding.buf(), encoding.size());
+  ++changeCount_;
+
+  if (unchanged) {
+    // The decoded fields are the same as the encoding, so restore the nonce
+    // and the default wire encoding.
+    getNonceChangeCount_ = getChangeCount();
+    if (!defaultWireEncoding.isNull())
+      setDefaultWireEncoding(defaultWireEncoding, defaultWireEncodingFormat);
+  }
+}
+
 string
 Interest::toUri() const
 {
+  decodeLazyFields();
   ostringstream selectors;
 
   if (minSuffixComponents_ >= 0)
@@ -225,6 +304,7 @@ Interest::toUri() const
 bool
 Interest::matchesName(const Name& name) const
 {
+  decodeLazyFields();
   if (!getName().match(name))
     return false;
 
@@ -316,6 +396,7 @@ Interest::matchesData(const Data& data, WireFormat& wireFormat) const
 Link*
 Interest::getLink()
 {
+  decodeLazyFields();
   if (link_.get())
     return link_.get();
   else if (!linkWireEncoding_.isNull()) {
@@ -337,6 +418,7 @@ Interest::getLink()
 Blob
 Interest::getLinkWireEncoding(WireFormat& wireFormat) const
 {
+  decodeLazyFields();
   if (!linkWireEncoding_.isNull() && linkWireEncodingFormat_ == &wireFormat)
     return linkWireEncoding_;
 
@@ -22,6 +22,7 @@
 #include <stdexcept>
 #include <ndn-cpp/common.hpp>
 #include <ndn-cpp/sha256-with-ecdsa-signature.hpp>
+#include <ndn-cpp/merkle-signature.hpp>
 #include <ndn-cpp/sha256-with-rsa-signature.hpp>
 #include <ndn-cpp/hmac-with-sha256-signature.hpp>
 #include <ndn-cpp/key-locator.hpp>
@@ -54,7 +55,8 @@ KeyLocator::canGetFromSignature(const Signature* signature)
 {
   return dynamic_cast<const Sha256WithRsaSignature *>(signature) ||
          dynamic_cast<const Sha256WithEcdsaSignature *>(signature) ||
-         dynamic_cast<const HmacWithSha256Signature *>(signature);
+         dynamic_cast<const HmacWithSha256Signature *>(signature) ||
+         dynamic_cast<const MerkleSignature *>(signature);
 }
 
 KeyLocator&
@@ -78,6 +80,12 @@ KeyLocator::getFromSignature(Signature* signature)
     if (castSignature)
       return castSignature->getKeyLocator();
   }
+  {
+    MerkleSignature *castSignature =
+      dynamic_cast<MerkleSignature *>(signature);
+    if (castSignature)
+      return castSignature->getKeyLocator();
+  }
 
   throw runtime_error
     ("KeyLocator::getFromSignature: Signature type does not have a KeyLocator");
@@ -54,7 +54,8 @@ fromHexChar(uint8_t c)
 /**
  * Make a Blob value by decoding the hexString between beginOffset and
  * endOffset.
- * @param hexString The hex string.
+ * @param hexString The hex string. It does not need to be null-terminated
+ * because we only scan to endOffset.
  * @param beginOffset The offset in hexString of the beginning of the
  * portion to decode.
  * @param endOffset The offset in hexString of the end of the portion to
@@ -63,9 +64,10 @@ fromHexChar(uint8_t c)
  * the Blob has a null pointer.
  */
 static Blob
-fromHex(const string& hexString, size_t beginOffset, size_t endOffset)
+fromHex(const char* hexString, size_t beginOffset, size_t endOffset)
 {
-  ostringstream result;
+  ptr_lib::shared_ptr<vector<uint8_t> > result(new vector<uint8_t>());
+  result->reserve((endOffset - beginOffset) / 2);
 
   for (size_t i = beginOffset; i < endOffset; ++i) {
     if (hexString[i] == ' ')
@@ -82,45 +84,359 @@ fromHex(const string& hexString, size_t beginOffset, size_t endOffset)
       // Invalid hex characters.
       return Blob();
 
-    result << (uint8_t)(16 * hi + lo);
+    result->push_back((uint8_t)(16 * hi + lo));
 
     // Skip past the second digit.
     i += 1;
   }
 
-  string resultString = result.str();
-  return Blob((uint8_t*)&resultString[0], resultString.size());
+  return Blob(result, false);
 }
 
 /**
- * Return a copy of str, converting each escaped "%XX" to the char value.
- * @param str
+ * Append the bytes of str between beginOffset and endOffset to result,
+ * converting each escaped "%XX" to the byte value.
+ * @param str The escaped string. It does not need to be null-terminated
+ * because we only scan to endOffset.
+ * @param beginOffset The offset in str of the beginning of the portion to
+ * unescape.
+ * @param endOffset The offset in str of the end of the portion to unescape.
+ * @param result Append the unescaped bytes to this.
  */
-static string
-unescape(const string& str)
+static void
+unescape
+  (const char* str, size_t beginOffset, size_t endOffset,
+   vector<uint8_t>& result)
 {
-  ostringstream result;
-
-  for (size_t i = 0; i < str.size(); ++i) {
-    if (str[i] == '%' && i + 2 < str.size()) {
+  for (size_t i = beginOffset; i < endOffset; ++i) {
+    if (str[i] == '%' && i + 2 < endOffset) {
       int hi = fromHexChar(str[i + 1]);
       int lo = fromHexChar(str[i + 2]);
 
-      if (hi < 0 || lo < 0)
+      if (hi < 0 || lo < 0) {
         // Invalid hex characters, so just keep the escaped string.
-        result << str[i] << str[i + 1] << str[i + 2];
+        result.push_back(str[i]);
+        result.push_back(str[i + 1]);
+        result.push_back(str[i + 2]);
+      }
       else
-        result << (uint8_t)(16 * hi + lo);
+        result.push_back((uint8_t)(16 * hi + lo));
 
       // Skip ahead past the escaped value.
       i += 2;
     }
     else
       // Just copy through.
-      result << str[i];
+      result.push_back(str[i]);
+  }
+}
+
+/**
+ * Check if the character is whitespace which ndn_trim removes.
+ */
+static bool
+isTrimWhitespace(char c)
+{
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+/**
+ * Move beginOffset forward and endOffset back to omit whitespace at the
+ * beginning and end of the portion of str, like ndn_trim.
+ * @param str The string.
+ * @param beginOffset The offset in str of the beginning of the portion. This
+ * updates it.
+ * @param endOffset The offset in str of the end of the portion. This updates
+ * it.
+ */
+static void
+trimOffsets(const char* str, size_t& beginOffset, size_t& endOffset)
+{
+  while (beginOffset < endOffset && isTrimWhitespace(str[beginOffset]))
+    ++beginOffset;
+  while (endOffset > beginOffset && isTrimWhitespace(str[endOffset - 1]))
+    --endOffset;
+}
+
+// The 64-bit FNV-1a constants, used by getHash().
+static const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+static const uint64_t FNV_PRIME = 1099511628211ULL;
+
+/**
+ * Update the FNV-1a hash with the bytes.
+ * @param hash The hash so far.
+ * @param buf A pointer to the bytes.
+ * @param length The number of bytes.
+ * @return The updated hash.
+ */
+static uint64_t
+fnvUpdate(uint64_t hash, const uint8_t* buf, size_t length)
+{
+  for (size_t i = 0; i < length; ++i) {
+    hash ^= buf[i];
+    hash *= FNV_PRIME;
+  }
+
+  return hash;
+}
+
+/**
+ * Update the FNV-1a hash with the bytes of the number, in little-endian order.
+ * @param hash The hash so far.
+ * @param value The number.
+ * @return The updated hash.
+ */
+static uint64_t
+fnvUpdateSize(uint64_t hash, size_t value)
+{
+  for (size_t i = 0; i < sizeof(value); ++i) {
+    hash ^= (uint8_t)(value >> (8 * i));
+    hash *= FNV_PRIME;
+  }
+
+  return hash;
+}
+
+/**
+ * URI_UNRESERVED[x] is 1 if the byte x is 0-9, A-Z, a-z, (+), (-), (.) or (_),
+ * which are not escaped in the NDN URI Scheme. Otherwise it is 0.
+ */
+static const uint8_t URI_UNRESERVED[256] = {
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 1, 1, 0,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0,
+  0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 1,
+  0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static const char UPPER_HEX_DIGITS[] = "0123456789ABCDEF";
+static const char LOWER_HEX_DIGITS[] = "0123456789abcdef";
+static const char IMPLICIT_SHA256_DIGEST_PREFIX[] = "sha256digest=";
+static const size_t IMPLICIT_SHA256_DIGEST_PREFIX_LENGTH =
+  sizeof(IMPLICIT_SHA256_DIGEST_PREFIX) - 1;
+static const char PARAMETERS_SHA256_DIGEST_PREFIX[] = "params-sha256=";
+static const size_t PARAMETERS_SHA256_DIGEST_PREFIX_LENGTH =
+  sizeof(PARAMETERS_SHA256_DIGEST_PREFIX) - 1;
+
+/**
+ * Get the length of the value escaped by writeEscaped.
+ * @param value A pointer to the value.
+ * @param valueLength The length of the value.
+ * @return The escaped length.
+ */
+static size_t
+getEscapedLength(const uint8_t* value, size_t valueLength)
+{
+  size_t length = 0;
+  bool gotNonDot = false;
+  for (size_t i = 0; i < valueLength; ++i) {
+    if (value[i] != 0x2e)
+      gotNonDot = true;
+    length += (URI_UNRESERVED[value[i]] ? 1 : 3);
+  }
+
+  if (!gotNonDot)
+    // Special case for component of zero or more periods. Add 3 periods.
+    return 3 + valueLength;
+  else
+    return length;
+}
+
+/**
+ * Write the value to output, escaping characters according to the NDN URI
+ * Scheme. This also adds "..." to a value with zero or more ".".
+ * @param value A pointer to the value.
+ * @param valueLength The length of the value.
+ * @param output The output buffer, which must have room for
+ * getEscapedLength(value, valueLength) characters.
+ * @return A pointer in output after the last written character.
+ */
+static char*
+writeEscaped(const uint8_t* value, size_t valueLength, char* output)
+{
+  bool gotNonDot = false;
+  for (size_t i = 0; i < valueLength; ++i) {
+    if (value[i] != 0x2e) {
+      gotNonDot = true;
+      break;
+    }
+  }
+  if (!gotNonDot) {
+    // Special case for component of zero or more periods. Add 3 periods.
+    for (size_t i = 0; i < 3 + valueLength; ++i)
+      *(output++) = '.';
+    return output;
+  }
+
+  for (size_t i = 0; i < valueLength; ++i) {
+    uint8_t x = value[i];
+    if (URI_UNRESERVED[x])
+      *(output++) = (char)x;
+    else {
+      *(output++) = '%';
+      *(output++) = UPPER_HEX_DIGITS[x >> 4];
+      *(output++) = UPPER_HEX_DIGITS[x & 0xf];
+    }
+  }
+
+  return output;
+}
+
+/**
+ * Get the number of decimal digits in the value.
+ */
+static size_t
+getDecimalLength(unsigned int value)
+{
+  size_t length = 1;
+  while (value >= 10) {
+    value /= 10;
+    ++length;
+  }
+
+  return length;
+}
+
+/**
+ * Write the value as decimal digits to output, which must have room for
+ * getDecimalLength(value) characters.
+ * @return A pointer in output after the last written character.
+ */
+static char*
+writeDecimal(unsigned int value, char* output)
+{
+  char* end = output + getDecimalLength(value);
+  char* p = end;
+  do {
+    *(--p) = (char)('0' + value % 10);
+    value /= 10;
+  } while (value > 0);
+
+  return end;
+}
+
+/**
+ * Get the length of the URI of the component written by writeComponentUri.
+ * @param component The name component.
+ * @return The length.
+ */
+static size_t
+getComponentUriLength(const Name::Component& component)
+{
+  const Blob& value = component.getValue();
+  if (component.isImplicitSha256Digest())
+    return IMPLICIT_SHA256_DIGEST_PREFIX_LENGTH + 2 * value.size();
+  if (component.isParametersSha256Digest())
+    return PARAMETERS_SHA256_DIGEST_PREFIX_LENGTH + 2 * value.size();
+
+  size_t length = getEscapedLength(value.buf(), value.size());
+  if (!component.isGeneric())
+    length += getDecimalLength
+      ((unsigned int)(component.getType() == ndn_NameComponentType_OTHER_CODE ?
+        component.getOtherTypeCode() : (int)component.getType())) + 1;
+
+  return length;
+}
+
+/**
+ * Write the component to output, escaping characters according to the NDN URI
+ * Scheme and adding a type code prefix as needed, such as "sha256digest=".
+ * @param component The name component.
+ * @param output The output buffer, which must have room for
+ * getComponentUriLength(component) characters.
+ * @return A pointer in output after the last written character.
+ */
+static char*
+writeComponentUri(const Name::Component& component, char* output)
+{
+  const Blob& value = component.getValue();
+  if (component.isImplicitSha256Digest() ||
+      component.isParametersSha256Digest()) {
+    if (component.isImplicitSha256Digest()) {
+      ndn_memcpy
+        ((uint8_t*)output, (const uint8_t*)IMPLICIT_SHA256_DIGEST_PREFIX,
+         IMPLICIT_SHA256_DIGEST_PREFIX_LENGTH);
+      output += IMPLICIT_SHA256_DIGEST_PREFIX_LENGTH;
+    }
+    else {
+      ndn_memcpy
+        ((uint8_t*)output, (const uint8_t*)PARAMETERS_SHA256_DIGEST_PREFIX,
+         PARAMETERS_SHA256_DIGEST_PREFIX_LENGTH);
+      output += PARAMETERS_SHA256_DIGEST_PREFIX_LENGTH;
+    }
+
+    const uint8_t* buf = value.buf();
+    for (size_t i = 0; i < value.size(); ++i) {
+      *(output++) = LOWER_HEX_DIGITS[buf[i] >> 4];
+      *(output++) = LOWER_HEX_DIGITS[buf[i] & 0xf];
+    }
+    return output;
+  }
+
+  if (!component.isGeneric()) {
+    output = writeDecimal
+      ((unsigned int)(component.getType() == ndn_NameComponentType_OTHER_CODE ?
+        component.getOtherTypeCode() : (int)component.getType()), output);
+    *(output++) = '=';
+  }
+
+  return writeEscaped(value.buf(), value.size(), output);
+}
+
+/**
+ * Get the length of the URI of the components written by writeUri.
+ * @param components The name components.
+ * @param includeScheme If true, include the "ndn:" scheme.
+ * @return The length.
+ */
+static size_t
+getUriLength(const vector<Name::Component>& components, bool includeScheme)
+{
+  size_t length = (includeScheme ? 4 : 0);
+  if (components.size() == 0)
+    return length + 1;
+
+  for (size_t i = 0; i < components.size(); ++i)
+    length += 1 + getComponentUriLength(components[i]);
+
+  return length;
+}
+
+/**
+ * Write the URI of the components to output.
+ * @param components The name components.
+ * @param includeScheme If true, include the "ndn:" scheme.
+ * @param output The output buffer, which must have room for
+ * getUriLength(components, includeScheme) characters.
+ */
+static void
+writeUri
+  (const vector<Name::Component>& components, bool includeScheme, char* output)
+{
+  if (includeScheme) {
+    ndn_memcpy((uint8_t*)output, (const uint8_t*)"ndn:", 4);
+    output += 4;
+  }
+  if (components.size() == 0) {
+    *output = '/';
+    return;
   }
 
-  return result.str();
+  for (size_t i = 0; i < components.size(); ++i) {
+    *(output++) = '/';
+    output = writeComponentUri(components[i], output);
+  }
 }
 
 const uint8_t Name::Component::FINAL_SEGMENT_PREFIX[] = { 0xC1, '.', 'M', '.', 'F', 'I', 'N', 'A', 'L', 0x00 };
@@ -221,32 +537,16 @@ Name::Component::get(NameLite::Component& componentLite) const
 void
 Name::Component::toEscapedString(std::ostringstream& result) const
 {
-  if (type_ == ndn_NameComponentType_IMPLICIT_SHA256_DIGEST) {
-    result << "sha256digest=";
-    value_.toHex(result);
-    return;
-  }
-  if (type_ == ndn_NameComponentType_PARAMETERS_SHA256_DIGEST) {
-    result << "params-sha256=";
-    value_.toHex(result);
-    return;
-  }
-
-  if (type_ != ndn_NameComponentType_GENERIC) {
-    result << (type_ == ndn_NameComponentType_OTHER_CODE ?
-               otherTypeCode_ : (int)type_);
-    result << '=';
-  }
-
-  Name::toEscapedString(*value_, result);
+  result << toEscapedString();
 }
 
 std::string
 Name::Component::toEscapedString() const
 {
-  ostringstream result;
-  toEscapedString(result);
-  return result.str();
+  string result(getComponentUriLength(*this), '\0');
+  if (result.size() > 0)
+    writeComponentUri(*this, &result[0]);
+  return result;
 }
 
 uint64_t
@@ -280,6 +580,17 @@ Name::Component::compare(const Name::Component& other) const
   return ndn_memcmp(value_.buf(), other.value_.buf(), value_.size());
 }
 
+uint64_t
+Name::Component::getHash() const
+{
+  int typeCode = (type_ == ndn_NameComponentType_OTHER_CODE ?
+                  otherTypeCode_ : (int)type_);
+
+  uint64_t hash = fnvUpdateSize(FNV_OFFSET_BASIS, (size_t)typeCode);
+  hash = fnvUpdateSize(hash, value_.size());
+  return fnvUpdate(hash, value_.buf(), value_.size());
+}
+
 Name::Component
 Name::Component::fromImplicitSha256Digest(const Blob& digest)
 {
@@ -352,121 +663,234 @@ Name::Component::setType(ndn_NameComponentType type, int otherTypeCode)
     otherTypeCode_ = -1;
 }
 
-void
-Name::set(const char *uri_cstr)
+/**
+ * Find the path of the URI after omitting whitespace, the scheme such as
+ * "ndn:", the leading slash and the authority following "//".
+ * @param uri The URI.
+ * @param uriLength The length of uri.
+ * @param beginOffset Set this to the offset in uri of the beginning of the
+ * path.
+ * @param endOffset Set this to the offset in uri of the end of the path. If
+ * the path is empty, this is the same as beginOffset.
+ */
+static void
+getUriPathOffsets
+  (const char* uri, size_t uriLength, size_t& beginOffset, size_t& endOffset)
 {
-  clear();
-
-  string uri = uri_cstr;
-  ndn_trim(uri);
-  if (uri.size() == 0)
+  beginOffset = 0;
+  endOffset = uriLength;
+  trimOffsets(uri, beginOffset, endOffset);
+  if (beginOffset == endOffset)
     return;
 
-  size_t iColon = uri.find(':');
-  if (iColon != string::npos) {
+  const char* colon = (const char*)::memchr
+    (uri + beginOffset, ':', endOffset - beginOffset);
+  if (colon) {
     // Make sure the colon came before a '/'.
-    size_t iFirstSlash = uri.find('/');
-    if (iFirstSlash == string::npos || iColon < iFirstSlash) {
+    const char* firstSlash = (const char*)::memchr
+      (uri + beginOffset, '/', endOffset - beginOffset);
+    if (!firstSlash || colon < firstSlash) {
       // Omit the leading protocol such as ndn:
-      uri.erase(0, iColon + 1);
-      ndn_trim(uri);
+      beginOffset = (colon - uri) + 1;
+      trimOffsets(uri, beginOffset, endOffset);
     }
   }
 
   // Trim the leading slash and possibly the authority.
-  if (uri[0] == '/') {
-    if (uri.size() >= 2 && uri[1] == '/') {
+  if (beginOffset < endOffset && uri[beginOffset] == '/') {
+    if (endOffset - beginOffset >= 2 && uri[beginOffset + 1] == '/') {
       // Strip the authority following "//".
-      size_t iAfterAuthority = uri.find('/', 2);
-      if (iAfterAuthority == string::npos)
+      const char* afterAuthority = (const char*)::memchr
+        (uri + beginOffset + 2, '/', endOffset - (beginOffset + 2));
+      if (!afterAuthority) {
         // Unusual case: there was only an authority.
+        beginOffset = endOffset;
         return;
-      else {
-        uri.erase(0, iAfterAuthority + 1);
-        ndn_trim(uri);
       }
+      else
+        beginOffset = (afterAuthority - uri) + 1;
     }
+    else
+      beginOffset += 1;
+
+    trimOffsets(uri, beginOffset, endOffset);
+  }
+}
+
+/**
+ * Parse the escaped URI component between beginOffset and endOffset, including
+ * a type code prefix such as "sha256digest=".
+ * @param uri The URI, used for the component and the error message.
+ * @param beginOffset The offset in uri of the beginning of the component.
+ * @param endOffset The offset in uri of the end of the component.
+ * @param component Set this to the parsed component.
+ * @return True for success, or false if the component is illegal and should
+ * be skipped, such as "." or "..".
+ * @throws runtime_error if the type code can't be parsed.
+ */
+static bool
+parseUriComponent
+  (const char* uri, size_t beginOffset, size_t endOffset,
+   Name::Component& component)
+{
+  size_t componentLength = endOffset - beginOffset;
+  if (componentLength >= IMPLICIT_SHA256_DIGEST_PREFIX_LENGTH &&
+      ::memcmp(uri + beginOffset, IMPLICIT_SHA256_DIGEST_PREFIX,
+               IMPLICIT_SHA256_DIGEST_PREFIX_LENGTH) == 0) {
+    component = Name::Component::fromImplicitSha256Digest
+      (fromHex(uri, beginOffset + IMPLICIT_SHA256_DIGEST_PREFIX_LENGTH,
+               endOffset));
+    return true;
+  }
+  if (componentLength >= PARAMETERS_SHA256_DIGEST_PREFIX_LENGTH &&
+      ::memcmp(uri + beginOffset, PARAMETERS_SHA256_DIGEST_PREFIX,
+               PARAMETERS_SHA256_DIGEST_PREFIX_LENGTH) == 0) {
+    component = Name::Component::fromParametersSha256Digest
+      (fromHex(uri, beginOffset + PARAMETERS_SHA256_DIGEST_PREFIX_LENGTH,
+               endOffset));
+    return true;
+  }
+
+  ndn_NameComponentType type = ndn_NameComponentType_GENERIC;
+  int otherTypeCode = -1;
+
+  // Check for a component type.
+  const char* typeCodeEnd = (const char*)::memchr
+    (uri + beginOffset, '=', componentLength);
+  if (typeCodeEnd) {
+    string typeString(uri + beginOffset, typeCodeEnd);
+    if (typeString == "0")
+      otherTypeCode = 0;
     else {
-      uri.erase(0, 1);
-      ndn_trim(uri);
+      otherTypeCode = ::atoi(typeString.c_str());
+      if (otherTypeCode == 0)
+      throw runtime_error
+        ("Can't parse decimal Name Component type: " + typeString +
+         " in URI " + uri);
     }
+
+    // Allow for a decimal value of recognized component types.
+    if (otherTypeCode == (int)ndn_NameComponentType_GENERIC ||
+        otherTypeCode == (int)ndn_NameComponentType_IMPLICIT_SHA256_DIGEST ||
+        otherTypeCode == (int)ndn_NameComponentType_PARAMETERS_SHA256_DIGEST)
+      // The enum values are the same as the TLV type codes.
+      type = (ndn_NameComponentType)otherTypeCode;
+    else
+      type = ndn_NameComponentType_OTHER_CODE;
+
+    beginOffset = (typeCodeEnd - uri) + 1;
   }
 
-  size_t iComponentStart = 0;
-
-  // Unescape the components.
-  string sha256digestPrefix("sha256digest=");
-  string paramsSha256Prefix("params-sha256=");
-  while (iComponentStart < uri.size()) {
-    size_t iComponentEnd = uri.find("/", iComponentStart);
-    if (iComponentEnd == string::npos)
-      iComponentEnd = uri.size();
-
-    Component component;
-    if (iComponentStart + sha256digestPrefix.size() <= uri.size() &&
-        uri.compare
-          (iComponentStart, sha256digestPrefix.size(), sha256digestPrefix) == 0)
-      component = Component::fromImplicitSha256Digest
-            (fromHex(uri, iComponentStart + sha256digestPrefix.size(),
-                     iComponentEnd));
-    else if (iComponentStart + paramsSha256Prefix.size() <= uri.size() &&
-        uri.compare
-          (iComponentStart, paramsSha256Prefix.size(), paramsSha256Prefix) == 0)
-      component = Component::fromParametersSha256Digest
-            (fromHex(uri, iComponentStart + paramsSha256Prefix.size(),
-                     iComponentEnd));
-    else {
-      ndn_NameComponentType type = ndn_NameComponentType_GENERIC;
-      int otherTypeCode = -1;
-
-      // Check for a component type.
-      int iTypeCodeEnd = uri.find("=", iComponentStart);
-      if (iTypeCodeEnd != string::npos && iTypeCodeEnd < iComponentEnd) {
-        string typeString = uri.substr
-          (iComponentStart, iTypeCodeEnd - iComponentStart);
-        if (typeString == "0")
-          otherTypeCode = 0;
-        else {
-          otherTypeCode = ::atoi(typeString.c_str());
-          if (otherTypeCode == 0)
-          throw runtime_error
-            ("Can't parse decimal Name Component type: " + typeString +
-             " in URI " + uri);
-        }
-
-        // Allow for a decimal value of recognized component types.
-        if (otherTypeCode == (int)ndn_NameComponentType_GENERIC ||
-            otherTypeCode == (int)ndn_NameComponentType_IMPLICIT_SHA256_DIGEST ||
-            otherTypeCode == (int)ndn_NameComponentType_PARAMETERS_SHA256_DIGEST)
-          // The enum values are the same as the TLV type codes.
-          type = (ndn_NameComponentType)otherTypeCode;
-        else
-          type = ndn_NameComponentType_OTHER_CODE;
-
-        iComponentStart = iTypeCodeEnd + 1;
-      }
+  Blob value = Name::fromEscapedString(uri, beginOffset, endOffset);
+  if (!value)
+    // Ignore illegal components.
+    return false;
+
+  component = Name::Component(value, type, otherTypeCode);
+  return true;
+}
 
-      component = Component
-        (fromEscapedString(&uri[0], iComponentStart, iComponentEnd), type,
-         otherTypeCode);
+/**
+ * A UriComponentCache remembers the text and the parsed component at each
+ * index of the URIs given to parseUri, so that a component with the same text
+ * at the same index in a later URI reuses the parsed component and shares its
+ * value.
+ */
+class UriComponentCache {
+public:
+  class Entry {
+  public:
+    Entry()
+    : text_(0), textLength_(0), isLegal_(false)
+    {
     }
 
-    // Ignore illegal components.  This also gets rid of a trailing '/'.
-    if (component.getValue())
-      append(component);
+    // A pointer into a URI which must remain valid while using the cache.
+    const char* text_;
+    size_t textLength_;
+    Name::Component component_;
+    bool isLegal_;
+  };
+
+  std::vector<Entry> entries_;
+};
+
+/**
+ * Parse the URI and append the components to the name.
+ * @param uri The null-terminated URI.
+ * @param name Append the components to this name.
+ * @param cache (optional) If not null, use the cache to reuse parsed
+ * components. The URI must remain valid while using the cache.
+ */
+static void
+parseUri(const char* uri, Name& name, UriComponentCache* cache)
+{
+  size_t iPathBegin, iPathEnd;
+  getUriPathOffsets(uri, ::strlen(uri), iPathBegin, iPathEnd);
+
+  size_t iComponentStart = iPathBegin;
+  size_t iComponent = 0;
+  while (iComponentStart < iPathEnd) {
+    const char* slash = (const char*)::memchr
+      (uri + iComponentStart, '/', iPathEnd - iComponentStart);
+    size_t iComponentEnd = (slash ? slash - uri : iPathEnd);
+    size_t textLength = iComponentEnd - iComponentStart;
+
+    if (cache) {
+      if (iComponent >= cache->entries_.size())
+        cache->entries_.resize(iComponent + 1);
+
+      UriComponentCache::Entry& entry = cache->entries_[iComponent];
+      if (!(entry.text_ && entry.textLength_ == textLength &&
+            ::memcmp(entry.text_, uri + iComponentStart, textLength) == 0)) {
+        entry.isLegal_ = parseUriComponent
+          (uri, iComponentStart, iComponentEnd, entry.component_);
+        entry.text_ = uri + iComponentStart;
+        entry.textLength_ = textLength;
+      }
+
+      if (entry.isLegal_)
+        name.append(entry.component_);
+    }
+    else {
+      Name::Component component;
+      // Ignore illegal components. This also gets rid of a trailing '/'.
+      if (parseUriComponent(uri, iComponentStart, iComponentEnd, component))
+        name.append(component);
+    }
 
     iComponentStart = iComponentEnd + 1;
+    ++iComponent;
   }
 }
 
+void
+Name::set(const char *uri)
+{
+  clear();
+  parseUri(uri, *this, 0);
+}
+
+void
+Name::fromUris(const vector<string>& uris, vector<Name>& names)
+{
+  names.clear();
+  names.resize(uris.size());
+
+  UriComponentCache cache;
+  for (size_t i = 0; i < uris.size(); ++i)
+    parseUri(uris[i].c_str(), names[i], &cache);
+}
+
 void
 Name::get(NameLite& nameLite) const
 {
   nameLite.clear();
-  for (size_t i = 0; i < components_.size(); ++i) {
+  const vector<Component>& components = getComponents();
+  for (size_t i = 0; i < components.size(); ++i) {
     ndn_Error error;
     NameLite::Component component;
-    components_[i].get(component);
+    components[i].get(component);
     if ((error = nameLite.append(component)))
       throw runtime_error(ndn_getErrorString(error));
   }
@@ -476,6 +900,11 @@ void
 Name::set(const NameLite& nameLite)
 {
   clear();
+  if (nameLite.size() == 0)
+    return;
+
+  // Allocate the components array once.
+  getMutableComponents().reserve(nameLite.size());
   for (size_t i = 0; i < nameLite.size(); ++i)
     append(Component(nameLite.get(i)));
 }
@@ -487,8 +916,23 @@ Name::append(const Name& name)
     // Copying from this name, so need to make a copy first.
     return append(Name(name));
 
-  for (size_t i = 0; i < name.components_.size(); ++i)
-    append(name.components_[i]);
+  if (name.size() == 0)
+    return *this;
+  if (size() == 0) {
+    // Share the components of the other name.
+    components_ = name.components_;
+    ++changeCount_;
+    hash_ = name.hash_;
+    return *this;
+  }
+
+  const vector<Component>& otherComponents = *name.components_;
+  vector<Component>& components = getMutableComponents();
+  components.insert
+    (components.end(), otherComponents.begin(), otherComponents.end());
+  ++changeCount_;
+  for (size_t i = 0; i < otherComponents.size(); ++i)
+    hash_ = updateHash(hash_, otherComponents[i]);
 
   return *this;
 }
@@ -496,31 +940,45 @@ Name::append(const Name& name)
 string
 Name::toUri(bool includeScheme) const
 {
-  if (components_.size() == 0)
-    return includeScheme ? "ndn:/" : "/";
-
-  ostringstream result;
-  if (includeScheme)
-    result << "ndn:";
-  for (size_t i = 0; i < components_.size(); ++i) {
-    result << "/";
-    components_[i].toEscapedString(result);
-  }
+  const vector<Component>& components = getComponents();
+  string result(getUriLength(components, includeScheme), '\0');
+  writeUri(components, includeScheme, &result[0]);
+  return result;
+}
 
-  return result.str();
+size_t
+Name::toUri(char* buffer, size_t bufferLength, bool includeScheme) const
+{
+  const vector<Component>& components = getComponents();
+  size_t length = getUriLength(components, includeScheme);
+  if (length >= bufferLength)
+    // The buffer is too small for the URI and the null terminator.
+    return length;
+
+  writeUri(components, includeScheme, buffer);
+  buffer[length] = 0;
+  return length;
 }
 
 Name
 Name::getSubName(int iStartComponent, size_t nComponents) const
 {
+  const vector<Component>& components = getComponents();
   if (iStartComponent < 0)
-    iStartComponent = components_.size() - (-iStartComponent);
+    iStartComponent = components.size() - (-iStartComponent);
 
-  Name result;
+  size_t iEnd = min(iStartComponent + nComponents, components.size());
+  if (iStartComponent == 0 && iEnd == components.size())
+    // The sub name is the whole name, so share the components.
+    return *this;
 
-  size_t iEnd = min(iStartComponent + nComponents, components_.size());
-  for (size_t i = iStartComponent; i < iEnd; ++i)
-    result.components_.push_back(components_[i]);
+  Name result;
+  if (iStartComponent >= 0 && (size_t)iStartComponent < iEnd) {
+    // Copy the components with one allocation.
+    result.components_.reset(new vector<Component>
+      (components.begin() + iStartComponent, components.begin() + iEnd));
+    result.hash_ = result.computeHash();
+  }
 
   return result;
 }
@@ -528,12 +986,19 @@ Name::getSubName(int iStartComponent, size_t nComponents) const
 bool
 Name::equals(const Name& name) const
 {
-  if (components_.size() != name.components_.size())
+  if (size() != name.size())
+    return false;
+  if (size() == 0 || components_ == name.components_)
+    // The names are empty or share the same components.
+    return true;
+  if (hash_ != name.hash_)
     return false;
 
+  const vector<Component>& components = *components_;
+  const vector<Component>& otherComponents = *name.components_;
   // Check from last to first since the last components are more likely to differ.
-  for (int i = components_.size() - 1; i >= 0; --i) {
-    if (*components_[i].getValue() != *name.components_[i].getValue())
+  for (int i = components.size() - 1; i >= 0; --i) {
+    if (*components[i].getValue() != *otherComponents[i].getValue())
       return false;
   }
 
@@ -555,13 +1020,15 @@ Name::match(const Name& name) const
   // Imitate ndn_Name_match.
 
   // This name is longer than the name we are checking it against.
-  if (components_.size() > name.components_.size())
+  if (size() > name.size())
     return false;
 
+  const vector<Component>& components = getComponents();
+  const vector<Component>& otherComponents = name.getComponents();
   // Check if at least one of given components doesn't match. Check from last to
   // first since the last components are more likely to differ.
-  for (int i = components_.size() - 1; i >= 0; --i) {
-    if (*components_[i].getValue() != *name.components_[i].getValue())
+  for (int i = components.size() - 1; i >= 0; --i) {
+    if (*components[i].getValue() != *otherComponents[i].getValue())
       return false;
   }
 
@@ -571,21 +1038,29 @@ Name::match(const Name& name) const
 Blob
 Name::fromEscapedString(const char *escapedString, size_t beginOffset, size_t endOffset)
 {
-  string trimmedString(escapedString + beginOffset, escapedString + endOffset);
-  ndn_trim(trimmedString);
-  string value = unescape(trimmedString);
+  trimOffsets(escapedString, beginOffset, endOffset);
+  ptr_lib::shared_ptr<vector<uint8_t> > value(new vector<uint8_t>());
+  value->reserve(endOffset - beginOffset);
+  unescape(escapedString, beginOffset, endOffset, *value);
 
-  if (value.find_first_not_of(".") == string::npos) {
+  bool gotNonDot = false;
+  for (size_t i = 0; i < value->size(); ++i) {
+    if ((*value)[i] != '.') {
+      gotNonDot = true;
+      break;
+    }
+  }
+  if (!gotNonDot) {
     // Special case for component of only periods.
-    if (value.size() <= 2)
+    if (value->size() <= 2)
       // Zero, one or two periods is illegal.  Ignore this component.
       return Blob();
     else
       // Remove 3 periods.
-      return Blob((const uint8_t *)&value[3], value.size() - 3);
+      value->erase(value->begin(), value->begin() + 3);
   }
-  else
-    return Blob((const uint8_t *)&value[0], value.size());
+
+  return Blob(value, false);
 }
 
 Blob
@@ -597,66 +1072,34 @@ Name::fromEscapedString(const char *escapedString)
 void
 Name::toEscapedString(const vector<uint8_t>& value, ostringstream& result)
 {
-  bool gotNonDot = false;
-  for (unsigned i = 0; i < value.size(); ++i) {
-    if (value[i] != 0x2e) {
-      gotNonDot = true;
-      break;
-    }
-  }
-  if (!gotNonDot) {
-    // Special case for component of zero or more periods.  Add 3 periods.
-    result << "...";
-    for (size_t i = 0; i < value.size(); ++i)
-      result << '.';
-  }
-  else {
-    // In case we need to escape, set to upper case hex and save the previous flags.
-    ios::fmtflags saveFlags = result.flags(ios::hex | ios::uppercase);
-
-    for (size_t i = 0; i < value.size(); ++i) {
-      uint8_t x = value[i];
-      // Check for 0-9, A-Z, a-z, (+), (-), (.), (_)
-      if ((x >= 0x30 && x <= 0x39) || (x >= 0x41 && x <= 0x5a) ||
-          (x >= 0x61 && x <= 0x7a) || x == 0x2b || x == 0x2d ||
-          x == 0x2e || x == 0x5f)
-        result << x;
-      else {
-        result << '%';
-        if (x < 16)
-          result << '0';
-        result << (unsigned int)x;
-      }
-    }
-
-    // Restore.
-    result.flags(saveFlags);
-  }
+  result << toEscapedString(value);
 }
 
 string
 Name::toEscapedString(const vector<uint8_t>& value)
 {
-  ostringstream result;
-  toEscapedString(value, result);
-  return result.str();
+  const uint8_t* buf = (value.size() > 0 ? &value[0] : 0);
+  string result(getEscapedLength(buf, value.size()), '\0');
+  writeEscaped(buf, value.size(), &result[0]);
+  return result;
 }
 
 const Name::Component&
 Name::get(int i) const
 {
+  const vector<Component>& components = getComponents();
   if (i >= 0) {
-    if (i >= (int)components_.size())
+    if (i >= (int)components.size())
       throw runtime_error("Name.get: Index is out of bounds");
 
-    return components_[i];
+    return components[i];
   }
   else {
     // Negative index.
-    if (i < -((int)components_.size()))
+    if (i < -((int)components.size()))
       throw runtime_error("Name.get: Index is out of bounds");
 
-    return components_[components_.size() - (-i)];
+    return components[components.size() - (-i)];
   }
 }
 
@@ -665,18 +1108,20 @@ Name::compare
   (int iStartComponent, size_t nComponents, const Name& other,
    int iOtherStartComponent, size_t nOtherComponents) const
 {
+  const vector<Component>& components = getComponents();
+  const vector<Component>& otherComponents = other.getComponents();
   if (iStartComponent < 0)
-    iStartComponent = components_.size() - (-iStartComponent);
+    iStartComponent = components.size() - (-iStartComponent);
   if (iStartComponent < 0)
-    iOtherStartComponent = other.components_.size() - (-iOtherStartComponent);
+    iOtherStartComponent = otherComponents.size() - (-iOtherStartComponent);
 
   nComponents = min(nComponents, size() - iStartComponent);
   nOtherComponents = min(nOtherComponents, other.size() - iOtherStartComponent);
 
   size_t count = min(nComponents, nOtherComponents);
   for (size_t i = 0; i < count; ++i) {
-    int comparison = components_[iStartComponent + i].compare
-      (other.components_[iOtherStartComponent + i]);
+    int comparison = components[iStartComponent + i].compare
+      (otherComponents[iOtherStartComponent + i]);
     if (comparison == 0)
       // The components at this index are equal, so check the next components.
       continue;
@@ -704,4 +1149,48 @@ Name::checkAppendOtherTypeCode(int otherTypeCode)
   if (otherTypeCode < -1)
     throw invalid_argument("Name::append: other type code must be non-negative");
 }
+
+vector<Name::Component>&
+Name::getMutableComponents()
+{
+  if (!components_)
+    components_.reset(new vector<Component>());
+  else if (components_.use_count() != 1)
+    // Another Name shares the components, so make our own copy.
+    components_.reset(new vector<Component>(*components_));
+
+  return *components_;
+}
+
+const uint64_t Name::EMPTY_HASH;
+
+uint64_t
+Name::computeHash() const
+{
+  // Equal names only need equal values (see equals()), so don't include the
+  // component types. Include each length so that the component boundaries
+  // affect the hash.
+  uint64_t hash = FNV_OFFSET_BASIS;
+  const vector<Component>& components = getComponents();
+  for (size_t i = 0; i < components.size(); ++i)
+    hash = updateHash(hash, components[i]);
+
+  return hash;
+}
+
+uint64_t
+Name::updateHash(uint64_t hash, const Component& component)
+{
+  const Blob& value = component.getValue();
+  hash = fnvUpdateSize(hash, value.size());
+  return fnvUpdate(hash, value.buf(), value.size());
+}
+
+const vector<Name::Component>&
+Name::getEmptyComponents()
+{
+  static vector<Component> emptyComponents;
+  return emptyComponents;
+}
+
 }
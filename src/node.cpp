@@ -28,6 +28,7 @@
 #include "c/util/time.h"
 #include "encoding/tlv-decoder.hpp"
 #include <ndn-cpp/util/logging.hpp>
+#include <ndn-cpp/util/packet-trace.hpp>
 #include "lp/lp-packet.hpp"
 #include "node.hpp"
 
@@ -143,6 +144,9 @@ Node::putData(const Data& data, WireFormat* wireFormat)
       ("The encoded Data packet size exceeds the maximum limit getMaxNdnPacketSize()");
 
   send(encoding.buf(), encoding.size());
+  _TRACE_PACKET(PacketTrace::SEND, encoding.size(), data.getName().getHash());
+  ++metrics_.nDataSent_;
+  metrics_.nDataBytesOut_ += encoding.size();
 }
 
 void
@@ -155,6 +159,17 @@ Node::send(const uint8_t *encoding, size_t encodingLength)
   transport_->send(encoding, encodingLength);
 }
 
+FaceMetrics
+Node::getMetrics() const
+{
+  FaceMetrics metrics(metrics_);
+  metrics.pendingInterestTableSize_ = pendingInterestTable_.size();
+  metrics.interestFilterTableSize_ = interestFilterTable_.size();
+  metrics.delayedCallTableSize_ = delayedCallTable_.size();
+
+  return metrics;
+}
+
 uint64_t
 Node::getNextEntryId()
 {
@@ -312,6 +327,8 @@ Node::processEvents()
 void
 Node::onReceivedElement(const uint8_t *element, size_t elementLength)
 {
+  _TRACE_PACKET(PacketTrace::RECEIVE, elementLength, 0);
+
   ptr_lib::shared_ptr<LpPacket> lpPacket;
   if (element[0] == ndn_Tlv_LpPacket_LpPacket) {
     // Decode the LpPacket and replace element with the fragment.
@@ -334,39 +351,64 @@ Node::onReceivedElement(const uint8_t *element, size_t elementLength)
     lpPacket->set(lpPacketLite);
   }
 
-  // First, decode as Interest or Data.
+  // First, decode as Interest or Data. Only decode the name now, since
+  // matching the interest filters and pending interests usually only needs the
+  // name. The other fields are decoded before passing the packet to the
+  // application, so that it gets a packet which is safe to share between
+  // threads, and are not decoded at all if nothing matches. To avoid an
+  // allocation for each packet, reuse an object which the application didn't
+  // keep from a previous packet.
   ptr_lib::shared_ptr<Interest> interest;
   ptr_lib::shared_ptr<Data> data;
 
   if (element[0] == ndn_Tlv_Interest || element[0] == ndn_Tlv_Data) {
     TlvDecoder decoder(element, elementLength);
     if (decoder.peekType(ndn_Tlv_Interest, elementLength)) {
-      interest.reset(new Interest());
-      interest->wireDecode(element, elementLength, *TlvWireFormat::get());
-
-      if (lpPacket)
-        interest->setLpPacket(lpPacket);
+      ++metrics_.nInterestsReceived_;
+      metrics_.nInterestBytesIn_ += elementLength;
+      interest = interestPool_.acquire();
+      interest->wireDecodeLazy(element, elementLength, *TlvWireFormat::get());
+      _TRACE_PACKET
+        (PacketTrace::DECODE, ndn_Tlv_Interest, interest->getName().getHash());
+      // Also clear an LpPacket from a previous use.
+      interest->setLpPacket(lpPacket);
     }
     else if (decoder.peekType(ndn_Tlv_Data, elementLength)) {
-      data.reset(new Data());
-      data->wireDecode(element, elementLength, *TlvWireFormat::get());
-
-      if (lpPacket)
-        data->setLpPacket(lpPacket);
+      ++metrics_.nDataReceived_;
+      metrics_.nDataBytesIn_ += elementLength;
+      data = dataPool_.acquire();
+      data->wireDecodeLazy(element, elementLength, *TlvWireFormat::get());
+      _TRACE_PACKET
+        (PacketTrace::DECODE, ndn_Tlv_Data, data->getName().getHash());
+      // Also clear an LpPacket from a previous use.
+      data->setLpPacket(lpPacket);
     }
   }
 
+  // Swap the reusable vectors into local variables in case a callback causes
+  // this method to be called again.
+  vector<ptr_lib::shared_ptr<PendingInterestTable::Entry> > pitEntries;
+  pitEntries.swap(pitEntriesBuffer_);
+
   if (lpPacket) {
     ptr_lib::shared_ptr<NetworkNack> networkNack =
       NetworkNack::getFirstHeader(*lpPacket);
     if (networkNack) {
-      if (!interest)
+      if (!interest) {
         // We got a Nack but not for an Interest, so drop the packet.
+        recycle(interest, data, pitEntries);
         return;
+      }
 
-      vector<ptr_lib::shared_ptr<PendingInterestTable::Entry> > pitEntries;
       pendingInterestTable_.extractEntriesForNackInterest(*interest, pitEntries);
+      _TRACE_PACKET
+        (PacketTrace::PIT_MATCH, pitEntries.size(),
+         interest->getName().getHash());
       for (size_t i = 0; i < pitEntries.size(); ++i) {
+        ++metrics_.nInterestsNacked_;
+        MillisecondsSince1970 callbackStart = ndn_getNowMilliseconds();
+        _TRACE_PACKET
+          (PacketTrace::CALLBACK_ENTER, pitEntries[i]->getPendingInterestId(), 0);
         try {
           pitEntries[i]->getOnNetworkNack()
             (pitEntries[i]->getInterest(), networkNack);
@@ -375,9 +417,13 @@ Node::onReceivedElement(const uint8_t *element, size_t elementLength)
         } catch (...) {
           _LOG_ERROR("Node::onReceivedElement: Error in onNetworkNack.");
         }
+        _TRACE_PACKET
+          (PacketTrace::CALLBACK_EXIT, pitEntries[i]->getPendingInterestId(), 0);
+        recordCallbackTime(callbackStart);
       }
 
       // We have processed the network Nack packet.
+      recycle(interest, data, pitEntries);
       return;
     }
   }
@@ -386,10 +432,19 @@ Node::onReceivedElement(const uint8_t *element, size_t elementLength)
   if (interest) {
     // Call all interest filter callbacks which match.
     vector<ptr_lib::shared_ptr<InterestFilterTable::Entry> > matchedFilters;
+    matchedFilters.swap(matchedFiltersBuffer_);
     interestFilterTable_.getMatchedFilters(*interest, matchedFilters);
+    _TRACE_PACKET
+      (PacketTrace::INTEREST_FILTER_MATCH, matchedFilters.size(),
+       interest->getName().getHash());
+    if (matchedFilters.size() > 0)
+      interest->decodeLazyFields();
 
     for (size_t i = 0; i < matchedFilters.size(); ++i) {
       InterestFilterTable::Entry &entry = *matchedFilters[i];
+      MillisecondsSince1970 callbackStart = ndn_getNowMilliseconds();
+      _TRACE_PACKET
+        (PacketTrace::CALLBACK_ENTER, entry.getInterestFilterId(), 0);
       try {
         entry.getOnInterest()
           (entry.getPrefix(), interest, entry.getFace(),
@@ -399,12 +454,28 @@ Node::onReceivedElement(const uint8_t *element, size_t elementLength)
       } catch (...) {
         _LOG_ERROR("Node::onReceivedElement: Error in onInterest.");
       }
+      _TRACE_PACKET(PacketTrace::CALLBACK_EXIT, entry.getInterestFilterId(), 0);
+      recordCallbackTime(callbackStart);
     }
+
+    matchedFilters.clear();
+    matchedFiltersBuffer_.swap(matchedFilters);
   }
   else if (data) {
-    vector<ptr_lib::shared_ptr<PendingInterestTable::Entry> > pitEntries;
     pendingInterestTable_.extractEntriesForExpressedInterest(*data, pitEntries);
+    _TRACE_PACKET
+      (PacketTrace::PIT_MATCH, pitEntries.size(), data->getName().getHash());
+    if (pitEntries.size() > 0)
+      data->decodeLazyFields();
+    MillisecondsSince1970 receiveTime = ndn_getNowMilliseconds();
     for (size_t i = 0; i < pitEntries.size(); ++i) {
+      ++metrics_.nInterestsSatisfied_;
+      metrics_.roundTripTimeMicroseconds_.recordValue
+        (toMicroseconds(pitEntries[i]->getExpressTime(), receiveTime));
+
+      MillisecondsSince1970 callbackStart = ndn_getNowMilliseconds();
+      _TRACE_PACKET
+        (PacketTrace::CALLBACK_ENTER, pitEntries[i]->getPendingInterestId(), 0);
       try {
         pitEntries[i]->getOnData()(pitEntries[i]->getInterest(), data);
       } catch (const std::exception& ex) {
@@ -412,8 +483,26 @@ Node::onReceivedElement(const uint8_t *element, size_t elementLength)
       } catch (...) {
         _LOG_ERROR("Node::onReceivedElement: Error in onData.");
       }
+      _TRACE_PACKET
+        (PacketTrace::CALLBACK_EXIT, pitEntries[i]->getPendingInterestId(), 0);
+      recordCallbackTime(callbackStart);
     }
   }
+
+  recycle(interest, data, pitEntries);
+}
+
+void
+Node::recycle
+  (ptr_lib::shared_ptr<Interest>& interest, ptr_lib::shared_ptr<Data>& data,
+   vector<ptr_lib::shared_ptr<PendingInterestTable::Entry> >& pitEntries)
+{
+  interestPool_.release(interest);
+  dataPool_.release(data);
+
+  // Clear the entries but keep the allocated capacity.
+  pitEntries.clear();
+  pitEntriesBuffer_.swap(pitEntries);
 }
 
 void
@@ -455,6 +544,10 @@ Node::expressInterestHelper
       throw runtime_error
         ("The encoded interest size exceeds the maximum limit getMaxNdnPacketSize()");
     transport_->send(*encoding);
+    _TRACE_PACKET
+      (PacketTrace::SEND, encoding.size(), interestCopy->getName().getHash());
+    ++metrics_.nInterestsExpressed_;
+    metrics_.nInterestBytesOut_ += encoding.size();
   }
 }
 
@@ -462,8 +555,36 @@ void
 Node::processInterestTimeout
   (ptr_lib::shared_ptr<PendingInterestTable::Entry> pendingInterest)
 {
-  if (pendingInterestTable_.removeEntry(pendingInterest))
+  if (pendingInterestTable_.removeEntry(pendingInterest)) {
+    ++metrics_.nInterestsTimedOut_;
+    _TRACE_PACKET
+      (PacketTrace::TIMEOUT, pendingInterest->getPendingInterestId(),
+       pendingInterest->getInterest()->getName().getHash());
+    MillisecondsSince1970 callbackStart = ndn_getNowMilliseconds();
+    _TRACE_PACKET
+      (PacketTrace::CALLBACK_ENTER, pendingInterest->getPendingInterestId(), 0);
     pendingInterest->callTimeout();
+    _TRACE_PACKET
+      (PacketTrace::CALLBACK_EXIT, pendingInterest->getPendingInterestId(), 0);
+    recordCallbackTime(callbackStart);
+  }
+}
+
+uint64_t
+Node::toMicroseconds(MillisecondsSince1970 start, MillisecondsSince1970 end)
+{
+  // The system clock may have been set back.
+  if (end <= start)
+    return 0;
+
+  return (uint64_t)((end - start) * 1000.0 + 0.5);
+}
+
+void
+Node::recordCallbackTime(MillisecondsSince1970 callbackStart)
+{
+  metrics_.callbackTimeMicroseconds_.recordValue
+    (toMicroseconds(callbackStart, ndn_getNowMilliseconds()));
 }
 
 }
@@ -33,11 +33,13 @@
 #include <ndn-cpp/forwarding-flags.hpp>
 #include <ndn-cpp/interest-filter.hpp>
 #include <ndn-cpp/face.hpp>
+#include <ndn-cpp/face-metrics.hpp>
 #include "util/command-interest-generator.hpp"
 #include "impl/delayed-call-table.hpp"
 #include "impl/interest-filter-table.hpp"
 #include "impl/pending-interest-table.hpp"
 #include "impl/registered-prefix-table.hpp"
+#include "impl/object-pool.hpp"
 #include "encoding/element-listener.hpp"
 
 struct ndn_Interest;
@@ -322,6 +324,16 @@ public:
   uint64_t
   getNextEntryId();
 
+  /**
+   * Get a snapshot of the counters and latency histograms, with the current
+   * sizes of the pending interest, interest filter and delayed call tables.
+   * This is not synchronized, so it must be called in the thread which
+   * processes events. See Face::getMetrics.
+   * @return A copy of the FaceMetrics.
+   */
+  FaceMetrics
+  getMetrics() const;
+
 private:
   enum ConnectStatus {
     ConnectStatus_UNCONNECTED = 1,
@@ -431,6 +443,24 @@ private:
   void
   processInterestTimeout(ptr_lib::shared_ptr<PendingInterestTable::Entry> pendingInterest);
 
+  /**
+   * Get the elapsed time between start and end in microseconds.
+   * @param start The start time in milliseconds since 1/1/1970.
+   * @param end The end time in milliseconds since 1/1/1970.
+   * @return The elapsed microseconds, or 0 if end is not after start.
+   */
+  static uint64_t
+  toMicroseconds(MillisecondsSince1970 start, MillisecondsSince1970 end);
+
+  /**
+   * Record the time from callbackStart until now in the callback time
+   * histogram of metrics_.
+   * @param callbackStart The time in milliseconds since 1/1/1970 before
+   * calling the application callback.
+   */
+  void
+  recordCallbackTime(MillisecondsSince1970 callbackStart);
+
   /**
    * Do the work of registerPrefix to register with NFD.
    * @param registeredPrefixId The getNextEntryId() which registerPrefix got so
@@ -460,6 +490,20 @@ private:
   void
   onConnected();
 
+  /**
+   * This is called by onReceivedElement when finished with a packet. Put the
+   * interest or data object back in its pool if the application did not keep
+   * it, and save the emptied pitEntries to reuse for the next packet.
+   * @param interest The decoded Interest, or null. This resets the pointer.
+   * @param data The decoded Data, or null. This resets the pointer.
+   * @param pitEntries The vector of pending interest table entries, which is
+   * cleared.
+   */
+  void
+  recycle
+    (ptr_lib::shared_ptr<Interest>& interest, ptr_lib::shared_ptr<Data>& data,
+     std::vector<ptr_lib::shared_ptr<PendingInterestTable::Entry> >& pitEntries);
+
   ptr_lib::shared_ptr<Transport> transport_;
   ptr_lib::shared_ptr<const Transport::ConnectionInfo> connectionInfo_;
   PendingInterestTable pendingInterestTable_;
@@ -471,6 +515,14 @@ private:
   Name timeoutPrefix_;
   ConnectStatus connectStatus_;
   Blob nonceTemplate_;
+  // The pools and buffers are reused by onReceivedElement for each packet.
+  ObjectPool<Interest> interestPool_;
+  ObjectPool<Data> dataPool_;
+  std::vector<ptr_lib::shared_ptr<PendingInterestTable::Entry> > pitEntriesBuffer_;
+  std::vector<ptr_lib::shared_ptr<InterestFilterTable::Entry> > matchedFiltersBuffer_;
+  // metrics_ is only updated in the thread which processes events (for
+  // ThreadsafeFace, the io_service thread), so it doesn't need a lock.
+  FaceMetrics metrics_;
 #ifdef NDN_CPP_HAVE_BOOST_ASIO
   // ThreadsafeFace accesses lastEntryId_ outside of a thread safe dispatch, so
   // use atomic_uint64_t to be thread safe.
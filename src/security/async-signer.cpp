@@ -0,0 +1,204 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2018 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+// Only compile if ndn-cpp-config.h defines NDN_CPP_HAVE_BOOST_ASIO.
+#include <ndn-cpp/ndn-cpp-config.h>
+#ifdef NDN_CPP_HAVE_BOOST_ASIO
+
+#include <boost/bind.hpp>
+#include <ndn-cpp/util/logging.hpp>
+#include <ndn-cpp/security/tpm/tpm-key-handle.hpp>
+#include <ndn-cpp/security/async-signer.hpp>
+
+using namespace std;
+
+INIT_LOGGER("ndn.AsyncSigner");
+
+namespace ndn {
+
+AsyncSigner::AsyncSigner
+  (KeyChain& keyChain, boost::asio::io_service& workerService,
+   boost::asio::io_service& resultService)
+: keyChain_(keyChain), workerService_(workerService),
+  resultService_(resultService)
+{
+  if (keyChain_.getIsSecurityV1())
+    throw KeyChain::Error("AsyncSigner is not supported for security v1");
+}
+
+void
+AsyncSigner::sign
+  (const ptr_lib::shared_ptr<Data>& data, const SigningInfo& params,
+   const OnDataSigned& onSigned, const OnDataSignError& onSignError,
+   WireFormat& wireFormat)
+{
+  Name keyName;
+  ptr_lib::shared_ptr<Signature> signatureInfo =
+    keyChain_.prepareSignatureInfo(params, keyName);
+  const TpmKeyHandle* keyHandle = keyChain_.findSigningKeyHandle(keyName);
+
+  data->setSignature(*signatureInfo);
+
+  // Encode once to get the signed portion.
+  SignedBlob encoding = data->wireEncode(wireFormat);
+
+  OnSignResult onSignResult = boost::bind
+    (&AsyncSigner::finishDataSign, data, &wireFormat, onSigned, _1);
+  if (keyHandle)
+    // Copy the signed portion since the Data encoding changes when signed.
+    sign
+      (*keyHandle, params.getDigestAlgorithm(),
+       Blob(encoding.signedBuf(), encoding.signedSize()), onSignResult,
+       boost::bind(&AsyncSigner::failDataSign, data, onSignError, _1));
+  else {
+    // A DigestSha256 doesn't need the TPM.
+    Blob signatureBytes = keyChain_.sign
+      (encoding.signedBuf(), encoding.signedSize(), keyName,
+       params.getDigestAlgorithm());
+    resultService_.post(boost::bind
+      (&AsyncSigner::deliverSignResult, onSignResult, signatureBytes));
+  }
+}
+
+void
+AsyncSigner::sign
+  (const Blob& data, const Name& keyName, DigestAlgorithm digestAlgorithm,
+   const OnSignResult& onSignResult, const OnSignError& onSignError)
+{
+  // Finding the key updates the cache of key handles, so do it in this thread.
+  const TpmKeyHandle* keyHandle;
+  try {
+    keyHandle = keyChain_.findSigningKeyHandle(keyName);
+  } catch (const KeyChain::Error& ex) {
+    resultService_.post(boost::bind
+      (&AsyncSigner::deliverSignError, onSignError, string(ex.what())));
+    return;
+  }
+
+  if (keyHandle)
+    sign(*keyHandle, digestAlgorithm, data, onSignResult, onSignError);
+  else
+    // A DigestSha256 doesn't need the TPM.
+    resultService_.post(boost::bind
+      (&AsyncSigner::deliverSignResult, onSignResult,
+       keyChain_.sign(data.buf(), data.size(), keyName, digestAlgorithm)));
+}
+
+void
+AsyncSigner::sign
+  (const TpmKeyHandle& keyHandle, DigestAlgorithm digestAlgorithm,
+   const Blob& data, const OnSignResult& onSignResult,
+   const OnSignError& onSignError)
+{
+  workerService_.post(boost::bind
+    (&AsyncSigner::signTask, &keyHandle, digestAlgorithm, data,
+     &resultService_, onSignResult, onSignError));
+}
+
+void
+AsyncSigner::signTask
+  (const TpmKeyHandle* keyHandle, DigestAlgorithm digestAlgorithm,
+   const Blob& data, boost::asio::io_service* resultService,
+   const OnSignResult& onSignResult, const OnSignError& onSignError)
+{
+  Blob signature;
+  string errorMessage;
+  // Give any error to onSignError. An exception thrown here would go to the
+  // thread running workerService instead of the application.
+  try {
+    signature = keyHandle->sign(digestAlgorithm, data.buf(), data.size());
+    if (signature.isNull())
+      errorMessage = "Unrecognized digest algorithm";
+  } catch (const std::exception& ex) {
+    errorMessage = ex.what();
+  }
+
+  if (signature.isNull())
+    resultService->post(boost::bind
+      (&AsyncSigner::deliverSignError, onSignError,
+       "Error signing with key " + keyHandle->getKeyName().toUri() + ": " +
+       errorMessage));
+  else
+    resultService->post(boost::bind
+      (&AsyncSigner::deliverSignResult, onSignResult, signature));
+}
+
+void
+AsyncSigner::finishDataSign
+  (const ptr_lib::shared_ptr<Data>& data, WireFormat* wireFormat,
+   const OnDataSigned& onSigned, const Blob& signature)
+{
+  data->getSignature()->setSignature(signature);
+  // Encode again to include the signature.
+  data->wireEncode(*wireFormat);
+
+  try {
+    onSigned(data);
+  } catch (const std::exception& ex) {
+    _LOG_ERROR("AsyncSigner: Error in onSigned: " << ex.what());
+  } catch (...) {
+    _LOG_ERROR("AsyncSigner: Error in onSigned.");
+  }
+}
+
+void
+AsyncSigner::failDataSign
+  (const ptr_lib::shared_ptr<Data>& data, const OnDataSignError& onSignError,
+   const string& errorMessage)
+{
+  try {
+    onSignError(data, errorMessage);
+  } catch (const std::exception& ex) {
+    _LOG_ERROR("AsyncSigner: Error in onSignError: " << ex.what());
+  } catch (...) {
+    _LOG_ERROR("AsyncSigner: Error in onSignError.");
+  }
+}
+
+void
+AsyncSigner::deliverSignResult
+  (const OnSignResult& onSignResult, const Blob& signature)
+{
+  try {
+    onSignResult(signature);
+  } catch (const std::exception& ex) {
+    _LOG_ERROR("AsyncSigner: Error in onSignResult: " << ex.what());
+  } catch (...) {
+    _LOG_ERROR("AsyncSigner: Error in onSignResult.");
+  }
+}
+
+void
+AsyncSigner::deliverSignError
+  (const OnSignError& onSignError, const string& errorMessage)
+{
+  try {
+    onSignError(errorMessage);
+  } catch (const std::exception& ex) {
+    _LOG_ERROR("AsyncSigner: Error in onSignError: " << ex.what());
+  } catch (...) {
+    _LOG_ERROR("AsyncSigner: Error in onSignError.");
+  }
+}
+
+}
+
+#endif // NDN_CPP_HAVE_BOOST_ASIO
@@ -0,0 +1,182 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2018 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+// Only compile if ndn-cpp-config.h defines NDN_CPP_HAVE_BOOST_ASIO.
+#include <ndn-cpp/ndn-cpp-config.h>
+#ifdef NDN_CPP_HAVE_BOOST_ASIO
+
+#include <boost/bind.hpp>
+#include <ndn-cpp/util/logging.hpp>
+#include <ndn-cpp/lite/util/crypto-lite.hpp>
+#include <ndn-cpp/security/tpm/tpm-key-handle.hpp>
+#include <ndn-cpp/security/batch-signer.hpp>
+#include "../util/parallel-tasks.hpp"
+
+using namespace std;
+
+INIT_LOGGER("ndn.BatchSigner");
+
+namespace ndn {
+
+/**
+ * A BatchSigner::Batch holds the packets of one call to sign and the shared
+ * key handle. Each task signs and encodes a different range of the packets, so
+ * no lock is needed.
+ */
+class BatchSigner::Batch {
+public:
+  Batch
+    (const vector<ptr_lib::shared_ptr<Data> >& dataList,
+     const TpmKeyHandle* keyHandle, DigestAlgorithm digestAlgorithm,
+     WireFormat& wireFormat, const OnSigned& onSigned,
+     const OnSignError& onSignError)
+  : dataList_(dataList), encodings_(dataList.size()),
+    errorMessages_(dataList.size()), keyHandle_(keyHandle),
+    digestAlgorithm_(digestAlgorithm), wireFormat_(wireFormat),
+    onSigned_(onSigned), onSignError_(onSignError)
+  {
+  }
+
+  vector<ptr_lib::shared_ptr<Data> > dataList_;
+  // The encoding of each packet with its SignatureInfo, to get the signed portion.
+  vector<SignedBlob> encodings_;
+  // The error message of each packet which the TPM failed to sign, else "".
+  vector<string> errorMessages_;
+  // If null, the signature is a DigestSha256.
+  const TpmKeyHandle* keyHandle_;
+  DigestAlgorithm digestAlgorithm_;
+  WireFormat& wireFormat_;
+  OnSigned onSigned_;
+  OnSignError onSignError_;
+};
+
+BatchSigner::BatchSigner
+  (KeyChain& keyChain, boost::asio::io_service& ioService, size_t maxTaskSize)
+: keyChain_(keyChain), ioService_(ioService),
+  maxTaskSize_(maxTaskSize > 0 ? maxTaskSize : 1)
+{
+}
+
+void
+BatchSigner::sign
+  (const vector<ptr_lib::shared_ptr<Data> >& dataList,
+   const SigningInfo& params, const OnSigned& onSigned,
+   const OnSignError& onSignError, WireFormat& wireFormat)
+{
+  Name keyName;
+  ptr_lib::shared_ptr<Signature> signatureInfo =
+    keyChain_.prepareSignatureInfo(params, keyName);
+  const TpmKeyHandle* keyHandle = keyChain_.findSigningKeyHandle(keyName);
+
+  ptr_lib::shared_ptr<Batch> batch(new Batch
+    (dataList, keyHandle, params.getDigestAlgorithm(), wireFormat, onSigned,
+     onSignError));
+
+  // Set the signature info and encode in this thread since the tasks must not
+  // share the Signature object.
+  for (size_t i = 0; i < dataList.size(); ++i) {
+    dataList[i]->setSignature(*signatureInfo);
+    batch->encodings_[i] = dataList[i]->wireEncode(wireFormat);
+  }
+
+  ParallelTasks::post
+    (ioService_, dataList.size(), maxTaskSize_,
+     boost::bind(&BatchSigner::signTask, batch, _1, _2),
+     boost::bind(&BatchSigner::finish, batch));
+}
+
+void
+BatchSigner::signTask
+  (const ptr_lib::shared_ptr<Batch>& batch, size_t begin, size_t end)
+{
+  for (size_t i = begin; i < end; ++i) {
+    const SignedBlob& encoding = batch->encodings_[i];
+
+    Blob signatureBytes;
+    if (batch->keyHandle_) {
+      // Catch the error for this packet so that the other packets are signed.
+      try {
+        signatureBytes = batch->keyHandle_->sign
+          (batch->digestAlgorithm_, encoding.signedBuf(), encoding.signedSize());
+        if (signatureBytes.isNull())
+          batch->errorMessages_[i] = "Unrecognized digest algorithm";
+      } catch (const std::exception& ex) {
+        batch->errorMessages_[i] = ex.what();
+      }
+
+      if (signatureBytes.isNull()) {
+        batch->errorMessages_[i] =
+          "Error signing " + batch->dataList_[i]->getName().toUri() + ": " +
+          batch->errorMessages_[i];
+        // Leave the packet unsigned.
+        continue;
+      }
+    }
+    else {
+      uint8_t digest[ndn_SHA256_DIGEST_SIZE];
+      CryptoLite::digestSha256
+        (encoding.signedBuf(), encoding.signedSize(), digest);
+      signatureBytes = Blob(digest, sizeof(digest));
+    }
+
+    Data& data = *batch->dataList_[i];
+    data.getSignature()->setSignature(signatureBytes);
+    // Encode again to include the signature.
+    data.wireEncode(batch->wireFormat_);
+  }
+}
+
+void
+BatchSigner::finish(const ptr_lib::shared_ptr<Batch>& batch)
+{
+  vector<ptr_lib::shared_ptr<Data> > failedDataList;
+  string errorMessage;
+  for (size_t i = 0; i < batch->dataList_.size(); ++i) {
+    if (batch->errorMessages_[i].size() > 0) {
+      if (failedDataList.size() == 0)
+        errorMessage = batch->errorMessages_[i];
+      failedDataList.push_back(batch->dataList_[i]);
+    }
+  }
+
+  if (failedDataList.size() > 0) {
+    try {
+      batch->onSignError_(failedDataList, errorMessage);
+    } catch (const std::exception& ex) {
+      _LOG_ERROR("BatchSigner: Error in onSignError: " << ex.what());
+    } catch (...) {
+      _LOG_ERROR("BatchSigner: Error in onSignError.");
+    }
+    return;
+  }
+
+  try {
+    batch->onSigned_(batch->dataList_);
+  } catch (const std::exception& ex) {
+    _LOG_ERROR("BatchSigner: Error in onSigned: " << ex.what());
+  } catch (...) {
+    _LOG_ERROR("BatchSigner: Error in onSigned.");
+  }
+}
+
+}
+
+#endif // NDN_CPP_HAVE_BOOST_ASIO
@@ -0,0 +1,177 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2018 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+// Only compile if ndn-cpp-config.h defines NDN_CPP_HAVE_BOOST_ASIO.
+#include <ndn-cpp/ndn-cpp-config.h>
+#ifdef NDN_CPP_HAVE_BOOST_ASIO
+
+#include <algorithm>
+#include <stdexcept>
+#include <boost/bind.hpp>
+#include <ndn-cpp/util/logging.hpp>
+#include <ndn-cpp/merkle-signature.hpp>
+#include <ndn-cpp/security/batch-verifier.hpp>
+#include "detail/decoded-public-key.hpp"
+#include "detail/merkle-tree.hpp"
+#include "../util/parallel-tasks.hpp"
+
+using namespace std;
+
+INIT_LOGGER("ndn.BatchVerifier");
+
+namespace ndn {
+
+/**
+ * A BatchVerifier::Batch holds the immutable inputs of one call to
+ * verifyDataSignatures and the results which are written by the tasks. Each
+ * task writes a different range of results_, so no lock is needed.
+ */
+class BatchVerifier::Batch {
+public:
+  Batch(size_t nPackets, const OnVerified& onVerified)
+  : encodings_(nPackets), signatures_(nPackets), keys_(nPackets, 0),
+    results_(nPackets, 0), onVerified_(onVerified)
+  {
+  }
+
+  /**
+   * Compare indexes by their key so that the packets for the same key are
+   * verified together.
+   */
+  struct KeyLess {
+    KeyLess(const Batch& batch) : batch_(batch) {}
+
+    bool
+    operator()(size_t x, size_t y) const
+    {
+      return batch_.keys_[x] < batch_.keys_[y];
+    }
+
+    const Batch& batch_;
+  };
+
+  // The signed portion of each packet, or the root hash for a MerkleSignature.
+  std::vector<SignedBlob> encodings_;
+  // The signature bits, or the root signature for a MerkleSignature.
+  std::vector<Blob> signatures_;
+  // The pointers are owned by decodedKeys_.
+  std::vector<const DecodedPublicKey*> keys_;
+  DecodedPublicKey::Map decodedKeys_;
+  // The indexes of the packets to verify, sorted by key.
+  std::vector<size_t> indexes_;
+  // Use uint8_t instead of bool since different threads write the results.
+  std::vector<uint8_t> results_;
+  OnVerified onVerified_;
+};
+
+BatchVerifier::BatchVerifier
+  (boost::asio::io_service& ioService, size_t maxTaskSize)
+: ioService_(ioService), maxTaskSize_(maxTaskSize > 0 ? maxTaskSize : 1)
+{
+}
+
+void
+BatchVerifier::verifyDataSignatures
+  (const vector<ptr_lib::shared_ptr<Data> >& dataList,
+   const vector<Blob>& publicKeyDerList, const OnVerified& onVerified,
+   WireFormat& wireFormat)
+{
+  if (publicKeyDerList.size() != dataList.size())
+    throw invalid_argument
+      ("BatchVerifier::verifyDataSignatures: publicKeyDerList must have the same size as dataList");
+
+  ptr_lib::shared_ptr<Batch> batch
+    (new Batch(dataList.size(), onVerified));
+
+  // Encode the packets and decode the keys in this thread since these modify
+  // cached values which are not thread safe.
+  for (size_t i = 0; i < dataList.size(); ++i) {
+    try {
+      if (dynamic_cast<const MerkleSignature*>(dataList[i]->getSignature())) {
+        // Compute the root from the authentication path, as in
+        // VerificationHelpers, and let the task verify the root signature.
+        Blob root, rootSignature;
+        if (!MerkleTree::computeDataRoot
+            (*dataList[i], wireFormat, root, rootSignature))
+          continue;
+        batch->encodings_[i] = SignedBlob(root, 0, root.size());
+        batch->signatures_[i] = rootSignature;
+      }
+      else {
+        batch->encodings_[i] = dataList[i]->wireEncode(wireFormat);
+        batch->signatures_[i] = dataList[i]->getSignature()->getSignature();
+      }
+    } catch (const std::exception& ex) {
+      _LOG_DEBUG("BatchVerifier: Error encoding Data packet: " << ex.what());
+      continue;
+    }
+
+    const DecodedPublicKey& key = DecodedPublicKey::get
+      (batch->decodedKeys_, publicKeyDerList[i]);
+    if (!key.isDecoded())
+      continue;
+
+    batch->keys_[i] = &key;
+    batch->indexes_.push_back(i);
+  }
+  stable_sort(batch->indexes_.begin(), batch->indexes_.end(),
+              Batch::KeyLess(*batch));
+
+  ParallelTasks::post
+    (ioService_, batch->indexes_.size(), maxTaskSize_,
+     boost::bind(&BatchVerifier::verifyTask, batch, _1, _2),
+     boost::bind(&BatchVerifier::finish, batch));
+}
+
+void
+BatchVerifier::verifyTask
+  (const ptr_lib::shared_ptr<Batch>& batch, size_t begin, size_t end)
+{
+  for (size_t i = begin; i < end; ++i) {
+    size_t index = batch->indexes_[i];
+    const SignedBlob& encoding = batch->encodings_[index];
+    const Blob& signature = batch->signatures_[index];
+
+    batch->results_[index] = batch->keys_[index]->verifyWithSha256
+      (encoding.signedBuf(), encoding.signedSize(), signature.buf(),
+       signature.size()) ? 1 : 0;
+  }
+}
+
+void
+BatchVerifier::finish(const ptr_lib::shared_ptr<Batch>& batch)
+{
+  vector<bool> results(batch->results_.size());
+  for (size_t i = 0; i < batch->results_.size(); ++i)
+    results[i] = (batch->results_[i] != 0);
+
+  try {
+    batch->onVerified_(results);
+  } catch (const std::exception& ex) {
+    _LOG_ERROR("BatchVerifier: Error in onVerified: " << ex.what());
+  } catch (...) {
+    _LOG_ERROR("BatchVerifier: Error in onVerified.");
+  }
+}
+
+}
+
+#endif // NDN_CPP_HAVE_BOOST_ASIO
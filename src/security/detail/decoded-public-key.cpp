@@ -0,0 +1,96 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2018 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+#include <algorithm>
+#include <string.h>
+#include <ndn-cpp/security/certificate/public-key.hpp>
+#include "decoded-public-key.hpp"
+
+using namespace std;
+
+namespace ndn {
+
+DecodedPublicKey::DecodedPublicKey(const Blob& publicKeyDer)
+: isDecoded_(false)
+{
+  try {
+    // The PublicKey constructor finds the key type.
+    keyType_ = PublicKey(publicKeyDer).getKeyType();
+  } catch (const std::exception&) {
+    // UnrecognizedKeyFormatException or a DER decoding error.
+    return;
+  }
+
+#if NDN_CPP_HAVE_LIBCRYPTO
+  if (keyType_ == KEY_TYPE_RSA)
+    isDecoded_ = (rsaPublicKey_.decode(publicKeyDer) == NDN_ERROR_success);
+  else if (keyType_ == KEY_TYPE_EC)
+    isDecoded_ = (ecPublicKey_.decode(publicKeyDer) == NDN_ERROR_success);
+#endif
+}
+
+bool
+DecodedPublicKey::verifyWithSha256
+  (const uint8_t* buffer, size_t bufferLength, const uint8_t* signature,
+   size_t signatureLength) const
+{
+  if (!isDecoded_)
+    return false;
+
+#if NDN_CPP_HAVE_LIBCRYPTO
+  if (keyType_ == KEY_TYPE_RSA)
+    return rsaPublicKey_.verifyWithSha256
+      (signature, signatureLength, buffer, bufferLength);
+  else if (keyType_ == KEY_TYPE_EC)
+    return ecPublicKey_.verifyWithSha256
+      (signature, signatureLength, buffer, bufferLength);
+#endif
+
+  return false;
+}
+
+bool
+DecodedPublicKey::BlobLess::operator()(const Blob& x, const Blob& y) const
+{
+  if (x.buf() == y.buf())
+    // The same buffer, which is the usual case for a batch.
+    return x.size() < y.size();
+
+  int result = memcmp(x.buf(), y.buf(), min(x.size(), y.size()));
+  if (result != 0)
+    return result < 0;
+  return x.size() < y.size();
+}
+
+const DecodedPublicKey&
+DecodedPublicKey::get(Map& keys, const Blob& publicKeyDer)
+{
+  Map::iterator found = keys.find(publicKeyDer);
+  if (found != keys.end())
+    return *found->second;
+
+  ptr_lib::shared_ptr<DecodedPublicKey> key
+    (new DecodedPublicKey(publicKeyDer));
+  keys[publicKeyDer] = key;
+  return *key;
+}
+
+}
@@ -0,0 +1,107 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2018 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+#ifndef NDN_DECODED_PUBLIC_KEY_HPP
+#define NDN_DECODED_PUBLIC_KEY_HPP
+
+#include <map>
+#include <ndn-cpp/util/signed-blob.hpp>
+#include <ndn-cpp/lite/security/ec-public-key-lite.hpp>
+#include <ndn-cpp/lite/security/rsa-public-key-lite.hpp>
+#include <ndn-cpp/security/security-common.hpp>
+
+namespace ndn {
+
+/**
+ * A DecodedPublicKey holds a public key which is decoded once from its DER
+ * encoding so that it can verify many signatures. (VerificationHelpers
+ * verifySignature decodes the DER for every call.) After construction, the
+ * object is not modified, so verifyWithSha256 can be called concurrently from
+ * multiple threads.
+ */
+class DecodedPublicKey {
+public:
+  /**
+   * Create a DecodedPublicKey by decoding the public key DER. If the key can't
+   * be decoded, then isDecoded() returns false.
+   * @param publicKeyDer The DER-encoded public key.
+   */
+  DecodedPublicKey(const Blob& publicKeyDer);
+
+  /**
+   * Check if the public key DER given to the constructor was decoded.
+   * @return True if the key was decoded.
+   */
+  bool
+  isDecoded() const { return isDecoded_; }
+
+  /**
+   * Verify the signature of the buffer using SHA-256 and the decoded key.
+   * @param buffer A pointer to the input buffer to verify.
+   * @param bufferLength The length of the buffer.
+   * @param signature A pointer to the signature bytes.
+   * @param signatureLength The length of the signature.
+   * @return True if verification succeeds, false if verification fails or the
+   * key was not decoded.
+   */
+  bool
+  verifyWithSha256
+    (const uint8_t* buffer, size_t bufferLength, const uint8_t* signature,
+     size_t signatureLength) const;
+
+  /**
+   * The BlobLess comparator orders Blob objects by their bytes so that the
+   * same DER-encoded key in different Blob buffers is decoded only once.
+   */
+  struct BlobLess {
+    bool
+    operator()(const Blob& x, const Blob& y) const;
+  };
+
+  typedef std::map<Blob, ptr_lib::shared_ptr<DecodedPublicKey>, BlobLess>
+    Map;
+
+  /**
+   * Get the DecodedPublicKey for the publicKeyDer from the keys map, decoding
+   * and adding it to the map if needed.
+   * @param keys The map of decoded keys.
+   * @param publicKeyDer The DER-encoded public key.
+   * @return The DecodedPublicKey, which may have isDecoded() false.
+   */
+  static const DecodedPublicKey&
+  get(Map& keys, const Blob& publicKeyDer);
+
+private:
+  // Disable the copy constructor and assignment operator.
+  DecodedPublicKey(const DecodedPublicKey& other);
+  DecodedPublicKey& operator=(const DecodedPublicKey& other);
+
+  KeyType keyType_;
+  bool isDecoded_;
+#if NDN_CPP_HAVE_LIBCRYPTO
+  RsaPublicKeyLite rsaPublicKey_;
+  EcPublicKeyLite ecPublicKey_;
+#endif
+};
+
+}
+
+#endif
@@ -0,0 +1,209 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2018 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+#include <stdexcept>
+#include <ndn-cpp/ndn-cpp-config.h>
+#if NDN_CPP_HAVE_LIBCRYPTO
+#include <openssl/ssl.h>
+#else
+#include "../../contrib/openssl/sha.h"
+#endif
+#include <ndn-cpp/merkle-signature.hpp>
+#include "../../c/encoding/tlv/tlv.h"
+#include "../../encoding/tlv-encoder.hpp"
+#include "../../encoding/tlv-decoder.hpp"
+#include "merkle-tree.hpp"
+
+using namespace std;
+
+namespace ndn {
+
+// The prefix bytes which separate the leaf hashes from the inner node hashes.
+static const uint8_t LEAF_PREFIX = 0x00;
+static const uint8_t NODE_PREFIX = 0x01;
+
+MerkleTree::MerkleTree(const vector<Blob>& leafHashes)
+{
+  if (leafHashes.size() == 0)
+    throw invalid_argument("MerkleTree: There must be at least one leaf");
+
+  levels_.push_back(leafHashes);
+  while (levels_.back().size() > 1) {
+    // Copy the level since push_back may reallocate levels_.
+    vector<Blob> level = levels_.back();
+    vector<Blob> nextLevel;
+    for (size_t i = 0; i < level.size(); i += 2) {
+      if (i + 1 < level.size())
+        nextLevel.push_back(computeNodeHash(level[i], level[i + 1]));
+      else
+        // Promote the odd node.
+        nextLevel.push_back(level[i]);
+    }
+
+    levels_.push_back(nextLevel);
+  }
+}
+
+void
+MerkleTree::getPath(size_t leafIndex, vector<Blob>& path) const
+{
+  path.clear();
+  size_t index = leafIndex;
+  for (size_t i = 0; i + 1 < levels_.size(); ++i) {
+    size_t siblingIndex = index ^ 1;
+    if (siblingIndex < levels_[i].size())
+      path.push_back(levels_[i][siblingIndex]);
+
+    index /= 2;
+  }
+}
+
+Blob
+MerkleTree::computeLeafHash
+  (const uint8_t* signedPortion, size_t signedPortionLength)
+{
+  SHA256_CTX sha256;
+  SHA256_Init(&sha256);
+  SHA256_Update(&sha256, &LEAF_PREFIX, 1);
+  SHA256_Update(&sha256, signedPortion, signedPortionLength);
+  uint8_t digest[ndn_SHA256_DIGEST_SIZE];
+  SHA256_Final(digest, &sha256);
+
+  return Blob(digest, sizeof(digest));
+}
+
+Blob
+MerkleTree::computeNodeHash(const Blob& left, const Blob& right)
+{
+  SHA256_CTX sha256;
+  SHA256_Init(&sha256);
+  SHA256_Update(&sha256, &NODE_PREFIX, 1);
+  SHA256_Update(&sha256, left.buf(), left.size());
+  SHA256_Update(&sha256, right.buf(), right.size());
+  uint8_t digest[ndn_SHA256_DIGEST_SIZE];
+  SHA256_Final(digest, &sha256);
+
+  return Blob(digest, sizeof(digest));
+}
+
+Blob
+MerkleTree::computeRootFromPath
+  (const Blob& leafHash, uint64_t leafIndex, uint64_t leafCount,
+   const vector<Blob>& path)
+{
+  if (leafIndex >= leafCount)
+    return Blob();
+
+  Blob hash = leafHash;
+  uint64_t index = leafIndex;
+  uint64_t levelSize = leafCount;
+  size_t iPath = 0;
+  while (levelSize > 1) {
+    if ((index ^ 1) < levelSize) {
+      if (iPath >= path.size())
+        return Blob();
+
+      if (index % 2 == 0)
+        hash = computeNodeHash(hash, path[iPath]);
+      else
+        hash = computeNodeHash(path[iPath], hash);
+      ++iPath;
+    }
+    // Otherwise, this is an odd node which is promoted.
+
+    index /= 2;
+    levelSize = (levelSize + 1) / 2;
+  }
+
+  if (iPath != path.size())
+    // There are extra hashes.
+    return Blob();
+
+  return hash;
+}
+
+/**
+ * Call encoder.writeBlobTlv with the bytes of the Blob.
+ * @param encoder The TlvEncoder.
+ * @param type The type of the TLV.
+ * @param value The TLV value.
+ */
+static void
+writeBlobTlv(TlvEncoder& encoder, unsigned int type, const Blob& value)
+{
+  struct ndn_Blob valueBlob;
+  ndn_Blob_initialize(&valueBlob, value.buf(), value.size());
+  encoder.writeBlobTlv(type, &valueBlob);
+}
+
+Blob
+MerkleTree::encodeSignatureValue
+  (uint64_t leafIndex, uint64_t leafCount, const Blob& rootSignature,
+   const vector<Blob>& path)
+{
+  TlvEncoder encoder
+    (32 + rootSignature.size() + path.size() * (ndn_SHA256_DIGEST_SIZE + 2));
+
+  encoder.writeNonNegativeIntegerTlv
+    (ndn_Tlv_MerkleSignature_LeafIndex, leafIndex);
+  encoder.writeNonNegativeIntegerTlv
+    (ndn_Tlv_MerkleSignature_LeafCount, leafCount);
+  writeBlobTlv(encoder, ndn_Tlv_MerkleSignature_RootSignature, rootSignature);
+  for (size_t i = 0; i < path.size(); ++i)
+    writeBlobTlv(encoder, ndn_Tlv_MerkleSignature_PathHash, path[i]);
+
+  return encoder.finish();
+}
+
+bool
+MerkleTree::computeDataRoot
+  (const Data& data, WireFormat& wireFormat, Blob& root, Blob& rootSignature)
+{
+  if (!dynamic_cast<const MerkleSignature*>(data.getSignature()))
+    return false;
+
+  try {
+    SignedBlob encoding = data.wireEncode(wireFormat);
+
+    const Blob& value = data.getSignature()->getSignature();
+    TlvDecoder decoder(value.buf(), value.size());
+    uint64_t leafIndex = decoder.readNonNegativeIntegerTlv
+      (ndn_Tlv_MerkleSignature_LeafIndex);
+    uint64_t leafCount = decoder.readNonNegativeIntegerTlv
+      (ndn_Tlv_MerkleSignature_LeafCount);
+    rootSignature = Blob(decoder.readBlobTlv
+      (ndn_Tlv_MerkleSignature_RootSignature));
+    vector<Blob> path;
+    while (decoder.peekType(ndn_Tlv_MerkleSignature_PathHash, value.size()))
+      path.push_back(Blob(decoder.readBlobTlv(ndn_Tlv_MerkleSignature_PathHash)));
+    if (decoder.offset != value.size())
+      return false;
+
+    root = computeRootFromPath
+      (computeLeafHash(encoding.signedBuf(), encoding.signedSize()), leafIndex,
+       leafCount, path);
+    return !root.isNull();
+  } catch (const std::exception&) {
+    return false;
+  }
+}
+
+}
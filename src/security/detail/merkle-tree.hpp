@@ -0,0 +1,132 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2018 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+#ifndef NDN_MERKLE_TREE_HPP
+#define NDN_MERKLE_TREE_HPP
+
+#include <vector>
+#include <ndn-cpp/data.hpp>
+
+namespace ndn {
+
+/**
+ * A MerkleTree is a binary tree of SHA-256 hashes over the signed portions of a
+ * batch of Data packets, used to make and check a MerkleSignature. A leaf is
+ * SHA-256(0x00 || signedPortion) and an inner node is
+ * SHA-256(0x01 || left || right), so that a leaf can't be mistaken for a node.
+ * If a level has an odd number of nodes, the last node is promoted unchanged to
+ * the next level.
+ */
+class MerkleTree {
+public:
+  /**
+   * Create a MerkleTree from the leaf hashes and compute all the levels up to
+   * the root.
+   * @param leafHashes The hash of each leaf from computeLeafHash. This must not
+   * be empty.
+   * @throws std::invalid_argument if leafHashes is empty.
+   */
+  MerkleTree(const std::vector<Blob>& leafHashes);
+
+  /**
+   * Get the root hash.
+   * @return The root hash.
+   */
+  const Blob&
+  getRoot() const { return levels_.back()[0]; }
+
+  /**
+   * Get the hashes on the path from the leaf to the root which are needed to
+   * recompute the root, starting at the leaf level.
+   * @param leafIndex The index of the leaf.
+   * @param path Set this to the path hashes.
+   */
+  void
+  getPath(size_t leafIndex, std::vector<Blob>& path) const;
+
+  /**
+   * Compute the leaf hash of the signed portion of a packet.
+   * @param signedPortion A pointer to the signed portion.
+   * @param signedPortionLength The length of the signed portion.
+   * @return The leaf hash.
+   */
+  static Blob
+  computeLeafHash(const uint8_t* signedPortion, size_t signedPortionLength);
+
+  /**
+   * Recompute the root hash from a leaf hash and its path as returned by
+   * getPath.
+   * @param leafHash The leaf hash.
+   * @param leafIndex The index of the leaf.
+   * @param leafCount The number of leaves in the tree.
+   * @param path The path hashes.
+   * @return The root hash, or an isNull() Blob if leafIndex is not less than
+   * leafCount or path does not have the number of hashes for the tree size.
+   */
+  static Blob
+  computeRootFromPath
+    (const Blob& leafHash, uint64_t leafIndex, uint64_t leafCount,
+     const std::vector<Blob>& path);
+
+  /**
+   * Encode the value of a MerkleSignature's signature bytes.
+   * @param leafIndex The index of the leaf.
+   * @param leafCount The number of leaves in the tree.
+   * @param rootSignature The signature of the root hash.
+   * @param path The path hashes from getPath.
+   * @return The encoding.
+   */
+  static Blob
+  encodeSignatureValue
+    (uint64_t leafIndex, uint64_t leafCount, const Blob& rootSignature,
+     const std::vector<Blob>& path);
+
+  /**
+   * Decode the signed portion of the Data packet and the value of its
+   * MerkleSignature's signature bytes, and recompute the root hash.
+   * @param data The Data packet with a MerkleSignature.
+   * @param wireFormat A WireFormat object used to encode the Data packet.
+   * @param root Set this to the root hash.
+   * @param rootSignature Set this to the signature of the root hash.
+   * @return True for success, or false if the signature is not a
+   * MerkleSignature or it can't be decoded.
+   */
+  static bool
+  computeDataRoot
+    (const Data& data, WireFormat& wireFormat, Blob& root, Blob& rootSignature);
+
+private:
+  /**
+   * Compute the hash of an inner node from its children.
+   * @param left The left child hash.
+   * @param right The right child hash.
+   * @return The node hash.
+   */
+  static Blob
+  computeNodeHash(const Blob& left, const Blob& right);
+
+  // levels_[0] is the leaf hashes. levels_.back() has only the root.
+  std::vector<std::vector<Blob> > levels_;
+};
+
+}
+
+#endif
@@ -27,6 +27,7 @@
 #include <fstream>
 #include <sstream>
 #include "../../encoding/base64.hpp"
+#include "../../util/file-status.hpp"
 #include <ndn-cpp/security/security-exception.hpp>
 #include <ndn-cpp/lite/util/crypto-lite.hpp>
 #include <ndn-cpp/security/tpm/tpm-private-key.hpp>
@@ -81,6 +82,9 @@ FilePrivateKeyStorage::generateKeyPair
   if (doesKeyExist(keyName, KEY_CLASS_PRIVATE))
     throw SecurityException("Private Key already exists");
 
+  privateKeyCache_.erase(keyName);
+  publicKeyCache_.erase(keyName);
+
   try {
     ptr_lib::shared_ptr<TpmPrivateKey> privateKey =
       TpmPrivateKey::generatePrivateKey(params);
@@ -111,6 +115,8 @@ FilePrivateKeyStorage::deleteKeyPair(const Name& keyName)
 {
   string keyUri = keyName.toUri();
 
+  privateKeyCache_.erase(keyName);
+  publicKeyCache_.erase(keyName);
   remove(nameTransform(keyUri, ".pub").c_str());
   remove(nameTransform(keyUri, ".pri").c_str());
 }
@@ -118,21 +124,24 @@ FilePrivateKeyStorage::deleteKeyPair(const Name& keyName)
 ptr_lib::shared_ptr<PublicKey>
 FilePrivateKeyStorage::getPublicKey(const Name& keyName)
 {
-  string keyURI = keyName.toUri();
-
-  if (!doesKeyExist(keyName, KEY_CLASS_PUBLIC))
+  CachedKeyFile* cached = getCachedKeyFile(publicKeyCache_, keyName, ".pub");
+  if (!cached)
     throw SecurityException("Public Key does not exist.");
 
-  ifstream file(nameTransform(keyURI, ".pub").c_str());
-  stringstream base64;
-  base64 << file.rdbuf();
+  if (!cached->publicKey_) {
+    ifstream file(cached->filePath_.c_str());
+    stringstream base64;
+    base64 << file.rdbuf();
 
-  // Use a vector in a shared_ptr so we can make it a Blob without copying.
-  ptr_lib::shared_ptr<vector<uint8_t> > der(new vector<uint8_t>());
-  fromBase64(base64.str(), *der);
+    // Use a vector in a shared_ptr so we can make it a Blob without copying.
+    ptr_lib::shared_ptr<vector<uint8_t> > der(new vector<uint8_t>());
+    fromBase64(base64.str(), *der);
 
-  Blob derBlob(der, false);
-  return ptr_lib::shared_ptr<PublicKey>(new PublicKey(derBlob));
+    Blob derBlob(der, false);
+    cached->publicKey_.reset(new PublicKey(derBlob));
+  }
+
+  return cached->publicKey_;
 }
 
 Blob
@@ -140,23 +149,26 @@ FilePrivateKeyStorage::sign
   (const uint8_t *data, size_t dataLength, const Name& keyName,
    DigestAlgorithm digestAlgorithm)
 {
-  string keyURI = keyName.toUri();
-
-  if (!doesKeyExist(keyName, KEY_CLASS_PRIVATE))
+  CachedKeyFile* cached = getCachedKeyFile(privateKeyCache_, keyName, ".pri");
+  if (!cached)
     throw SecurityException
       ("FilePrivateKeyStorage::sign: private key doesn't exist");
 
-  // Read the private key.
-  ifstream file(nameTransform(keyURI, ".pri").c_str());
-  stringstream base64;
-  base64 << file.rdbuf();
-  vector<uint8_t> pkcs8Der;
-  fromBase64(base64.str(), pkcs8Der);
-
-  TpmPrivateKey privateKey;
   try {
-    privateKey.loadPkcs8(&pkcs8Der.front(), pkcs8Der.size());
-    return privateKey.sign(data, dataLength, digestAlgorithm);
+    if (!cached->privateKey_) {
+      // Read the private key.
+      ifstream file(cached->filePath_.c_str());
+      stringstream base64;
+      base64 << file.rdbuf();
+      vector<uint8_t> pkcs8Der;
+      fromBase64(base64.str(), pkcs8Der);
+
+      ptr_lib::shared_ptr<TpmPrivateKey> privateKey(new TpmPrivateKey());
+      privateKey->loadPkcs8(&pkcs8Der.front(), pkcs8Der.size());
+      cached->privateKey_ = privateKey;
+    }
+
+    return cached->privateKey_->sign(data, dataLength, digestAlgorithm);
   } catch (TpmPrivateKey::Error& ex) {
     throw SecurityException(ex.what());
   }
@@ -202,6 +214,34 @@ FilePrivateKeyStorage::doesKeyExist(const Name& keyName, KeyClass keyClass)
   return file.good();
 }
 
+FilePrivateKeyStorage::CachedKeyFile*
+FilePrivateKeyStorage::getCachedKeyFile
+  (KeyFileCache& cache, const Name& keyName, const string& extension)
+{
+  KeyFileCache::iterator entry = cache.find(keyName);
+  // Reuse the file path to avoid the digest in nameTransform.
+  string filePath = (entry != cache.end() ? entry->second.filePath_ :
+    nameTransform(keyName.toUri(), extension));
+
+  FileStatus status;
+  if (!status.get(filePath)) {
+    if (entry != cache.end())
+      cache.erase(entry);
+    return 0;
+  }
+
+  if (entry != cache.end() && *entry->second.status_ == status)
+    return &entry->second;
+
+  // The entry is new or the file has changed.
+  CachedKeyFile& cached = cache[keyName];
+  cached.filePath_ = filePath;
+  cached.status_ = ptr_lib::make_shared<FileStatus>(status);
+  cached.privateKey_.reset();
+  cached.publicKey_.reset();
+  return &cached;
+}
+
 string
 FilePrivateKeyStorage::nameTransform
   (const string& keyName, const string& extension)
@@ -50,14 +50,15 @@ namespace ndn {
 IdentityManager::IdentityManager
   (const ptr_lib::shared_ptr<IdentityStorage>& identityStorage,
    const ptr_lib::shared_ptr<PrivateKeyStorage>& privateKeyStorage)
-: identityStorage_(identityStorage), privateKeyStorage_(privateKeyStorage)
+: identityStorage_(identityStorage), privateKeyStorage_(privateKeyStorage),
+  haveDefaultIdentity_(false)
 {
   // Don't call checkTpm() when using a custom PrivateKeyStorage.
 }
 
 IdentityManager::IdentityManager
   (const ptr_lib::shared_ptr<IdentityStorage>& identityStorage)
-: identityStorage_(identityStorage)
+: identityStorage_(identityStorage), haveDefaultIdentity_(false)
 {
   ConfigFile config;
   string canonicalTpmLocator;
@@ -67,6 +68,7 @@ IdentityManager::IdentityManager
 }
 
 IdentityManager::IdentityManager()
+: haveDefaultIdentity_(false)
 {
   ConfigFile config;
   identityStorage_ = getDefaultIdentityStorage(config);
@@ -154,6 +156,7 @@ Name
 IdentityManager::createIdentityAndCertificate
   (const Name& identityName, const KeyParams& params)
 {
+  clearDefaultCertificateNameCache();
   identityStorage_->addIdentity(identityName);
 
   Name keyName;
@@ -191,6 +194,7 @@ IdentityManager::createIdentityAndCertificate
 void
 IdentityManager::deleteIdentity(const Name& identityName)
 {
+  clearDefaultCertificateNameCache();
   try {
     if (identityStorage_->getDefaultIdentity() == identityName)
       // Don't delete the default identity!
@@ -214,6 +218,7 @@ Name
 IdentityManager::generateKeyPair
   (const Name& identityName, bool isKsk, const KeyParams& params)
 {
+  clearDefaultCertificateNameCache();
   Name keyName = identityStorage_->getNewKeyName(identityName, isKsk);
   privateKeyStorage_->generateKeyPair(keyName, params);
   ptr_lib::shared_ptr<PublicKey> pubKey = privateKeyStorage_->getPublicKey(keyName);
@@ -404,6 +409,7 @@ IdentityManager::prepareUnsignedIdentityCertificate
 void
 IdentityManager::addCertificateAsDefault(const IdentityCertificate& certificate)
 {
+  clearDefaultCertificateNameCache();
   identityStorage_->addCertificate(certificate);
 
   setDefaultCertificateForKey(certificate);
@@ -412,6 +418,7 @@ IdentityManager::addCertificateAsDefault(const IdentityCertificate& certificate)
 void
 IdentityManager::addCertificateAsIdentityDefault(const IdentityCertificate& certificate)
 {
+  clearDefaultCertificateNameCache();
   identityStorage_->addCertificate(certificate);
 
   Name keyName = certificate.getPublicKeyName();
@@ -424,6 +431,7 @@ IdentityManager::addCertificateAsIdentityDefault(const IdentityCertificate& cert
 void
 IdentityManager::setDefaultCertificateForKey(const IdentityCertificate& certificate)
 {
+  clearDefaultCertificateNameCache();
   Name keyName = certificate.getPublicKeyName();
 
   if(!identityStorage_->doesKeyExist(keyName))
@@ -574,6 +582,32 @@ IdentityManager::selfSign(const Name& keyName)
   return certificate;
 }
 
+Name
+IdentityManager::getDefaultIdentity()
+{
+  if (!haveDefaultIdentity_) {
+    // This throws SecurityException if there is no default identity.
+    defaultIdentity_ = identityStorage_->getDefaultIdentity();
+    haveDefaultIdentity_ = true;
+  }
+
+  return defaultIdentity_;
+}
+
+Name
+IdentityManager::getDefaultCertificateNameForIdentity(const Name& identityName)
+{
+  map<Name, Name>::iterator found = defaultCertificateNames_.find(identityName);
+  if (found != defaultCertificateNames_.end())
+    return found->second;
+
+  // This throws SecurityException if there is no default.
+  Name certificateName = identityStorage_->getDefaultCertificateNameForIdentity
+    (identityName);
+  defaultCertificateNames_[identityName] = certificateName;
+  return certificateName;
+}
+
 Name
 IdentityManager::getKeyNameFromCertificatePrefix(const Name & certificatePrefix)
 {
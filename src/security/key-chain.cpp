@@ -36,6 +36,7 @@
 #include <ndn-cpp/sha256-with-rsa-signature.hpp>
 #include <ndn-cpp/digest-sha256-signature.hpp>
 #include <ndn-cpp/hmac-with-sha256-signature.hpp>
+#include <ndn-cpp/merkle-signature.hpp>
 #if NDN_CPP_HAVE_UNISTD_H
 #include <unistd.h>
 #endif
@@ -45,7 +46,9 @@
 #include <ndn-cpp/security/tpm/tpm-back-end-osx.hpp>
 #include <ndn-cpp/security/tpm/tpm-back-end-file.hpp>
 #include <ndn-cpp/security/tpm/tpm-back-end-memory.hpp>
+#include <ndn-cpp/security/tpm/tpm-key-handle.hpp>
 #include "../util/config-file.hpp"
+#include "detail/merkle-tree.hpp"
 #include <ndn-cpp/security/key-chain.hpp>
 
 INIT_LOGGER("ndn.KeyChain");
@@ -352,6 +355,83 @@ KeyChain::sign
   data.wireEncode(wireFormat);
 }
 
+void
+KeyChain::sign
+  (const vector<ptr_lib::shared_ptr<Data> >& dataList,
+   const SigningInfo& params, WireFormat& wireFormat)
+{
+  Name keyName;
+  ptr_lib::shared_ptr<Signature> signatureInfo = prepareSignatureInfo
+    (params, keyName);
+  const TpmKeyHandle* keyHandle = findSigningKeyHandle(keyName);
+
+  for (size_t i = 0; i < dataList.size(); ++i) {
+    Data& data = *dataList[i];
+    data.setSignature(*signatureInfo);
+
+    // Encode once to get the signed portion.
+    SignedBlob encoding = data.wireEncode(wireFormat);
+
+    Blob signatureBytes;
+    if (keyHandle)
+      signatureBytes = keyHandle->sign
+        (params.getDigestAlgorithm(), encoding.signedBuf(),
+         encoding.signedSize());
+    else
+      signatureBytes = sign
+        (encoding.signedBuf(), encoding.signedSize(), keyName,
+         params.getDigestAlgorithm());
+    data.getSignature()->setSignature(signatureBytes);
+
+    // Encode again to include the signature.
+    data.wireEncode(wireFormat);
+  }
+}
+
+void
+KeyChain::signWithMerkleTree
+  (const vector<ptr_lib::shared_ptr<Data> >& dataList,
+   const SigningInfo& params, WireFormat& wireFormat)
+{
+  Name keyName;
+  ptr_lib::shared_ptr<Signature> keySignatureInfo = prepareSignatureInfo
+    (params, keyName);
+  if (keyName == SigningInfo::getDigestSha256Identity())
+    throw InvalidSigningInfoError
+      ("signWithMerkleTree: The signing parameters must specify a key");
+  if (dataList.size() == 0)
+    return;
+
+  MerkleSignature signatureInfo;
+  signatureInfo.setKeyLocator(KeyLocator::getFromSignature(keySignatureInfo.get()));
+  signatureInfo.setValidityPeriod
+    (ValidityPeriod::getFromSignature(keySignatureInfo.get()));
+
+  vector<Blob> leafHashes(dataList.size());
+  for (size_t i = 0; i < dataList.size(); ++i) {
+    dataList[i]->setSignature(signatureInfo);
+    // Encode once to get the signed portion.
+    SignedBlob encoding = dataList[i]->wireEncode(wireFormat);
+    leafHashes[i] = MerkleTree::computeLeafHash
+      (encoding.signedBuf(), encoding.signedSize());
+  }
+
+  MerkleTree tree(leafHashes);
+  Blob rootSignature = sign
+    (tree.getRoot().buf(), tree.getRoot().size(), keyName,
+     params.getDigestAlgorithm());
+
+  vector<Blob> path;
+  for (size_t i = 0; i < dataList.size(); ++i) {
+    tree.getPath(i, path);
+    dataList[i]->getSignature()->setSignature(MerkleTree::encodeSignatureValue
+      (i, dataList.size(), rootSignature, path));
+
+    // Encode again to include the signature.
+    dataList[i]->wireEncode(wireFormat);
+  }
+}
+
 void
 KeyChain::sign
   (Interest& interest, const SigningInfo& params, WireFormat& wireFormat)
@@ -1005,6 +1085,18 @@ KeyChain::sign
   return tpm_->sign(buffer, bufferLength, keyName, digestAlgorithm);
 }
 
+const TpmKeyHandle*
+KeyChain::findSigningKeyHandle(const Name& keyName) const
+{
+  if (keyName == SigningInfo::getDigestSha256Identity())
+    return 0;
+
+  const TpmKeyHandle* keyHandle = tpm_->findKey(keyName);
+  if (!keyHandle)
+    throw Error("The signing key " + keyName.toUri() + " does not exist in the TPM");
+  return keyHandle;
+}
+
 const SigningInfo&
 KeyChain::getDefaultSigningInfo()
 {
@@ -1095,14 +1187,15 @@ KeyChain::onCertificateInterestTimeoutForVerifyInterest
 Name
 KeyChain::prepareDefaultCertificateName()
 {
-  ptr_lib::shared_ptr<IdentityCertificate> signingCertificate =
-    identityManager_->getDefaultCertificate();
-  if (!signingCertificate) {
-    setDefaultCertificate();
-    signingCertificate = identityManager_->getDefaultCertificate();
+  // Use the cached name so that signing doesn't fetch the certificate.
+  try {
+    return identityManager_->getDefaultCertificateName();
+  } catch (SecurityException&) {
+    // The default is not defined.
   }
 
-  return signingCertificate->getName();
+  setDefaultCertificate();
+  return identityManager_->getDefaultCertificateName();
 }
 
 void
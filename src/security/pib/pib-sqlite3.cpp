@@ -217,6 +217,11 @@ PibSqlite3::PibSqlite3
 
   // Enable foreign keys.
   sqlite3_exec(database_, "PRAGMA foreign_keys=ON", NULL, NULL, NULL);
+  // Use write-ahead logging so that a commit appends to the log instead of
+  // syncing a rollback journal and the database file, and so that readers
+  // don't block the writer.
+  sqlite3_exec(database_, "PRAGMA journal_mode=WAL", NULL, NULL, NULL);
+  sqlite3_exec(database_, "PRAGMA synchronous=NORMAL", NULL, NULL, NULL);
 
   // Initialize the PIB tables.
   char* errorMessage = 0;
@@ -226,10 +231,14 @@ PibSqlite3::PibSqlite3
     sqlite3_free(errorMessage);
     throw PibImpl::Error("PIB database cannot be initialized");
   }
+
+  statementCache_.reset(new Sqlite3StatementCache(database_));
 }
 
 PibSqlite3::~PibSqlite3()
 {
+  // Finalize the cached statements before closing.
+  statementCache_.reset();
   sqlite3_close(database_);
 }
 
@@ -239,14 +248,14 @@ PibSqlite3::getScheme() { return NDN_PIB_SQLITE3_SCHEME; }
 void
 PibSqlite3::setTpmLocator(const string& tpmLocator)
 {
-  Sqlite3Statement statement(database_, "UPDATE tpmInfo SET tpm_locator=?");
+  Sqlite3Statement statement(*statementCache_, "UPDATE tpmInfo SET tpm_locator=?");
   statement.bind(1, tpmLocator);
   statement.step();
 
   if (sqlite3_changes(database_) == 0) {
     // No row was updated, so tpmLocator does not exist. Insert it directly.
     Sqlite3Statement insertStatement
-      (database_, "INSERT INTO tpmInfo (tpm_locator) values (?)");
+      (*statementCache_, "INSERT INTO tpmInfo (tpm_locator) values (?)");
     insertStatement.bind(1, tpmLocator);
     insertStatement.step();
   }
@@ -255,7 +264,7 @@ PibSqlite3::setTpmLocator(const string& tpmLocator)
 string
 PibSqlite3::getTpmLocator() const
 {
-  Sqlite3Statement statement(database_, "SELECT tpm_locator FROM tpmInfo");
+  Sqlite3Statement statement(*statementCache_, "SELECT tpm_locator FROM tpmInfo");
   int res = statement.step();
   if (res == SQLITE_ROW)
     return statement.getString(0);
@@ -267,7 +276,7 @@ bool
 PibSqlite3::hasIdentity(const Name& identityName) const
 {
   Sqlite3Statement statement
-    (database_, "SELECT id FROM identities WHERE identity=?");
+    (*statementCache_, "SELECT id FROM identities WHERE identity=?");
   statement.bind(1, identityName.wireEncode());
   return (statement.step() == SQLITE_ROW);
 }
@@ -277,7 +286,7 @@ PibSqlite3::addIdentity(const Name& identityName)
 {
   if (!hasIdentity(identityName)) {
     Sqlite3Statement statement
-      (database_, "INSERT INTO identities (identity) values (?)");
+      (*statementCache_, "INSERT INTO identities (identity) values (?)");
     statement.bind(1, identityName.wireEncode());
     statement.step();
   }
@@ -289,7 +298,7 @@ PibSqlite3::addIdentity(const Name& identityName)
 void
 PibSqlite3::removeIdentity(const Name& identityName)
 {
-  Sqlite3Statement statement(database_, "DELETE FROM identities WHERE identity=?");
+  Sqlite3Statement statement(*statementCache_, "DELETE FROM identities WHERE identity=?");
   statement.bind(1, identityName.wireEncode());
   statement.step();
 }
@@ -297,7 +306,7 @@ PibSqlite3::removeIdentity(const Name& identityName)
 void
 PibSqlite3::clearIdentities()
 {
-  Sqlite3Statement statement(database_, "DELETE FROM identities");
+  Sqlite3Statement statement(*statementCache_, "DELETE FROM identities");
   statement.step();
 }
 
@@ -305,7 +314,7 @@ set<Name>
 PibSqlite3::getIdentities() const
 {
   set<Name> identities;
-  Sqlite3Statement statement(database_, "SELECT identity FROM identities");
+  Sqlite3Statement statement(*statementCache_, "SELECT identity FROM identities");
 
   while (statement.step() == SQLITE_ROW) {
     Name name;
@@ -321,13 +330,13 @@ PibSqlite3::setDefaultIdentity(const Name& identityName)
 {
   if (!hasIdentity(identityName)) {
     Sqlite3Statement statement
-      (database_, "INSERT INTO identities (identity) values (?)");
+      (*statementCache_, "INSERT INTO identities (identity) values (?)");
     statement.bind(1, identityName.wireEncode());
     statement.step();
   }
 
   Sqlite3Statement statement
-    (database_, "UPDATE identities SET is_default=1 WHERE identity=?");
+    (*statementCache_, "UPDATE identities SET is_default=1 WHERE identity=?");
   statement.bind(1, identityName.wireEncode());
   statement.step();
 }
@@ -336,7 +345,7 @@ Name
 PibSqlite3::getDefaultIdentity() const
 {
   Sqlite3Statement statement
-    (database_, "SELECT identity FROM identities WHERE is_default=1");
+    (*statementCache_, "SELECT identity FROM identities WHERE is_default=1");
 
   if (statement.step() == SQLITE_ROW) {
     Name name;
@@ -350,7 +359,7 @@ PibSqlite3::getDefaultIdentity() const
 bool
 PibSqlite3::hasKey(const Name& keyName) const
 {
-  Sqlite3Statement statement(database_, "SELECT id FROM keys WHERE key_name=?");
+  Sqlite3Statement statement(*statementCache_, "SELECT id FROM keys WHERE key_name=?");
   statement.bind(1, keyName.wireEncode());
 
   return (statement.step() == SQLITE_ROW);
@@ -365,7 +374,7 @@ PibSqlite3::addKey
   addIdentity(identityName);
 
   if (!hasKey(keyName)) {
-    Sqlite3Statement statement(database_,
+    Sqlite3Statement statement(*statementCache_,
 "INSERT INTO keys (identity_id, key_name, key_bits) \
 VALUES ((SELECT id FROM identities WHERE identity=?), ?, ?)");
     statement.bind(1, identityName.wireEncode());
@@ -375,7 +384,7 @@ VALUES ((SELECT id FROM identities WHERE identity=?), ?, ?)");
   }
   else {
     Sqlite3Statement statement
-      (database_, "UPDATE keys SET key_bits=? WHERE key_name=?");
+      (*statementCache_, "UPDATE keys SET key_bits=? WHERE key_name=?");
     statement.bind(1, key, keyLength, SQLITE_STATIC);
     statement.bind(2, keyName.wireEncode());
     statement.step();
@@ -388,7 +397,7 @@ VALUES ((SELECT id FROM identities WHERE identity=?), ?, ?)");
 void
 PibSqlite3::removeKey(const Name& keyName)
 {
-  Sqlite3Statement statement(database_, "DELETE FROM keys WHERE key_name=?");
+  Sqlite3Statement statement(*statementCache_, "DELETE FROM keys WHERE key_name=?");
   statement.bind(1, keyName.wireEncode());
   statement.step();
 }
@@ -397,7 +406,7 @@ Blob
 PibSqlite3::getKeyBits(const Name& keyName) const
 {
   Sqlite3Statement statement
-    (database_, "SELECT key_bits FROM keys WHERE key_name=?");
+    (*statementCache_, "SELECT key_bits FROM keys WHERE key_name=?");
   statement.bind(1, keyName.wireEncode());
 
   if (statement.step() == SQLITE_ROW)
@@ -411,7 +420,7 @@ PibSqlite3::getKeysOfIdentity(const Name& identityName) const
 {
   set<Name> keyNames;
 
-  Sqlite3Statement statement(database_,
+  Sqlite3Statement statement(*statementCache_,
 "SELECT key_name \
 FROM keys JOIN identities ON keys.identity_id=identities.id \
 WHERE identities.identity=?");
@@ -434,7 +443,7 @@ PibSqlite3::setDefaultKeyOfIdentity
     throw Pib::Error("Key `" + keyName.toUri() + "` does not exist");
 
   Sqlite3Statement statement
-    (database_, "UPDATE keys SET is_default=1 WHERE key_name=?");
+    (*statementCache_, "UPDATE keys SET is_default=1 WHERE key_name=?");
   statement.bind(1, keyName.wireEncode());
   statement.step();
 }
@@ -445,7 +454,7 @@ PibSqlite3::getDefaultKeyOfIdentity(const Name& identityName) const
   if (!hasIdentity(identityName))
     throw Pib::Error("Identity `" + identityName.toUri() + "` does not exist");
 
-  Sqlite3Statement statement(database_,
+  Sqlite3Statement statement(*statementCache_,
 "SELECT key_name \
 FROM keys JOIN identities ON keys.identity_id=identities.id \
 WHERE identities.identity=? AND keys.is_default=1");
@@ -464,7 +473,7 @@ bool
 PibSqlite3::hasCertificate(const Name& certificateName) const
 {
   Sqlite3Statement statement
-    (database_, "SELECT id FROM certificates WHERE certificate_name=?");
+    (*statementCache_, "SELECT id FROM certificates WHERE certificate_name=?");
   statement.bind(1, certificateName.wireEncode());
   return (statement.step() == SQLITE_ROW);
 }
@@ -479,7 +488,7 @@ PibSqlite3::addCertificate(const CertificateV2& certificate)
      content.buf(), content.size());
 
   if (!hasCertificate(certificate.getName())) {
-    Sqlite3Statement statement(database_,
+    Sqlite3Statement statement(*statementCache_,
 "INSERT INTO certificates \
 (key_id, certificate_name, certificate_data) \
 VALUES ((SELECT id FROM keys WHERE key_name=?), ?, ?)");
@@ -491,7 +500,7 @@ VALUES ((SELECT id FROM keys WHERE key_name=?), ?, ?)");
   }
   else {
     Sqlite3Statement statement
-      (database_,
+      (*statementCache_,
        "UPDATE certificates SET certificate_data=? WHERE certificate_name=?");
     statement.bind(1, certificate.wireEncode(), true);
     statement.bind(2, certificate.getName().wireEncode());
@@ -506,7 +515,7 @@ void
 PibSqlite3::removeCertificate(const Name& certificateName)
 {
   Sqlite3Statement statement
-    (database_, "DELETE FROM certificates WHERE certificate_name=?");
+    (*statementCache_, "DELETE FROM certificates WHERE certificate_name=?");
   statement.bind(1, certificateName.wireEncode());
   statement.step();
 }
@@ -515,7 +524,7 @@ ptr_lib::shared_ptr<CertificateV2>
 PibSqlite3::getCertificate(const Name& certificateName) const
 {
   Sqlite3Statement statement
-    (database_,
+    (*statementCache_,
      "SELECT certificate_data FROM certificates WHERE certificate_name=?");
   statement.bind(1, certificateName.wireEncode());
 
@@ -533,7 +542,7 @@ PibSqlite3::getCertificatesOfKey(const Name& keyName) const
 {
   set<Name> certNames;
 
-  Sqlite3Statement statement(database_,
+  Sqlite3Statement statement(*statementCache_,
 "SELECT certificate_name \
 FROM certificates JOIN keys ON certificates.key_id=keys.id \
 WHERE keys.key_name=?");
@@ -556,7 +565,7 @@ PibSqlite3::setDefaultCertificateOfKey
     throw Pib::Error("Certificate `" + certificateName.toUri() + "` does not exist");
 
   Sqlite3Statement statement
-    (database_, "UPDATE certificates SET is_default=1 WHERE certificate_name=?");
+    (*statementCache_, "UPDATE certificates SET is_default=1 WHERE certificate_name=?");
   statement.bind(1, certificateName.wireEncode());
   statement.step();
 }
@@ -564,7 +573,7 @@ PibSqlite3::setDefaultCertificateOfKey
 ptr_lib::shared_ptr<CertificateV2>
 PibSqlite3::getDefaultCertificateOfKey(const Name& keyName) const
 {
-  Sqlite3Statement statement(database_,
+  Sqlite3Statement statement(*statementCache_,
 "SELECT certificate_data \
 FROM certificates JOIN keys ON certificates.key_id=keys.id \
 WHERE certificates.is_default=1 AND keys.key_name=?");
@@ -579,6 +588,30 @@ WHERE certificates.is_default=1 AND keys.key_name=?");
     throw Pib::Error("No default certificate for key `" + keyName.toUri() + "`");
 }
 
+void
+PibSqlite3::beginTransaction()
+{
+  if (statementCache_->beginTransaction() != SQLITE_OK)
+    throw PibImpl::Error
+      (string("PibSqlite3::beginTransaction: ") + sqlite3_errmsg(database_));
+}
+
+void
+PibSqlite3::commitTransaction()
+{
+  if (statementCache_->commitTransaction() != SQLITE_OK)
+    throw PibImpl::Error
+      (string("PibSqlite3::commitTransaction: ") + sqlite3_errmsg(database_));
+}
+
+void
+PibSqlite3::rollbackTransaction()
+{
+  if (statementCache_->rollbackTransaction() != SQLITE_OK)
+    throw PibImpl::Error
+      (string("PibSqlite3::rollbackTransaction: ") + sqlite3_errmsg(database_));
+}
+
 string
 PibSqlite3::getDefaultDatabaseDirectoryPath()
 {
@@ -601,14 +634,14 @@ bool
 PibSqlite3::hasDefaultIdentity() const
 {
   Sqlite3Statement statement
-    (database_, "SELECT identity FROM identities WHERE is_default=1");
+    (*statementCache_, "SELECT identity FROM identities WHERE is_default=1");
   return (statement.step() == SQLITE_ROW);
 }
 
 bool
 PibSqlite3::hasDefaultKeyOfIdentity(const Name& identityName) const
 {
-  Sqlite3Statement statement(database_,
+  Sqlite3Statement statement(*statementCache_,
 "SELECT key_name \
 FROM keys JOIN identities ON keys.identity_id=identities.id \
 WHERE identities.identity=? AND keys.is_default=1");
@@ -621,7 +654,7 @@ WHERE identities.identity=? AND keys.is_default=1");
 bool
 PibSqlite3::hasDefaultCertificateOfKey(const Name& keyName) const
 {
-  Sqlite3Statement statement(database_,
+  Sqlite3Statement statement(*statementCache_,
 "SELECT certificate_data \
 FROM certificates JOIN keys ON certificates.key_id=keys.id \
 WHERE certificates.is_default=1 AND keys.key_name=?");
@@ -31,9 +31,10 @@ INIT_LOGGER("ndn.CertificateCacheV2");
 
 namespace ndn {
 
-CertificateCacheV2::CertificateCacheV2(Milliseconds maxLifetimeMilliseconds)
+CertificateCacheV2::CertificateCacheV2
+  (Milliseconds maxLifetimeMilliseconds, size_t capacity)
 : maxLifetimeMilliseconds_(maxLifetimeMilliseconds),
-  nextRefreshTime_(DBL_MAX),
+  capacity_(capacity),
   nowOffsetMilliseconds_(0)
 {
 }
@@ -50,35 +51,61 @@ CertificateCacheV2::insert(const CertificateV2& certificate)
       ": already expired at " << Schedule::toIsoString(notAfterTime));
     return;
   }
+  if (capacity_ == 0)
+    return;
 
   MillisecondsSince1970 removalTime =
     min(notAfterTime, now + maxLifetimeMilliseconds_);
-  if (removalTime < nextRefreshTime_)
-    // We need to run refresh() sooner.)
-    nextRefreshTime_ = removalTime;
 
   Milliseconds removalHours = (removalTime - now) / (3600 * 1000.0);
   _LOG_DEBUG("Adding " << certificate.getName().toUri() << ", will remove in "
     << removalHours << " hours");
   ptr_lib::shared_ptr<CertificateV2> certificateCopy(new CertificateV2(certificate));
-  certificatesByName_[certificateCopy->getName()] =
-    Entry(certificateCopy, removalTime);
+  const Name& certificateName = certificateCopy->getName();
+
+  EntryMap::iterator entry = certificatesByName_.find(certificateName);
+  if (entry != certificatesByName_.end())
+    erase(entry);
+
+  while (certificatesByName_.size() >= capacity_)
+    // Remove the least recently used.
+    erase(certificatesByName_.find(lruList_.back()));
+
+  lruList_.push_front(certificateName);
+  Entry& newEntry = certificatesByName_[certificateName];
+  newEntry.certificate_ = certificateCopy;
+  // getFullName() computes the digest of the encoding.
+  newEntry.implicitDigest_ = certificateCopy->getFullName()->get(-1);
+  newEntry.removalPosition_ = certificatesByRemovalTime_.insert
+    (make_pair(removalTime, certificateName));
+  newEntry.lruPosition_ = lruList_.begin();
 }
 
 ptr_lib::shared_ptr<CertificateV2>
 CertificateCacheV2::find(const Name& certificatePrefix) const
 {
-  if (certificatePrefix.size() > 0 &&
-      certificatePrefix[-1].isImplicitSha256Digest())
-    _LOG_DEBUG("Certificate search using a name with an implicit digest is not yet supported");
-
   const_cast<CertificateCacheV2*>(this)->refresh();
 
-  map<Name, Entry>::const_iterator itr =
+  if (certificatePrefix.size() > 0 &&
+      certificatePrefix[-1].isImplicitSha256Digest()) {
+    // The certificate name is the full name without the digest.
+    EntryMap::const_iterator entry =
+      certificatesByName_.find(certificatePrefix.getPrefix(-1));
+    if (entry == certificatesByName_.end() ||
+        !entry->second.implicitDigest_.equals(certificatePrefix[-1]))
+      return ptr_lib::shared_ptr<CertificateV2>();
+
+    touch(entry->second);
+    return entry->second.certificate_;
+  }
+
+  EntryMap::const_iterator itr =
     certificatesByName_.lower_bound(certificatePrefix);
   if (itr == certificatesByName_.end() ||
       !certificatePrefix.isPrefixOf(itr->second.certificate_->getName()))
     return ptr_lib::shared_ptr<CertificateV2>();
+
+  touch(itr->second);
   return itr->second.certificate_;
 }
 
@@ -88,19 +115,30 @@ CertificateCacheV2::find(const Interest& interest) const
   if (interest.getChildSelector() >= 0)
     _LOG_DEBUG("Certificate search using a ChildSelector is not supported. Searching as if this selector not specified");
 
-  if (interest.getName().size() > 0 &&
-      interest.getName()[-1].isImplicitSha256Digest())
-    _LOG_DEBUG("Certificate search using a name with an implicit digest is not yet supported");
-
   const_cast<CertificateCacheV2*>(this)->refresh();
 
-  for (map<Name, Entry>::const_iterator i =
-         certificatesByName_.lower_bound(interest.getName());
+  const Name& interestName = interest.getName();
+  if (interestName.size() > 0 && interestName[-1].isImplicitSha256Digest()) {
+    // Only the certificate with the full name can match.
+    EntryMap::const_iterator entry =
+      certificatesByName_.find(interestName.getPrefix(-1));
+    if (entry == certificatesByName_.end() ||
+        !entry->second.implicitDigest_.equals(interestName[-1]) ||
+        !interest.matchesData(*entry->second.certificate_))
+      return ptr_lib::shared_ptr<CertificateV2>();
+
+    touch(entry->second);
+    return entry->second.certificate_;
+  }
+
+  for (EntryMap::const_iterator i = certificatesByName_.lower_bound(interestName);
        i != certificatesByName_.end() &&
-         interest.getName().isPrefixOf(i->second.certificate_->getName());
+         interestName.isPrefixOf(i->second.certificate_->getName());
        ++i) {
-    if (interest.matchesData(*i->second.certificate_))
+    if (interest.matchesData(*i->second.certificate_)) {
+      touch(i->second);
       return i->second.certificate_;
+    }
   }
 
   return ptr_lib::shared_ptr<CertificateV2>();
@@ -109,9 +147,17 @@ CertificateCacheV2::find(const Interest& interest) const
 void
 CertificateCacheV2::deleteCertificate(const Name& certificateName)
 {
-  certificatesByName_.erase(certificateName);
-  // This may be the certificate to be removed at nextRefreshTime_ by refresh(),
-  // but just allow refresh() to run instead of update nextRefreshTime_ now.
+  EntryMap::iterator entry = certificatesByName_.find(certificateName);
+  if (entry != certificatesByName_.end())
+    erase(entry);
+}
+
+void
+CertificateCacheV2::setCapacity(size_t capacity)
+{
+  capacity_ = capacity;
+  while (certificatesByName_.size() > capacity_)
+    erase(certificatesByName_.find(lruList_.back()));
 }
 
 void
@@ -119,25 +165,20 @@ CertificateCacheV2::refresh()
 {
   // nowOffsetMilliseconds_ is only used for testing.
   MillisecondsSince1970 now = ndn_getNowMilliseconds() + nowOffsetMilliseconds_;
-  if (now < nextRefreshTime_)
-    return;
 
-  // We recompute nextRefreshTime_.
-  MillisecondsSince1970 nextRefreshTime = DBL_MAX;
-  // Keep a separate list of entries to erase since we can't erase while iterating.
-  vector<Name> namesToErase;
-  for (map<Name, Entry>::const_iterator i = certificatesByName_.begin();
-       i != certificatesByName_.end(); ++i) {
-    if (i->second.removalTime_ <= now)
-      namesToErase.push_back(i->first);
-    else
-      nextRefreshTime = min(nextRefreshTime, i->second.removalTime_);
-  }
+  // The index is ordered by removal time, so stop at the first entry which is
+  // not expired.
+  while (!certificatesByRemovalTime_.empty() &&
+         certificatesByRemovalTime_.begin()->first <= now)
+    erase(certificatesByName_.find(certificatesByRemovalTime_.begin()->second));
+}
 
-  nextRefreshTime_ = nextRefreshTime;
-  // Now actually erase.
-  for (int i = 0; i < namesToErase.size(); ++i)
-    certificatesByName_.erase(namesToErase[i]);
+void
+CertificateCacheV2::erase(EntryMap::iterator entry)
+{
+  certificatesByRemovalTime_.erase(entry->second.removalPosition_);
+  lruList_.erase(entry->second.lruPosition_);
+  certificatesByName_.erase(entry);
 }
 
 }
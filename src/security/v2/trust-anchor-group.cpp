@@ -22,11 +22,17 @@
 
 #include <dirent.h>
 #include <sys/types.h>
-#include <sys/stat.h>
 #include <fstream>
 #include <sstream>
+#include <ndn-cpp/ndn-cpp-config.h>
+#if NDN_CPP_HAVE_INOTIFY
+#include <errno.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+#endif
 #include <ndn-cpp/util/logging.hpp>
 #include "../../encoding/base64.hpp"
+#include "../../util/file-status.hpp"
 #include <ndn-cpp/security/v2/trust-anchor-group.hpp>
 
 INIT_LOGGER("ndn.TrustAnchorGroup");
@@ -98,16 +104,36 @@ DynamicTrustAnchorGroup::DynamicTrustAnchorGroup
   isDirectory_(isDirectory),
   path_(path),
   refreshPeriod_(refreshPeriod),
-  expireTime_(0)
+  expireTime_(0),
+  watchFd_(-1)
 {
   if (refreshPeriod <= 0)
     throw runtime_error("Refresh period for the dynamic group must be positive");
 
+  if (isDirectory)
+    watchDirectory_ = path;
+  else {
+    size_t slash = path.find_last_of('/');
+    if (slash == string::npos) {
+      watchDirectory_ = ".";
+      watchFileName_ = path;
+    }
+    else {
+      watchDirectory_ = slash == 0 ? "/" : path.substr(0, slash);
+      watchFileName_ = path.substr(slash + 1);
+    }
+  }
+
   _LOG_TRACE("Create a dynamic trust anchor group " << id << " for file/dir " <<
     path << " with refresh time " << refreshPeriod);
   refresh();
 }
 
+DynamicTrustAnchorGroup::~DynamicTrustAnchorGroup()
+{
+  stopWatch();
+}
+
 void
 DynamicTrustAnchorGroup::refresh()
 {
@@ -116,51 +142,221 @@ DynamicTrustAnchorGroup::refresh()
     return;
 
   expireTime_ = now + refreshPeriod_;
+
+  if (watchFd_ >= 0) {
+    set<string> changedFilePaths;
+    if (readWatchEvents(changedFilePaths)) {
+      // Only check the files named in the events.
+      for (set<string>::iterator filePath = changedFilePaths.begin();
+           filePath != changedFilePaths.end(); ++filePath)
+        updateFile(*filePath);
+      return;
+    }
+  }
+
+  // Start the watch before scanning so that changes during the scan are not
+  // missed. If the directory doesn't exist yet, this tries again next time.
+  if (watchFd_ < 0)
+    startWatch();
+
   _LOG_TRACE("Reloading the dynamic trust anchor group");
+  scanAllFiles();
+}
 
-  // Save a copy of anchorNames_ .
-  set<Name> oldAnchorNames = anchorNames_;
+void
+DynamicTrustAnchorGroup::scanAllFiles()
+{
+  set<string> filePaths;
 
   if (!isDirectory_)
-    loadCertificate(path_, oldAnchorNames);
+    filePaths.insert(path_);
   else {
     DIR *directory = ::opendir(path_.c_str());
     if (directory != NULL) {
       struct dirent *entry;
       while ((entry = ::readdir(directory)) != NULL) {
-        // TODO: Handle non-unix file systems which don't have stat.
-        string filePath = path_ + '/' + entry->d_name;
-        struct stat fileStat;
-        if (::stat(filePath.c_str(), &fileStat) != -1 &&
-            S_ISREG(fileStat.st_mode))
-          loadCertificate(filePath, oldAnchorNames);
+        string fileName = entry->d_name;
+        if (fileName != "." && fileName != "..")
+          filePaths.insert(path_ + '/' + fileName);
       }
 
       ::closedir(directory);
     }
   }
 
-  // Remove old certificates.
-  for (set<Name>::iterator name = oldAnchorNames.begin();
-       name != oldAnchorNames.end(); ++name) {
-    anchorNames_.erase(*name);
-    certificates_.remove(*name);
+  // Remove the files which are gone.
+  vector<string> goneFilePaths;
+  for (AnchorFileMap::iterator file = files_.begin(); file != files_.end();
+       ++file) {
+    if (filePaths.count(file->first) == 0)
+      goneFilePaths.push_back(file->first);
+  }
+  for (size_t i = 0; i < goneFilePaths.size(); ++i)
+    updateFile(goneFilePaths[i]);
+
+  for (set<string>::iterator filePath = filePaths.begin();
+       filePath != filePaths.end(); ++filePath)
+    updateFile(*filePath);
+}
+
+void
+DynamicTrustAnchorGroup::updateFile(const string& filePath)
+{
+  AnchorFileMap::iterator file = files_.find(filePath);
+
+  FileStatus fileStatus;
+  if (!fileStatus.get(filePath) || !fileStatus.isRegularFile()) {
+    // The file is gone.
+    if (file != files_.end()) {
+      removeFileAnchor(file->second.certificateName_);
+      files_.erase(file);
+    }
+    return;
+  }
+
+  if (file != files_.end() && *file->second.status_ == fileStatus)
+    // Not changed.
+    return;
+
+  AnchorFile status;
+  status.status_ = ptr_lib::make_shared<FileStatus>(fileStatus);
+  ptr_lib::shared_ptr<CertificateV2> certificate = readCertificate(filePath);
+  if (certificate)
+    status.certificateName_ = certificate->getName();
+
+  if (file == files_.end())
+    file = files_.insert(make_pair(filePath, AnchorFile())).first;
+  // If the certificate name is the same, keep the existing certificate.
+  if (file->second.certificateName_ != status.certificateName_) {
+    if (certificate)
+      addFileAnchor(*certificate);
+    removeFileAnchor(file->second.certificateName_);
+  }
+  file->second = status;
+}
+
+void
+DynamicTrustAnchorGroup::addFileAnchor(const CertificateV2& certificate)
+{
+  const Name& certificateName = certificate.getName();
+  if (++anchorFileCount_[certificateName] == 1) {
+    if (anchorNames_.count(certificateName) == 0) {
+      anchorNames_.insert(certificateName);
+      certificates_.add(certificate);
+    }
+  }
+}
+
+void
+DynamicTrustAnchorGroup::removeFileAnchor(const Name& certificateName)
+{
+  if (certificateName.size() == 0)
+    return;
+
+  map<Name, int>::iterator count = anchorFileCount_.find(certificateName);
+  if (count == anchorFileCount_.end())
+    return;
+
+  if (--count->second <= 0) {
+    anchorFileCount_.erase(count);
+    anchorNames_.erase(certificateName);
+    certificates_.remove(certificateName);
+  }
+}
+
+#if NDN_CPP_HAVE_INOTIFY
+
+bool
+DynamicTrustAnchorGroup::startWatch()
+{
+  watchFd_ = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (watchFd_ < 0)
+    return false;
+
+  if (::inotify_add_watch
+      (watchFd_, watchDirectory_.c_str(),
+       IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO |
+       IN_ATTRIB | IN_MODIFY | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR) < 0) {
+    stopWatch();
+    return false;
   }
+
+  _LOG_TRACE("Watching " << watchDirectory_ << " for trust anchor changes");
+  return true;
 }
 
 void
-DynamicTrustAnchorGroup::loadCertificate
-  (const string& file, set<Name>& oldAnchorNames)
-{
-  ptr_lib::shared_ptr<CertificateV2> certificate = readCertificate(file);
-  if (certificate) {
-    if (anchorNames_.count(certificate->getName()) == 0) {
-      anchorNames_.insert(certificate->getName());
-      certificates_.add(*certificate);
+DynamicTrustAnchorGroup::stopWatch()
+{
+  if (watchFd_ >= 0) {
+    ::close(watchFd_);
+    watchFd_ = -1;
+  }
+}
+
+bool
+DynamicTrustAnchorGroup::readWatchEvents(set<string>& changedFilePaths)
+{
+  // Align the buffer for struct inotify_event.
+  union {
+    struct inotify_event event;
+    char buffer[4096];
+  } events;
+
+  while (true) {
+    ssize_t nBytes = ::read(watchFd_, events.buffer, sizeof(events.buffer));
+    if (nBytes < 0) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK)
+        // No more events.
+        return true;
+      if (errno == EINTR)
+        continue;
+
+      stopWatch();
+      return false;
+    }
+    if (nBytes == 0)
+      return true;
+
+    for (ssize_t offset = 0; offset < nBytes; ) {
+      const struct inotify_event* event =
+        (const struct inotify_event*)(events.buffer + offset);
+      offset += sizeof(struct inotify_event) + event->len;
+
+      if (event->mask & IN_Q_OVERFLOW)
+        // Some events were lost, so check all the files.
+        return false;
+      if (event->mask & (IN_IGNORED | IN_DELETE_SELF | IN_MOVE_SELF)) {
+        // The directory is gone or moved.
+        stopWatch();
+        return false;
+      }
+      if (event->len == 0)
+        continue;
+
+      string fileName = event->name;
+      if (isDirectory_)
+        changedFilePaths.insert(path_ + '/' + fileName);
+      else if (fileName == watchFileName_)
+        changedFilePaths.insert(path_);
     }
-    else
-      oldAnchorNames.erase(certificate->getName());
   }
 }
 
+#else // NDN_CPP_HAVE_INOTIFY
+
+bool
+DynamicTrustAnchorGroup::startWatch() { return false; }
+
+void
+DynamicTrustAnchorGroup::stopWatch() {}
+
+bool
+DynamicTrustAnchorGroup::readWatchEvents(set<string>& changedFilePaths)
+{
+  return false;
+}
+
+#endif // NDN_CPP_HAVE_INOTIFY
+
 }
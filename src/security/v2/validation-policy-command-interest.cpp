@@ -74,9 +74,14 @@ ValidationPolicyCommandInterest::cleanUp()
   MillisecondsSince1970 now = ndn_getNowMilliseconds() + nowOffsetMilliseconds_;
   MillisecondsSince1970 expiring = now - options_.recordLifetime_;
 
-  while ((container_.size() > 0 && container_[0]->lastRefreshed_ <= expiring) ||
-         (options_.maxRecords_ >= 0 && container_.size() > options_.maxRecords_))
-    container_.erase(container_.begin());
+  // container_ is ordered by lastRefreshed_, so only check the front.
+  while ((container_.size() > 0 &&
+          container_.front().lastRefreshed_ <= expiring) ||
+         (options_.maxRecords_ >= 0 &&
+          container_.size() > (size_t)options_.maxRecords_)) {
+    recordsByKeyName_.erase(container_.front().keyName_);
+    container_.pop_front();
+  }
 }
 
 bool
@@ -121,9 +126,9 @@ ValidationPolicyCommandInterest::checkTimestamp
     return false;
   }
 
-  int index = findByKeyName(keyName);
-  if (index >= 0) {
-    if (timestamp <= container_[index]->timestamp_) {
+  RecordMap::iterator record = recordsByKeyName_.find(keyName);
+  if (record != recordsByKeyName_.end()) {
+    if (timestamp <= record->second->timestamp_) {
       state->fail(ValidationError(ValidationError::POLICY_ERROR,
         "Timestamp is reordered for key " + keyName.toUri()));
       return false;
@@ -146,26 +151,18 @@ ValidationPolicyCommandInterest::insertNewRecord
 {
   // nowOffsetMilliseconds_ is only used for testing.
   MillisecondsSince1970 now = ndn_getNowMilliseconds() + nowOffsetMilliseconds_;
-  ptr_lib::shared_ptr<LastTimestampRecord> newRecord
-    (new LastTimestampRecord(keyName, timestamp, now));
-
-  int index = findByKeyName(keyName);
-  if (index >= 0)
-    // Remove the existing record so we can move it to the end.
-    container_.erase(container_.begin() + index);
-
-  container_.push_back(newRecord);
-}
 
-int
-ValidationPolicyCommandInterest::findByKeyName(const Name& keyName)
-{
-  for (int i = 0; i < container_.size(); ++i) {
-    if (container_[i]->keyName_.equals(keyName))
-      return i;
+  RecordMap::iterator record = recordsByKeyName_.find(keyName);
+  if (record != recordsByKeyName_.end()) {
+    // Update the existing record and move it to the end.
+    record->second->timestamp_ = timestamp;
+    record->second->lastRefreshed_ = now;
+    container_.splice(container_.end(), container_, record->second);
+  }
+  else {
+    container_.push_back(LastTimestampRecord(keyName, timestamp, now));
+    recordsByKeyName_[keyName] = --container_.end();
   }
-
-  return -1;
 }
 
 }
@@ -20,9 +20,11 @@
  * A copy of the GNU Lesser General Public License is in the file COPYING.
  */
 
+#include <algorithm>
 #include <stdexcept>
 #include <ndn-cpp/util/logging.hpp>
 #include <ndn-cpp/security/v2/validator.hpp>
+#include "../detail/merkle-tree.hpp"
 
 INIT_LOGGER("ndn.Validator");
 
@@ -53,6 +55,19 @@ Validator::validate
    const DataValidationSuccessCallback& successCallback,
    const DataValidationFailureCallback& failureCallback)
 {
+  if (verifiedDataCache_.getCapacity() > 0 &&
+      verifiedDataCache_.contains(*data.getFullName())) {
+    _LOG_TRACE("Found data " << data.getName() << " in the verified data cache");
+    try {
+      successCallback(data);
+    } catch (const std::exception& ex) {
+      _LOG_ERROR("Validator::validate: Error in successCallback: " << ex.what());
+    } catch (...) {
+      _LOG_ERROR("Validator::validate: Error in successCallback.");
+    }
+    return;
+  }
+
   ptr_lib::shared_ptr<DataValidationState> state
     (new DataValidationState(data, successCallback, failureCallback));
   _LOG_TRACE("Start validating data " << data.getName());
@@ -121,9 +136,21 @@ Validator::requestCertificate
   if (certificate) {
     _LOG_TRACE("Found trusted certificate " << certificate->getName());
 
+    ptr_lib::shared_ptr<CertificateV2> trustedCertificate = certificate;
     certificate = state->verifyCertificateChain(certificate);
-    if (certificate)
-      state->verifyOriginalPacket(*certificate);
+    if (certificate) {
+      Name merkleRootName = getMerkleRootName(state, *certificate);
+      if (merkleRootName.size() > 0 &&
+          verifiedMerkleRootCache_.contains(merkleRootName)) {
+        // The authentication path leads to a root which was already verified.
+        _LOG_TRACE("Found the Merkle root " << merkleRootName <<
+                   " in the verified Merkle root cache");
+        state->bypassValidation();
+      }
+      else
+        state->verifyOriginalPacket(*certificate);
+      cacheVerifiedData(state, *trustedCertificate, merkleRootName);
+    }
 
     for (size_t i = 0; i < state->certificateChain_.size(); ++i)
       cacheVerifiedCertificate(*state->certificateChain_[i]);
@@ -136,4 +163,55 @@ Validator::requestCertificate
      bind(&Validator::validateCertificate, this, _1, _2));
 }
 
+void
+Validator::cacheVerifiedData
+  (const ptr_lib::shared_ptr<ValidationState>& state,
+   const CertificateV2& trustedCertificate, const Name& merkleRootName)
+{
+  if ((verifiedDataCache_.getCapacity() == 0 && merkleRootName.size() == 0) ||
+      !state->isOutcomeSuccess())
+    return;
+  DataValidationState* dataState =
+    dynamic_cast<DataValidationState*>(state.get());
+  if (!dataState)
+    // Only cache Data. An Interest (such as a command Interest) is not expected
+    // to be validated twice.
+    return;
+
+  // The cached result is only valid while all the certificates are valid.
+  MillisecondsSince1970 notAfterTime =
+    trustedCertificate.getValidityPeriod().getNotAfter();
+  for (size_t i = 0; i < state->certificateChain_.size(); ++i)
+    notAfterTime = min
+      (notAfterTime,
+       state->certificateChain_[i]->getValidityPeriod().getNotAfter());
+
+  if (verifiedDataCache_.getCapacity() > 0)
+    verifiedDataCache_.insert
+      (*dataState->getOriginalData().getFullName(), notAfterTime);
+  if (merkleRootName.size() > 0)
+    verifiedMerkleRootCache_.insert(merkleRootName, notAfterTime);
+}
+
+Name
+Validator::getMerkleRootName
+  (const ptr_lib::shared_ptr<ValidationState>& state,
+   const CertificateV2& signingCertificate)
+{
+  if (verifiedMerkleRootCache_.getCapacity() == 0)
+    return Name();
+  DataValidationState* dataState =
+    dynamic_cast<DataValidationState*>(state.get());
+  if (!dataState)
+    return Name();
+
+  Blob root, rootSignature;
+  if (!MerkleTree::computeDataRoot
+      (dataState->getOriginalData(), *WireFormat::getDefaultWireFormat(), root,
+       rootSignature))
+    return Name();
+
+  return Name(signingCertificate.getKeyName()).appendImplicitSha256Digest(root);
+}
+
 }
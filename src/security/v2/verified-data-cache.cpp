@@ -0,0 +1,110 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2018 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+#include <algorithm>
+#include <ndn-cpp/util/logging.hpp>
+#include <ndn-cpp/security/v2/verified-data-cache.hpp>
+
+using namespace std;
+
+INIT_LOGGER("ndn.VerifiedDataCache");
+
+namespace ndn {
+
+VerifiedDataCache::VerifiedDataCache
+  (size_t capacity, Milliseconds maxLifetimeMilliseconds)
+: capacity_(capacity),
+  maxLifetimeMilliseconds_(maxLifetimeMilliseconds),
+  nowOffsetMilliseconds_(0)
+{
+}
+
+void
+VerifiedDataCache::insert
+  (const Name& fullName, MillisecondsSince1970 notAfterTime)
+{
+  if (capacity_ == 0)
+    return;
+
+  // nowOffsetMilliseconds_ is only used for testing.
+  MillisecondsSince1970 now = ndn_getNowMilliseconds() + nowOffsetMilliseconds_;
+  if (notAfterTime <= now)
+    return;
+  MillisecondsSince1970 removalTime =
+    min(notAfterTime, now + maxLifetimeMilliseconds_);
+
+  RemovalTimeMap::iterator found =
+    removalTimeByFullName_.find(fullName);
+  if (found != removalTimeByFullName_.end()) {
+    // Update the removal time of the existing entry.
+    fullNamesByRemovalTime_.erase(make_pair(found->second, fullName));
+    found->second = removalTime;
+    fullNamesByRemovalTime_.insert(make_pair(removalTime, fullName));
+    return;
+  }
+
+  refresh(now);
+  while (removalTimeByFullName_.size() >= capacity_)
+    evictOne();
+
+  _LOG_TRACE("Adding verified data " << fullName.toUri());
+  removalTimeByFullName_[fullName] = removalTime;
+  fullNamesByRemovalTime_.insert(make_pair(removalTime, fullName));
+}
+
+bool
+VerifiedDataCache::contains(const Name& fullName) const
+{
+  if (removalTimeByFullName_.empty())
+    return false;
+
+  // nowOffsetMilliseconds_ is only used for testing.
+  MillisecondsSince1970 now = ndn_getNowMilliseconds() + nowOffsetMilliseconds_;
+  const_cast<VerifiedDataCache*>(this)->refresh(now);
+
+  return removalTimeByFullName_.find(fullName) != removalTimeByFullName_.end();
+}
+
+void
+VerifiedDataCache::setCapacity(size_t capacity)
+{
+  capacity_ = capacity;
+  while (removalTimeByFullName_.size() > capacity_)
+    evictOne();
+}
+
+void
+VerifiedDataCache::refresh(MillisecondsSince1970 now)
+{
+  while (!fullNamesByRemovalTime_.empty() &&
+         fullNamesByRemovalTime_.begin()->first <= now)
+    evictOne();
+}
+
+void
+VerifiedDataCache::evictOne()
+{
+  RemovalIndex::iterator first = fullNamesByRemovalTime_.begin();
+  removalTimeByFullName_.erase(first->second);
+  fullNamesByRemovalTime_.erase(first);
+}
+
+}
@@ -23,6 +23,7 @@
 #include <math.h>
 #include <stdexcept>
 #include <ndn-cpp/sha256-with-ecdsa-signature.hpp>
+#include <ndn-cpp/merkle-signature.hpp>
 #include <ndn-cpp/sha256-with-rsa-signature.hpp>
 #include <ndn-cpp/security/validity-period.hpp>
 
@@ -44,7 +45,8 @@ bool
 ValidityPeriod::canGetFromSignature(const Signature* signature)
 {
   return dynamic_cast<const Sha256WithRsaSignature *>(signature) ||
-         dynamic_cast<const Sha256WithEcdsaSignature *>(signature);
+         dynamic_cast<const Sha256WithEcdsaSignature *>(signature) ||
+         dynamic_cast<const MerkleSignature *>(signature);
 }
 
 ValidityPeriod&
@@ -62,6 +64,12 @@ ValidityPeriod::getFromSignature(Signature* signature)
     if (castSignature)
       return castSignature->getValidityPeriod();
   }
+  {
+    MerkleSignature *castSignature =
+      dynamic_cast<MerkleSignature *>(signature);
+    if (castSignature)
+      return castSignature->getValidityPeriod();
+  }
 
   throw runtime_error
     ("ValidityPeriod::getFromSignature: Signature type does not have a ValidityPeriod");
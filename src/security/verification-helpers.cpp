@@ -25,7 +25,10 @@
 #include <ndn-cpp/lite/util/crypto-lite.hpp>
 #include <ndn-cpp/lite/security/ec-public-key-lite.hpp>
 #include <ndn-cpp/lite/security/rsa-public-key-lite.hpp>
+#include <ndn-cpp/merkle-signature.hpp>
 #include <ndn-cpp/security/verification-helpers.hpp>
+#include "detail/decoded-public-key.hpp"
+#include "detail/merkle-tree.hpp"
 
 using namespace std;
 
@@ -87,6 +90,17 @@ VerificationHelpers::verifyDataSignature
   (const Data& data, const PublicKey& publicKey, DigestAlgorithm digestAlgorithm,
    WireFormat& wireFormat)
 {
+  if (dynamic_cast<const MerkleSignature*>(data.getSignature())) {
+    // Verify the signature of the root computed from the authentication path.
+    Blob root, rootSignature;
+    if (!MerkleTree::computeDataRoot(data, wireFormat, root, rootSignature))
+      return false;
+
+    return verifySignature
+      (root.buf(), root.size(), rootSignature.buf(), rootSignature.size(),
+       publicKey, digestAlgorithm);
+  }
+
   SignedBlob encoding;
   try {
     encoding = data.wireEncode(wireFormat);
@@ -113,6 +127,45 @@ VerificationHelpers::verifyDataSignature
   }
 }
 
+void
+VerificationHelpers::verifyDataSignatures
+  (const vector<ptr_lib::shared_ptr<Data> >& dataList,
+   const vector<Blob>& publicKeyDerList, vector<bool>& results,
+   WireFormat& wireFormat)
+{
+  if (publicKeyDerList.size() != dataList.size())
+    throw invalid_argument
+      ("verifyDataSignatures: publicKeyDerList must have the same size as dataList");
+
+  results.assign(dataList.size(), false);
+  DecodedPublicKey::Map keys;
+  for (size_t i = 0; i < dataList.size(); ++i) {
+    const DecodedPublicKey& key = DecodedPublicKey::get
+      (keys, publicKeyDerList[i]);
+
+    if (dynamic_cast<const MerkleSignature*>(dataList[i]->getSignature())) {
+      Blob root, rootSignature;
+      if (MerkleTree::computeDataRoot
+          (*dataList[i], wireFormat, root, rootSignature))
+        results[i] = key.verifyWithSha256
+          (root.buf(), root.size(), rootSignature.buf(), rootSignature.size());
+      continue;
+    }
+
+    SignedBlob encoding;
+    try {
+      encoding = dataList[i]->wireEncode(wireFormat);
+    } catch (const std::exception&) {
+      continue;
+    }
+
+    const Blob& signature = dataList[i]->getSignature()->getSignature();
+    results[i] = key.verifyWithSha256
+      (encoding.signedBuf(), encoding.signedSize(), signature.buf(),
+       signature.size());
+  }
+}
+
 bool
 VerificationHelpers::verifyInterestSignature
   (const Interest& interest, const PublicKey& publicKey,
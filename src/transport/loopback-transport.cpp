@@ -0,0 +1,151 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2018 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+#include <stdexcept>
+#include "../encoding/element-listener.hpp"
+#include <ndn-cpp/transport/loopback-transport.hpp>
+
+using namespace std;
+
+namespace ndn {
+
+LoopbackTransport::ConnectionInfo::~ConnectionInfo()
+{
+}
+
+LoopbackTransport::LoopbackTransport()
+  : elementListener_(0), peer_(0)
+{
+}
+
+bool
+LoopbackTransport::isLocal(const Transport::ConnectionInfo& connectionInfo)
+{
+  return true;
+}
+
+bool
+LoopbackTransport::isAsync() { return false; }
+
+void
+LoopbackTransport::connect
+  (const Transport::ConnectionInfo& connectionInfo,
+   ElementListener& elementListener, const OnConnected& onConnected)
+{
+  const LoopbackTransport::ConnectionInfo& loopbackConnectionInfo =
+    dynamic_cast<const LoopbackTransport::ConnectionInfo&>(connectionInfo);
+
+  LoopbackTransport* peer = loopbackConnectionInfo.getPeer().get();
+  if (peer == this)
+    throw runtime_error("LoopbackTransport: Cannot connect to itself");
+  if (peer) {
+    disconnect();
+    // A transport has only one peer.
+    peer->disconnect();
+    peer_ = peer;
+    peer->peer_ = this;
+  }
+
+  elementListener_ = &elementListener;
+
+  if (onConnected)
+    onConnected();
+}
+
+void
+LoopbackTransport::send(const uint8_t *data, size_t dataLength)
+{
+  if (!peer_)
+    throw runtime_error("LoopbackTransport: Not connected to a peer");
+
+  peer_->receiveQueue_.insert(peer_->receiveQueue_.end(), data, data + dataLength);
+  peer_->receiveQueueLengths_.push_back(dataLength);
+}
+
+void
+LoopbackTransport::processEvents()
+{
+  if (!elementListener_ || receiveQueueLengths_.size() == 0)
+    return;
+
+  // Swap into local vectors in case a callback sends to this transport or calls
+  // processEvents again.
+  vector<uint8_t> buffer;
+  vector<size_t> lengths;
+  buffer.swap(processBuffer_);
+  lengths.swap(processLengths_);
+  buffer.swap(receiveQueue_);
+  lengths.swap(receiveQueueLengths_);
+
+  size_t i = 0;
+  size_t offset = 0;
+  try {
+    for (; i < lengths.size(); ++i) {
+      const uint8_t* element = &buffer[offset];
+      offset += lengths[i];
+      elementListener_->onReceivedElement(element, lengths[i]);
+    }
+  } catch (...) {
+    // Put the elements after the one which threw back at the front of the queue.
+    receiveQueue_.insert
+      (receiveQueue_.begin(), buffer.begin() + offset, buffer.end());
+    receiveQueueLengths_.insert
+      (receiveQueueLengths_.begin(), lengths.begin() + i + 1, lengths.end());
+    throw;
+  }
+
+  // Keep the allocated buffers for the next call.
+  buffer.clear();
+  lengths.clear();
+  processBuffer_.swap(buffer);
+  processLengths_.swap(lengths);
+}
+
+bool
+LoopbackTransport::getIsConnected()
+{
+  return elementListener_ != 0 && peer_ != 0;
+}
+
+void
+LoopbackTransport::close()
+{
+  disconnect();
+  elementListener_ = 0;
+  receiveQueue_.clear();
+  receiveQueueLengths_.clear();
+}
+
+LoopbackTransport::~LoopbackTransport()
+{
+  disconnect();
+}
+
+void
+LoopbackTransport::disconnect()
+{
+  if (peer_) {
+    peer_->peer_ = 0;
+    peer_ = 0;
+  }
+}
+
+}
@@ -39,9 +39,14 @@ UdpTransport::ConnectionInfo::~ConnectionInfo()
 {
 }
 
-UdpTransport::UdpTransport()
+UdpTransport::UdpTransport
+  (size_t batchSize, int receiveBufferSize, int sendBufferSize)
   : isConnected_(false), transport_(new struct ndn_UdpTransport),
-    elementBuffer_(new DynamicUInt8Vector(1000))
+    elementBuffer_(new DynamicUInt8Vector(1000)),
+    batchSize_(batchSize < 1 ? 1 :
+               (batchSize > MAX_DATAGRAMS_PER_CALL ?
+                MAX_DATAGRAMS_PER_CALL : batchSize)),
+    receiveBufferSize_(receiveBufferSize), sendBufferSize_(sendBufferSize)
 {
   ndn_UdpTransport_initialize(transport_.get(), elementBuffer_.get());
 }
@@ -69,6 +74,14 @@ UdpTransport::connect
         udpConnectionInfo.getPort(), &elementListener)))
     throw runtime_error(ndn_getErrorString(error));
 
+  if (receiveBufferSize_ > 0 || sendBufferSize_ > 0) {
+    if ((error = ndn_UdpTransport_setBufferSizes
+         (transport_.get(), receiveBufferSize_, sendBufferSize_)))
+      throw runtime_error(ndn_getErrorString(error));
+  }
+  if (batchSize_ > 1 && receiveBuffers_.size() == 0)
+    receiveBuffers_.resize(batchSize_ * MAX_NDN_PACKET_SIZE);
+
   isConnected_ = true;
   if (onConnected)
     onConnected();
@@ -77,19 +90,69 @@ UdpTransport::connect
 void
 UdpTransport::send(const uint8_t *data, size_t dataLength)
 {
+  if (batchSize_ > 1) {
+    // Check here since an error from flush() could be much later.
+    if (transport_->base.socketDescriptor < 0)
+      throw runtime_error
+        (ndn_getErrorString(NDN_ERROR_SocketTransport_socket_is_not_open));
+
+    sendQueue_.insert(sendQueue_.end(), data, data + dataLength);
+    sendQueueLengths_.push_back(dataLength);
+    if (sendQueueLengths_.size() >= batchSize_)
+      flush();
+    return;
+  }
+
   ndn_Error error;
   if ((error = ndn_UdpTransport_send(transport_.get(), data, dataLength)))
     throw runtime_error(ndn_getErrorString(error));
 }
 
+void
+UdpTransport::flush()
+{
+  if (sendQueueLengths_.size() == 0)
+    return;
+
+  ndn_Error error = ndn_UdpTransport_sendDatagrams
+    (transport_.get(), &sendQueue_[0], &sendQueueLengths_[0],
+     sendQueueLengths_.size());
+  // Clear the queue even if there is an error so that it doesn't grow.
+  sendQueue_.clear();
+  sendQueueLengths_.clear();
+  if (error)
+    throw runtime_error(ndn_getErrorString(error));
+}
+
 void
 UdpTransport::processEvents()
 {
-  uint8_t buffer[MAX_NDN_PACKET_SIZE];
-  ndn_Error error;
-  if ((error = ndn_UdpTransport_processEvents
-       (transport_.get(), buffer, sizeof(buffer))))
+  if (batchSize_ <= 1) {
+    uint8_t buffer[MAX_NDN_PACKET_SIZE];
+    ndn_Error error;
+    if ((error = ndn_UdpTransport_processEvents
+         (transport_.get(), buffer, sizeof(buffer))))
+      throw runtime_error(ndn_getErrorString(error));
+    return;
+  }
+
+  flush();
+
+  // Swap the reusable buffers into a local variable in case a callback calls
+  // processEvents again, which would overwrite datagrams not yet delivered.
+  vector<uint8_t> receiveBuffers;
+  receiveBuffers.swap(receiveBuffers_);
+  if (receiveBuffers.size() == 0)
+    receiveBuffers.resize(batchSize_ * MAX_NDN_PACKET_SIZE);
+
+  ndn_Error error = ndn_UdpTransport_processDatagrams
+    (transport_.get(), &receiveBuffers[0], MAX_NDN_PACKET_SIZE, batchSize_);
+  receiveBuffers_.swap(receiveBuffers);
+  if (error)
     throw runtime_error(ndn_getErrorString(error));
+
+  // Send any packets which the receive callbacks queued.
+  flush();
 }
 
 bool
@@ -101,6 +164,14 @@ UdpTransport::getIsConnected()
 void
 UdpTransport::close()
 {
+  try {
+    flush();
+  } catch (...) {
+    // Still close the socket.
+    ndn_UdpTransport_close(transport_.get());
+    throw;
+  }
+
   ndn_Error error;
   if ((error = ndn_UdpTransport_close(transport_.get())))
     throw runtime_error(ndn_getErrorString(error));
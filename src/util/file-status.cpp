@@ -0,0 +1,55 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2018 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+#include <sys/stat.h>
+#include "file-status.hpp"
+
+using namespace std;
+
+namespace ndn {
+
+bool
+FileStatus::get(const string& filePath)
+{
+  // TODO: Handle non-unix file systems which don't have stat.
+  struct stat fileStat;
+  if (::stat(filePath.c_str(), &fileStat) != 0)
+    return false;
+
+  // Use the nanoseconds where available so that a file which is rewritten in
+  // the same second is detected.
+#if defined(__APPLE__)
+  modificationTimeNanoseconds_ =
+    (int64_t)fileStat.st_mtimespec.tv_sec * 1000000000 +
+    fileStat.st_mtimespec.tv_nsec;
+#elif defined(__linux__)
+  modificationTimeNanoseconds_ =
+    (int64_t)fileStat.st_mtim.tv_sec * 1000000000 + fileStat.st_mtim.tv_nsec;
+#else
+  modificationTimeNanoseconds_ = (int64_t)fileStat.st_mtime * 1000000000;
+#endif
+  size_ = fileStat.st_size;
+  inode_ = fileStat.st_ino;
+  isRegularFile_ = S_ISREG(fileStat.st_mode);
+  return true;
+}
+
+}
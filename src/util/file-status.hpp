@@ -0,0 +1,82 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2018 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+#ifndef NDN_FILE_STATUS_HPP
+#define NDN_FILE_STATUS_HPP
+
+#include <string>
+#include <ndn-cpp/common.hpp>
+
+namespace ndn {
+
+/**
+ * A FileStatus has the values from stat() which are used to check if a file
+ * has changed since it was read: the modification time, size and inode number.
+ */
+class FileStatus {
+public:
+  FileStatus()
+  : modificationTimeNanoseconds_(0), size_(0), inode_(0), isRegularFile_(false)
+  {
+  }
+
+  /**
+   * Set this to the status of the file.
+   * @param filePath The path of the file.
+   * @return True for success, or false if the file doesn't exist, in which
+   * case this is not changed.
+   */
+  bool
+  get(const std::string& filePath);
+
+  /**
+   * Check if the file is a regular file, as opposed to a directory, etc.
+   * @return True if the file is a regular file.
+   */
+  bool
+  isRegularFile() const { return isRegularFile_; }
+
+  /**
+   * Check if the modification time, size and inode number are the same.
+   * @param other The other FileStatus to compare with.
+   * @return True if the status is the same.
+   */
+  bool
+  operator==(const FileStatus& other) const
+  {
+    return
+      modificationTimeNanoseconds_ == other.modificationTimeNanoseconds_ &&
+      size_ == other.size_ && inode_ == other.inode_;
+  }
+
+  bool
+  operator!=(const FileStatus& other) const { return !(*this == other); }
+
+private:
+  int64_t modificationTimeNanoseconds_;
+  int64_t size_;
+  uint64_t inode_;
+  bool isRegularFile_;
+};
+
+}
+
+#endif
@@ -0,0 +1,133 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2018 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+#include <ndn-cpp/util/latency-histogram.hpp>
+
+using namespace std;
+
+namespace ndn {
+
+const uint64_t LatencyHistogram::MAX_TRACKABLE_VALUE;
+const size_t LatencyHistogram::N_BUCKETS;
+
+LatencyHistogram::LatencyHistogram()
+: counts_(N_BUCKETS, 0)
+{
+  reset();
+}
+
+void
+LatencyHistogram::recordValue(uint64_t value)
+{
+  if (value > MAX_TRACKABLE_VALUE)
+    value = MAX_TRACKABLE_VALUE;
+
+  ++counts_[getBucketIndex(value)];
+  if (count_ == 0 || value < min_)
+    min_ = value;
+  if (value > max_)
+    max_ = value;
+  ++count_;
+  sum_ += value;
+}
+
+void
+LatencyHistogram::add(const LatencyHistogram& other)
+{
+  if (other.count_ == 0)
+    return;
+
+  for (size_t i = 0; i < N_BUCKETS; ++i)
+    counts_[i] += other.counts_[i];
+  if (count_ == 0 || other.min_ < min_)
+    min_ = other.min_;
+  if (other.max_ > max_)
+    max_ = other.max_;
+  count_ += other.count_;
+  sum_ += other.sum_;
+}
+
+void
+LatencyHistogram::reset()
+{
+  for (size_t i = 0; i < counts_.size(); ++i)
+    counts_[i] = 0;
+  count_ = 0;
+  min_ = 0;
+  max_ = 0;
+  sum_ = 0;
+}
+
+uint64_t
+LatencyHistogram::getValueAtPercentile(double percentile) const
+{
+  if (count_ == 0)
+    return 0;
+
+  if (percentile < 0.0)
+    percentile = 0.0;
+  if (percentile > 100.0)
+    percentile = 100.0;
+  // The number of values at or below the percentile, at least one.
+  uint64_t target = (uint64_t)(percentile / 100.0 * count_ + 0.5);
+  if (target < 1)
+    target = 1;
+
+  uint64_t total = 0;
+  for (size_t i = 0; i < N_BUCKETS; ++i) {
+    total += counts_[i];
+    if (total >= target) {
+      uint64_t value = getHighestEquivalentValue(i);
+      return value > max_ ? max_ : value;
+    }
+  }
+
+  // We don't expect this to happen.
+  return max_;
+}
+
+size_t
+LatencyHistogram::getBucketIndex(uint64_t value)
+{
+  if (value < 32)
+    return (size_t)value;
+
+  // Find the position of the most significant bit, at least 5.
+  int msb = 5;
+  while ((value >> (msb + 1)) != 0)
+    ++msb;
+  // Keep the top 5 bits, which range from 16 to 31.
+  int shift = msb - 4;
+  return 16 * shift + (size_t)(value >> shift);
+}
+
+uint64_t
+LatencyHistogram::getHighestEquivalentValue(size_t bucketIndex)
+{
+  if (bucketIndex < 32)
+    return bucketIndex;
+
+  int shift = (int)(bucketIndex / 16) - 1;
+  uint64_t subBucket = bucketIndex - 16 * shift;
+  return ((subBucket + 1) << shift) - 1;
+}
+
+}
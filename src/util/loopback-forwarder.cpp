@@ -0,0 +1,432 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2018 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+#include <algorithm>
+#include "../c/encoding/tlv/tlv.h"
+#include "../c/util/time.h"
+#include "../encoding/element-listener.hpp"
+#include <ndn-cpp/control-parameters.hpp>
+#include <ndn-cpp/control-response.hpp>
+#include <ndn-cpp/digest-sha256-signature.hpp>
+#include <ndn-cpp/encoding/tlv-wire-format.hpp>
+#include <ndn-cpp/util/logging.hpp>
+#include <ndn-cpp/util/loopback-forwarder.hpp>
+
+INIT_LOGGER("ndn.LoopbackForwarder");
+
+using namespace std;
+
+namespace ndn {
+
+/**
+ * A FaceEntry has the forwarder's end of the LoopbackTransport for one Face and
+ * passes each received element to the forwarder with the face ID.
+ */
+class LoopbackForwarder::FaceEntry : public ElementListener {
+public:
+  FaceEntry(LoopbackForwarder& forwarder, size_t faceId)
+  : forwarder_(forwarder), faceId_(faceId),
+    transport_(new LoopbackTransport())
+  {
+  }
+
+  virtual void
+  onReceivedElement(const uint8_t *element, size_t elementLength)
+  {
+    forwarder_.onReceivedElement(faceId_, element, elementLength);
+  }
+
+  LoopbackForwarder& forwarder_;
+  size_t faceId_;
+  ptr_lib::shared_ptr<LoopbackTransport> transport_;
+};
+
+// The name prefix of the NFD RIB management commands from the local host.
+static const Name&
+getRibCommandPrefix()
+{
+  static Name prefix("/localhost/nfd/rib");
+  return prefix;
+}
+
+LoopbackForwarder::LoopbackForwarder(size_t contentStoreCapacity)
+: contentStoreCapacity_(contentStoreCapacity), pitSize_(0),
+  nextPitExpirationTime_(-1)
+{
+}
+
+ptr_lib::shared_ptr<Face>
+LoopbackForwarder::makeFace()
+{
+  // Face IDs start from 1 since NFD uses 0 for "the face of the command".
+  size_t faceId = faces_.size() + 1;
+  ptr_lib::shared_ptr<FaceEntry> faceEntry(new FaceEntry(*this, faceId));
+  faces_.push_back(faceEntry);
+  // Wait for the Face's transport to connect.
+  faceEntry->transport_->connect
+    (LoopbackTransport::ConnectionInfo(), *faceEntry,
+     Transport::OnConnected());
+
+  return ptr_lib::make_shared<Face>
+    (ptr_lib::make_shared<LoopbackTransport>(),
+     ptr_lib::make_shared<LoopbackTransport::ConnectionInfo>
+       (faceEntry->transport_));
+}
+
+void
+LoopbackForwarder::processEvents()
+{
+  // Use an index since a callback could call makeFace.
+  for (size_t i = 0; i < faces_.size(); ++i)
+    faces_[i]->transport_->processEvents();
+
+  MillisecondsSince1970 nowMilliseconds = ndn_getNowMilliseconds();
+  if (nextPitExpirationTime_ >= 0 && nowMilliseconds >= nextPitExpirationTime_)
+    removeTimedOutPitEntries(nowMilliseconds);
+}
+
+LoopbackForwarder::~LoopbackForwarder()
+{
+  // Close the forwarder's end of each transport so that it no longer calls
+  // this object.
+  for (size_t i = 0; i < faces_.size(); ++i)
+    faces_[i]->transport_->close();
+}
+
+void
+LoopbackForwarder::onReceivedElement
+  (size_t faceId, const uint8_t *element, size_t elementLength)
+{
+  try {
+    if (element[0] == ndn_Tlv_Interest)
+      onReceivedInterest(faceId, element, elementLength);
+    else if (element[0] == ndn_Tlv_Data)
+      onReceivedData(faceId, element, elementLength);
+    else {
+      _LOG_DEBUG("LoopbackForwarder: Dropping a packet of unsupported type " <<
+                 (int)element[0]);
+    }
+  } catch (const std::exception& ex) {
+    // Like a forwarder, drop a packet which can't be decoded.
+    _LOG_DEBUG("LoopbackForwarder: Dropping a packet from face " << faceId <<
+               ": " << ex.what());
+  }
+}
+
+void
+LoopbackForwarder::onReceivedInterest
+  (size_t faceId, const uint8_t *element, size_t elementLength)
+{
+  ptr_lib::shared_ptr<Interest> interest(new Interest());
+  interest->wireDecode(element, elementLength, *TlvWireFormat::get());
+  const Name& name = interest->getName();
+
+  if (getRibCommandPrefix().isPrefixOf(name)) {
+    onRibCommand(faceId, *interest);
+    return;
+  }
+
+  MillisecondsSince1970 nowMilliseconds = ndn_getNowMilliseconds();
+
+  // Check the content store.
+  for (map<Name, ptr_lib::shared_ptr<ContentStoreEntry> >::iterator
+         entry = contentStore_.lower_bound(name);
+       entry != contentStore_.end() && name.isPrefixOf(entry->first);
+       ++entry) {
+    if (interest->getMustBeFresh() && entry->second->staleTime_ >= 0 &&
+        nowMilliseconds >= entry->second->staleTime_)
+      continue;
+
+    if (interest->matchesData(entry->second->data_)) {
+      sendToFace
+        (faceId, entry->second->encoding_.buf(),
+         entry->second->encoding_.size());
+      return;
+    }
+  }
+
+  double lifetime = interest->getInterestLifetimeMilliseconds();
+  if (lifetime < 0)
+    // Use the NFD default.
+    lifetime = 4000.0;
+  MillisecondsSince1970 expirationTime = nowMilliseconds + lifetime;
+
+  // Check for an existing PIT entry to aggregate with.
+  vector<ptr_lib::shared_ptr<PitEntry> >& entries = pit_[name];
+  for (size_t i = 0; i < entries.size(); ++i) {
+    PitEntry& pitEntry = *entries[i];
+    if (!selectorsEqual(*pitEntry.interest_, *interest))
+      continue;
+
+    for (size_t j = 0; j < pitEntry.nonces_.size(); ++j) {
+      if (pitEntry.nonces_[j].equals(interest->getNonce())) {
+        _LOG_DEBUG("LoopbackForwarder: Dropping a looping Interest " <<
+                   name.toUri());
+        return;
+      }
+    }
+
+    pitEntry.nonces_.push_back(interest->getNonce());
+    if (find(pitEntry.inFaceIds_.begin(), pitEntry.inFaceIds_.end(), faceId) ==
+        pitEntry.inFaceIds_.end())
+      pitEntry.inFaceIds_.push_back(faceId);
+    pitEntry.expirationTime_ =
+      max(pitEntry.expirationTime_, expirationTime);
+    return;
+  }
+
+  // Find the longest prefix match in the FIB.
+  const vector<size_t>* nextHops = 0;
+  for (int i = (int)name.size(); i >= 0; --i) {
+    map<Name, vector<size_t> >::iterator fibEntry =
+      fib_.find(i == (int)name.size() ? name : name.getPrefix(i));
+    if (fibEntry != fib_.end()) {
+      nextHops = &fibEntry->second;
+      break;
+    }
+  }
+
+  bool forwarded = false;
+  if (nextHops) {
+    for (size_t i = 0; i < nextHops->size(); ++i) {
+      if ((*nextHops)[i] != faceId) {
+        sendToFace((*nextHops)[i], element, elementLength);
+        forwarded = true;
+      }
+    }
+  }
+  if (!forwarded) {
+    _LOG_DEBUG("LoopbackForwarder: No route for Interest " << name.toUri());
+    if (entries.size() == 0)
+      pit_.erase(name);
+    return;
+  }
+
+  ptr_lib::shared_ptr<PitEntry> pitEntry(new PitEntry(interest));
+  pitEntry->inFaceIds_.push_back(faceId);
+  pitEntry->nonces_.push_back(interest->getNonce());
+  pitEntry->expirationTime_ = expirationTime;
+  entries.push_back(pitEntry);
+  ++pitSize_;
+  if (nextPitExpirationTime_ < 0 || expirationTime < nextPitExpirationTime_)
+    nextPitExpirationTime_ = expirationTime;
+}
+
+void
+LoopbackForwarder::onReceivedData
+  (size_t faceId, const uint8_t *element, size_t elementLength)
+{
+  ptr_lib::shared_ptr<ContentStoreEntry> contentStoreEntry
+    (new ContentStoreEntry());
+  Data& data = contentStoreEntry->data_;
+  data.wireDecode(element, elementLength, *TlvWireFormat::get());
+  const Name& name = data.getName();
+
+  // Collect the face IDs of the PIT entries which the Data satisfies. An
+  // Interest name can be any prefix of the Data name, or the full name with
+  // the implicit digest.
+  vector<size_t> outFaceIds;
+  for (size_t i = 0; i <= name.size() + 1; ++i) {
+    map<Name, vector<ptr_lib::shared_ptr<PitEntry> > >::iterator pitEntries;
+    if (i <= name.size())
+      pitEntries = pit_.find(i == name.size() ? name : name.getPrefix(i));
+    else {
+      // Only compute the full name if there is a longer Interest name. The
+      // names which have the Data name as a prefix sort right after it, but
+      // the full name need not be the first of these.
+      map<Name, vector<ptr_lib::shared_ptr<PitEntry> > >::iterator next =
+        pit_.upper_bound(name);
+      if (next == pit_.end() || !name.isPrefixOf(next->first))
+        break;
+      pitEntries = pit_.find(*data.getFullName(*TlvWireFormat::get()));
+    }
+    if (pitEntries == pit_.end())
+      continue;
+
+    vector<ptr_lib::shared_ptr<PitEntry> >& entries = pitEntries->second;
+    for (size_t j = 0; j < entries.size();) {
+      if (entries[j]->interest_->matchesData(data, *TlvWireFormat::get())) {
+        for (size_t k = 0; k < entries[j]->inFaceIds_.size(); ++k) {
+          if (find(outFaceIds.begin(), outFaceIds.end(),
+                   entries[j]->inFaceIds_[k]) == outFaceIds.end())
+            outFaceIds.push_back(entries[j]->inFaceIds_[k]);
+        }
+
+        entries.erase(entries.begin() + j);
+        --pitSize_;
+      }
+      else
+        ++j;
+    }
+
+    if (entries.size() == 0)
+      pit_.erase(pitEntries);
+  }
+
+  if (outFaceIds.size() == 0) {
+    // Like NFD, drop unsolicited Data.
+    _LOG_DEBUG("LoopbackForwarder: Dropping unsolicited Data " << name.toUri());
+    return;
+  }
+
+  for (size_t i = 0; i < outFaceIds.size(); ++i)
+    sendToFace(outFaceIds[i], element, elementLength);
+
+  if (contentStoreCapacity_ == 0)
+    return;
+
+  contentStoreEntry->encoding_ = Blob(element, elementLength);
+  contentStoreEntry->staleTime_ = -1;
+  if (data.getMetaInfo().getFreshnessPeriod() >= 0)
+    contentStoreEntry->staleTime_ =
+      ndn_getNowMilliseconds() + data.getMetaInfo().getFreshnessPeriod();
+
+  ptr_lib::shared_ptr<ContentStoreEntry>& storedEntry = contentStore_[name];
+  if (!storedEntry) {
+    contentStoreOrder_.push_back(name);
+    if (contentStoreOrder_.size() > contentStoreCapacity_) {
+      contentStore_.erase(contentStoreOrder_.front());
+      contentStoreOrder_.pop_front();
+    }
+  }
+  // Replace a previous Data packet with the same name.
+  contentStore_[name] = contentStoreEntry;
+}
+
+void
+LoopbackForwarder::onRibCommand(size_t faceId, const Interest& interest)
+{
+  const Name& name = interest.getName();
+  const Name& prefix = getRibCommandPrefix();
+  ControlResponse controlResponse;
+
+  ControlParameters controlParameters;
+  bool isRegister = false;
+  bool isUnregister = false;
+  if (name.size() > prefix.size() + 1) {
+    isRegister = (name[prefix.size()].toEscapedString() == "register");
+    isUnregister = (name[prefix.size()].toEscapedString() == "unregister");
+  }
+
+  if (!(isRegister || isUnregister)) {
+    controlResponse.setStatusCode(501);
+    controlResponse.setStatusText("Unsupported command");
+  }
+  else {
+    try {
+      controlParameters.wireDecode
+        (name[prefix.size() + 1].getValue(), *TlvWireFormat::get());
+    } catch (const std::exception& ex) {
+      controlResponse.setStatusCode(400);
+      controlResponse.setStatusText("Malformed command");
+    }
+  }
+
+  if (controlResponse.getStatusCode() < 0) {
+    if (controlParameters.getFaceId() <= 0)
+      controlParameters.setFaceId((int)faceId);
+    size_t nextHop = (size_t)controlParameters.getFaceId();
+
+    if (isRegister) {
+      vector<size_t>& nextHops = fib_[controlParameters.getName()];
+      if (find(nextHops.begin(), nextHops.end(), nextHop) == nextHops.end())
+        nextHops.push_back(nextHop);
+    }
+    else {
+      map<Name, vector<size_t> >::iterator fibEntry =
+        fib_.find(controlParameters.getName());
+      if (fibEntry != fib_.end()) {
+        fibEntry->second.erase
+          (remove(fibEntry->second.begin(), fibEntry->second.end(), nextHop),
+           fibEntry->second.end());
+        if (fibEntry->second.size() == 0)
+          fib_.erase(fibEntry);
+      }
+    }
+
+    controlResponse.setStatusCode(200);
+    controlResponse.setStatusText("OK");
+    controlResponse.setBodyAsControlParameters(&controlParameters);
+  }
+
+  Data response(name);
+  response.setContent(controlResponse.wireEncode(*TlvWireFormat::get()));
+  // The Face doesn't verify the response, so use an unsigned digest signature.
+  response.setSignature(DigestSha256Signature());
+  Blob encoding = response.wireEncode(*TlvWireFormat::get());
+  sendToFace(faceId, encoding.buf(), encoding.size());
+}
+
+void
+LoopbackForwarder::sendToFace
+  (size_t faceId, const uint8_t *element, size_t elementLength)
+{
+  if (faceId < 1 || faceId > faces_.size())
+    return;
+
+  LoopbackTransport& transport = *faces_[faceId - 1]->transport_;
+  if (transport.getIsConnected())
+    transport.send(element, elementLength);
+}
+
+void
+LoopbackForwarder::removeTimedOutPitEntries
+  (MillisecondsSince1970 nowMilliseconds)
+{
+  nextPitExpirationTime_ = -1;
+  map<Name, vector<ptr_lib::shared_ptr<PitEntry> > >::iterator pitEntries =
+    pit_.begin();
+  while (pitEntries != pit_.end()) {
+    vector<ptr_lib::shared_ptr<PitEntry> >& entries = pitEntries->second;
+    for (size_t i = 0; i < entries.size();) {
+      if (nowMilliseconds >= entries[i]->expirationTime_) {
+        entries.erase(entries.begin() + i);
+        --pitSize_;
+      }
+      else {
+        if (nextPitExpirationTime_ < 0 ||
+            entries[i]->expirationTime_ < nextPitExpirationTime_)
+          nextPitExpirationTime_ = entries[i]->expirationTime_;
+        ++i;
+      }
+    }
+
+    if (entries.size() == 0)
+      pit_.erase(pitEntries++);
+    else
+      ++pitEntries;
+  }
+}
+
+bool
+LoopbackForwarder::selectorsEqual
+  (const Interest& interest1, const Interest& interest2)
+{
+  return interest1.getMinSuffixComponents() ==
+           interest2.getMinSuffixComponents() &&
+         interest1.getMaxSuffixComponents() ==
+           interest2.getMaxSuffixComponents() &&
+         interest1.getChildSelector() == interest2.getChildSelector() &&
+         interest1.getMustBeFresh() == interest2.getMustBeFresh() &&
+         interest1.getExclude().toUri() == interest2.getExclude().toUri();
+}
+
+}
@@ -54,7 +54,7 @@ MemoryContentCache::Impl::registerPrefix
    const OnInterestCallback& onDataNotFound,
    const ForwardingFlags& flags, WireFormat& wireFormat)
 {
-  onDataNotFoundForPrefix_[prefix.toUri()] = onDataNotFound;
+  onDataNotFoundForPrefix_[prefix] = onDataNotFound;
   uint64_t registeredPrefixId = face_->registerPrefix
     (prefix,
      bind(&MemoryContentCache::Impl::onInterest, shared_from_this(), _1, _2, _3, _4, _5),
@@ -67,7 +67,7 @@ void
 MemoryContentCache::Impl::setInterestFilter
   (const InterestFilter& filter, const OnInterestCallback& onDataNotFound)
 {
-  onDataNotFoundForPrefix_[filter.getPrefix().toUri()] = onDataNotFound;
+  onDataNotFoundForPrefix_[filter.getPrefix()] = onDataNotFound;
   uint64_t interestFilterId = face_->setInterestFilter
     (filter,
      bind(&MemoryContentCache::Impl::onInterest, shared_from_this(), _1, _2, _3, _4, _5));
@@ -79,7 +79,7 @@ void
 MemoryContentCache::Impl::setInterestFilter
   (const Name& prefix, const OnInterestCallback& onDataNotFound)
 {
-  onDataNotFoundForPrefix_[prefix.toUri()] = onDataNotFound;
+  onDataNotFoundForPrefix_[prefix] = onDataNotFound;
   uint64_t interestFilterId = face_->setInterestFilter
     (prefix,
      bind(&MemoryContentCache::Impl::onInterest, shared_from_this(), _1, _2, _3, _4, _5));
@@ -268,8 +268,8 @@ MemoryContentCache::Impl::onInterest
     face.send(*selectedEncoding);
   else {
     // Call the onDataNotFound callback (if defined).
-    map<string, OnInterestCallback>::iterator onDataNotFound =
-      onDataNotFoundForPrefix_.find(prefix->toUri());
+    OnDataNotFoundMap::iterator onDataNotFound =
+      onDataNotFoundForPrefix_.find(*prefix);
     if (onDataNotFound != onDataNotFoundForPrefix_.end() &&
         onDataNotFound->second) {
       try {
@@ -0,0 +1,305 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2018 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+#include <time.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <stdexcept>
+#include "../c/util/time.h"
+#include <ndn-cpp/util/packet-trace.hpp>
+
+using namespace std;
+
+namespace ndn {
+
+#if defined(__GNUC__)
+
+/**
+ * A PacketTraceThreadBuffer is the ring buffer of one thread. Only the owning
+ * thread writes the records and head_. Other threads read head_ to copy the
+ * records.
+ */
+class PacketTraceThreadBuffer {
+public:
+  PacketTraceThreadBuffer(size_t capacity, uint32_t threadIndex)
+  : records_(capacity), mask_(capacity - 1), head_(0), clearedHead_(0),
+    threadIndex_(threadIndex)
+  {
+  }
+
+  std::vector<PacketTrace::Record> records_;
+  uint64_t mask_;
+  // The number of records written so far, which only increases.
+  uint64_t head_;
+  // Don't return records before this index.
+  uint64_t clearedHead_;
+  uint32_t threadIndex_;
+};
+
+// The ring buffer of the calling thread, or null if not registered yet.
+static __thread PacketTraceThreadBuffer* threadBuffer = 0;
+
+// The buffers of all threads. A buffer is kept after its thread exits so that
+// its records can still be dumped.
+static std::vector<PacketTraceThreadBuffer*>* allBuffers = 0;
+// A spin lock for allBuffers, only taken when a thread registers its buffer
+// and when reading the records.
+static bool allBuffersLock = false;
+static size_t bufferCapacity = 16384;
+
+static void
+lockAllBuffers()
+{
+  while (__atomic_test_and_set(&allBuffersLock, __ATOMIC_ACQUIRE))
+    ;
+}
+
+static void
+unlockAllBuffers()
+{
+  __atomic_clear(&allBuffersLock, __ATOMIC_RELEASE);
+}
+
+static PacketTraceThreadBuffer*
+registerThread()
+{
+  lockAllBuffers();
+  if (!allBuffers)
+    allBuffers = new std::vector<PacketTraceThreadBuffer*>();
+  threadBuffer = new PacketTraceThreadBuffer(bufferCapacity, allBuffers->size());
+  allBuffers->push_back(threadBuffer);
+  unlockAllBuffers();
+
+  return threadBuffer;
+}
+
+static uint64_t
+getNowNanoseconds()
+{
+#ifdef CLOCK_MONOTONIC
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+#else
+  return (uint64_t)(ndn_getNowMilliseconds() * 1000000.0);
+#endif
+}
+
+static bool
+recordIsEarlier(const PacketTrace::Record& x, const PacketTrace::Record& y)
+{
+  return x.timestampNanoseconds < y.timestampNanoseconds;
+}
+
+void
+PacketTrace::record(EventType eventType, uint64_t value, uint64_t nameHash)
+{
+  PacketTraceThreadBuffer* buffer = threadBuffer;
+  if (!buffer)
+    buffer = registerThread();
+
+  // Only this thread changes head_, so we don't need an atomic read.
+  uint64_t head = buffer->head_;
+  Record& record = buffer->records_[head & buffer->mask_];
+  record.timestampNanoseconds = getNowNanoseconds();
+  record.nameHash = nameHash;
+  record.value = value;
+  record.threadIndex = buffer->threadIndex_;
+  record.eventType = (uint16_t)eventType;
+  record.reserved = 0;
+
+  // Publish the record to readers.
+  __atomic_store_n(&buffer->head_, head + 1, __ATOMIC_RELEASE);
+}
+
+void
+PacketTrace::getRecords(vector<Record>& records)
+{
+  records.clear();
+
+  lockAllBuffers();
+  if (allBuffers) {
+    for (size_t i = 0; i < allBuffers->size(); ++i) {
+      PacketTraceThreadBuffer& buffer = *(*allBuffers)[i];
+      uint64_t capacity = buffer.records_.size();
+
+      uint64_t head = __atomic_load_n(&buffer.head_, __ATOMIC_ACQUIRE);
+      uint64_t start = head > capacity ? head - capacity : 0;
+      uint64_t clearedHead = __atomic_load_n
+        (&buffer.clearedHead_, __ATOMIC_RELAXED);
+      if (start < clearedHead)
+        start = clearedHead;
+
+      size_t firstNew = records.size();
+      for (uint64_t index = start; index < head; ++index)
+        records.push_back(buffer.records_[index & buffer.mask_]);
+
+      // The writer may have overwritten the oldest records while we copied,
+      // including the slot which it is writing now, so drop them.
+      __atomic_thread_fence(__ATOMIC_ACQUIRE);
+      uint64_t newHead = __atomic_load_n(&buffer.head_, __ATOMIC_ACQUIRE);
+      if (newHead + 1 > capacity && newHead + 1 - capacity > start) {
+        uint64_t nOverwritten = newHead + 1 - capacity - start;
+        if (nOverwritten > head - start)
+          nOverwritten = head - start;
+        records.erase
+          (records.begin() + firstNew,
+           records.begin() + firstNew + (size_t)nOverwritten);
+      }
+    }
+  }
+  unlockAllBuffers();
+
+  stable_sort(records.begin(), records.end(), recordIsEarlier);
+}
+
+void
+PacketTrace::clear()
+{
+  lockAllBuffers();
+  if (allBuffers) {
+    for (size_t i = 0; i < allBuffers->size(); ++i) {
+      PacketTraceThreadBuffer& buffer = *(*allBuffers)[i];
+      __atomic_store_n
+        (&buffer.clearedHead_, __atomic_load_n(&buffer.head_, __ATOMIC_ACQUIRE),
+         __ATOMIC_RELAXED);
+    }
+  }
+  unlockAllBuffers();
+}
+
+void
+PacketTrace::setBufferCapacity(size_t capacity)
+{
+  size_t powerOf2 = 1;
+  while (powerOf2 < capacity)
+    powerOf2 <<= 1;
+
+  lockAllBuffers();
+  bufferCapacity = powerOf2;
+  unlockAllBuffers();
+}
+
+size_t
+PacketTrace::getBufferCapacity()
+{
+  lockAllBuffers();
+  size_t capacity = bufferCapacity;
+  unlockAllBuffers();
+
+  return capacity;
+}
+
+#else // __GNUC__
+
+void
+PacketTrace::record(EventType eventType, uint64_t value, uint64_t nameHash)
+{
+}
+
+void
+PacketTrace::getRecords(vector<Record>& records)
+{
+  records.clear();
+}
+
+void
+PacketTrace::clear()
+{
+}
+
+void
+PacketTrace::setBufferCapacity(size_t capacity)
+{
+}
+
+size_t
+PacketTrace::getBufferCapacity() { return 0; }
+
+#endif // __GNUC__
+
+static const char* DUMP_MAGIC = "NDNTRACE";
+static const uint32_t DUMP_VERSION = 1;
+
+void
+PacketTrace::dump(const string& filePath)
+{
+  vector<Record> records;
+  getRecords(records);
+
+  FILE* file = fopen(filePath.c_str(), "wb");
+  if (!file)
+    throw runtime_error("PacketTrace::dump: Cannot open file " + filePath);
+
+  uint32_t recordSize = sizeof(Record);
+  bool success =
+    fwrite(DUMP_MAGIC, 1, 8, file) == 8 &&
+    fwrite(&DUMP_VERSION, sizeof(DUMP_VERSION), 1, file) == 1 &&
+    fwrite(&recordSize, sizeof(recordSize), 1, file) == 1 &&
+    (records.size() == 0 ||
+     fwrite(&records[0], sizeof(Record), records.size(), file) ==
+       records.size());
+  if (fclose(file) != 0)
+    success = false;
+  if (!success)
+    throw runtime_error("PacketTrace::dump: Error writing file " + filePath);
+}
+
+void
+PacketTrace::readFile(const string& filePath, vector<Record>& records)
+{
+  records.clear();
+
+  FILE* file = fopen(filePath.c_str(), "rb");
+  if (!file)
+    throw runtime_error("PacketTrace::readFile: Cannot open file " + filePath);
+
+  char magic[8];
+  uint32_t version;
+  uint32_t recordSize;
+  if (fread(magic, 1, 8, file) != 8 || memcmp(magic, DUMP_MAGIC, 8) != 0 ||
+      fread(&version, sizeof(version), 1, file) != 1 ||
+      version != DUMP_VERSION ||
+      fread(&recordSize, sizeof(recordSize), 1, file) != 1 ||
+      recordSize != sizeof(Record)) {
+    fclose(file);
+    throw runtime_error
+      ("PacketTrace::readFile: Not a packet trace dump file " + filePath);
+  }
+
+  Record record;
+  while (fread(&record, sizeof(record), 1, file) == 1)
+    records.push_back(record);
+  fclose(file);
+}
+
+bool
+PacketTrace::isEnabled()
+{
+#if NDN_CPP_WITH_PACKET_TRACE
+  return true;
+#else
+  return false;
+#endif
+}
+
+}
@@ -0,0 +1,112 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2018 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+// Only compile if ndn-cpp-config.h defines NDN_CPP_HAVE_BOOST_ASIO.
+#include <ndn-cpp/ndn-cpp-config.h>
+#ifdef NDN_CPP_HAVE_BOOST_ASIO
+
+#include <algorithm>
+#include <boost/atomic.hpp>
+#include <boost/bind.hpp>
+#include <ndn-cpp/util/logging.hpp>
+#include "parallel-tasks.hpp"
+
+using namespace std;
+
+INIT_LOGGER("ndn.ParallelTasks");
+
+namespace ndn {
+
+/**
+ * A ParallelTasks::Countdown holds the functions of one call to post and the
+ * number of tasks which are not yet finished.
+ */
+class ParallelTasks::Countdown {
+public:
+  Countdown(const Task& task, const OnFinished& onFinished)
+  : task_(task), onFinished_(onFinished), remainingTasks_(0)
+  {
+  }
+
+  Task task_;
+  OnFinished onFinished_;
+  boost::atomic<size_t> remainingTasks_;
+};
+
+void
+ParallelTasks::post
+  (boost::asio::io_service& ioService, size_t nItems, size_t maxTaskSize,
+   const Task& task, const OnFinished& onFinished)
+{
+  if (maxTaskSize == 0)
+    maxTaskSize = 1;
+  ptr_lib::shared_ptr<Countdown> countdown(new Countdown(task, onFinished));
+
+  size_t nTasks = (nItems + maxTaskSize - 1) / maxTaskSize;
+  if (nTasks == 0) {
+    ioService.post(boost::bind(&ParallelTasks::finish, countdown));
+    return;
+  }
+
+  // Set the count before posting any task. Otherwise the first task could
+  // finish and count down to zero before the others are posted.
+  countdown->remainingTasks_ = nTasks;
+  for (size_t begin = 0; begin < nItems; begin += maxTaskSize)
+    ioService.post(boost::bind
+      (&ParallelTasks::runTask, countdown, begin,
+       min(begin + maxTaskSize, nItems)));
+}
+
+void
+ParallelTasks::runTask
+  (const ptr_lib::shared_ptr<Countdown>& countdown, size_t begin, size_t end)
+{
+  // An exception must not escape to the io_service. Otherwise this task would
+  // not count down and onFinished would never be called.
+  try {
+    countdown->task_(begin, end);
+  } catch (const std::exception& ex) {
+    _LOG_ERROR("ParallelTasks: Error in task: " << ex.what());
+  } catch (...) {
+    _LOG_ERROR("ParallelTasks: Error in task.");
+  }
+
+  // fetch_sub is a release/acquire operation, so the task which counts down
+  // to zero sees the results written by all the other tasks.
+  if (countdown->remainingTasks_.fetch_sub(1) == 1)
+    finish(countdown);
+}
+
+void
+ParallelTasks::finish(const ptr_lib::shared_ptr<Countdown>& countdown)
+{
+  try {
+    countdown->onFinished_();
+  } catch (const std::exception& ex) {
+    _LOG_ERROR("ParallelTasks: Error in onFinished: " << ex.what());
+  } catch (...) {
+    _LOG_ERROR("ParallelTasks: Error in onFinished.");
+  }
+}
+
+}
+
+#endif // NDN_CPP_HAVE_BOOST_ASIO
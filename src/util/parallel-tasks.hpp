@@ -0,0 +1,90 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2018 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+#ifndef NDN_PARALLEL_TASKS_HPP
+#define NDN_PARALLEL_TASKS_HPP
+
+// Only compile if ndn-cpp-config.h defines NDN_CPP_HAVE_BOOST_ASIO.
+#include <ndn-cpp/ndn-cpp-config.h>
+#ifdef NDN_CPP_HAVE_BOOST_ASIO
+
+#include <boost/asio.hpp>
+#include <ndn-cpp/common.hpp>
+
+namespace ndn {
+
+/**
+ * ParallelTasks has a static method to split the indexes of a batch of items
+ * into tasks which are posted to an io_service, and to call a function once
+ * after the last task finishes. This is used by BatchSigner, BatchVerifier and
+ * GroupManager. The threads which call run() on the io_service set how many
+ * tasks run at the same time.
+ */
+class ParallelTasks {
+public:
+  /**
+   * A Task function object is called as task(begin, end) to process the items
+   * in the range [begin, end). Different tasks get different ranges, so they
+   * can write the results for their own items without a lock.
+   */
+  typedef func_lib::function<void(size_t begin, size_t end)> Task;
+
+  /**
+   * An OnFinished function object is called as onFinished() after all the
+   * tasks are finished. It is called in the thread of the last task, and it
+   * sees all the results written by the tasks.
+   */
+  typedef func_lib::function<void()> OnFinished;
+
+  /**
+   * Split the range [0, nItems) into ranges of at most maxTaskSize items and
+   * post a call to task for each to ioService. If a task throws an exception,
+   * this logs it and still counts the task as finished, so that onFinished is
+   * always called. If nItems is zero, this posts onFinished to ioService.
+   * @param ioService The asio io_service for the tasks.
+   * @param nItems The number of items.
+   * @param maxTaskSize The maximum number of items for one task. If zero, use
+   * one.
+   * @param task The function object to process a range of items.
+   * @param onFinished The function object to call after all the tasks.
+   */
+  static void
+  post
+    (boost::asio::io_service& ioService, size_t nItems, size_t maxTaskSize,
+     const Task& task, const OnFinished& onFinished);
+
+private:
+  class Countdown;
+
+  static void
+  runTask
+    (const ptr_lib::shared_ptr<Countdown>& countdown, size_t begin,
+     size_t end);
+
+  static void
+  finish(const ptr_lib::shared_ptr<Countdown>& countdown);
+};
+
+}
+
+#endif // NDN_CPP_HAVE_BOOST_ASIO
+
+#endif
@@ -31,16 +31,69 @@ using namespace std;
 
 namespace ndn {
 
+Sqlite3StatementCache::~Sqlite3StatementCache()
+{
+#if NDN_CPP_HAVE_STD_UNORDERED_MAP
+  for (unordered_map<string, StatementList>::iterator
+#else
+  for (map<string, StatementList>::iterator
+#endif
+         entry = statements_.begin(); entry != statements_.end(); ++entry) {
+    for (size_t i = 0; i < entry->second.size(); ++i)
+      sqlite3_finalize(entry->second[i]);
+  }
+}
+
+size_t
+Sqlite3StatementCache::size() const
+{
+  size_t result = 0;
+#if NDN_CPP_HAVE_STD_UNORDERED_MAP
+  for (unordered_map<string, StatementList>::const_iterator
+#else
+  for (map<string, StatementList>::const_iterator
+#endif
+         entry = statements_.begin(); entry != statements_.end(); ++entry)
+    result += entry->second.size();
+
+  return result;
+}
+
 Sqlite3Statement::Sqlite3Statement(sqlite3* database, const string& statement)
+: freeList_(0)
 {
   int result = sqlite3_prepare_v2(database, statement.c_str(), -1, &statement_, 0);
   if (result != SQLITE_OK)
     throw domain_error("Error preparing SQL statement: " + statement);
 }
 
+Sqlite3Statement::Sqlite3Statement
+  (Sqlite3StatementCache& cache, const string& statement)
+{
+  // The list stays valid since the cache never erases an entry.
+  freeList_ = &cache.statements_[statement];
+  if (!freeList_->empty()) {
+    statement_ = freeList_->back();
+    freeList_->pop_back();
+    return;
+  }
+
+  int result = sqlite3_prepare_v2
+    (cache.database_, statement.c_str(), -1, &statement_, 0);
+  if (result != SQLITE_OK)
+    throw domain_error("Error preparing SQL statement: " + statement);
+}
+
 Sqlite3Statement::~Sqlite3Statement()
 {
-  sqlite3_finalize(statement_);
+  if (freeList_) {
+    // Reset so that the statement doesn't hold a lock on the database.
+    sqlite3_reset(statement_);
+    sqlite3_clear_bindings(statement_);
+    freeList_->push_back(statement_);
+  }
+  else
+    sqlite3_finalize(statement_);
 }
 
 }
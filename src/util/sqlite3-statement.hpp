@@ -28,11 +28,109 @@
 #ifdef NDN_CPP_HAVE_SQLITE3
 
 #include <string>
+#include <vector>
+#include <map>
 #include <sqlite3.h>
 #include <ndn-cpp/util/blob.hpp>
+#if NDN_CPP_HAVE_STD_UNORDERED_MAP
+#include <unordered_map>
+#endif
 
 namespace ndn {
 
+/**
+ * An Sqlite3StatementCache keeps the prepared statements for one SQLite3
+ * database connection so that an Sqlite3Statement created with the cache reuses
+ * the statement instead of preparing the SQL again. The owner of the database
+ * connection should destroy the cache before closing the connection. This also
+ * has methods for transactions on the connection. This is not thread safe.
+ */
+class Sqlite3StatementCache
+{
+public:
+  /**
+   * Create an Sqlite3StatementCache for the database connection.
+   * @param database The handle to the open SQLite3 database.
+   */
+  Sqlite3StatementCache(sqlite3* database)
+  : database_(database)
+  {
+  }
+
+  /**
+   * Finalize all the cached statements.
+   */
+  ~Sqlite3StatementCache();
+
+  /**
+   * Get the database connection given to the constructor.
+   * @return The handle to the SQLite3 database.
+   */
+  sqlite3*
+  getDatabase() { return database_; }
+
+  /**
+   * Begin a transaction with "BEGIN IMMEDIATE". The following statements on
+   * the connection are not written until commitTransaction().
+   * @return SQLite result value. This is not SQLITE_OK if a transaction is
+   * already in progress.
+   */
+  int
+  beginTransaction() { return execute("BEGIN IMMEDIATE"); }
+
+  /**
+   * Commit the transaction started by beginTransaction().
+   * @return SQLite result value.
+   */
+  int
+  commitTransaction() { return execute("COMMIT"); }
+
+  /**
+   * Roll back the transaction started by beginTransaction().
+   * @return SQLite result value.
+   */
+  int
+  rollbackTransaction() { return execute("ROLLBACK"); }
+
+  /**
+   * Get the number of prepared statements which are in the cache and not in
+   * use.
+   * @return The number of statements.
+   */
+  size_t
+  size() const;
+
+private:
+  friend class Sqlite3Statement;
+
+  /**
+   * Wrap sqlite3_exec to run the SQL without a callback.
+   * @param sql The SQL to run.
+   * @return SQLite result value.
+   */
+  int
+  execute(const char* sql)
+  {
+    return sqlite3_exec(database_, sql, 0, 0, 0);
+  }
+
+  // Disable the copy constructor and assignment operator.
+  Sqlite3StatementCache(const Sqlite3StatementCache& other);
+  Sqlite3StatementCache& operator=(const Sqlite3StatementCache& other);
+
+  typedef std::vector<sqlite3_stmt*> StatementList;
+
+  sqlite3* database_;
+  // The key is the SQL. The value is the list of prepared statements which are
+  // not in use. There is usually at most one, but a method may use the same SQL
+  // while iterating over the results.
+#if NDN_CPP_HAVE_STD_UNORDERED_MAP
+  std::unordered_map<std::string, StatementList> statements_;
+#else
+  std::map<std::string, StatementList> statements_;
+#endif
+};
+
 /*
  * Sqlite3Statement is a utility class to wrap an SQLite3 prepared statement,
  * provide access methods, and finalize the statement in the destructor.
@@ -49,7 +147,18 @@ public:
   Sqlite3Statement(sqlite3* database, const std::string& statement);
 
   /**
-   * Finalize the statement.
+   * Create an Sqlite3Statement which uses a prepared statement from the cache,
+   * or prepares the SQLite3 statement if the cache doesn't have one. The cache
+   * must remain valid during the life of this object.
+   * @param cache The Sqlite3StatementCache of the database connection.
+   * @param statement The SQL statement to prepare.
+   * @throws std::domain_error SQL statement is bad
+   */
+  Sqlite3Statement(Sqlite3StatementCache& cache, const std::string& statement);
+
+  /**
+   * If this was created with an Sqlite3StatementCache, reset the statement and
+   * return it to the cache. Otherwise, finalize the statement.
    */
   ~Sqlite3Statement();
 
@@ -186,6 +295,9 @@ private:
   Sqlite3Statement& operator=(const Sqlite3Statement& other);
 
   sqlite3_stmt* statement_;
+  // freeList_ is the list in the Sqlite3StatementCache which receives the
+  // statement in the destructor, or null if this is not from a cache.
+  Sqlite3StatementCache::StatementList* freeList_;
 };
 
 }
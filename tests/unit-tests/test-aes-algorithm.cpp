@@ -22,6 +22,7 @@
 
 #include "gtest/gtest.h"
 #include <ndn-cpp/encrypt/algo/aes-algorithm.hpp>
+#include <ndn-cpp/encrypt/algo/aes-stream-cipher.hpp>
 
 using namespace std;
 using namespace ndn;
@@ -121,6 +122,102 @@ TEST_F(TestAesAlgorithm, KeyGeneration)
   ASSERT_TRUE(receivedBlob.equals(plainBlob));
 }
 
+/**
+ * Concatenate the Blobs.
+ */
+static Blob
+concatenate(const vector<Blob>& blobs)
+{
+  vector<uint8_t> result;
+  for (size_t i = 0; i < blobs.size(); ++i)
+    result.insert(result.end(), blobs[i].buf(), blobs[i].buf() + blobs[i].size());
+  return Blob(result);
+}
+
+TEST_F(TestAesAlgorithm, StreamCbc)
+{
+  Blob key(KEY, sizeof(KEY));
+  Blob initialVector(INITIAL_VECTOR, sizeof(INITIAL_VECTOR));
+
+  // Encrypt in parts which don't align with the block size.
+  AesStreamCipher encryptor
+    (AesStreamCipher::MODE_CBC, true, key, initialVector);
+  vector<Blob> parts;
+  parts.push_back(encryptor.update(Blob(PLAINTEXT, 5)));
+  parts.push_back(encryptor.update(Blob(PLAINTEXT + 5, sizeof(PLAINTEXT) - 5)));
+  parts.push_back(encryptor.finish());
+  ASSERT_TRUE(concatenate(parts).equals
+              (Blob(CIPHERTEXT_CBC_IV, sizeof(CIPHERTEXT_CBC_IV))));
+
+  // Decrypt one byte at a time.
+  AesStreamCipher decryptor
+    (AesStreamCipher::MODE_CBC, false, key, initialVector);
+  parts.clear();
+  for (size_t i = 0; i < sizeof(CIPHERTEXT_CBC_IV); ++i)
+    parts.push_back(decryptor.update(Blob(CIPHERTEXT_CBC_IV + i, 1)));
+  parts.push_back(decryptor.finish());
+  ASSERT_TRUE(concatenate(parts).equals(Blob(PLAINTEXT, sizeof(PLAINTEXT))));
+  ASSERT_THROW(decryptor.update(Blob(PLAINTEXT, 1)), runtime_error);
+
+  // Reset with the same key and compare with AesAlgorithm.
+  EncryptParams params(ndn_EncryptAlgorithmType_AesCbc, 16);
+  Blob largePlainText(vector<uint8_t>(1000, 0x5a));
+  encryptor.reset(params.getInitialVector());
+  parts.clear();
+  parts.push_back(encryptor.update(largePlainText));
+  parts.push_back(encryptor.finish());
+  ASSERT_TRUE(concatenate(parts).equals
+              (AesAlgorithm::encrypt(key, largePlainText, params)));
+
+  ASSERT_THROW
+    (AesStreamCipher(AesStreamCipher::MODE_CBC, true, Blob(KEY, 10),
+                     initialVector),
+     invalid_argument);
+  ASSERT_THROW
+    (AesStreamCipher(AesStreamCipher::MODE_CBC, true, key, Blob(KEY, 12)),
+     invalid_argument);
+}
+
+TEST_F(TestAesAlgorithm, StreamGcm)
+{
+  // The test case 2 from the GCM specification.
+  Blob key(vector<uint8_t>(16, 0));
+  Blob initialVector(vector<uint8_t>(AesStreamCipher::GCM_IV_SIZE, 0));
+  Blob plainText(vector<uint8_t>(16, 0));
+  uint8_t cipherText[] = {
+    0x03, 0x88, 0xda, 0xce, 0x60, 0xb6, 0xa3, 0x92,
+    0xf3, 0x28, 0xc2, 0xb9, 0x71, 0xb2, 0xfe, 0x78
+  };
+  uint8_t tag[] = {
+    0xab, 0x6e, 0x47, 0xd4, 0x2c, 0xec, 0x13, 0xbd,
+    0xf5, 0x3a, 0x67, 0xb2, 0x12, 0x57, 0xbd, 0xdf
+  };
+
+  AesStreamCipher encryptor
+    (AesStreamCipher::MODE_GCM, true, key, initialVector);
+  vector<Blob> parts;
+  parts.push_back(encryptor.update(Blob(plainText.buf(), 7)));
+  parts.push_back(encryptor.update(Blob(plainText.buf() + 7, 9)));
+  parts.push_back(encryptor.finish());
+  ASSERT_TRUE(concatenate(parts).equals(Blob(cipherText, sizeof(cipherText))));
+  ASSERT_TRUE(encryptor.getTag().equals(Blob(tag, sizeof(tag))));
+
+  AesStreamCipher decryptor
+    (AesStreamCipher::MODE_GCM, false, key, initialVector);
+  parts.clear();
+  parts.push_back(decryptor.update(Blob(cipherText, sizeof(cipherText))));
+  decryptor.setTag(Blob(tag, sizeof(tag)));
+  parts.push_back(decryptor.finish());
+  ASSERT_TRUE(concatenate(parts).equals(plainText));
+
+  // A modified cipher text should not verify.
+  cipherText[0] ^= 1;
+  decryptor.reset(initialVector);
+  decryptor.update(Blob(cipherText, sizeof(cipherText)));
+  decryptor.setTag(Blob(tag, sizeof(tag)));
+  ASSERT_THROW(decryptor.finish(), runtime_error);
+}
+
 int
 main(int argc, char **argv)
 {
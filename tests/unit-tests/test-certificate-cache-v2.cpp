@@ -0,0 +1,125 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2018 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+#include "gtest/gtest.h"
+#include "identity-management-fixture.hpp"
+#include <ndn-cpp/security/v2/certificate-cache-v2.hpp>
+
+using namespace std;
+using namespace ndn;
+
+class TestCertificateCacheV2 : public ::testing::Test {
+public:
+  TestCertificateCacheV2()
+  : certificateCache_(1000.0)
+  {
+    identity_ = fixture_.addIdentity("/TestCertificateCacheV2");
+    key_ = identity_->getDefaultKey();
+    certificate_ = key_->getDefaultCertificate();
+  }
+
+  IdentityManagementFixture fixture_;
+  CertificateCacheV2 certificateCache_;
+  ptr_lib::shared_ptr<PibIdentity> identity_;
+  ptr_lib::shared_ptr<PibKey> key_;
+  ptr_lib::shared_ptr<CertificateV2> certificate_;
+};
+
+TEST_F(TestCertificateCacheV2, Expiry)
+{
+  ptr_lib::shared_ptr<CertificateV2> certificate2 =
+    fixture_.addCertificate(key_, "2");
+  certificateCache_.insert(*certificate_);
+  certificateCache_.setNowOffsetMilliseconds_(500.0);
+  certificateCache_.insert(*certificate2);
+  ASSERT_EQ(2, certificateCache_.size());
+
+  // The first certificate is removed after the maximum lifetime.
+  certificateCache_.setNowOffsetMilliseconds_(1200.0);
+  ASSERT_TRUE(!certificateCache_.find(certificate_->getName()));
+  ASSERT_TRUE(!!certificateCache_.find(certificate2->getName()));
+  ASSERT_EQ(1, certificateCache_.size());
+
+  certificateCache_.setNowOffsetMilliseconds_(1600.0);
+  ASSERT_TRUE(!certificateCache_.find(certificate2->getName()));
+  ASSERT_EQ(0, certificateCache_.size());
+
+  // Re-inserting resets the removal time.
+  certificateCache_.insert(*certificate_);
+  certificateCache_.setNowOffsetMilliseconds_(2000.0);
+  certificateCache_.insert(*certificate_);
+  certificateCache_.setNowOffsetMilliseconds_(2700.0);
+  ASSERT_TRUE(!!certificateCache_.find(certificate_->getName()));
+}
+
+TEST_F(TestCertificateCacheV2, ImplicitDigest)
+{
+  certificateCache_.insert(*certificate_);
+  Name fullName = *certificate_->getFullName();
+
+  ASSERT_EQ(certificate_->getName(),
+            certificateCache_.find(fullName)->getName());
+  ASSERT_EQ(certificate_->getName(),
+            certificateCache_.find(Interest(fullName))->getName());
+
+  // A different digest doesn't match.
+  Name otherFullName(certificate_->getName());
+  otherFullName.appendImplicitSha256Digest
+    (Blob(vector<uint8_t>(ndn_SHA256_DIGEST_SIZE, 0)));
+  ASSERT_TRUE(!certificateCache_.find(otherFullName));
+  ASSERT_TRUE(!certificateCache_.find(Interest(otherFullName)));
+}
+
+TEST_F(TestCertificateCacheV2, Capacity)
+{
+  ptr_lib::shared_ptr<CertificateV2> certificate2 =
+    fixture_.addCertificate(key_, "2");
+  ptr_lib::shared_ptr<CertificateV2> certificate3 =
+    fixture_.addCertificate(key_, "3");
+
+  certificateCache_.setCapacity(2);
+  certificateCache_.insert(*certificate_);
+  certificateCache_.insert(*certificate2);
+  // Use the first certificate so that the second is the least recently used.
+  ASSERT_TRUE(!!certificateCache_.find(certificate_->getName()));
+  certificateCache_.insert(*certificate3);
+
+  ASSERT_EQ(2, certificateCache_.size());
+  ASSERT_TRUE(!!certificateCache_.find(certificate_->getName()));
+  ASSERT_TRUE(!certificateCache_.find(certificate2->getName()));
+  ASSERT_TRUE(!!certificateCache_.find(certificate3->getName()));
+
+  // Reducing the capacity removes the least recently used.
+  certificateCache_.setCapacity(1);
+  ASSERT_EQ(1, certificateCache_.size());
+  ASSERT_TRUE(!!certificateCache_.find(certificate3->getName()));
+
+  certificateCache_.setCapacity(0);
+  certificateCache_.insert(*certificate_);
+  ASSERT_EQ(0, certificateCache_.size());
+}
+
+int
+main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -62,7 +62,7 @@ class TestConsumerDb : public ::testing::Test {
 public:
   TestConsumerDb()
   {
-    databaseFilePath = getPolicyConfigDirectory() + "/test.db";
+    databaseFilePath = getPolicyConfigDirectory() + "/consumer-db-test.db";
     remove(databaseFilePath.c_str());
   }
 
@@ -188,7 +188,7 @@ public:
   {
     string policyConfigDirectory = getPolicyConfigDirectory();
 
-    databaseFilePath = policyConfigDirectory + "/test.db";
+    databaseFilePath = policyConfigDirectory + "/consumer-test.db";
     remove(databaseFilePath.c_str());
 
     groupName = Name("/Prefix/READ");
@@ -524,6 +524,127 @@ TEST_F(TestConsumer, ConsumerWithLink)
   ASSERT_EQ(1, finalCount);
 }
 
+TEST_F(TestConsumer, KeyCache)
+{
+  Consumer::KeyCache cache(2, 1000.0);
+  Blob keyBits;
+
+  cache.insert(Name("/key1"), Blob(Name("/bits1").wireEncode()));
+  cache.insert(Name("/key2"), Blob(Name("/bits2").wireEncode()));
+  ASSERT_TRUE(cache.find(Name("/key1"), keyBits));
+  ASSERT_TRUE(keyBits.equals(Blob(Name("/bits1").wireEncode())));
+
+  // /key2 is the least recently used, so inserting /key3 evicts it.
+  cache.insert(Name("/key3"), Blob(Name("/bits3").wireEncode()));
+  ASSERT_EQ(2, cache.size());
+  ASSERT_FALSE(cache.find(Name("/key2"), keyBits));
+  ASSERT_TRUE(cache.find(Name("/key1"), keyBits));
+  ASSERT_TRUE(cache.find(Name("/key3"), keyBits));
+
+  cache.setCapacity(1);
+  ASSERT_EQ(1, cache.size());
+  ASSERT_TRUE(cache.find(Name("/key3"), keyBits));
+
+  // Simulate a time after the lifetime.
+  cache.setNowOffsetMilliseconds_(2000.0);
+  ASSERT_FALSE(cache.find(Name("/key3"), keyBits));
+  ASSERT_EQ(0, cache.size());
+
+  cache.setCapacity(0);
+  cache.insert(Name("/key1"), Blob(Name("/bits1").wireEncode()));
+  ASSERT_EQ(0, cache.size());
+}
+
+static void
+onConsumeCompleteCount
+  (const ptr_lib::shared_ptr<Data>& contentData, const Blob& result,
+   int* finalCount)
+{
+  ++(*finalCount);
+}
+
+TEST_F(TestConsumer, ConsumeWithPendingKeyFetch)
+{
+  ptr_lib::shared_ptr<Data> contentData = createEncryptedContent();
+  ptr_lib::shared_ptr<Data> cKeyData = createEncryptedCKey();
+  ptr_lib::shared_ptr<Data> dKeyData = createEncryptedDKey();
+
+  // Prepare a TestFace which instantly answers the content Interest, but saves
+  // the key Interests so that the test can answer them later.
+  class TestFace : public Face {
+  public:
+    TestFace(ptr_lib::shared_ptr<Data> contentData)
+    : Face("localhost"),
+      contentData_(contentData)
+    {}
+
+    virtual uint64_t
+    expressInterest
+      (const Interest& interest, const OnData& onData,
+       const OnTimeout& onTimeout, const OnNetworkNack& onNetworkNack,
+       WireFormat& wireFormat = *WireFormat::getDefaultWireFormat())
+    {
+      if (interest.matchesName(contentData_->getName()))
+        onData(ptr_lib::make_shared<Interest>(interest), contentData_);
+      else {
+        keyInterests_.push_back(ptr_lib::make_shared<Interest>(interest));
+        keyOnData_.push_back(onData);
+      }
+
+      return 0;
+    }
+
+    ptr_lib::shared_ptr<Data> contentData_;
+    vector<ptr_lib::shared_ptr<const Interest> > keyInterests_;
+    vector<OnData> keyOnData_;
+  };
+
+  TestFace face(contentData);
+
+  // Create the consumer.
+  Consumer consumer
+    (&face, keyChain.get(), groupName, uName,
+     ptr_lib::make_shared<Sqlite3ConsumerDb>(databaseFilePath));
+  consumer.addDecryptionKey(uKeyName, fixtureUDKeyBlob);
+
+  int finalCount = 0;
+  for (int i = 0; i < 3; ++i)
+    consumer.consume
+      (contentName, bind(&onConsumeCompleteCount, _1, _2, &finalCount),
+       bind(&TestConsumer::onError, this, _1, _2));
+
+  // All three wait for one C-KEY fetch.
+  ASSERT_EQ(1, face.keyInterests_.size());
+  ASSERT_TRUE(face.keyInterests_[0]->matchesName(cKeyData->getName()));
+  face.keyOnData_[0](face.keyInterests_[0], cKeyData);
+
+  // Decrypting the C-KEY needs one D-KEY fetch.
+  ASSERT_EQ(2, face.keyInterests_.size());
+  ASSERT_TRUE(face.keyInterests_[1]->matchesName(dKeyData->getName()));
+  ASSERT_EQ(0, finalCount);
+  face.keyOnData_[1](face.keyInterests_[1], dKeyData);
+  ASSERT_EQ(3, finalCount);
+
+  // The C-KEY is now cached.
+  consumer.consume
+    (contentName, bind(&onConsumeCompleteCount, _1, _2, &finalCount),
+     bind(&TestConsumer::onError, this, _1, _2));
+  ASSERT_EQ(2, face.keyInterests_.size());
+  ASSERT_EQ(4, finalCount);
+
+  // After the cached keys expire, they are fetched again.
+  consumer.setKeyCacheNowOffsetMilliseconds_
+    (Consumer::getDefaultKeyCacheLifetime() + 1000.0);
+  consumer.consume
+    (contentName, bind(&onConsumeCompleteCount, _1, _2, &finalCount),
+     bind(&TestConsumer::onError, this, _1, _2));
+  ASSERT_EQ(3, face.keyInterests_.size());
+  face.keyOnData_[2](face.keyInterests_[2], cKeyData);
+  ASSERT_EQ(4, face.keyInterests_.size());
+  face.keyOnData_[3](face.keyInterests_[3], dKeyData);
+  ASSERT_EQ(5, finalCount);
+}
+
 int
 main(int argc, char **argv)
 {
@@ -640,6 +640,16 @@ TEST_F(TestDataMethods, FullName)
   Name saveFullName(*data.getFullName());
   data.setContent(Blob());
   ASSERT_FALSE(data.getFullName()->get(-1).equals(saveFullName.get(-1)));
+
+  // Changing and re-encoding a copy should not keep the copied full name.
+  Data data2;
+  data2.wireDecode(codedData, sizeof(codedData));
+  saveFullName = *data2.getFullName();
+  Data data3(data2);
+  ASSERT_TRUE(data3.getFullName()->equals(saveFullName));
+  data3.setContent(Blob());
+  data3.wireEncode();
+  ASSERT_FALSE(data3.getFullName()->get(-1).equals(saveFullName.get(-1)));
 }
 
 
@@ -670,6 +680,53 @@ TEST_F(TestDataMethods, CongestionMark)
   ASSERT_EQ(1, data->getCongestionMark());
 }
 
+TEST_F(TestDataMethods, LazyDecode)
+{
+  Blob input(codedData, sizeof(codedData));
+  Data data;
+  data.wireDecodeLazy(input);
+  ASSERT_EQ(Name("/ndn/abc"), data.getName());
+  // The default wire encoding points to the input, so encoding doesn't need
+  // the other fields.
+  ASSERT_EQ(input.buf(), data.wireEncode().buf());
+  ASSERT_EQ
+    ("/ndn/abc/sha256digest="
+       "96556d685dcb1af04be4ae57f0e7223457d4055ea9b3d07c0d337bef4a8b3ee9",
+     data.getFullName()->toUri());
+
+  // Accessing the other fields decodes them and keeps the encoding.
+  ASSERT_EQ(dumpData(data), initialDump) << "Lazy decoded data does not match original dump";
+  ASSERT_EQ(input.buf(), data.getDefaultWireEncoding().buf());
+
+  // A copy decodes the fields from the same encoding.
+  Data data2;
+  data2.wireDecodeLazy(input);
+  Data data3(data2);
+  ASSERT_EQ(dumpData(data3), initialDump) << "Copy of lazy decoded data does not match original dump";
+
+  // Changing the name before decoding the other fields keeps the new name.
+  Data data4;
+  data4.wireDecodeLazy(input);
+  data4.getName().append("extra");
+  ASSERT_TRUE(data4.getContent().equals(data.getContent()));
+  ASSERT_EQ(Name("/ndn/abc/extra"), data4.getName());
+  ASSERT_TRUE(data4.getDefaultWireEncoding().isNull()) <<
+    "Changing the name should clear the default wire encoding";
+
+  // decodeLazyFields can be called on a const object before sharing it.
+  Data data6;
+  data6.wireDecodeLazy(input);
+  const Data& constData6 = data6;
+  constData6.decodeLazyFields();
+  ASSERT_EQ(input.buf(), constData6.getDefaultWireEncoding().buf());
+  ASSERT_EQ(dumpData(constData6), initialDump) << "Data after decodeLazyFields does not match original dump";
+
+  // The entire encoding is checked, not only the name. Truncate the packet.
+  Data data5;
+  ASSERT_THROW
+    (data5.wireDecodeLazy(codedData, sizeof(codedData) - 10), runtime_error);
+}
+
 int
 main(int argc, char **argv)
 {
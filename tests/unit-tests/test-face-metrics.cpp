@@ -0,0 +1,258 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2018 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+#include <unistd.h>
+#include "gtest/gtest.h"
+#include <ndn-cpp/security/key-chain.hpp>
+#include <ndn-cpp/security/verification-helpers.hpp>
+#include <ndn-cpp/util/loopback-forwarder.hpp>
+#include <ndn-cpp/util/latency-histogram.hpp>
+#include <ndn-cpp/face-metrics.hpp>
+
+using namespace std;
+using namespace ndn;
+using namespace ndn::func_lib;
+
+class MetricsCounter
+{
+public:
+  MetricsCounter()
+  : onDataCallCount_(0), onTimeoutCallCount_(0), onRegisterSuccessCallCount_(0)
+  {
+  }
+
+  void
+  onData(const ptr_lib::shared_ptr<const Interest>& interest,
+         const ptr_lib::shared_ptr<Data>& data)
+  {
+    ++onDataCallCount_;
+    data_ = data;
+  }
+
+  void
+  onTimeout(const ptr_lib::shared_ptr<const Interest>& interest)
+  {
+    ++onTimeoutCallCount_;
+  }
+
+  void
+  onRegisterFailed(const ptr_lib::shared_ptr<const Name>& prefix)
+  {
+  }
+
+  void
+  onRegisterSuccess
+    (const ptr_lib::shared_ptr<const Name>& prefix, uint64_t registeredPrefixId)
+  {
+    ++onRegisterSuccessCallCount_;
+  }
+
+  void
+  onInterest
+    (const ptr_lib::shared_ptr<const Name>& prefix,
+     const ptr_lib::shared_ptr<const Interest>& interest, Face& face,
+     uint64_t interestFilterId,
+     const ptr_lib::shared_ptr<const InterestFilter>& filter)
+  {
+    Data data(interest->getName());
+    data.setContent(Blob((const uint8_t*)"SUCCESS", 7));
+    keyChain_->signWithSha256(data);
+    face.putData(data);
+  }
+
+  int onDataCallCount_;
+  int onTimeoutCallCount_;
+  int onRegisterSuccessCallCount_;
+  ptr_lib::shared_ptr<Data> data_;
+  KeyChain* keyChain_;
+};
+
+TEST(TestLatencyHistogram, Empty)
+{
+  LatencyHistogram histogram;
+
+  ASSERT_EQ(0, histogram.getCount());
+  ASSERT_EQ(0, histogram.getMin());
+  ASSERT_EQ(0, histogram.getMax());
+  ASSERT_EQ(0.0, histogram.getMean());
+  ASSERT_EQ(0, histogram.getValueAtPercentile(99.0));
+}
+
+TEST(TestLatencyHistogram, Percentiles)
+{
+  LatencyHistogram histogram;
+  for (uint64_t value = 1; value <= 1000; ++value)
+    histogram.recordValue(value);
+
+  ASSERT_EQ(1000, histogram.getCount());
+  ASSERT_EQ(1, histogram.getMin());
+  ASSERT_EQ(1000, histogram.getMax());
+  ASSERT_DOUBLE_EQ(500.5, histogram.getMean());
+  // Small values are exact.
+  ASSERT_EQ(10, histogram.getValueAtPercentile(1.0));
+  // Larger values are within the bucket resolution of 1/16.
+  ASSERT_NEAR(500, histogram.getValueAtPercentile(50.0), 500 / 16);
+  ASSERT_NEAR(990, histogram.getValueAtPercentile(99.0), 990 / 16);
+  ASSERT_EQ(1000, histogram.getValueAtPercentile(100.0));
+
+  LatencyHistogram histogram2;
+  histogram2.recordValue(LatencyHistogram::getMaxTrackableValue() + 1000);
+  ASSERT_EQ(LatencyHistogram::getMaxTrackableValue(), histogram2.getMax());
+  histogram.add(histogram2);
+  ASSERT_EQ(1001, histogram.getCount());
+  ASSERT_EQ(LatencyHistogram::getMaxTrackableValue(),
+            histogram.getValueAtPercentile(100.0));
+
+  histogram.reset();
+  ASSERT_EQ(0, histogram.getCount());
+  ASSERT_EQ(0, histogram.getValueAtPercentile(50.0));
+}
+
+class TestFaceMetrics : public ::testing::Test {
+public:
+  TestFaceMetrics()
+  : keyChain("pib-memory:", "tpm-memory:")
+  {
+    keyChain.createIdentityV2(Name("/test/identity"), EcKeyParams());
+    consumer = forwarder.makeFace();
+    producer = forwarder.makeFace();
+    producer->setCommandSigningInfo
+      (keyChain, keyChain.getDefaultCertificateName());
+    producerCounter.keyChain_ = &keyChain;
+  }
+
+  /**
+   * Call processEvents on the forwarder and faces until count reaches expected
+   * or the loop runs too many times.
+   */
+  void
+  processEventsUntil(const int& count, int expected)
+  {
+    for (int i = 0; i < 1000 && count < expected; ++i) {
+      forwarder.processEvents();
+      consumer->processEvents();
+      producer->processEvents();
+      if (i > 100)
+        // Give time for an Interest to time out.
+        usleep(1000);
+    }
+  }
+
+  void
+  registerProducer(const Name& prefix, const OnInterestCallback& onInterest)
+  {
+    int expected = producerCounter.onRegisterSuccessCallCount_ + 1;
+    producer->registerPrefix
+      (prefix, onInterest,
+       bind(&MetricsCounter::onRegisterFailed, &producerCounter, _1),
+       bind(&MetricsCounter::onRegisterSuccess, &producerCounter, _1, _2));
+    processEventsUntil(producerCounter.onRegisterSuccessCallCount_, expected);
+    ASSERT_EQ(expected, producerCounter.onRegisterSuccessCallCount_) <<
+      "The forwarder did not answer the register command";
+  }
+
+  LoopbackForwarder forwarder;
+  KeyChain keyChain;
+  ptr_lib::shared_ptr<Face> consumer;
+  ptr_lib::shared_ptr<Face> producer;
+  MetricsCounter producerCounter;
+};
+
+TEST_F(TestFaceMetrics, Counters)
+{
+  registerProducer
+    (Name("/test/prefix"),
+     bind(&MetricsCounter::onInterest, &producerCounter, _1, _2, _3, _4, _5));
+
+  MetricsCounter counter;
+  const int nInterests = 5;
+  for (int i = 0; i < nInterests; ++i)
+    consumer->expressInterest
+      (Name("/test/prefix/data").appendSegment(i),
+       bind(&MetricsCounter::onData, &counter, _1, _2),
+       bind(&MetricsCounter::onTimeout, &counter, _1));
+  ASSERT_EQ(nInterests, consumer->getMetrics().getPendingInterestTableSize());
+  ASSERT_EQ(nInterests, consumer->getMetrics().getDelayedCallTableSize());
+  processEventsUntil(counter.onDataCallCount_, nInterests);
+  ASSERT_EQ(nInterests, counter.onDataCallCount_);
+
+  // Express an Interest with no route, which times out.
+  Interest interest(Name("/no/route"));
+  interest.setInterestLifetimeMilliseconds(10);
+  consumer->expressInterest
+    (interest, bind(&MetricsCounter::onData, &counter, _1, _2),
+     bind(&MetricsCounter::onTimeout, &counter, _1));
+  processEventsUntil(counter.onTimeoutCallCount_, 1);
+  ASSERT_EQ(1, counter.onTimeoutCallCount_);
+
+  FaceMetrics metrics = consumer->getMetrics();
+  ASSERT_EQ(nInterests + 1, metrics.getNInterestsExpressed());
+  ASSERT_EQ(nInterests, metrics.getNInterestsSatisfied());
+  ASSERT_EQ(1, metrics.getNInterestsTimedOut());
+  ASSERT_EQ(0, metrics.getNInterestsNacked());
+  ASSERT_EQ(nInterests, metrics.getNDataReceived());
+  ASSERT_EQ(0, metrics.getNDataSent());
+  ASSERT_EQ(0, metrics.getNInterestsReceived());
+  ASSERT_TRUE(metrics.getNInterestBytesOut() > 0);
+  ASSERT_EQ(0, metrics.getNInterestBytesIn());
+  ASSERT_TRUE(metrics.getNDataBytesIn() > 7 * nInterests);
+  ASSERT_EQ(0, metrics.getPendingInterestTableSize());
+  ASSERT_EQ(nInterests, metrics.getRoundTripTimeMicroseconds().getCount());
+  // One callback for each Data and one for the timeout.
+  ASSERT_EQ(nInterests + 1, metrics.getCallbackTimeMicroseconds().getCount());
+
+  FaceMetrics producerMetrics = producer->getMetrics();
+  ASSERT_EQ(nInterests, producerMetrics.getNInterestsReceived());
+  ASSERT_EQ(nInterests, producerMetrics.getNDataSent());
+  ASSERT_EQ(metrics.getNDataBytesIn(), producerMetrics.getNDataBytesOut());
+  ASSERT_EQ(1, producerMetrics.getInterestFilterTableSize());
+}
+
+TEST_F(TestFaceMetrics, ServeMetrics)
+{
+  Name prefix("/test/metrics");
+  producer->serveMetrics(prefix);
+  registerProducer(prefix, OnInterestCallback());
+
+  MetricsCounter counter;
+  consumer->expressInterest
+    (prefix, bind(&MetricsCounter::onData, &counter, _1, _2),
+     bind(&MetricsCounter::onTimeout, &counter, _1));
+  processEventsUntil(counter.onDataCallCount_, 1);
+  ASSERT_EQ(1, counter.onDataCallCount_);
+
+  ASSERT_TRUE(prefix.isPrefixOf(counter.data_->getName()));
+  ASSERT_TRUE(counter.data_->getName().get(-1).isVersion());
+  ASSERT_TRUE(VerificationHelpers::verifyDataDigest
+              (*counter.data_, DIGEST_ALGORITHM_SHA256));
+  string json = counter.data_->getContent().toRawStr();
+  ASSERT_EQ(0, json.find("{\"interestsExpressed\":"));
+  // The producer received the Interest before making the snapshot.
+  ASSERT_NE(string::npos, json.find("\"interestsReceived\":1,"));
+  ASSERT_NE(string::npos, json.find("\"roundTripTimeMicroseconds\":{\"count\":"));
+}
+
+int
+main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -23,6 +23,7 @@
 #include "gtest/gtest.h"
 #include <algorithm>
 #include <fstream>
+#include <sstream>
 #include <stdexcept>
 #include <ndn-cpp/encrypt/algo/rsa-algorithm.hpp>
 #include <ndn-cpp/encrypt/sqlite3-group-manager-db.hpp>
@@ -125,7 +126,7 @@ class TestGroupManagerDb : public ::testing::Test {
 public:
   TestGroupManagerDb()
   {
-    databaseFilePath = getPolicyConfigDirectory() + "/test.db";
+    databaseFilePath = getPolicyConfigDirectory() + "/group-manager-db-test.db";
     remove(databaseFilePath.c_str());
 
     database.reset(new Sqlite3GroupManagerDb(databaseFilePath));
@@ -135,6 +136,9 @@ public:
   TearDown()
   {
     remove(databaseFilePath.c_str());
+    // The database is still open, so also remove the write-ahead log files.
+    remove((databaseFilePath + "-wal").c_str());
+    remove((databaseFilePath + "-shm").c_str());
   }
 
   string databaseFilePath;
@@ -279,6 +283,43 @@ TEST_F(TestGroupManagerDb, DatabaseFunctions)
   database->deleteSchedule("not-existing-time");
 }
 
+TEST_F(TestGroupManagerDb, Transaction)
+{
+  Sqlite3GroupManagerDb& sqlite3Database =
+    static_cast<Sqlite3GroupManagerDb&>(*database);
+  Schedule schedule;
+  schedule.wireDecode(Blob(SCHEDULE, sizeof(SCHEDULE)));
+  database->addSchedule("work-time", schedule);
+  // The database doesn't check the key bits.
+  uint8_t keyBits[] = { 0, 1, 2, 3 };
+  Blob keyBlob(keyBits, sizeof(keyBits));
+
+  // Roll back to discard the members.
+  sqlite3Database.beginTransaction();
+  ASSERT_THROW(sqlite3Database.beginTransaction(), GroupManagerDb::Error)
+    << "Expected an error for a nested transaction";
+  database->addMember("work-time", Name("/ndn/BoyA/ksk-123"), keyBlob);
+  ASSERT_TRUE(database->hasMember(Name("/ndn/BoyA")));
+  sqlite3Database.rollbackTransaction();
+  ASSERT_FALSE(database->hasMember(Name("/ndn/BoyA")));
+
+  // Add many members in one transaction.
+  sqlite3Database.beginTransaction();
+  for (int i = 0; i < 100; ++i) {
+    ostringstream keyName;
+    keyName << "/ndn/member" << i << "/ksk-123";
+    database->addMember("work-time", Name(keyName.str()), keyBlob);
+  }
+  sqlite3Database.commitTransaction();
+  ASSERT_THROW(sqlite3Database.commitTransaction(), GroupManagerDb::Error)
+    << "Expected an error for no transaction in progress";
+
+  vector<Name> members;
+  database->listAllMembers(members);
+  ASSERT_EQ(100, members.size());
+  ASSERT_EQ("work-time", database->getMemberSchedule(Name("/ndn/member99")));
+}
+
 int
 main(int argc, char **argv)
 {
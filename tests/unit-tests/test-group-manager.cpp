@@ -28,6 +28,7 @@
 #include <ndn-cpp/security/identity/memory-private-key-storage.hpp>
 #include <ndn-cpp/security/policy/no-verify-policy-manager.hpp>
 #include <ndn-cpp/security/key-chain.hpp>
+#include <ndn-cpp/security/verification-helpers.hpp>
 #include <ndn-cpp/encoding/tlv-wire-format.hpp>
 #include <ndn-cpp/encrypt/encrypted-content.hpp>
 #include <ndn-cpp/encrypt/schedule.hpp>
@@ -38,6 +39,7 @@
 
 using namespace std;
 using namespace ndn;
+using namespace ndn::func_lib;
 
 static bool
 fileExists(const string& filePath)
@@ -339,6 +341,50 @@ TEST_F(TestGroupManager, CalculateInterval)
   ASSERT_EQ("20150827T060000", toIsoString(result.getEndTime()));
 }
 
+TEST_F(TestGroupManager, ScheduleIndex)
+{
+  // Create the group manager.
+  GroupManager manager
+    (Name("Alice"), Name("data_type"),
+     ptr_lib::make_shared<Sqlite3GroupManagerDb>(intervalDatabaseFilePath),
+     1024, 1, keyChain.get());
+  setManager(manager);
+
+  map<Name, Blob> memberKeys;
+  MillisecondsSince1970 timePoint1 = fromIsoString("20150825T093000");
+  MillisecondsSince1970 timePoint2 = fromIsoString("20150825T053000");
+
+  // Load the index.
+  manager.calculateInterval(timePoint1, memberKeys);
+  ASSERT_EQ(3, memberKeys.size());
+  // At timePoint2, only schedule1 is positive.
+  manager.calculateInterval(timePoint2, memberKeys);
+  ASSERT_EQ(2, memberKeys.size());
+
+  // The index should follow changes made through the manager.
+  manager.updateMemberSchedule(Name("/ndn/memberB"), "schedule2");
+  manager.calculateInterval(timePoint2, memberKeys);
+  ASSERT_EQ(1, memberKeys.size());
+  ASSERT_TRUE(memberKeys.find(Name("/ndn/memberA/ksk-123")) != memberKeys.end());
+
+  manager.removeMember(Name("/ndn/memberA"));
+  manager.calculateInterval(timePoint2, memberKeys);
+  ASSERT_EQ(0, memberKeys.size());
+
+  manager.deleteSchedule("schedule2");
+  Interval result = manager.calculateInterval(timePoint1, memberKeys);
+  ASSERT_EQ(0, memberKeys.size());
+  ASSERT_EQ("20150825T050000", toIsoString(result.getStartTime()));
+  ASSERT_EQ("20150825T100000", toIsoString(result.getEndTime()));
+
+  // Check that the index matches a reload from the database.
+  manager.clearScheduleIndex();
+  result = manager.calculateInterval(timePoint1, memberKeys);
+  ASSERT_EQ(0, memberKeys.size());
+  ASSERT_EQ("20150825T050000", toIsoString(result.getStartTime()));
+  ASSERT_EQ("20150825T100000", toIsoString(result.getEndTime()));
+}
+
 TEST_F(TestGroupManager, GetGroupKey)
 {
   // Create the group manager.
@@ -485,6 +531,134 @@ TEST_F(TestGroupManager, GetGroupKeyWithoutRegeneration)
      data2->getName().toUri());
 }
 
+#ifdef NDN_CPP_HAVE_BOOST_ASIO
+static void
+saveGroupKeyData
+  (const ptr_lib::shared_ptr<Data>& data,
+   vector<ptr_lib::shared_ptr<Data> >* result, const bool* isComplete)
+{
+  // All packets should come before onComplete.
+  ASSERT_FALSE(*isComplete);
+  result->push_back(data);
+}
+
+static void
+setComplete
+  (const vector<Name>& failedKeyNames, bool* isComplete,
+   vector<Name>* failedKeyNamesResult)
+{
+  *isComplete = true;
+  *failedKeyNamesResult = failedKeyNames;
+}
+#endif
+
+TEST_F(TestGroupManager, GetGroupKeyParallel)
+{
+#ifdef NDN_CPP_HAVE_BOOST_ASIO
+  // Use a security v1 KeyChain from the fixture and a security v2 KeyChain
+  // which signs in the worker tasks.
+  KeyChain keyChainV2("pib-memory:", "tpm-memory:");
+  ptr_lib::shared_ptr<PibIdentity> identityV2 = keyChainV2.createIdentityV2
+    (Name("/TestGroupManager/V2"));
+  KeyChain* keyChains[] = { keyChain.get(), &keyChainV2 };
+
+  for (size_t iKeyChain = 0; iKeyChain < 2; ++iKeyChain) {
+    GroupManager manager
+      (Name("Alice"), Name("data_type"),
+       ptr_lib::make_shared<Sqlite3GroupManagerDb>(groupKeyDatabaseFilePath),
+       1024, 1, keyChains[iKeyChain]);
+    setManager(manager);
+    // Add more members than one task handles.
+    Blob dataBlob = certificate.wireEncode();
+    for (int i = 0; i < 20; ++i) {
+      Data member;
+      member.wireDecode(dataBlob);
+      member.setName(Name("/ndn/extraMember").appendSequenceNumber(i)
+                     .append("KEY").append("ksk-123").append("ID-CERT")
+                     .append("123"));
+      manager.addMember("schedule1", member);
+    }
+
+    MillisecondsSince1970 timePoint1 = fromIsoString("20150825T093000");
+    vector<ptr_lib::shared_ptr<Data> > expectedResult;
+    manager.getGroupKey(timePoint1, expectedResult);
+
+    // Add a member whose public key can't be used to encrypt. Add it to the
+    // database directly since addMember would reject it, and clear the index
+    // so that getGroupKey reloads it.
+    Name badKeyName("/ndn/badMember/ksk-123");
+    uint8_t badKeyDer[] = { 0x30, 0x03, 0x02, 0x01, 0x00 };
+    manager.database_->addMember
+      ("schedule1", badKeyName, Blob(badKeyDer, sizeof(badKeyDer)));
+    manager.clearScheduleIndex();
+
+    boost::asio::io_service workerService;
+    boost::asio::io_service resultService;
+    vector<ptr_lib::shared_ptr<Data> > result;
+    bool isComplete = false;
+    vector<Name> failedKeyNames;
+    manager.getGroupKey
+      (timePoint1, workerService, resultService,
+       bind(&saveGroupKeyData, _1, &result, &isComplete),
+       bind(&setComplete, _1, &isComplete, &failedKeyNames), false);
+    // run() returns when all the tasks are finished.
+    workerService.run();
+    resultService.run();
+
+    ASSERT_TRUE(isComplete);
+    ASSERT_EQ(1, failedKeyNames.size());
+    ASSERT_TRUE(failedKeyNames[0].equals(badKeyName)) <<
+      "The member with the bad key should be reported to onComplete";
+    ASSERT_EQ(expectedResult.size(), result.size());
+    // The E-KEY is first and is the same since needRegenerate is false.
+    ASSERT_TRUE(expectedResult[0]->getName().equals(result[0]->getName()));
+    ASSERT_TRUE(expectedResult[0]->getContent().equals(result[0]->getContent()));
+
+    // Decrypt each D-KEY to check that it has the group private key.
+    for (size_t i = 1; i < result.size(); ++i) {
+      Data& dKeyData = *result[i];
+      ASSERT_TRUE(dKeyData.getSignature()->getSignature().size() > 0);
+      if (iKeyChain == 1) {
+        ASSERT_TRUE(VerificationHelpers::verifyDataSignature
+          (dKeyData, *identityV2->getDefaultKey()->getDefaultCertificate()));
+      }
+
+      EncryptedContent encryptedNonce;
+      encryptedNonce.wireDecode(dKeyData.getContent());
+      EncryptParams decryptParams(ndn_EncryptAlgorithmType_RsaOaep);
+      Blob nonce = RsaAlgorithm::decrypt
+        (decryptKeyBlob, encryptedNonce.getPayload(), decryptParams);
+
+      size_t payloadIndex = encryptedNonce.wireEncode().size();
+      EncryptedContent encryptedPayload;
+      encryptedPayload.wireDecode(Blob
+        (dKeyData.getContent().buf() + payloadIndex,
+         dKeyData.getContent().size() - payloadIndex));
+      decryptParams.setAlgorithmType(ndn_EncryptAlgorithmType_AesCbc);
+      decryptParams.setInitialVector(encryptedPayload.getInitialVector());
+      Blob privateKey = AesAlgorithm::decrypt
+        (nonce, encryptedPayload.getPayload(), decryptParams);
+
+      EncryptKey groupEKey = RsaAlgorithm::deriveEncryptKey(privateKey);
+      ASSERT_TRUE(groupEKey.getKeyBits().equals(result[0]->getContent()));
+    }
+
+    // Check the D-KEY names, which may be in a different order.
+    vector<string> expectedNames;
+    vector<string> names;
+    for (size_t i = 1; i < result.size(); ++i) {
+      expectedNames.push_back(expectedResult[i]->getName().toUri());
+      names.push_back(result[i]->getName().toUri());
+    }
+    sort(expectedNames.begin(), expectedNames.end());
+    sort(names.begin(), names.end());
+    ASSERT_EQ(expectedNames, names);
+
+    remove(groupKeyDatabaseFilePath.c_str());
+  }
+#endif
+}
+
 int
 main(int argc, char **argv)
 {
@@ -341,6 +341,33 @@ TEST_F(TestSqlIdentityStorage, EcdsaIdentity)
   ASSERT_FALSE(identityStorage->doesKeyExist(keyName));
 }
 
+TEST_F(TestSqlIdentityStorage, PrivateKeyFileChange)
+{
+  string keyStorePath = getPolicyConfigDirectory() + "/test-private-keys";
+  FilePrivateKeyStorage storage(keyStorePath);
+  Name keyName("/TestSqlIdentityStorage/PrivateKeyFileChange/ksk-1");
+  storage.deleteKeyPair(keyName);
+  storage.generateKeyPair(keyName, RsaKeyParams());
+  uint8_t data[] = { 1, 2, 3, 4 };
+
+  // Sign twice to use the cached key.
+  ASSERT_EQ(KEY_TYPE_RSA, storage.getPublicKey(keyName)->getKeyType());
+  ASSERT_EQ(256, storage.sign(data, sizeof(data), keyName).size());
+  ASSERT_EQ(256, storage.sign(data, sizeof(data), keyName).size());
+
+  // Replace the key files using another storage object, which the first
+  // storage object should detect.
+  FilePrivateKeyStorage otherStorage(keyStorePath);
+  otherStorage.deleteKeyPair(keyName);
+  otherStorage.generateKeyPair(keyName, EcKeyParams());
+  ASSERT_EQ(KEY_TYPE_EC, storage.getPublicKey(keyName)->getKeyType());
+  // An ECDSA signature is much smaller than an RSA signature.
+  ASSERT_TRUE(storage.sign(data, sizeof(data), keyName).size() < 100);
+
+  otherStorage.deleteKeyPair(keyName);
+  ASSERT_THROW(storage.sign(data, sizeof(data), keyName), SecurityException);
+}
+
 int
 main(int argc, char **argv)
 {
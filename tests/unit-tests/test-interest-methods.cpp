@@ -409,6 +409,35 @@ TEST_F(TestInterestMethods, RefreshNonce)
                "The refreshed nonce should be different";
 }
 
+TEST_F(TestInterestMethods, LazyDecode)
+{
+  Blob input(codedInterest, sizeof(codedInterest));
+  Interest interest;
+  interest.wireDecodeLazy(input);
+  ASSERT_TRUE(interest.getName().equals(referenceInterest.getName()));
+  ASSERT_EQ(input.buf(), interest.wireEncode().buf());
+
+  // Accessing the other fields decodes them and keeps the nonce and encoding.
+  ASSERT_TRUE(interestDumpsEqual(dumpInterest(interest), initialDump)) <<
+    "Lazy decoded interest does not match original dump";
+  ASSERT_EQ(input.buf(), interest.getDefaultWireEncoding().buf());
+
+  // Changing the name before decoding the other fields removes the nonce.
+  Interest interest2;
+  interest2.wireDecodeLazy(input);
+  interest2.getName().append("extra");
+  ASSERT_EQ(referenceInterest.getExclude().toUri(),
+            interest2.getExclude().toUri());
+  ASSERT_TRUE(interest2.getNonce().isNull()) <<
+    "Interest should not have a nonce after changing the name";
+
+  // The entire encoding is checked, not only the name. Truncate the packet.
+  Interest interest3;
+  ASSERT_THROW
+    (interest3.wireDecodeLazy(codedInterest, sizeof(codedInterest) - 10),
+     runtime_error);
+}
+
 TEST_F(TestInterestMethods, ExcludeMatches)
 {
   Exclude exclude;
@@ -27,9 +27,18 @@
 #include <cstdio>
 #include "identity-management-fixture.hpp"
 #include <ndn-cpp/security/key-chain.hpp>
+#include <ndn-cpp/security/verification-helpers.hpp>
+#include <ndn-cpp/security/pib/pib-memory.hpp>
+#include <ndn-cpp/security/tpm/tpm-back-end-memory.hpp>
+#include <ndn-cpp/security/tpm/tpm-key-handle.hpp>
+#include <ndn-cpp/security/async-signer.hpp>
+#include <ndn-cpp/security/batch-signer.hpp>
+#include <ndn-cpp/security/batch-verifier.hpp>
+#include <ndn-cpp/merkle-signature.hpp>
 
 using namespace std;
 using namespace ndn;
+using namespace ndn::func_lib;
 
 class TestKeyChain : public ::testing::Test {
 public:
@@ -156,6 +165,485 @@ TEST_F(TestKeyChain, SelfSignedCertValidity)
     ndn_getNowMilliseconds() + 10 * 365 * 24 * 3600 * 1000.0);
 }
 
+static void
+saveResults(const vector<bool>& results, vector<bool>* savedResults)
+{
+  *savedResults = results;
+}
+
+TEST_F(TestKeyChain, BatchVerify)
+{
+  ptr_lib::shared_ptr<PibKey> rsaKey = fixture_.addIdentity
+    ("/Security/V2/TestKeyChain/BatchVerify/Rsa", RsaKeyParams())->getDefaultKey();
+  ptr_lib::shared_ptr<PibKey> ecKey = fixture_.addIdentity
+    ("/Security/V2/TestKeyChain/BatchVerify/Ec", EcKeyParams())->getDefaultKey();
+
+  vector<ptr_lib::shared_ptr<Data> > dataList;
+  vector<Blob> publicKeyDerList;
+  vector<bool> expected;
+  for (int i = 0; i < 10; ++i) {
+    ptr_lib::shared_ptr<PibKey> key = (i % 2 == 0 ? rsaKey : ecKey);
+    ptr_lib::shared_ptr<Data> data(new Data(Name("/data").appendSequenceNumber(i)));
+    fixture_.keyChain_.sign(*data, SigningInfo(key));
+    dataList.push_back(data);
+    publicKeyDerList.push_back(key->getPublicKey());
+    expected.push_back(true);
+  }
+  // Use the wrong key.
+  publicKeyDerList[2] = ecKey->getPublicKey();
+  expected[2] = false;
+  // Change the content after signing.
+  dataList[3]->setContent(Blob(Name("/changed").wireEncode()));
+  expected[3] = false;
+  // Use a key which can't be decoded.
+  publicKeyDerList[4] = Blob(Name("/bad-key").wireEncode());
+  expected[4] = false;
+
+  // Add packets signed with a Merkle tree.
+  vector<ptr_lib::shared_ptr<Data> > merkleDataList;
+  for (int i = 0; i < 5; ++i)
+    merkleDataList.push_back(ptr_lib::make_shared<Data>
+      (Name("/merkle-data").appendSequenceNumber(i)));
+  fixture_.keyChain_.signWithMerkleTree(merkleDataList, SigningInfo(rsaKey));
+  for (size_t i = 0; i < merkleDataList.size(); ++i) {
+    dataList.push_back(merkleDataList[i]);
+    publicKeyDerList.push_back(rsaKey->getPublicKey());
+    expected.push_back(true);
+  }
+  // Change the content after signing, which changes the computed root.
+  merkleDataList[1]->setContent(Blob(Name("/changed").wireEncode()));
+  expected[11] = false;
+  // Use the wrong key.
+  publicKeyDerList[12] = ecKey->getPublicKey();
+  expected[12] = false;
+
+  vector<bool> results;
+  VerificationHelpers::verifyDataSignatures(dataList, publicKeyDerList, results);
+  ASSERT_TRUE(expected == results);
+
+  vector<Blob> shortKeyList(publicKeyDerList.begin(), publicKeyDerList.end() - 1);
+  ASSERT_THROW
+    (VerificationHelpers::verifyDataSignatures(dataList, shortKeyList, results),
+     std::invalid_argument);
+
+#ifdef NDN_CPP_HAVE_BOOST_ASIO
+  boost::asio::io_service ioService;
+  // Use a small task size to check splitting the batch into multiple tasks.
+  BatchVerifier verifier(ioService, 3);
+  vector<bool> batchResults;
+  verifier.verifyDataSignatures
+    (dataList, publicKeyDerList, bind(&saveResults, _1, &batchResults));
+  // run() returns when all the tasks are finished.
+  ioService.run();
+  ASSERT_TRUE(expected == batchResults);
+
+  // An empty batch should still call onVerified.
+  batchResults.push_back(true);
+  verifier.verifyDataSignatures
+    (vector<ptr_lib::shared_ptr<Data> >(), vector<Blob>(),
+     bind(&saveResults, _1, &batchResults));
+  ioService.reset();
+  ioService.run();
+  ASSERT_EQ(0, batchResults.size());
+#endif
+}
+
+/**
+ * A FailingKeyHandle is a TPM key handle which fails to sign. It can wrap
+ * another key handle to fail only when a flag is set.
+ */
+class FailingKeyHandle : public TpmKeyHandle {
+public:
+  /**
+   * Create a FailingKeyHandle which always fails to sign.
+   */
+  FailingKeyHandle()
+  : fail_(0)
+  {
+  }
+
+  /**
+   * Create a FailingKeyHandle which signs with keyHandle unless *fail is true.
+   */
+  FailingKeyHandle
+    (const ptr_lib::shared_ptr<TpmKeyHandle>& keyHandle, const bool* fail)
+  : keyHandle_(keyHandle), fail_(fail)
+  {
+    setKeyName(keyHandle->getKeyName());
+  }
+
+private:
+  virtual Blob
+  doSign
+    (DigestAlgorithm digestAlgorithm, const uint8_t* data,
+     size_t dataLength) const
+  {
+    if (!keyHandle_ || *fail_)
+      throw runtime_error("The TPM is not available");
+    return keyHandle_->sign(digestAlgorithm, data, dataLength);
+  }
+
+  virtual Blob
+  doDecrypt(const uint8_t* cipherText, size_t cipherTextLength) const
+  {
+    return keyHandle_ ? keyHandle_->decrypt(cipherText, cipherTextLength) : Blob();
+  }
+
+  virtual Blob
+  doDerivePublicKey() const
+  {
+    return keyHandle_ ? keyHandle_->derivePublicKey() : Blob();
+  }
+
+  ptr_lib::shared_ptr<TpmKeyHandle> keyHandle_;
+  const bool* fail_;
+};
+
+/**
+ * A FailingTpmBackEnd keeps its keys in a TpmBackEndMemory, and its key
+ * handles fail to sign while fail_ is true.
+ */
+class FailingTpmBackEnd : public TpmBackEnd {
+public:
+  FailingTpmBackEnd()
+  : fail_(false)
+  {
+  }
+
+  bool fail_;
+
+private:
+  virtual bool
+  doHasKey(const Name& keyName) const { return memory_.hasKey(keyName); }
+
+  virtual ptr_lib::shared_ptr<TpmKeyHandle>
+  doGetKeyHandle(const Name& keyName) const
+  {
+    ptr_lib::shared_ptr<TpmKeyHandle> keyHandle = memory_.getKeyHandle(keyName);
+    if (!keyHandle)
+      return keyHandle;
+    return ptr_lib::make_shared<FailingKeyHandle>(keyHandle, &fail_);
+  }
+
+  virtual ptr_lib::shared_ptr<TpmKeyHandle>
+  doCreateKey(const Name& identityName, const KeyParams& params)
+  {
+    return ptr_lib::make_shared<FailingKeyHandle>
+      (memory_.createKey(identityName, params), &fail_);
+  }
+
+  virtual void
+  doDeleteKey(const Name& keyName) { memory_.deleteKey(keyName); }
+
+  TpmBackEndMemory memory_;
+};
+
+static void
+saveDataList
+  (const vector<ptr_lib::shared_ptr<Data> >& dataList,
+   vector<ptr_lib::shared_ptr<Data> >* savedDataList)
+{
+  *savedDataList = dataList;
+}
+
+static void
+saveDataListError
+  (const vector<ptr_lib::shared_ptr<Data> >& failedDataList,
+   const string& errorMessage,
+   vector<ptr_lib::shared_ptr<Data> >* savedFailedDataList,
+   vector<string>* errorMessages)
+{
+  *savedFailedDataList = failedDataList;
+  errorMessages->push_back(errorMessage);
+}
+
+TEST_F(TestKeyChain, BatchSign)
+{
+  ptr_lib::shared_ptr<PibKey> key = fixture_.addIdentity
+    ("/Security/V2/TestKeyChain/BatchSign", RsaKeyParams())->getDefaultKey();
+
+  // RSA signatures are deterministic, so compare with signing one at a time.
+  vector<ptr_lib::shared_ptr<Data> > dataList;
+  vector<Blob> expectedEncodings;
+  for (int i = 0; i < 10; ++i) {
+    ptr_lib::shared_ptr<Data> data(new Data(Name("/data").appendSequenceNumber(i)));
+    Data expectedData(*data);
+    fixture_.keyChain_.sign(expectedData, SigningInfo(key));
+    dataList.push_back(data);
+    expectedEncodings.push_back(expectedData.wireEncode());
+  }
+
+  fixture_.keyChain_.sign(dataList, SigningInfo(key));
+  for (size_t i = 0; i < dataList.size(); ++i)
+    ASSERT_TRUE(expectedEncodings[i].equals(dataList[i]->wireEncode()));
+
+  ASSERT_THROW
+    (fixture_.keyChain_.sign
+     (dataList, SigningInfo(SigningInfo::SIGNER_TYPE_KEY,
+                            Name("/Security/V2/TestKeyChain/BatchSign/KEY/none"))),
+     KeyChain::InvalidSigningInfoError);
+
+#ifdef NDN_CPP_HAVE_BOOST_ASIO
+  for (size_t i = 0; i < dataList.size(); ++i)
+    dataList[i]->setContent(Blob());
+
+  boost::asio::io_service ioService;
+  // Use a small task size to check splitting the batch into multiple tasks.
+  BatchSigner signer(fixture_.keyChain_, ioService, 3);
+  vector<ptr_lib::shared_ptr<Data> > signedDataList;
+  vector<ptr_lib::shared_ptr<Data> > failedDataList;
+  vector<string> errorMessages;
+  signer.sign
+    (dataList, SigningInfo(key), bind(&saveDataList, _1, &signedDataList),
+     bind(&saveDataListError, _1, _2, &failedDataList, &errorMessages));
+  // run() returns when all the tasks are finished.
+  ioService.run();
+
+  ASSERT_EQ(dataList.size(), signedDataList.size());
+  ASSERT_EQ(0, errorMessages.size());
+  for (size_t i = 0; i < dataList.size(); ++i) {
+    ASSERT_EQ(dataList[i], signedDataList[i]);
+    ASSERT_TRUE(expectedEncodings[i].equals(dataList[i]->wireEncode()));
+  }
+
+  // Check signing with a digest.
+  signer.sign
+    (dataList, SigningInfo(SigningInfo::SIGNER_TYPE_SHA256),
+     bind(&saveDataList, _1, &signedDataList),
+     bind(&saveDataListError, _1, _2, &failedDataList, &errorMessages));
+  ioService.reset();
+  ioService.run();
+  for (size_t i = 0; i < dataList.size(); ++i)
+    ASSERT_TRUE(VerificationHelpers::verifyDataDigest
+      (*dataList[i], DIGEST_ALGORITHM_SHA256));
+#endif
+}
+
+#ifdef NDN_CPP_HAVE_BOOST_ASIO
+TEST_F(TestKeyChain, BatchSignError)
+{
+  ptr_lib::shared_ptr<FailingTpmBackEnd> tpmBackEnd(new FailingTpmBackEnd());
+  KeyChain keyChain(ptr_lib::make_shared<PibMemory>(), tpmBackEnd);
+  ptr_lib::shared_ptr<PibKey> key = keyChain.createIdentityV2
+    ("/Security/V2/TestKeyChain/BatchSignError", RsaKeyParams())
+    ->getDefaultKey();
+
+  vector<ptr_lib::shared_ptr<Data> > dataList;
+  for (int i = 0; i < 5; ++i)
+    dataList.push_back(ptr_lib::make_shared<Data>
+      (Name("/data").appendSequenceNumber(i)));
+
+  boost::asio::io_service ioService;
+  BatchSigner signer(keyChain, ioService, 2);
+  vector<ptr_lib::shared_ptr<Data> > signedDataList;
+  vector<ptr_lib::shared_ptr<Data> > failedDataList;
+  vector<string> errorMessages;
+  tpmBackEnd->fail_ = true;
+  signer.sign
+    (dataList, SigningInfo(key), bind(&saveDataList, _1, &signedDataList),
+     bind(&saveDataListError, _1, _2, &failedDataList, &errorMessages));
+  ioService.run();
+
+  ASSERT_EQ(0, signedDataList.size()) << "Failed packets must not be reported as signed";
+  ASSERT_EQ(1, errorMessages.size());
+  ASSERT_TRUE(errorMessages[0].find("The TPM is not available") != string::npos);
+  ASSERT_EQ(dataList.size(), failedDataList.size());
+  for (size_t i = 0; i < dataList.size(); ++i) {
+    ASSERT_EQ(dataList[i], failedDataList[i]);
+    ASSERT_EQ(0, dataList[i]->getSignature()->getSignature().size());
+  }
+
+  // The same signer succeeds when the TPM works again.
+  tpmBackEnd->fail_ = false;
+  errorMessages.clear();
+  signer.sign
+    (dataList, SigningInfo(key), bind(&saveDataList, _1, &signedDataList),
+     bind(&saveDataListError, _1, _2, &failedDataList, &errorMessages));
+  ioService.reset();
+  ioService.run();
+  ASSERT_EQ(0, errorMessages.size());
+  ASSERT_EQ(dataList.size(), signedDataList.size());
+  for (size_t i = 0; i < dataList.size(); ++i)
+    ASSERT_TRUE(VerificationHelpers::verifyDataSignature
+      (*dataList[i], key->getPublicKey()));
+}
+
+static void
+saveData
+  (const ptr_lib::shared_ptr<Data>& data,
+   vector<ptr_lib::shared_ptr<Data> >* savedDataList)
+{
+  savedDataList->push_back(data);
+}
+
+static void
+saveDataError
+  (const ptr_lib::shared_ptr<Data>& data, const string& errorMessage,
+   vector<string>* errorMessages)
+{
+  errorMessages->push_back(errorMessage);
+}
+
+static void
+saveSignature(const Blob& signature, vector<Blob>* signatures)
+{
+  signatures->push_back(signature);
+}
+
+static void
+saveError(const string& errorMessage, vector<string>* errorMessages)
+{
+  errorMessages->push_back(errorMessage);
+}
+
+TEST_F(TestKeyChain, AsyncSign)
+{
+  ptr_lib::shared_ptr<PibKey> key = fixture_.addIdentity
+    ("/Security/V2/TestKeyChain/AsyncSign", RsaKeyParams())->getDefaultKey();
+
+  ptr_lib::shared_ptr<Data> data(new Data(Name("/data")));
+  data->setContent(Blob(vector<uint8_t>(10, 1)));
+  Data expectedData(*data);
+  fixture_.keyChain_.sign(expectedData, SigningInfo(key));
+
+  boost::asio::io_service workerService;
+  boost::asio::io_service resultService;
+  AsyncSigner signer(fixture_.keyChain_, workerService, resultService);
+  vector<ptr_lib::shared_ptr<Data> > signedDataList;
+  vector<string> errorMessages;
+  signer.sign
+    (data, SigningInfo(key), bind(&saveData, _1, &signedDataList),
+     bind(&saveDataError, _1, _2, &errorMessages));
+  // The signing waits for the worker.
+  resultService.run();
+  ASSERT_EQ(0, signedDataList.size());
+
+  workerService.run();
+  resultService.reset();
+  resultService.run();
+  ASSERT_EQ(1, signedDataList.size());
+  ASSERT_EQ(0, errorMessages.size());
+  ASSERT_EQ(data, signedDataList[0]);
+  // RSA signatures are deterministic.
+  ASSERT_TRUE(expectedData.wireEncode().equals(data->wireEncode()));
+
+  // Check signing with a digest, delivering the result in the worker.
+  AsyncSigner workerSigner(fixture_.keyChain_, workerService, workerService);
+  workerSigner.sign
+    (data, SigningInfo(SigningInfo::SIGNER_TYPE_SHA256),
+     bind(&saveData, _1, &signedDataList),
+     bind(&saveDataError, _1, _2, &errorMessages));
+  workerService.reset();
+  workerService.run();
+  ASSERT_EQ(2, signedDataList.size());
+  ASSERT_TRUE(VerificationHelpers::verifyDataDigest
+    (*data, DIGEST_ALGORITHM_SHA256));
+
+  ASSERT_THROW
+    (signer.sign
+     (data, SigningInfo(SigningInfo::SIGNER_TYPE_KEY,
+                        Name("/Security/V2/TestKeyChain/AsyncSign/KEY/none")),
+      bind(&saveData, _1, &signedDataList),
+      bind(&saveDataError, _1, _2, &errorMessages)),
+     KeyChain::InvalidSigningInfoError);
+
+  // Sign with the key name.
+  vector<Blob> signatures;
+  workerSigner.sign
+    (Blob(vector<uint8_t>(10, 1)), key->getName(), DIGEST_ALGORITHM_SHA256,
+     bind(&saveSignature, _1, &signatures), bind(&saveError, _1, &errorMessages));
+  workerService.reset();
+  workerService.run();
+  ASSERT_EQ(1, signatures.size());
+  ASSERT_EQ(0, errorMessages.size());
+  ASSERT_TRUE(signatures[0].size() > 0);
+
+  // A missing key calls onSignError instead of onSignResult.
+  workerSigner.sign
+    (Blob(vector<uint8_t>(10, 1)), Name("/Security/V2/TestKeyChain/KEY/none"),
+     DIGEST_ALGORITHM_SHA256, bind(&saveSignature, _1, &signatures),
+     bind(&saveError, _1, &errorMessages));
+  workerService.reset();
+  workerService.run();
+  ASSERT_EQ(1, signatures.size());
+  ASSERT_EQ(1, errorMessages.size());
+
+  // A key handle which fails to sign calls onSignError.
+  FailingKeyHandle failingKeyHandle;
+  workerSigner.sign
+    (failingKeyHandle, DIGEST_ALGORITHM_SHA256, Blob(vector<uint8_t>(10, 1)),
+     bind(&saveSignature, _1, &signatures), bind(&saveError, _1, &errorMessages));
+  workerService.reset();
+  workerService.run();
+  ASSERT_EQ(1, signatures.size());
+  ASSERT_EQ(2, errorMessages.size());
+  ASSERT_TRUE(errorMessages[1].find("The TPM is not available") != string::npos);
+}
+#endif
+
+TEST_F(TestKeyChain, MerkleSign)
+{
+  ptr_lib::shared_ptr<PibKey> key = fixture_.addIdentity
+    ("/Security/V2/TestKeyChain/MerkleSign", EcKeyParams())->getDefaultKey();
+  ptr_lib::shared_ptr<PibKey> otherKey = fixture_.addIdentity
+    ("/Security/V2/TestKeyChain/MerkleSignOther", EcKeyParams())->getDefaultKey();
+
+  // Check a tree with one leaf and trees with odd and even numbers of leaves.
+  for (size_t nPackets = 1; nPackets <= 8; nPackets += 3) {
+    vector<ptr_lib::shared_ptr<Data> > dataList;
+    for (size_t i = 0; i < nPackets; ++i) {
+      dataList.push_back(ptr_lib::make_shared<Data>
+        (Name("/data").appendSegment(i)));
+      dataList.back()->setContent(Blob(Name("/content").appendSegment(i).wireEncode()));
+    }
+
+    fixture_.keyChain_.signWithMerkleTree(dataList, SigningInfo(key));
+
+    vector<Blob> publicKeys(nPackets, key->getPublicKey());
+    vector<bool> results;
+    VerificationHelpers::verifyDataSignatures(dataList, publicKeys, results);
+    for (size_t i = 0; i < nPackets; ++i) {
+      ASSERT_TRUE(results[i]);
+
+      // Decode to check the signature type and that it verifies by itself.
+      Data decodedData;
+      decodedData.wireDecode(dataList[i]->wireEncode());
+      ASSERT_TRUE(dynamic_cast<const MerkleSignature*>(decodedData.getSignature()));
+      ASSERT_TRUE(KeyLocator::getFromSignature(decodedData.getSignature())
+                  .getKeyName().equals(key->getName()));
+      ASSERT_TRUE(VerificationHelpers::verifyDataSignature
+                  (decodedData, key->getPublicKey()));
+      ASSERT_FALSE(VerificationHelpers::verifyDataSignature
+                   (decodedData, otherKey->getPublicKey()));
+
+      // A changed packet doesn't match its path.
+      decodedData.setContent(Blob(Name("/other").wireEncode()));
+      ASSERT_FALSE(VerificationHelpers::verifyDataSignature
+                   (decodedData, key->getPublicKey()));
+    }
+
+    if (nPackets > 1) {
+      // Swap the authentication paths of two packets.
+      Blob signature0 = dataList[0]->getSignature()->getSignature();
+      dataList[0]->getSignature()->setSignature
+        (dataList[1]->getSignature()->getSignature());
+      ASSERT_FALSE(VerificationHelpers::verifyDataSignature
+                   (*dataList[0], key->getPublicKey()));
+      dataList[0]->getSignature()->setSignature(signature0);
+      ASSERT_TRUE(VerificationHelpers::verifyDataSignature
+                  (*dataList[0], key->getPublicKey()));
+    }
+  }
+
+  // A Merkle tree signature needs a key.
+  vector<ptr_lib::shared_ptr<Data> > dataList;
+  dataList.push_back(ptr_lib::make_shared<Data>(Name("/data")));
+  ASSERT_THROW
+    (fixture_.keyChain_.signWithMerkleTree
+     (dataList, SigningInfo(SigningInfo::SIGNER_TYPE_SHA256)),
+     KeyChain::InvalidSigningInfoError);
+}
+
 int
 main(int argc, char **argv)
 {
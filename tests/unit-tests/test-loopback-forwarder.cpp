@@ -0,0 +1,326 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2018 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+#include "gtest/gtest.h"
+#include <ndn-cpp/security/key-chain.hpp>
+#include <ndn-cpp/util/memory-content-cache.hpp>
+#include <ndn-cpp/util/segment-fetcher.hpp>
+#include <ndn-cpp/util/loopback-forwarder.hpp>
+
+using namespace std;
+using namespace ndn;
+using namespace ndn::func_lib;
+
+class Counter
+{
+public:
+  Counter()
+  : onDataCallCount_(0), onTimeoutCallCount_(0), onInterestCallCount_(0),
+    onRegisterSuccessCallCount_(0), answerInterest_(true)
+  {
+  }
+
+  void
+  onData(const ptr_lib::shared_ptr<const Interest>& interest,
+         const ptr_lib::shared_ptr<Data>& data)
+  {
+    ++onDataCallCount_;
+    data_ = data;
+  }
+
+  void
+  onTimeout(const ptr_lib::shared_ptr<const Interest>& interest)
+  {
+    ++onTimeoutCallCount_;
+  }
+
+  void
+  onRegisterFailed(const ptr_lib::shared_ptr<const Name>& prefix)
+  {
+  }
+
+  void
+  onRegisterSuccess
+    (const ptr_lib::shared_ptr<const Name>& prefix, uint64_t registeredPrefixId)
+  {
+    ++onRegisterSuccessCallCount_;
+  }
+
+  /**
+   * If answerInterest_, answer the Interest with a Data packet which has the
+   * Interest name.
+   */
+  void
+  onInterest
+    (const ptr_lib::shared_ptr<const Name>& prefix,
+     const ptr_lib::shared_ptr<const Interest>& interest, Face& face,
+     uint64_t interestFilterId,
+     const ptr_lib::shared_ptr<const InterestFilter>& filter)
+  {
+    ++onInterestCallCount_;
+    if (!answerInterest_)
+      return;
+
+    Data data(interest->getName());
+    data.setContent(Blob((const uint8_t*)"SUCCESS", 7));
+    data.getMetaInfo().setFreshnessPeriod(10000);
+    keyChain_->signWithSha256(data);
+    face.putData(data);
+  }
+
+  int onDataCallCount_;
+  int onTimeoutCallCount_;
+  int onInterestCallCount_;
+  int onRegisterSuccessCallCount_;
+  ptr_lib::shared_ptr<Data> data_;
+  KeyChain* keyChain_;
+  bool answerInterest_;
+};
+
+class FetchResult
+{
+public:
+  FetchResult() : nCalls_(0) {}
+
+  void
+  onComplete(const Blob& content)
+  {
+    ++nCalls_;
+    content_ = content;
+  }
+
+  void
+  onError(SegmentFetcher::ErrorCode errorCode, const string& message)
+  {
+    ++nCalls_;
+  }
+
+  int nCalls_;
+  Blob content_;
+};
+
+class TestLoopbackForwarder : public ::testing::Test {
+public:
+  TestLoopbackForwarder()
+  : keyChain("pib-memory:", "tpm-memory:")
+  {
+    keyChain.createIdentityV2(Name("/test/identity"), EcKeyParams());
+    consumer = forwarder.makeFace();
+    producer = forwarder.makeFace();
+    producer->setCommandSigningInfo
+      (keyChain, keyChain.getDefaultCertificateName());
+    producerCounter.keyChain_ = &keyChain;
+  }
+
+  /**
+   * Call processEvents on the forwarder and faces until count reaches expected
+   * or the loop runs too many times.
+   */
+  void
+  processEventsUntil(const int& count, int expected)
+  {
+    for (int i = 0; i < 1000 && count < expected; ++i) {
+      forwarder.processEvents();
+      consumer->processEvents();
+      producer->processEvents();
+    }
+  }
+
+  void
+  registerProducer(const Name& prefix)
+  {
+    producer->registerPrefix
+      (prefix,
+       bind(&Counter::onInterest, &producerCounter, _1, _2, _3, _4, _5),
+       bind(&Counter::onRegisterFailed, &producerCounter, _1),
+       bind(&Counter::onRegisterSuccess, &producerCounter, _1, _2));
+    processEventsUntil(producerCounter.onRegisterSuccessCallCount_, 1);
+    ASSERT_EQ(1, producerCounter.onRegisterSuccessCallCount_) <<
+      "The forwarder did not answer the register command";
+  }
+
+  LoopbackForwarder forwarder;
+  KeyChain keyChain;
+  ptr_lib::shared_ptr<Face> consumer;
+  ptr_lib::shared_ptr<Face> producer;
+  Counter producerCounter;
+};
+
+TEST_F(TestLoopbackForwarder, ExpressInterest)
+{
+  registerProducer(Name("/test/prefix"));
+  ASSERT_EQ(1, forwarder.getFibSize());
+
+  Counter counter;
+  consumer->expressInterest
+    (Name("/test/prefix/data"), bind(&Counter::onData, &counter, _1, _2),
+     bind(&Counter::onTimeout, &counter, _1));
+  processEventsUntil(counter.onDataCallCount_, 1);
+
+  ASSERT_EQ(1, counter.onDataCallCount_);
+  ASSERT_EQ(Name("/test/prefix/data"), counter.data_->getName());
+  ASSERT_TRUE(counter.data_->getContent().equals
+              (Blob((const uint8_t*)"SUCCESS", 7)));
+  ASSERT_EQ(0, forwarder.getPitSize());
+  ASSERT_EQ(1, forwarder.getContentStoreSize());
+}
+
+TEST_F(TestLoopbackForwarder, AggregateAndCache)
+{
+  registerProducer(Name("/test/prefix"));
+
+  ptr_lib::shared_ptr<Face> consumer2 = forwarder.makeFace();
+  Counter counter;
+  Counter counter2;
+  Name name("/test/prefix/data");
+  consumer->expressInterest
+    (name, bind(&Counter::onData, &counter, _1, _2),
+     bind(&Counter::onTimeout, &counter, _1));
+  consumer2->expressInterest
+    (name, bind(&Counter::onData, &counter2, _1, _2),
+     bind(&Counter::onTimeout, &counter2, _1));
+
+  for (int i = 0; i < 1000 && counter2.onDataCallCount_ == 0; ++i) {
+    forwarder.processEvents();
+    consumer->processEvents();
+    consumer2->processEvents();
+    producer->processEvents();
+  }
+
+  ASSERT_EQ(1, counter.onDataCallCount_);
+  ASSERT_EQ(1, counter2.onDataCallCount_);
+  ASSERT_EQ(1, producerCounter.onInterestCallCount_) <<
+    "The PIT should aggregate the two Interests";
+
+  // The content store should answer the next Interest.
+  consumer->expressInterest
+    (name, bind(&Counter::onData, &counter, _1, _2),
+     bind(&Counter::onTimeout, &counter, _1));
+  processEventsUntil(counter.onDataCallCount_, 2);
+  ASSERT_EQ(2, counter.onDataCallCount_);
+  ASSERT_EQ(1, producerCounter.onInterestCallCount_) <<
+    "The content store should answer the Interest";
+}
+
+TEST_F(TestLoopbackForwarder, ImplicitDigest)
+{
+  registerProducer(Name("/test/prefix"));
+  producerCounter.answerInterest_ = false;
+
+  Data data(Name("/test/prefix/data"));
+  data.setContent(Blob((const uint8_t*)"SUCCESS", 7));
+  keyChain.signWithSha256(data);
+  Name fullName(*data.getFullName());
+
+  // Make pending Interest names which sort before and after the full name.
+  Name beforeName(data.getName());
+  beforeName.append(Name::Component::fromImplicitSha256Digest
+    (Blob(vector<uint8_t>(ndn_SHA256_DIGEST_SIZE, 0)))).append("x");
+  Name afterName(data.getName());
+  afterName.append("c");
+  ASSERT_TRUE(beforeName < fullName);
+  ASSERT_TRUE(fullName < afterName);
+
+  Counter beforeCounter;
+  Counter fullNameCounter;
+  Counter afterCounter;
+  consumer->expressInterest
+    (beforeName, bind(&Counter::onData, &beforeCounter, _1, _2),
+     bind(&Counter::onTimeout, &beforeCounter, _1));
+  consumer->expressInterest
+    (fullName, bind(&Counter::onData, &fullNameCounter, _1, _2),
+     bind(&Counter::onTimeout, &fullNameCounter, _1));
+  consumer->expressInterest
+    (afterName, bind(&Counter::onData, &afterCounter, _1, _2),
+     bind(&Counter::onTimeout, &afterCounter, _1));
+  processEventsUntil(producerCounter.onInterestCallCount_, 3);
+  ASSERT_EQ(3, producerCounter.onInterestCallCount_);
+  ASSERT_EQ(3, forwarder.getPitSize());
+
+  producer->putData(data);
+  processEventsUntil(fullNameCounter.onDataCallCount_, 1);
+
+  ASSERT_EQ(1, fullNameCounter.onDataCallCount_) <<
+    "The Data should satisfy the Interest with its full name";
+  ASSERT_EQ(fullName, *fullNameCounter.data_->getFullName());
+  ASSERT_EQ(0, beforeCounter.onDataCallCount_);
+  ASSERT_EQ(0, afterCounter.onDataCallCount_);
+  ASSERT_EQ(2, forwarder.getPitSize());
+}
+
+TEST_F(TestLoopbackForwarder, NoRoute)
+{
+  Counter counter;
+  Interest interest(Name("/test/no-route"));
+  interest.setInterestLifetimeMilliseconds(10);
+  consumer->expressInterest
+    (interest, bind(&Counter::onData, &counter, _1, _2),
+     bind(&Counter::onTimeout, &counter, _1));
+
+  for (int i = 0; i < 100000 && counter.onTimeoutCallCount_ == 0; ++i) {
+    forwarder.processEvents();
+    consumer->processEvents();
+  }
+
+  ASSERT_EQ(0, counter.onDataCallCount_);
+  ASSERT_EQ(1, counter.onTimeoutCallCount_);
+  ASSERT_EQ(0, forwarder.getPitSize());
+}
+
+TEST_F(TestLoopbackForwarder, SegmentFetcherWithMemoryContentCache)
+{
+  Name prefix("/test/content");
+  MemoryContentCache contentCache(producer.get());
+  contentCache.registerPrefix
+    (prefix, bind(&Counter::onRegisterFailed, &producerCounter, _1),
+     OnRegisterSuccess(bind
+       (&Counter::onRegisterSuccess, &producerCounter, _1, _2)));
+  processEventsUntil(producerCounter.onRegisterSuccessCallCount_, 1);
+  ASSERT_EQ(1, producerCounter.onRegisterSuccessCallCount_);
+
+  const int nSegments = 3;
+  for (int i = 0; i < nSegments; ++i) {
+    Data data(Name(prefix).appendVersion(1).appendSegment(i));
+    data.setContent(Blob((const uint8_t*)"abc", 3));
+    data.getMetaInfo().setFinalBlockId(Name::Component::fromSegment(nSegments - 1));
+    data.getMetaInfo().setFreshnessPeriod(10000);
+    keyChain.signWithSha256(data);
+    contentCache.add(data);
+  }
+
+  FetchResult result;
+
+  SegmentFetcher::fetch
+    (*consumer, Interest(prefix), SegmentFetcher::DontVerifySegment,
+     bind(&FetchResult::onComplete, &result, _1),
+     bind(&FetchResult::onError, &result, _1, _2));
+  processEventsUntil(result.nCalls_, 1);
+
+  ASSERT_EQ(1, result.nCalls_);
+  ASSERT_TRUE(result.content_.equals(Blob((const uint8_t*)"abcabcabc", 9)));
+}
+
+int
+main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -25,6 +25,9 @@
 #include <algorithm>
 #include <ndn-cpp/name.hpp>
 #include <ndn-cpp/encoding/tlv-wire-format.hpp>
+#if NDN_CPP_HAVE_STD_UNORDERED_MAP
+#include <unordered_map>
+#endif
 
 using namespace std;
 using namespace ndn;
@@ -433,6 +436,133 @@ TEST_F(TestNameMethods, TypedNameComponent)
   ASSERT_EQ(otherTypeCode, decodedName.get(1).getOtherTypeCode());
 }
 
+TEST_F(TestNameMethods, CopyOnWrite)
+{
+  Name name("/a/b/c");
+  Name copy(name);
+  ASSERT_EQ(&name.get(0), &copy.get(0)) << "A copy should share the components";
+  ASSERT_EQ(&name.get(0), &name.getPrefix(3).get(0))
+    << "getPrefix of the whole name should share the components";
+
+  copy.append("d");
+  ASSERT_EQ(Name("/a/b/c"), name) << "Changing a copy should not change the original";
+  ASSERT_EQ(Name("/a/b/c/d"), copy);
+
+  Name empty;
+  empty.append(name);
+  name.clear();
+  ASSERT_EQ(0, name.size());
+  ASSERT_EQ(Name("/a/b/c"), empty) << "Clearing should not change a sharing name";
+
+  ASSERT_EQ(Name("/a/b"), copy.getSubName(0, 2));
+  ASSERT_EQ(Name("/c/d"), copy.getSubName(-2));
+  ASSERT_EQ(Name(), copy.getSubName(4));
+
+  ASSERT_TRUE(Name() == Name(vector<Name::Component>()));
+}
+
+TEST_F(TestNameMethods, Hash)
+{
+  Name name("/a/b");
+  uint64_t hash = name.getHash();
+  ASSERT_EQ(hash, Name("/a/b").getHash()) << "Equal names should have equal hashes";
+  ASSERT_NE(hash, Name("/ab").getHash()) << "The hash should include component boundaries";
+  ASSERT_EQ(Name().getHash(), Name(vector<Name::Component>()).getHash());
+
+  name.append("c");
+  ASSERT_NE(hash, name.getHash()) << "The cached hash should be updated after a change";
+  ASSERT_EQ(Name("/a/b/c").getHash(), name.getHash());
+  ASSERT_FALSE(name.equals(Name("/a/b/d")));
+
+  // Each way of changing a name should keep the hash equal to a new name.
+  Name abc("/a/b/c");
+  ASSERT_EQ(abc.getHash(), Name("/a").append(Name("/b/c")).getHash());
+  ASSERT_EQ(abc.getHash(), Name().append(abc).getHash());
+  ASSERT_EQ(Name("/a/b").getHash(), abc.getPrefix(2).getHash());
+  ASSERT_EQ(Name("/b/c").getHash(), abc.getSubName(1).getHash());
+  Name decoded;
+  decoded.wireDecode(abc.wireEncode());
+  ASSERT_EQ(abc.getHash(), decoded.getHash());
+  decoded.clear();
+  ASSERT_EQ(Name().getHash(), decoded.getHash());
+
+  ASSERT_EQ(Name::Component("a").getHash(), Name::Component("a").getHash());
+  ASSERT_NE(Name::Component("a").getHash(), Name::Component("b").getHash());
+  ASSERT_NE
+    (Name::Component("a").getHash(),
+     Name::Component("a", ndn_NameComponentType_OTHER_CODE, 99).getHash())
+    << "The component hash should include the type";
+}
+
+TEST_F(TestNameMethods, ToUriBuffer)
+{
+  Name name(expectedURI);
+  string uri = name.toUri();
+  ASSERT_EQ(expectedURI, uri);
+
+  char buffer[100];
+  ASSERT_EQ(uri.size(), name.toUri(buffer, sizeof(buffer)));
+  ASSERT_EQ(uri, string(buffer));
+  ASSERT_EQ(4 + uri.size(), name.toUri(buffer, sizeof(buffer), true));
+  ASSERT_EQ("ndn:" + uri, string(buffer));
+
+  // The buffer needs room for the null terminator.
+  buffer[0] = 'x';
+  ASSERT_EQ(uri.size(), name.toUri(buffer, uri.size()));
+  ASSERT_EQ('x', buffer[0]) << "toUri should not write to a small buffer";
+  ASSERT_EQ(uri.size(), name.toUri(buffer, uri.size() + 1));
+  ASSERT_EQ(uri, string(buffer));
+
+  ASSERT_EQ(1, Name().toUri(buffer, sizeof(buffer)));
+  ASSERT_EQ("/", string(buffer));
+
+  // A type code after a digest component should still be decimal.
+  Name typedName;
+  typedName.appendImplicitSha256Digest(Blob(vector<uint8_t>(32, 0xab)))
+    .append("x", ndn_NameComponentType_OTHER_CODE, 99);
+  string abHex;
+  for (size_t i = 0; i < 32; ++i)
+    abHex += "ab";
+  ASSERT_EQ("/sha256digest=" + abHex + "/99=x", typedName.toUri());
+  ASSERT_EQ(typedName, Name(typedName.toUri()));
+}
+
+TEST_F(TestNameMethods, FromUris)
+{
+  vector<string> uris;
+  uris.push_back("/ndn/edu/ucla/a");
+  uris.push_back("ndn:/ndn/edu/ucla/b");
+  uris.push_back(" /ndn/./edu/%41 ");
+  uris.push_back("/");
+  uris.push_back("/ndn/edu/ucla/a/sha256digest=" + string(64, '0'));
+
+  vector<Name> names;
+  Name::fromUris(uris, names);
+  ASSERT_EQ(uris.size(), names.size());
+  for (size_t i = 0; i < uris.size(); ++i)
+    ASSERT_EQ(Name(uris[i]), names[i]) << "fromUris should match Name(uri) for " << uris[i];
+
+  ASSERT_EQ(names[0].get(0).getValue().buf(), names[1].get(0).getValue().buf())
+    << "A repeated component should share its value";
+}
+
+#if NDN_CPP_HAVE_STD_UNORDERED_MAP
+TEST_F(TestNameMethods, UnorderedMap)
+{
+  unordered_map<Name, int> nameMap;
+  nameMap[Name("/a/b")] = 1;
+  nameMap[Name("/a/c")] = 2;
+  ASSERT_EQ(1, nameMap[Name("/a/b")]);
+  ASSERT_EQ(2, nameMap.find(Name("/a").append("c"))->second);
+  ASSERT_TRUE(nameMap.find(Name("/a")) == nameMap.end());
+
+  unordered_map<Name::Component, int> componentMap;
+  componentMap[Name::Component("a")] = 1;
+  ASSERT_EQ(1, componentMap[Name::Component("a")]);
+  ASSERT_TRUE(componentMap.find(Name::Component("b")) == componentMap.end());
+}
+#endif
+
 int
 main(int argc, char **argv)
 {
@@ -0,0 +1,369 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2018 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+#include "gtest/gtest.h"
+#include <ndn-cpp/face.hpp>
+#include <ndn-cpp/security/key-chain.hpp>
+#include <ndn-cpp/transport/transport.hpp>
+#include "../../src/encoding/element-listener.hpp"
+#include "../../src/impl/object-pool.hpp"
+
+using namespace std;
+using namespace ndn;
+using namespace ndn::func_lib;
+
+class Receiver
+{
+public:
+  Receiver()
+  : onDataCallCount_(0), onInterestCallCount_(0), dataPointer_(0),
+    interestPointer_(0), congestionMark_(0), mustBeFresh_(false)
+  {
+  }
+
+  void
+  onData(const ptr_lib::shared_ptr<const Interest>& interest,
+         const ptr_lib::shared_ptr<Data>& data)
+  {
+    ++onDataCallCount_;
+    dataPointer_ = data.get();
+    name_ = data->getName();
+    content_ = data->getContent();
+    congestionMark_ = data->getCongestionMark();
+    if (keepPackets_)
+      keptData_ = data;
+  }
+
+  void
+  onInterest
+    (const ptr_lib::shared_ptr<const Name>& prefix,
+     const ptr_lib::shared_ptr<const Interest>& interest, Face& face,
+     uint64_t interestFilterId,
+     const ptr_lib::shared_ptr<const InterestFilter>& filter)
+  {
+    ++onInterestCallCount_;
+    interestPointer_ = interest.get();
+    name_ = interest->getName();
+    mustBeFresh_ = interest->getMustBeFresh();
+    if (keepPackets_)
+      keptInterest_ = interest;
+  }
+
+  void
+  onTimeout(const ptr_lib::shared_ptr<const Interest>& interest)
+  {
+  }
+
+  int onDataCallCount_;
+  int onInterestCallCount_;
+  // Only used to compare the object address, not to access the object.
+  const void* dataPointer_;
+  const void* interestPointer_;
+  Name name_;
+  Blob content_;
+  uint64_t congestionMark_;
+  bool mustBeFresh_;
+  bool keepPackets_;
+  ptr_lib::shared_ptr<Data> keptData_;
+  ptr_lib::shared_ptr<const Interest> keptInterest_;
+};
+
+/**
+ * Append the TLV type and length in the NDN-TLV variable-length format.
+ */
+static void
+appendTypeAndLength(vector<uint8_t>& output, int type, size_t length)
+{
+  output.push_back((uint8_t)type);
+  if (length < 253)
+    output.push_back((uint8_t)length);
+  else {
+    output.push_back(253);
+    output.push_back((uint8_t)(length >> 8));
+    output.push_back((uint8_t)length);
+  }
+}
+
+/**
+ * Wrap the element in an LpPacket with a CongestionMark of 1.
+ */
+static Blob
+makeCongestionMarkPacket(const Blob& element)
+{
+  const uint8_t congestionMark[] = { 0xfd, 0x03, 0x40, 0x01, 0x01 };
+  vector<uint8_t> fragment;
+  appendTypeAndLength(fragment, 80, element.size());
+  fragment.insert(fragment.end(), element.buf(), element.buf() + element.size());
+
+  vector<uint8_t> result;
+  appendTypeAndLength
+    (result, 100, sizeof(congestionMark) + fragment.size());
+  result.insert
+    (result.end(), congestionMark, congestionMark + sizeof(congestionMark));
+  result.insert(result.end(), fragment.begin(), fragment.end());
+  return Blob(result);
+}
+
+/**
+ * A ReceiveTransport ignores sent packets. processEvents() gives each element
+ * added with receive() to the element listener.
+ */
+class ReceiveTransport : public Transport {
+public:
+  ReceiveTransport()
+  : elementListener_(0)
+  {
+  }
+
+  virtual bool
+  isLocal(const Transport::ConnectionInfo& connectionInfo) { return true; }
+
+  virtual bool
+  isAsync() { return false; }
+
+  virtual void
+  connect(const Transport::ConnectionInfo& connectionInfo,
+          ElementListener& elementListener, const OnConnected& onConnected)
+  {
+    elementListener_ = &elementListener;
+    if (onConnected)
+      onConnected();
+  }
+
+  virtual void
+  send(const uint8_t *data, size_t dataLength) {}
+
+  virtual void
+  processEvents()
+  {
+    vector<Blob> elements;
+    elements.swap(receiveQueue_);
+    for (size_t i = 0; i < elements.size(); ++i)
+      elementListener_->onReceivedElement
+        (elements[i].buf(), elements[i].size());
+  }
+
+  virtual bool
+  getIsConnected() { return elementListener_ != 0; }
+
+  virtual void
+  close() { elementListener_ = 0; }
+
+  /**
+   * Add the element to the queue for the next call to processEvents().
+   */
+  void
+  receive(const Blob& element) { receiveQueue_.push_back(element); }
+
+private:
+  ElementListener* elementListener_;
+  vector<Blob> receiveQueue_;
+};
+
+class TestNodeObjectPool : public ::testing::Test {
+public:
+  TestNodeObjectPool()
+  : keyChain_("pib-memory:", "tpm-memory:"),
+    transport_(new ReceiveTransport()),
+    face_(transport_, ptr_lib::make_shared<Transport::ConnectionInfo>())
+  {
+    receiver_.keepPackets_ = false;
+  }
+
+  /**
+   * Express an Interest for the name, and send a Data packet from the peer.
+   * @param name The name of the Interest and Data.
+   * @param content The Data content.
+   * @param withCongestionMark If true, send the Data in an LpPacket with a
+   * CongestionMark.
+   */
+  void
+  expressAndReceive
+    (const Name& name, const string& content, bool withCongestionMark)
+  {
+    face_.expressInterest
+      (name, bind(&Receiver::onData, &receiver_, _1, _2),
+       bind(&Receiver::onTimeout, &receiver_, _1));
+    sendData(name, content, withCongestionMark);
+  }
+
+  /**
+   * Send a Data packet from the peer and process it in the face.
+   */
+  void
+  sendData(const Name& name, const string& content, bool withCongestionMark)
+  {
+    Data data(name);
+    data.setContent(Blob((const uint8_t*)content.c_str(), content.size()));
+    keyChain_.signWithSha256(data);
+    if (withCongestionMark)
+      sendFromPeer(makeCongestionMarkPacket(data.wireEncode()));
+    else
+      sendFromPeer(data.wireEncode());
+  }
+
+  /**
+   * Send the element from the peer and process it in the face.
+   */
+  void
+  sendFromPeer(const Blob& element)
+  {
+    transport_->receive(element);
+    face_.processEvents();
+  }
+
+  KeyChain keyChain_;
+  ptr_lib::shared_ptr<ReceiveTransport> transport_;
+  Face face_;
+  Receiver receiver_;
+};
+
+TEST(TestObjectPool, AcquireAndRelease)
+{
+  ObjectPool<Name> pool(1);
+  ptr_lib::shared_ptr<Name> name = pool.acquire();
+  Name* namePointer = name.get();
+  pool.release(name);
+  ASSERT_TRUE(!name);
+  ASSERT_EQ(1, pool.size());
+
+  // The released object is reused.
+  name = pool.acquire();
+  ASSERT_EQ(namePointer, name.get());
+  ASSERT_EQ(0, pool.size());
+
+  // An object with another reference is not put back in the pool.
+  ptr_lib::shared_ptr<Name> otherReference = name;
+  pool.release(name);
+  ASSERT_EQ(0, pool.size());
+
+  // The pool doesn't keep more than maxSize objects.
+  ptr_lib::shared_ptr<Name> name1 = pool.acquire();
+  ptr_lib::shared_ptr<Name> name2 = pool.acquire();
+  pool.release(name1);
+  pool.release(name2);
+  ASSERT_EQ(1, pool.size());
+}
+
+TEST_F(TestNodeObjectPool, ReuseData)
+{
+  expressAndReceive(Name("/test/a"), "content a", true);
+  ASSERT_EQ(1, receiver_.onDataCallCount_);
+  ASSERT_EQ(1, receiver_.congestionMark_);
+  const void* firstPointer = receiver_.dataPointer_;
+
+  // The application dropped its reference, so the Data object is reused.
+  expressAndReceive(Name("/test/b"), "content b", false);
+  ASSERT_EQ(2, receiver_.onDataCallCount_);
+  ASSERT_EQ(firstPointer, receiver_.dataPointer_);
+
+  // The reused object has no values from the previous packet.
+  ASSERT_EQ(Name("/test/b"), receiver_.name_);
+  ASSERT_TRUE(receiver_.content_.equals
+              (Blob((const uint8_t*)"content b", 9)));
+  ASSERT_EQ(0, receiver_.congestionMark_) <<
+    "The LpPacket of the previous packet was not cleared";
+}
+
+TEST_F(TestNodeObjectPool, ResetLazyDecodedData)
+{
+  // A Data packet which doesn't match a pending Interest is recycled without
+  // decoding the fields other than the name.
+  // Express an Interest to connect the transport.
+  face_.expressInterest
+    (Name("/other"), bind(&Receiver::onData, &receiver_, _1, _2),
+     bind(&Receiver::onTimeout, &receiver_, _1));
+  sendData(Name("/test/unexpected"), "unexpected content", true);
+  ASSERT_EQ(0, receiver_.onDataCallCount_);
+
+  expressAndReceive(Name("/test/c"), "content c", false);
+  ASSERT_EQ(1, receiver_.onDataCallCount_);
+  ASSERT_EQ(Name("/test/c"), receiver_.name_);
+  ASSERT_TRUE(receiver_.content_.equals
+              (Blob((const uint8_t*)"content c", 9))) <<
+    "The lazy decoded fields of the previous packet were not reset";
+  ASSERT_EQ(0, receiver_.congestionMark_);
+}
+
+TEST_F(TestNodeObjectPool, KeepData)
+{
+  receiver_.keepPackets_ = true;
+  expressAndReceive(Name("/test/a"), "content a", false);
+  ptr_lib::shared_ptr<Data> firstData = receiver_.keptData_;
+  ASSERT_TRUE(!!firstData);
+
+  // The application has a reference, so the Data object is not reused.
+  expressAndReceive(Name("/test/b"), "content b", false);
+  ASSERT_EQ(2, receiver_.onDataCallCount_);
+  ASSERT_NE((const void*)firstData.get(), receiver_.dataPointer_);
+  ASSERT_EQ(Name("/test/a"), firstData->getName());
+  ASSERT_TRUE(firstData->getContent().equals
+              (Blob((const uint8_t*)"content a", 9)));
+}
+
+TEST_F(TestNodeObjectPool, KeepInterest)
+{
+  face_.setInterestFilter
+    (Name("/test"),
+     bind(&Receiver::onInterest, &receiver_, _1, _2, _3, _4, _5));
+  // Express an Interest to connect the transport.
+  face_.expressInterest
+    (Name("/other"), bind(&Receiver::onData, &receiver_, _1, _2),
+     bind(&Receiver::onTimeout, &receiver_, _1));
+
+  receiver_.keepPackets_ = true;
+  Interest interest1(Name("/test/a"));
+  interest1.setMustBeFresh(false);
+  sendFromPeer(makeCongestionMarkPacket(interest1.wireEncode()));
+  ASSERT_EQ(1, receiver_.onInterestCallCount_);
+  ptr_lib::shared_ptr<const Interest> firstInterest = receiver_.keptInterest_;
+
+  Interest interest2(Name("/test/b"));
+  interest2.setMustBeFresh(true);
+  sendFromPeer(interest2.wireEncode());
+  ASSERT_EQ(2, receiver_.onInterestCallCount_);
+  // The first Interest is not reused since the application kept it.
+  ASSERT_NE((const void*)firstInterest.get(), receiver_.interestPointer_);
+  const void* secondPointer = receiver_.interestPointer_;
+  ASSERT_EQ(Name("/test/a"), firstInterest->getName());
+  ASSERT_FALSE(firstInterest->getMustBeFresh());
+
+  // Drop the references. The next Interest reuses an object and has its own
+  // values.
+  firstInterest.reset();
+  receiver_.keptInterest_.reset();
+  receiver_.keepPackets_ = false;
+  Interest interest3(Name("/test/c"));
+  interest3.setMustBeFresh(false);
+  sendFromPeer(interest3.wireEncode());
+  ASSERT_EQ(3, receiver_.onInterestCallCount_);
+  ASSERT_EQ(secondPointer, receiver_.interestPointer_);
+  ASSERT_EQ(Name("/test/c"), receiver_.name_);
+  ASSERT_FALSE(receiver_.mustBeFresh_) <<
+    "The reused Interest has a selector from the previous packet";
+}
+
+int
+main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,243 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2018 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+#include <stdio.h>
+#include <pthread.h>
+#include "gtest/gtest.h"
+#include <ndn-cpp/name.hpp>
+#include <ndn-cpp/digest-sha256-signature.hpp>
+#include <ndn-cpp/security/key-chain.hpp>
+#include <ndn-cpp/util/loopback-forwarder.hpp>
+#include <ndn-cpp/util/packet-trace.hpp>
+
+using namespace std;
+using namespace ndn;
+using namespace ndn::func_lib;
+
+static void*
+recordInThread(void* arg)
+{
+  for (uint64_t i = 0; i < 5; ++i)
+    PacketTrace::record(PacketTrace::SEND, 100 + i, 0);
+
+  return 0;
+}
+
+static void*
+recordManyInThread(void* arg)
+{
+  uint64_t nameHash = Name("/test/trace").getHash();
+  for (uint64_t i = 0; i < 20; ++i)
+    PacketTrace::record(PacketTrace::RECEIVE, i, nameHash);
+
+  return 0;
+}
+
+static void
+onInterest
+  (const ptr_lib::shared_ptr<const Name>& prefix,
+   const ptr_lib::shared_ptr<const Interest>& interest, Face& face,
+   uint64_t interestFilterId,
+   const ptr_lib::shared_ptr<const InterestFilter>& filter)
+{
+  Data data(interest->getName());
+  data.setSignature(DigestSha256Signature());
+  face.putData(data);
+}
+
+static void
+onData
+  (const ptr_lib::shared_ptr<const Interest>& interest,
+   const ptr_lib::shared_ptr<Data>& data, int* nData)
+{
+  ++*nData;
+}
+
+static void
+onRegisterFailed(const ptr_lib::shared_ptr<const Name>& prefix)
+{
+}
+
+static void
+onRegisterSuccess
+  (const ptr_lib::shared_ptr<const Name>& prefix, uint64_t registeredPrefixId,
+   int* nRegistered)
+{
+  ++*nRegistered;
+}
+
+TEST(TestPacketTrace, RingBuffer)
+{
+  // Use a new thread so that it gets a ring buffer with the small capacity.
+  size_t savedCapacity = PacketTrace::getBufferCapacity();
+  PacketTrace::setBufferCapacity(6);
+  ASSERT_EQ(8, PacketTrace::getBufferCapacity());
+  pthread_t thread;
+  ASSERT_EQ(0, pthread_create(&thread, 0, recordManyInThread, 0));
+  ASSERT_EQ(0, pthread_join(thread, 0));
+  PacketTrace::setBufferCapacity(savedCapacity);
+
+  vector<PacketTrace::Record> records;
+  PacketTrace::getRecords(records);
+  // Only the most recent records remain, except the slot which the writer
+  // would overwrite next.
+  ASSERT_EQ(7, records.size());
+  uint64_t nameHash = Name("/test/trace").getHash();
+  for (size_t i = 0; i < records.size(); ++i) {
+    ASSERT_EQ(13 + i, records[i].value);
+    ASSERT_EQ(PacketTrace::RECEIVE, records[i].eventType);
+    ASSERT_EQ(nameHash, records[i].nameHash);
+    if (i > 0) {
+      ASSERT_TRUE(records[i].timestampNanoseconds >=
+                  records[i - 1].timestampNanoseconds);
+    }
+  }
+
+  PacketTrace::clear();
+  PacketTrace::getRecords(records);
+  ASSERT_EQ(0, records.size());
+
+  PacketTrace::record(PacketTrace::DECODE, 5, nameHash);
+  PacketTrace::getRecords(records);
+  ASSERT_EQ(1, records.size());
+  ASSERT_EQ(PacketTrace::DECODE, records[0].eventType);
+  PacketTrace::clear();
+}
+
+TEST(TestPacketTrace, Threads)
+{
+  PacketTrace::record(PacketTrace::RECEIVE, 1, 0);
+  pthread_t thread;
+  ASSERT_EQ(0, pthread_create(&thread, 0, recordInThread, 0));
+  ASSERT_EQ(0, pthread_join(thread, 0));
+  PacketTrace::record(PacketTrace::RECEIVE, 2, 0);
+
+  vector<PacketTrace::Record> records;
+  PacketTrace::getRecords(records);
+  ASSERT_EQ(7, records.size());
+  // The records are sorted by time.
+  ASSERT_EQ(1, records[0].value);
+  ASSERT_EQ(2, records[6].value);
+  for (size_t i = 1; i <= 5; ++i) {
+    ASSERT_EQ(PacketTrace::SEND, records[i].eventType);
+    ASSERT_EQ(99 + i, records[i].value);
+    ASSERT_NE(records[0].threadIndex, records[i].threadIndex);
+  }
+  ASSERT_EQ(records[0].threadIndex, records[6].threadIndex);
+  PacketTrace::clear();
+}
+
+TEST(TestPacketTrace, DumpAndRead)
+{
+  for (uint64_t i = 0; i < 3; ++i)
+    PacketTrace::record(PacketTrace::CALLBACK_ENTER, i, i * 10);
+  vector<PacketTrace::Record> records;
+  PacketTrace::getRecords(records);
+
+  string filePath = "test-packet-trace.bin";
+  PacketTrace::dump(filePath);
+  vector<PacketTrace::Record> fileRecords;
+  PacketTrace::readFile(filePath, fileRecords);
+  remove(filePath.c_str());
+
+  ASSERT_EQ(3, fileRecords.size());
+  for (size_t i = 0; i < fileRecords.size(); ++i) {
+    ASSERT_EQ(records[i].timestampNanoseconds,
+              fileRecords[i].timestampNanoseconds);
+    ASSERT_EQ(i, fileRecords[i].value);
+    ASSERT_EQ(i * 10, fileRecords[i].nameHash);
+    ASSERT_EQ(PacketTrace::CALLBACK_ENTER, fileRecords[i].eventType);
+  }
+
+  ASSERT_THROW
+    (PacketTrace::readFile("no-such-packet-trace.bin", fileRecords),
+     runtime_error);
+  PacketTrace::clear();
+}
+
+TEST(TestPacketTrace, FaceEvents)
+{
+  if (!PacketTrace::isEnabled())
+    // The library was not configured with --with-packet-trace .
+    return;
+
+  LoopbackForwarder forwarder;
+  KeyChain keyChain("pib-memory:", "tpm-memory:");
+  keyChain.createIdentityV2(Name("/test/identity"), EcKeyParams());
+  ptr_lib::shared_ptr<Face> consumer = forwarder.makeFace();
+  ptr_lib::shared_ptr<Face> producer = forwarder.makeFace();
+  producer->setCommandSigningInfo
+    (keyChain, keyChain.getDefaultCertificateName());
+
+  Name prefix("/test/trace");
+  int nRegistered = 0;
+  producer->registerPrefix
+    (prefix, &onInterest, &onRegisterFailed,
+     bind(&onRegisterSuccess, _1, _2, &nRegistered));
+  for (int i = 0; i < 100 && nRegistered == 0; ++i) {
+    forwarder.processEvents();
+    producer->processEvents();
+  }
+  ASSERT_EQ(1, nRegistered);
+
+  PacketTrace::clear();
+  Name name(prefix);
+  name.append("data");
+  int nData = 0;
+  consumer->expressInterest(name, bind(&onData, _1, _2, &nData));
+  for (int i = 0; i < 100 && nData == 0; ++i) {
+    forwarder.processEvents();
+    consumer->processEvents();
+    producer->processEvents();
+  }
+  ASSERT_EQ(1, nData);
+
+  vector<PacketTrace::Record> records;
+  PacketTrace::getRecords(records);
+  int nEvents[PacketTrace::TIMEOUT + 1] = { 0 };
+  for (size_t i = 0; i < records.size(); ++i) {
+    if (records[i].nameHash != 0) {
+      ASSERT_EQ(name.getHash(), records[i].nameHash);
+    }
+    ++nEvents[records[i].eventType];
+  }
+
+  // The Interest and the Data are each sent, received and decoded once.
+  ASSERT_EQ(2, nEvents[PacketTrace::SEND]);
+  ASSERT_EQ(2, nEvents[PacketTrace::RECEIVE]);
+  ASSERT_EQ(2, nEvents[PacketTrace::DECODE]);
+  ASSERT_EQ(1, nEvents[PacketTrace::INTEREST_FILTER_MATCH]);
+  ASSERT_EQ(1, nEvents[PacketTrace::PIT_MATCH]);
+  // The producer's onInterest and the consumer's onData.
+  ASSERT_EQ(2, nEvents[PacketTrace::CALLBACK_ENTER]);
+  ASSERT_EQ(2, nEvents[PacketTrace::CALLBACK_EXIT]);
+  ASSERT_EQ(0, nEvents[PacketTrace::TIMEOUT]);
+  ASSERT_EQ(PacketTrace::SEND, records[0].eventType);
+  ASSERT_EQ(PacketTrace::CALLBACK_EXIT, records.back().eventType);
+  PacketTrace::clear();
+}
+
+int
+main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
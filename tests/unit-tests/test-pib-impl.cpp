@@ -109,6 +109,9 @@ public:
   TearDown()
   {
     remove(pibSqlite3Fixture.databaseFilePath.c_str());
+    // The database is still open, so also remove the write-ahead log files.
+    remove((pibSqlite3Fixture.databaseFilePath + "-wal").c_str());
+    remove((pibSqlite3Fixture.databaseFilePath + "-shm").c_str());
   }
 };
 
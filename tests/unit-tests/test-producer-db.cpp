@@ -68,7 +68,7 @@ class TestProducerDb : public ::testing::Test {
 public:
   TestProducerDb()
   {
-    databaseFilePath = getPolicyConfigDirectory() + "/test.db";
+    databaseFilePath = getPolicyConfigDirectory() + "/producer-db-test.db";
     remove(databaseFilePath.c_str());
   }
 
@@ -86,7 +86,7 @@ public:
   {
     string policyConfigDirectory = getPolicyConfigDirectory();
 
-    databaseFilePath = policyConfigDirectory + "/test.db";
+    databaseFilePath = policyConfigDirectory + "/producer-test.db";
     remove(databaseFilePath.c_str());
 
     // Set up the keyChain.
@@ -312,6 +312,35 @@ TEST_F(TestProducer, ContentKeyRequest)
   params.setInitialVector(initialVector);
   Blob decryptTest = AesAlgorithm::decrypt(contentKey, encryptedData, params);
   ASSERT_TRUE(decryptTest.equals(Blob(DATA_CONTENT, sizeof(DATA_CONTENT))));
+
+  // Check that a batch produce uses the same content key.
+  vector<MillisecondsSince1970> timeSlots;
+  vector<Blob> contents;
+  for (int i = 0; i < 5; ++i) {
+    timeSlots.push_back(testTime2 + i * 1000.0);
+    contents.push_back(Blob(DATA_CONTENT, sizeof(DATA_CONTENT) - i));
+  }
+  vector<ptr_lib::shared_ptr<Data> > dataList;
+  producer.produce(timeSlots, contents, dataList);
+  ASSERT_EQ(contents.size(), dataList.size());
+  for (size_t i = 0; i < dataList.size(); ++i) {
+    const Name& batchName = dataList[i]->getName();
+    ASSERT_EQ(Name::Component(Schedule::toIsoString(timeSlots[i])),
+              batchName.get(5));
+    ASSERT_EQ(cKeyName, batchName.getSubName(7, 6));
+    ASSERT_EQ(testTimeRounded2, batchName.get(13));
+    ASSERT_TRUE(dataList[i]->getSignature()->getSignature().size() > 0);
+
+    EncryptedContent batchContent;
+    batchContent.wireDecode(dataList[i]->getContent());
+    params.setInitialVector(batchContent.getInitialVector());
+    ASSERT_TRUE(AesAlgorithm::decrypt
+      (contentKey, batchContent.getPayload(), params).equals(contents[i]));
+  }
+
+  timeSlots.pop_back();
+  ASSERT_THROW
+    (producer.produce(timeSlots, contents, dataList), invalid_argument);
 }
 
 TEST_F(TestProducer, ContentKeySearch)
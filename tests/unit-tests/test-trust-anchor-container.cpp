@@ -182,6 +182,46 @@ TEST_F(TestTrustAnchorContainer, DynamicAnchorFromDirectory)
   ASSERT_EQ(0, anchorContainer.getGroup("group").size());
 }
 
+TEST_F(TestTrustAnchorContainer, DynamicAnchorIncrementalRefresh)
+{
+  anchorContainer.insert("group", certificateDirectoryPath, 400.0, true);
+  ASSERT_EQ(2, anchorContainer.getGroup("group").size());
+  ptr_lib::shared_ptr<CertificateV2> certificate =
+    anchorContainer.find(certificate1->getName());
+  ASSERT_TRUE(!!certificate);
+
+  // Replace the second file with a new certificate of the first identity.
+  ptr_lib::shared_ptr<CertificateV2> certificate3 =
+    fixture.addCertificate(identity1->getDefaultKey(), "3");
+  fixture.saveCertificateToFile(*certificate3, certificatePath2);
+
+  // Wait for the refresh period to expire.
+  usleep(500000);
+
+  ASSERT_TRUE(!anchorContainer.find(certificate2->getName()));
+  ASSERT_TRUE(!!anchorContainer.find(certificate3->getName()));
+  ASSERT_EQ(2, anchorContainer.getGroup("group").size());
+  // The unchanged file should not be reloaded.
+  ASSERT_EQ(certificate, anchorContainer.find(certificate1->getName()));
+
+  // Save the same certificate in a second file. Removing one file should keep
+  // the anchor.
+  string certificatePath3 = certificateDirectoryPath + "/trust-anchor-3.cert";
+  fixture.saveCertificateToFile(*certificate1, certificatePath3);
+  usleep(500000);
+  ASSERT_EQ(2, anchorContainer.getGroup("group").size());
+
+  remove(certificatePath1.c_str());
+  usleep(500000);
+  ASSERT_TRUE(!!anchorContainer.find(certificate1->getName()));
+  ASSERT_EQ(2, anchorContainer.getGroup("group").size());
+
+  remove(certificatePath3.c_str());
+  usleep(500000);
+  ASSERT_TRUE(!anchorContainer.find(certificate1->getName()));
+  ASSERT_EQ(1, anchorContainer.getGroup("group").size());
+}
+
 TEST_F(TestTrustAnchorContainer, FindByInterest)
 {
   anchorContainer.insert("group1", certificatePath1, 400.0);
@@ -0,0 +1,245 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2018 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <cstring>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <ndn-cpp/util/blob.hpp>
+#include <ndn-cpp/transport/udp-transport.hpp>
+#include "../../src/encoding/element-listener.hpp"
+
+using namespace std;
+using namespace ndn;
+
+/**
+ * Make a small NDN-TLV element whose value is the one byte.
+ */
+static Blob
+makeElement(uint8_t value)
+{
+  // Use the Name type with one GenericNameComponent.
+  const uint8_t element[] = { 0x07, 0x03, 0x08, 0x01, value };
+  return Blob(element, sizeof(element));
+}
+
+class ElementCollector : public ElementListener {
+public:
+  ElementCollector()
+  : transport_(0), reenterOnFirstElement_(false)
+  {
+  }
+
+  virtual void
+  onReceivedElement(const uint8_t *element, size_t elementLength)
+  {
+    values_.push_back(element[elementLength - 1]);
+    if (reenterOnFirstElement_) {
+      reenterOnFirstElement_ = false;
+      transport_->processEvents();
+    }
+  }
+
+  vector<uint8_t> values_;
+  UdpTransport* transport_;
+  bool reenterOnFirstElement_;
+};
+
+class TestUdpTransport : public ::testing::Test {
+public:
+  TestUdpTransport()
+  : transport_(4)
+  {
+    // Make a server socket on an unused loopback port.
+    serverSocket_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+    struct sockaddr_in address;
+    ::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0;
+    ::bind(serverSocket_, (struct sockaddr*)&address, sizeof(address));
+    socklen_t addressLength = sizeof(address);
+    ::getsockname(serverSocket_, (struct sockaddr*)&address, &addressLength);
+    serverPort_ = ntohs(address.sin_port);
+
+    collector_.transport_ = &transport_;
+  }
+
+  virtual
+  ~TestUdpTransport()
+  {
+    ::close(serverSocket_);
+  }
+
+  void
+  connect()
+  {
+    transport_.connect
+      (UdpTransport::ConnectionInfo("127.0.0.1", serverPort_), collector_,
+       Transport::OnConnected());
+  }
+
+  /**
+   * Receive the datagrams waiting at the server socket without blocking.
+   * @param clientAddress If not null, set this to the sender address.
+   * @return The last byte of each datagram.
+   */
+  vector<uint8_t>
+  receiveAtServer(struct sockaddr_in* clientAddress = 0)
+  {
+    vector<uint8_t> values;
+    uint8_t buffer[100];
+    // Wait briefly for the datagrams on the loopback interface.
+    ::usleep(10000);
+    while (true) {
+      struct sockaddr_in address;
+      socklen_t addressLength = sizeof(address);
+      ssize_t nBytes = ::recvfrom
+        (serverSocket_, buffer, sizeof(buffer), MSG_DONTWAIT,
+         (struct sockaddr*)&address, &addressLength);
+      if (nBytes <= 0)
+        break;
+      values.push_back(buffer[nBytes - 1]);
+      if (clientAddress)
+        *clientAddress = address;
+    }
+
+    return values;
+  }
+
+  /**
+   * Call processEvents until count elements are received or too many tries.
+   */
+  void
+  processEventsUntil(size_t count)
+  {
+    for (int i = 0; i < 100 && collector_.values_.size() < count; ++i) {
+      ::usleep(1000);
+      transport_.processEvents();
+    }
+  }
+
+  UdpTransport transport_;
+  ElementCollector collector_;
+  int serverSocket_;
+  unsigned short serverPort_;
+};
+
+TEST_F(TestUdpTransport, BatchedSend)
+{
+  Blob element = makeElement(0);
+  ASSERT_THROW(transport_.send(element.buf(), element.size()), runtime_error) <<
+    "send before connect should throw";
+
+  connect();
+  for (uint8_t i = 0; i < 3; ++i) {
+    Blob element = makeElement(i);
+    transport_.send(element.buf(), element.size());
+  }
+  ASSERT_EQ(0, receiveAtServer().size()) <<
+    "The packets should be queued until the batch is full or flushed";
+
+  transport_.flush();
+  vector<uint8_t> values = receiveAtServer();
+  ASSERT_EQ(3, values.size());
+  for (uint8_t i = 0; i < 3; ++i)
+    ASSERT_EQ(i, values[i]);
+
+  // A full batch is sent immediately.
+  for (uint8_t i = 0; i < 4; ++i) {
+    Blob element = makeElement(10 + i);
+    transport_.send(element.buf(), element.size());
+  }
+  ASSERT_EQ(4, receiveAtServer().size());
+}
+
+TEST_F(TestUdpTransport, FlushOnClose)
+{
+  connect();
+  for (uint8_t i = 0; i < 2; ++i) {
+    Blob element = makeElement(i);
+    transport_.send(element.buf(), element.size());
+  }
+
+  transport_.close();
+  ASSERT_EQ(2, receiveAtServer().size());
+
+  Blob element = makeElement(0);
+  ASSERT_THROW(transport_.send(element.buf(), element.size()), runtime_error) <<
+    "send after close should throw";
+}
+
+TEST_F(TestUdpTransport, BatchSizeLimit)
+{
+  // The batch size is reduced to the most datagrams for one system call, so
+  // the queue is sent when it has 64 packets.
+  UdpTransport transport(1000);
+  transport.connect
+    (UdpTransport::ConnectionInfo("127.0.0.1", serverPort_), collector_,
+     Transport::OnConnected());
+  for (uint8_t i = 0; i < 64; ++i) {
+    Blob element = makeElement(i);
+    transport.send(element.buf(), element.size());
+  }
+  ASSERT_EQ(64, receiveAtServer().size());
+}
+
+TEST_F(TestUdpTransport, BatchedReceive)
+{
+  connect();
+  // Send one packet so that the server knows the client address.
+  Blob element = makeElement(100);
+  transport_.send(element.buf(), element.size());
+  transport_.flush();
+  struct sockaddr_in clientAddress;
+  ASSERT_EQ(1, receiveAtServer(&clientAddress).size());
+
+  // Send more datagrams than the batch size. Re-enter processEvents in the
+  // callback for the first element, which must not overwrite the datagrams of
+  // the outer call which are not yet delivered.
+  const uint8_t nDatagrams = 7;
+  for (uint8_t i = 0; i < nDatagrams; ++i) {
+    Blob element = makeElement(i);
+    ::sendto
+      (serverSocket_, element.buf(), element.size(), 0,
+       (struct sockaddr*)&clientAddress, sizeof(clientAddress));
+  }
+  ::usleep(10000);
+
+  collector_.reenterOnFirstElement_ = true;
+  processEventsUntil(nDatagrams);
+
+  ASSERT_EQ(nDatagrams, collector_.values_.size());
+  vector<uint8_t> values(collector_.values_);
+  sort(values.begin(), values.end());
+  for (uint8_t i = 0; i < nDatagrams; ++i)
+    ASSERT_EQ(i, values[i]) << "A datagram was lost or delivered twice";
+}
+
+int
+main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
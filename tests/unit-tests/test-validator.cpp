@@ -314,6 +314,85 @@ TEST_F(TestValidator, ResetVerifiedCertificates)
     (data, "Should fail, as there is no trusted cache or anchors");
 }
 
+TEST_F(TestValidator, VerifiedDataCaching)
+{
+  fixture_.validator_.getVerifiedDataCache().setCapacity(2);
+
+  Data data(Name("/Security/V2/ValidatorFixture/Sub1/Sub2/Data"));
+  fixture_.keyChain_.sign(data, SigningInfo(fixture_.subIdentity_));
+  Data badData(Name("/Security/V2/ValidatorFixture/Sub1/Sub2/Data"));
+  fixture_.keyChain_.sign(badData, SigningInfo(fixture_.subSelfSignedIdentity_));
+
+  validateExpectFailure
+    (badData, "Should fail, as signed by the policy-violating certificate");
+  ASSERT_EQ(0, fixture_.validator_.getVerifiedDataCache().size());
+
+  validateExpectSuccess
+    (data, "Should get accepted, as signed by the policy-compliant certificate");
+  ASSERT_EQ(1, fixture_.validator_.getVerifiedDataCache().size());
+  ASSERT_TRUE(fixture_.validator_.getVerifiedDataCache().contains
+    (*data.getFullName()));
+  fixture_.face_.sentInterests_.clear();
+
+  // The cache is checked before the policy.
+  fixture_.validator_.getVerifiedDataCache().insert
+    (*badData.getFullName(), ndn_getNowMilliseconds() + 3600 * 1000.0);
+  validateExpectSuccess
+    (badData, "Should get accepted from the verified data cache");
+  ASSERT_EQ(2, fixture_.validator_.getVerifiedDataCache().size());
+
+  // Resetting the anchors through the base class also clears the cache.
+  CertificateStorage& certificateStorage = fixture_.validator_;
+  certificateStorage.resetAnchors();
+  ASSERT_EQ(0, fixture_.validator_.getVerifiedDataCache().size());
+  validateExpectFailure
+    (badData, "Should fail, as signed by the policy-violating certificate");
+  validateExpectSuccess
+    (data, "Should get accepted, as signed by the certificate in the trusted cache");
+  ASSERT_EQ(1, fixture_.validator_.getVerifiedDataCache().size());
+
+  // Make the cache simulate a time 2 hours later, after expiration.
+  fixture_.validator_.setCacheNowOffsetMilliseconds_(2 * 3600 * 1000.0);
+  validateExpectFailure(data, "Should fail, as the cached entry has expired");
+  ASSERT_EQ(0, fixture_.validator_.getVerifiedDataCache().size());
+}
+
+TEST_F(TestValidator, VerifiedMerkleRootCaching)
+{
+  fixture_.validator_.getVerifiedMerkleRootCache().setCapacity(2);
+
+  vector<ptr_lib::shared_ptr<Data> > dataList;
+  for (int i = 0; i < 3; ++i)
+    dataList.push_back(ptr_lib::make_shared<Data>
+      (Name("/Security/V2/ValidatorFixture/Sub1/Sub2/Data").appendSegment(i)));
+  fixture_.keyChain_.signWithMerkleTree
+    (dataList, SigningInfo(fixture_.subIdentity_));
+
+  validateExpectSuccess
+    (*dataList[0], "Should get accepted, as signed by the policy-compliant certificate");
+  ASSERT_EQ(1, fixture_.validator_.getVerifiedMerkleRootCache().size());
+  fixture_.face_.sentInterests_.clear();
+
+  // The other packets with the same root are accepted from the cache.
+  validateExpectSuccess
+    (*dataList[1], "Should get accepted from the verified Merkle root cache");
+  validateExpectSuccess
+    (*dataList[2], "Should get accepted from the verified Merkle root cache");
+  ASSERT_EQ(0, fixture_.face_.sentInterests_.size());
+  ASSERT_EQ(1, fixture_.validator_.getVerifiedMerkleRootCache().size());
+
+  // A changed packet has a different leaf, so its path leads to another root.
+  Data otherData(*dataList[1]);
+  otherData.setContent(Blob(Name("/other").wireEncode()));
+  validateExpectFailure
+    (otherData, "Should fail, as the root from the path has not been verified");
+
+  // Resetting the certificates through the base class also clears the cache.
+  CertificateStorage& certificateStorage = fixture_.validator_;
+  certificateStorage.resetVerifiedCertificates();
+  ASSERT_EQ(0, fixture_.validator_.getVerifiedMerkleRootCache().size());
+}
+
 TEST_F(TestValidator, UntrustedCertificateCaching)
 {
   Data data(Name("/Security/V2/ValidatorFixture/Sub1/Sub2/Data"));
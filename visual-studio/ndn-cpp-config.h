@@ -54,6 +54,11 @@
 #define NDN_CPP_HAVE_HTONLL 0
 #endif
 
+/* 1 if have sys/inotify inotify_init1. */
+#ifndef NDN_CPP_HAVE_INOTIFY
+#define NDN_CPP_HAVE_INOTIFY 0
+#endif
+
 /* Define to 1 if you have the <inttypes.h> header file. */
 #ifndef NDN_CPP_HAVE_INTTYPES_H
 #define NDN_CPP_HAVE_INTTYPES_H 1
@@ -113,6 +118,11 @@
 #define NDN_CPP_HAVE_PROTOBUF 0
 #endif
 
+/* 1 if have sys/socket recvmmsg and sendmmsg. */
+#ifndef NDN_CPP_HAVE_RECVMMSG
+#define NDN_CPP_HAVE_RECVMMSG 0
+#endif
+
 /* Define to 1 if you have the `round' function. */
 #ifndef NDN_CPP_HAVE_ROUND
 #define NDN_CPP_HAVE_ROUND 1
@@ -153,6 +163,11 @@
 #define NDN_CPP_HAVE_STD_SHARED_PTR 1
 #endif
 
+/* 1 if have std::unordered_map and std::hash. */
+#ifndef NDN_CPP_HAVE_STD_UNORDERED_MAP
+#define NDN_CPP_HAVE_STD_UNORDERED_MAP 1
+#endif
+
 /* Define to 1 if you have the `strchr' function. */
 #ifndef NDN_CPP_HAVE_STRCHR
 #define NDN_CPP_HAVE_STRCHR 1
@@ -209,6 +224,11 @@
 #define NDN_CPP_WITH_OSX_KEYCHAIN 0
 #endif
 
+/* Define to 1 if the library should record packet events with PacketTrace. */
+#ifndef NDN_CPP_WITH_PACKET_TRACE
+#define NDN_CPP_WITH_PACKET_TRACE 0
+#endif
+
 /* Define to 1 if func_lib should use std::function, etc. if available */
 #ifndef NDN_CPP_WITH_STD_FUNCTION
 #define NDN_CPP_WITH_STD_FUNCTION 1